@@ -4,6 +4,8 @@
 #include "ui/views/main_window.h"
 #include "services/hardware_service.h"
 #include "services/configuration_service.h"
+#include "services/profiler.h"
+#include "ui/widgets/deferred_draw.h"
 #include "imgui.h"
 
 #ifdef _WIN32
@@ -60,6 +62,9 @@ namespace I2CDebugger {
                 }
                 m_tableViewModel->GetData().isConnected = success;
                 m_tableViewModel->GetData().deviceName = deviceName;
+                if (!success) {
+                    m_tableViewModel->ResetRunState();
+                }
             });
 
         // 设备异常断开回调
@@ -73,10 +78,8 @@ namespace I2CDebugger {
 
             m_tableViewModel->GetData().isConnected = false;
             m_tableViewModel->GetData().deviceName.clear();
-            m_tableViewModel->GetData().isPeriodicRunning = false;
-            // 重置寄存器表读取状态
-            m_tableViewModel->GetData().isReadingAllRegisters = false;
-            m_tableViewModel->GetData().isExecuteAllSingleCommands = false;
+            // 重置周期触发、读取全部等进行中的状态
+            m_tableViewModel->ResetRunState();
             });
 
         // 扫描回调
@@ -115,7 +118,7 @@ namespace I2CDebugger {
                         }
                         else {
                             m_simpleViewModel->GetData().lastErrorMessage =
-                                packet.errorMsg.empty() ? "操作失败" : packet.errorMsg;
+                                packet.errorDetail.empty() ? "操作失败" : packet.errorDetail.str();
                         }
                     }
                     else {
@@ -124,9 +127,17 @@ namespace I2CDebugger {
                     }
                     });
 
+                // 批次完成回调 - 仅多命令表窗口使用
+                m_hardwareService->SetBatchCallback([this](const BatchCompletion& batch) {
+                    m_tableViewModel->OnBatchComplete(batch);
+                    });
+
                 // ========== 启动硬件服务工作线程 ==========
                 m_hardwareService->Start();
 
+                // 延迟绘制工作线程（默认关闭，可在性能诊断窗口中开启）
+                DeferredDraw::Install();
+
                 // 创建主窗口
                 m_mainWindow = std::make_unique<MainWindow>(m_simpleViewModel, m_tableViewModel);
 
@@ -151,10 +162,12 @@ namespace I2CDebugger {
             m_tableViewModel->GetData(),
             m_globalConfigPath
         );
+        m_tableViewModel->InvalidateHandleIndex();
     }
 
     void App::SaveGlobalConfig() {
-        m_configService->SaveGlobalConfiguration(
+        // 快照后在后台线程写入，不阻塞界面
+        m_configService->SaveGlobalConfigurationAsync(
             m_simpleViewModel->GetData(),
             m_tableViewModel->GetData(),
             m_globalConfigPath
@@ -167,6 +180,7 @@ namespace I2CDebugger {
             m_tableViewModel->GetData(),
             m_globalConfigPath
         );
+        m_tableViewModel->InvalidateHandleIndex();
     }
 
     void App::LoadGlobalConfigFromFile(const std::string& filePath) {
@@ -175,6 +189,7 @@ namespace I2CDebugger {
             m_tableViewModel->GetData(),
             filePath
         );
+        m_tableViewModel->InvalidateHandleIndex();
     }
 
     void App::RenderMainMenuBar() {
@@ -189,6 +204,7 @@ namespace I2CDebugger {
                 }
                 ImGui::EndMenu();
             }
+            RenderSaveStatus();
             ImGui::EndMenuBar();
         }
 
@@ -247,7 +263,36 @@ namespace I2CDebugger {
         }
     }
 
+    void App::RenderSaveStatus() {
+        ConfigSaveStatus status = m_configService->GetSaveStatus();
+        if (!status.pending && status.completedCount == 0) return;
+
+        ImGui::Separator();
+        if (status.pending) {
+            ImGui::TextDisabled("正在保存...");
+        }
+        else if (status.lastSuccess) {
+            ImGui::TextDisabled("已保存 %.1f ms", status.latencyMs);
+        }
+        else {
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "保存失败");
+        }
+
+        if (ImGui::IsItemHovered() && status.completedCount > 0) {
+            ImGui::BeginTooltip();
+            if (!status.lastSuccess) {
+                ImGui::TextUnformatted(status.lastError.c_str());
+            }
+            ImGui::Text("快照 (界面线程): %.2f ms", status.snapshotMs);
+            ImGui::Text("序列化 + 写入 (后台): %.2f ms", status.writeMs);
+            ImGui::Text("命令组: 重写 %d, 未变更 %d", status.groupsWritten, status.groupsReused);
+            ImGui::Text("文件大小: %.1f KB", status.fileBytes / 1024.0);
+            ImGui::EndTooltip();
+        }
+    }
+
     void App::Render() {
+        ProfileZone zone("App::Render");
         // 处理硬件服务回调（在UI线程中执行）
         m_hardwareService->ProcessCallbacks();
 
@@ -261,13 +306,16 @@ namespace I2CDebugger {
     }
 
     void App::Shutdown() {
-        // 退出时自动保存全局配置
+        // 退出时自动保存全局配置，并等待后台写入完成
         SaveGlobalConfig();
+        m_configService->WaitForPendingSave();
 
         // 停止硬件服务工作线程
         if (m_hardwareService) {
             m_hardwareService->Stop();
         }
+
+        DeferredDraw::Shutdown();
     }
 
 }
@@ -30,6 +30,7 @@ namespace I2CDebugger {
 
     private:
         void RenderMainMenuBar();
+        void RenderSaveStatus();
         void AutoLoadConfig();
 
         std::shared_ptr<HardwareService> m_hardwareService;
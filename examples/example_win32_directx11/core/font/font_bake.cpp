@@ -0,0 +1,247 @@
+﻿#include "font_bake.h"
+#include "imgui_internal.h"
+#include "../services/profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct FontBakeJob {
+    ImGuiID bakedId;
+    ImFontConfig* src;
+    const ImFontLoader* loader;
+    ImFontGlyphRasterParams params;
+    ImWchar codepoint;
+};
+
+struct FontBakeResult {
+    ImGuiID bakedId = 0;
+    ImFontConfig* src = nullptr;
+    ImWchar codepoint = 0;
+    bool found = false;
+    ImFontGlyph glyph;
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;  // Alpha8，width * height
+};
+
+// ========== 工作线程共享（g_FontBakeMutex 保护） ==========
+
+static std::vector<std::thread> g_FontBakeThreads;
+static std::mutex g_FontBakeMutex;
+static std::condition_variable g_FontBakeCv;
+static std::deque<FontBakeJob> g_FontBakeJobs;
+static std::vector<FontBakeResult> g_FontBakeDone;
+static bool g_FontBakeStopping = false;
+static FontBakeStats g_FontBakeStats;
+
+// ========== 只由界面线程访问 ==========
+
+static std::unordered_set<uint64_t> g_FontBakePending;                  // 已提交、尚未收取
+static std::unordered_map<uint64_t, FontBakeResult> g_FontBakeReady;    // 已收取、等待打包
+static std::vector<FontBakeResult> g_FontBakeReceived;                  // 收取时的交换缓冲，跨帧复用
+static ImGuiContext* g_FontBakeContext = nullptr;
+static ImGuiID g_FontBakeHookId = 0;
+static bool g_FontBakeEnabled = true;
+static int g_FontBakeSyncDepth = 0;                                     // FontBakeBeginSynchronous 嵌套层数
+
+static uint64_t MakeBakeKey(ImGuiID bakedId, ImWchar codepoint)
+{
+    return ((uint64_t)bakedId << 32) | (uint64_t)codepoint;
+}
+
+static void FontBakeWorker(void)
+{
+    I2CDebugger::Profiler::SetThreadName("字形线程");
+    std::vector<unsigned char> buffer(64 * 64);
+    for (;;) {
+        FontBakeJob job;
+        {
+            std::unique_lock<std::mutex> lock(g_FontBakeMutex);
+            g_FontBakeCv.wait(lock, []() { return g_FontBakeStopping || !g_FontBakeJobs.empty(); });
+            if (g_FontBakeStopping) return;
+            job = g_FontBakeJobs.front();
+            g_FontBakeJobs.pop_front();
+        }
+
+        I2CDebugger::ProfileZone zone("FontBake::Rasterize");
+        auto begin = std::chrono::steady_clock::now();
+        FontBakeResult result;
+        result.bakedId = job.bakedId;
+        result.src = job.src;
+        result.codepoint = job.codepoint;
+        result.found = job.loader->FontSrcRasterizeGlyph(job.src, &job.params, job.codepoint, &result.glyph,
+            &result.width, &result.height, buffer.data(), (int)buffer.size());
+        if (result.found && result.width != 0 && !result.glyph.Visible) {
+            buffer.resize((size_t)result.width * result.height);
+            job.loader->FontSrcRasterizeGlyph(job.src, &job.params, job.codepoint, &result.glyph,
+                &result.width, &result.height, buffer.data(), (int)buffer.size());
+        }
+        if (result.glyph.Visible)
+            result.pixels.assign(buffer.begin(), buffer.begin() + (size_t)result.width * result.height);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+        std::lock_guard<std::mutex> lock(g_FontBakeMutex);
+        g_FontBakeDone.push_back(std::move(result));
+        g_FontBakeStats.completed++;
+        g_FontBakeStats.rasterMs += ms;
+        g_FontBakeStats.maxRasterMs = std::max(g_FontBakeStats.maxRasterMs, ms);
+    }
+}
+
+// NewFrame 开始（图集更新之前）：收取完成的结果，清掉占位期间留下的"未找到"标记，
+// 下次用到该字符时会重新经加载器取字形，从 g_FontBakeReady 打包
+static void FontBakeOnNewFramePre(ImGuiContext* ctx, ImGuiContextHook*)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_FontBakeMutex);
+        g_FontBakeReceived.swap(g_FontBakeDone);
+    }
+
+    ImFontAtlasBuilder* builder = ctx->IO.Fonts->Builder;
+    for (FontBakeResult& result : g_FontBakeReceived) {
+        const uint64_t key = MakeBakeKey(result.bakedId, result.codepoint);
+        g_FontBakePending.erase(key);
+        ImFontBaked* baked = builder ? (ImFontBaked*)builder->BakedMap.GetVoidPtr(result.bakedId) : nullptr;
+        if (!result.found || baked == nullptr) continue;
+        if (!ImFontAtlasBakedForgetMissingGlyph(baked, result.codepoint)) continue;   // 已经加载过
+        g_FontBakeReady[key] = std::move(result);
+    }
+    g_FontBakeReceived.clear();
+
+    // 所属 ImFontBaked 已被回收的结果不会再被取用
+    for (auto it = g_FontBakeReady.begin(); it != g_FontBakeReady.end(); ) {
+        if (builder == nullptr || builder->BakedMap.GetVoidPtr(it->second.bakedId) == nullptr)
+            it = g_FontBakeReady.erase(it);
+        else
+            ++it;
+    }
+}
+
+void FontBakeStart(int workerCount)
+{
+    if (g_FontBakeContext != nullptr) return;
+
+    if (workerCount <= 0) {
+        int cores = (int)std::thread::hardware_concurrency();
+        workerCount = std::min(std::max(cores / 2, 1), 4);
+    }
+
+    g_FontBakeContext = ImGui::GetCurrentContext();
+    ImGuiContextHook hook;
+    hook.Type = ImGuiContextHookType_NewFramePre;
+    hook.Callback = FontBakeOnNewFramePre;
+    g_FontBakeHookId = ImGui::AddContextHook(g_FontBakeContext, &hook);
+
+    g_FontBakeStopping = false;
+    for (int i = 0; i < workerCount; i++)
+        g_FontBakeThreads.emplace_back(FontBakeWorker);
+}
+
+void FontBakeStop(void)
+{
+    if (g_FontBakeContext == nullptr) return;
+
+    {
+        std::lock_guard<std::mutex> lock(g_FontBakeMutex);
+        g_FontBakeStopping = true;
+        g_FontBakeJobs.clear();
+    }
+    g_FontBakeCv.notify_all();
+    for (auto& thread : g_FontBakeThreads)
+        thread.join();
+    g_FontBakeThreads.clear();
+
+    ImGui::RemoveContextHook(g_FontBakeContext, g_FontBakeHookId);
+    g_FontBakeContext = nullptr;
+    g_FontBakeDone.clear();
+    g_FontBakePending.clear();
+    g_FontBakeReady.clear();
+}
+
+void FontBakeSetEnabled(bool enabled)
+{
+    g_FontBakeEnabled = enabled;
+}
+
+bool FontBakeIsEnabled(void)
+{
+    return g_FontBakeEnabled && !g_FontBakeThreads.empty();
+}
+
+void FontBakeBeginSynchronous(void)
+{
+    g_FontBakeSyncDepth++;
+}
+
+void FontBakeEndSynchronous(void)
+{
+    IM_ASSERT(g_FontBakeSyncDepth > 0);
+    g_FontBakeSyncDepth--;
+}
+
+FontBakeStatus FontBakeLoadGlyph(const ImFontLoader* loader, ImFontAtlas* atlas, ImFontConfig* src, ImFontBaked* baked,
+    ImWchar codepoint, ImFontGlyph* out_glyph)
+{
+    const uint64_t key = MakeBakeKey(baked->BakedId, codepoint);
+    auto it = g_FontBakeReady.find(key);
+    if (it != g_FontBakeReady.end() && it->second.src == src) {
+        FontBakeResult& result = it->second;
+        *out_glyph = result.glyph;
+        if (result.glyph.Visible) {
+            ImFontAtlasRectId pack_id = ImFontAtlasPackAddRect(atlas, result.width, result.height);
+            if (pack_id == ImFontAtlasRectId_Invalid) {
+                g_FontBakeReady.erase(it);
+                return FontBakeStatus::Unavailable;
+            }
+            ImTextureRect* r = ImFontAtlasPackGetRect(atlas, pack_id);
+            out_glyph->PackId = pack_id;
+            ImFontAtlasBakedSetFontGlyphBitmap(atlas, baked, src, out_glyph, r, result.pixels.data(), ImTextureFormat_Alpha8, result.width);
+        }
+        g_FontBakeReady.erase(it);
+        g_FontBakeStats.packed++;   // 只有界面线程写
+        return FontBakeStatus::Loaded;
+    }
+
+    // ASCII 字形少且光栅化很快，启动后马上会用到，占位闪一帧不值得。
+    // 回退字形和省略号在 ImFontBaked 创建时就要确定索引，占位会让字体改选 '?' 作回退
+    const ImFont* font = baked->OwnerFont;
+    if (!FontBakeIsEnabled() || g_FontBakeSyncDepth > 0 || loader->FontSrcRasterizeGlyph == nullptr || codepoint < 0x80 ||
+        codepoint == font->FallbackChar || codepoint == font->EllipsisChar)
+        return FontBakeStatus::Unavailable;
+    if (g_FontBakePending.count(key) != 0)
+        return FontBakeStatus::Pending;
+    // 本字体源没有的字符交还给调用方，由后续字体源或回退字形处理
+    if (loader->FontSrcContainsGlyph != nullptr && !loader->FontSrcContainsGlyph(atlas, src, codepoint))
+        return FontBakeStatus::Unavailable;
+
+    FontBakeJob job;
+    job.bakedId = baked->BakedId;
+    job.src = src;
+    job.loader = loader;
+    job.codepoint = codepoint;
+    ImFontAtlasBuildGetGlyphRasterParams(src, baked, &job.params);
+    {
+        std::lock_guard<std::mutex> lock(g_FontBakeMutex);
+        g_FontBakeJobs.push_back(job);
+        g_FontBakeStats.queued++;
+    }
+    g_FontBakeCv.notify_one();
+    g_FontBakePending.insert(key);
+    return FontBakeStatus::Pending;
+}
+
+FontBakeStats FontBakeGetStats(void)
+{
+    std::lock_guard<std::mutex> lock(g_FontBakeMutex);
+    FontBakeStats stats = g_FontBakeStats;
+    stats.enabled = FontBakeIsEnabled();
+    stats.workers = (int)g_FontBakeThreads.size();
+    stats.pending = (int)g_FontBakePending.size();
+    return stats;
+}
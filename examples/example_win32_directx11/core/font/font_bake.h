@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include "imgui.h"
+#include <cstdint>
+
+// ========== 字形后台光栅化 ==========
+// 动态字形第一次出现时不在帧内同步光栅化：请求交给工作线程，本帧该字符先显示回退字形占位；
+// 下一帧 NewFrame 开始时收取结果，字形在下次绘制时打包进图集（只剩打包和拷贝，不再光栅化）。
+// 一次出现大量新汉字（公式帮助、中文寄存器表）时，界面线程的耗时不再随字数增长。
+// 由 font_cache 的加载器在缓存未命中时调用；基础加载器需提供 FontSrcRasterizeGlyph。
+
+enum class FontBakeStatus {
+    Unavailable,    // 未启用或不适用，调用方照常同步加载
+    Pending,        // 已提交（或仍在光栅化），本帧显示占位字形
+    Loaded          // 结果已打包进图集，out_glyph 已填好
+};
+
+struct FontBakeStats {
+    bool enabled = false;
+    int workers = 0;
+    uint32_t queued = 0;            // 累计提交的字形
+    uint32_t completed = 0;         // 累计光栅化完成
+    uint32_t packed = 0;            // 累计打包进图集
+    int pending = 0;                // 已提交、尚未收取
+    double rasterMs = 0.0;          // 工作线程光栅化总耗时
+    double maxRasterMs = 0.0;       // 单个字形最长耗时
+};
+
+// 在 LoadFont() 之后调用。workerCount <= 0 时按 CPU 核数决定
+void FontBakeStart(int workerCount);
+
+// 在 ImGui::DestroyContext() 之前调用，丢弃未完成的请求
+void FontBakeStop(void);
+
+void FontBakeSetEnabled(bool enabled);
+bool FontBakeIsEnabled(void);
+
+// 需要立即拿到字形的场合（如预热）：Begin/End 之间的新字形一律同步光栅化，可嵌套
+void FontBakeBeginSynchronous(void);
+void FontBakeEndSynchronous(void);
+
+// 加载器 FontBakedLoadGlyph 中调用（完整加载，不含只取度量的情况）
+FontBakeStatus FontBakeLoadGlyph(const ImFontLoader* loader, ImFontAtlas* atlas, ImFontConfig* src, ImFontBaked* baked,
+    ImWchar codepoint, ImFontGlyph* out_glyph);
+
+FontBakeStats FontBakeGetStats(void);
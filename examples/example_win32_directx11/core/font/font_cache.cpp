@@ -0,0 +1,439 @@
+﻿#include "font_cache.h"
+#include "font_bake.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+// ========== 文件格式 ==========
+// [FontCacheHeader][FontCacheGlyph x glyphCount][Alpha8 像素区 pixelBytes]
+// 所有结构按原样写入，仅供本机同一构建读取
+
+static const char FONT_CACHE_MAGIC[4] = { 'I', 'F', 'G', 'C' };
+static const uint32_t FONT_CACHE_FORMAT_VERSION = 1;
+
+struct FontCacheHeader {
+    char magic[4];
+    uint32_t formatVersion;
+    uint32_t imguiVersion;
+    uint32_t glyphCount;
+    uint64_t fontHash;
+    uint64_t configHash;
+    uint64_t pixelBytes;
+};
+
+struct FontCacheGlyph {
+    uint32_t codepoint;
+    float size;                 // ImFontBaked::Size
+    float density;              // src->RasterizerDensity * baked->RasterizerDensity
+    uint8_t oversampleH;
+    uint8_t oversampleV;
+    uint8_t visible;
+    uint8_t reserved;
+    uint16_t width;
+    uint16_t height;
+    float advanceX;
+    float x0, y0, x1, y1;
+    uint32_t pixelOffset;       // 相对像素区起点
+};
+
+// ========== 运行时状态 ==========
+
+static FontCacheStats g_FontCacheStats;
+static std::string g_FontCachePath;
+static FontCacheHeader g_FontCacheHeader;
+
+// 映射的旧缓存
+static const unsigned char* g_FontCacheView = nullptr;
+static size_t g_FontCacheViewSize = 0;
+static std::vector<unsigned char> g_FontCacheFallbackBuffer;   // 非 Windows 平台读入内存
+#ifdef _WIN32
+static HANDLE g_FontCacheFile = INVALID_HANDLE_VALUE;
+static HANDLE g_FontCacheMapping = nullptr;
+#endif
+
+static const FontCacheGlyph* g_FontCacheGlyphs = nullptr;
+static const unsigned char* g_FontCachePixels = nullptr;
+
+// 本次启动新光栅化的字形
+static std::vector<FontCacheGlyph> g_FontCacheNewGlyphs;
+static std::vector<unsigned char> g_FontCacheNewPixels;
+
+// 键 -> 字形记录（旧记录指向映射区，新记录指向 g_FontCacheNewGlyphs 下标，用高位区分）
+static std::unordered_map<uint64_t, uint32_t> g_FontCacheIndex;
+static const uint32_t NEW_GLYPH_FLAG = 0x80000000u;
+
+static ImFontLoader g_FontCacheLoader;
+static const ImFontLoader* g_FontCacheBaseLoader = nullptr;
+
+static uint64_t HashBytes(const void* data, size_t size, uint64_t seed)
+{
+    // 8 字节步进的 FNV 变体，10MB 级字体数据约数毫秒
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = seed ^ (size * 0x9E3779B97F4A7C15ull);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t v;
+        memcpy(&v, p + i, 8);
+        h = (h ^ v) * 0x100000001B3ull;
+        h ^= h >> 29;
+    }
+    for (; i < size; i++) {
+        h = (h ^ p[i]) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+static uint64_t HashConfig(const ImFontConfig& cfg)
+{
+    // 只取影响光栅化结果和字形度量的字段
+    struct {
+        float sizePixels, glyphOffsetX, glyphOffsetY, extraAdvanceX;
+        float rasterizerMultiply, rasterizerDensity, extraSizeScale;
+        int oversampleH, oversampleV, pixelSnapH;
+        uint32_t fontNo, loaderFlags;
+    } key;
+    memset(&key, 0, sizeof(key));
+    key.sizePixels = cfg.SizePixels;
+    key.glyphOffsetX = cfg.GlyphOffset.x;
+    key.glyphOffsetY = cfg.GlyphOffset.y;
+    key.extraAdvanceX = cfg.GlyphExtraAdvanceX;
+    key.rasterizerMultiply = cfg.RasterizerMultiply;
+    key.rasterizerDensity = cfg.RasterizerDensity;
+    key.extraSizeScale = cfg.ExtraSizeScale;
+    key.oversampleH = cfg.OversampleH;
+    key.oversampleV = cfg.OversampleV;
+    key.pixelSnapH = cfg.PixelSnapH ? 1 : 0;
+    key.fontNo = cfg.FontNo;
+    key.loaderFlags = cfg.FontLoaderFlags;
+    return HashBytes(&key, sizeof(key), 0xCBF29CE484222325ull);
+}
+
+static uint64_t MakeGlyphKey(uint32_t codepoint, float size, float density, int oversampleH, int oversampleV)
+{
+    // 字号和密度按 1/64 量化，足以区分 DPI 缩放产生的不同 ImFontBaked
+    uint64_t sizeQ = (uint64_t)(size * 64.0f + 0.5f) & 0xFFFF;
+    uint64_t densityQ = (uint64_t)(density * 64.0f + 0.5f) & 0xFFFF;
+    return (uint64_t)(codepoint & 0x1FFFFF)
+        | (sizeQ << 21)
+        | (densityQ << 37)
+        | ((uint64_t)(oversampleH & 0xF) << 53)
+        | ((uint64_t)(oversampleV & 0xF) << 57);
+}
+
+static const FontCacheGlyph* FindCachedGlyph(uint64_t key, const unsigned char** outPixels)
+{
+    auto it = g_FontCacheIndex.find(key);
+    if (it == g_FontCacheIndex.end()) return nullptr;
+
+    if (it->second & NEW_GLYPH_FLAG) {
+        const FontCacheGlyph* g = &g_FontCacheNewGlyphs[it->second & ~NEW_GLYPH_FLAG];
+        *outPixels = g_FontCacheNewPixels.data() + g->pixelOffset;
+        return g;
+    }
+    const FontCacheGlyph* g = &g_FontCacheGlyphs[it->second];
+    *outPixels = g_FontCachePixels + g->pixelOffset;
+    return g;
+}
+
+static void ReleaseMapping(void)
+{
+#ifdef _WIN32
+    if (g_FontCacheView) UnmapViewOfFile(g_FontCacheView);
+    if (g_FontCacheMapping) CloseHandle(g_FontCacheMapping);
+    if (g_FontCacheFile != INVALID_HANDLE_VALUE) CloseHandle(g_FontCacheFile);
+    g_FontCacheMapping = nullptr;
+    g_FontCacheFile = INVALID_HANDLE_VALUE;
+#endif
+    g_FontCacheFallbackBuffer.clear();
+    g_FontCacheFallbackBuffer.shrink_to_fit();
+    g_FontCacheView = nullptr;
+    g_FontCacheViewSize = 0;
+    g_FontCacheGlyphs = nullptr;
+    g_FontCachePixels = nullptr;
+}
+
+static bool MapCacheFile(const std::string& path)
+{
+#ifdef _WIN32
+    g_FontCacheFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (g_FontCacheFile == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(g_FontCacheFile, &size) || size.QuadPart == 0) {
+        ReleaseMapping();
+        return false;
+    }
+    g_FontCacheMapping = CreateFileMappingA(g_FontCacheFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!g_FontCacheMapping) {
+        ReleaseMapping();
+        return false;
+    }
+    g_FontCacheView = (const unsigned char*)MapViewOfFile(g_FontCacheMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!g_FontCacheView) {
+        ReleaseMapping();
+        return false;
+    }
+    g_FontCacheViewSize = (size_t)size.QuadPart;
+    return true;
+#else
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size > 0) {
+        g_FontCacheFallbackBuffer.resize((size_t)size);
+        if (fread(g_FontCacheFallbackBuffer.data(), 1, (size_t)size, f) != (size_t)size)
+            g_FontCacheFallbackBuffer.clear();
+    }
+    fclose(f);
+    if (g_FontCacheFallbackBuffer.empty()) return false;
+    g_FontCacheView = g_FontCacheFallbackBuffer.data();
+    g_FontCacheViewSize = g_FontCacheFallbackBuffer.size();
+    return true;
+#endif
+}
+
+// 校验头部与各记录范围，通过后建立索引
+static bool ValidateAndIndex(uint64_t fontHash, uint64_t configHash)
+{
+    if (g_FontCacheViewSize < sizeof(FontCacheHeader)) return false;
+
+    FontCacheHeader header;
+    memcpy(&header, g_FontCacheView, sizeof(header));
+    if (memcmp(header.magic, FONT_CACHE_MAGIC, 4) != 0 ||
+        header.formatVersion != FONT_CACHE_FORMAT_VERSION ||
+        header.imguiVersion != IMGUI_VERSION_NUM ||
+        header.fontHash != fontHash ||
+        header.configHash != configHash) {
+        return false;
+    }
+
+    uint64_t glyphBytes = (uint64_t)header.glyphCount * sizeof(FontCacheGlyph);
+    if (sizeof(FontCacheHeader) + glyphBytes + header.pixelBytes != g_FontCacheViewSize) return false;
+
+    g_FontCacheGlyphs = (const FontCacheGlyph*)(g_FontCacheView + sizeof(FontCacheHeader));
+    g_FontCachePixels = g_FontCacheView + sizeof(FontCacheHeader) + glyphBytes;
+
+    g_FontCacheIndex.reserve(header.glyphCount * 2);
+    for (uint32_t i = 0; i < header.glyphCount; i++) {
+        const FontCacheGlyph& g = g_FontCacheGlyphs[i];
+        uint64_t pixelSize = g.visible ? (uint64_t)g.width * g.height : 0;
+        if (g.pixelOffset + pixelSize > header.pixelBytes) {
+            g_FontCacheIndex.clear();
+            return false;
+        }
+        g_FontCacheIndex[MakeGlyphKey(g.codepoint, g.size, g.density, g.oversampleH, g.oversampleV)] = i;
+    }
+
+    g_FontCacheHeader = header;
+    return true;
+}
+
+// ========== 加载器回调 ==========
+
+static bool FontCache_FontBakedLoadGlyph(ImFontAtlas* atlas, ImFontConfig* src, ImFontBaked* baked, void* loader_data,
+    ImWchar codepoint, ImFontGlyph* out_glyph, float* out_advance_x)
+{
+    int oversample_h, oversample_v;
+    ImFontAtlasBuildGetOversampleFactors(src, baked, &oversample_h, &oversample_v);
+    const float density = src->RasterizerDensity * baked->RasterizerDensity;
+    const uint64_t key = MakeGlyphKey(codepoint, baked->Size, density, oversample_h, oversample_v);
+
+    const unsigned char* pixels = nullptr;
+    if (const FontCacheGlyph* cached = FindCachedGlyph(key, &pixels)) {
+        if (out_advance_x != nullptr) {
+            *out_advance_x = cached->advanceX;
+            return true;
+        }
+
+        out_glyph->Codepoint = codepoint;
+        out_glyph->AdvanceX = cached->advanceX;
+        if (cached->visible) {
+            ImFontAtlasRectId pack_id = ImFontAtlasPackAddRect(atlas, cached->width, cached->height);
+            if (pack_id == ImFontAtlasRectId_Invalid) return false;
+            ImTextureRect* r = ImFontAtlasPackGetRect(atlas, pack_id);
+
+            // 缓存中的像素已经过 RasterizerMultiply 等后处理，直接转换格式写入
+            ImTextureData* tex = atlas->TexData;
+            ImFontAtlasTextureBlockConvert(pixels, ImTextureFormat_Alpha8, cached->width,
+                (unsigned char*)tex->GetPixelsAt(r->x, r->y), tex->Format, tex->GetPitch(), r->w, r->h);
+            ImFontAtlasTextureBlockQueueUpload(atlas, tex, r->x, r->y, r->w, r->h);
+
+            out_glyph->X0 = cached->x0;
+            out_glyph->Y0 = cached->y0;
+            out_glyph->X1 = cached->x1;
+            out_glyph->Y1 = cached->y1;
+            out_glyph->Visible = true;
+            out_glyph->PackId = pack_id;
+        }
+        g_FontCacheStats.hits++;
+        return true;
+    }
+
+    // 完整加载先交给后台光栅化：尚未完成时本帧显示占位字形
+    FontBakeStatus bake = FontBakeStatus::Unavailable;
+    if (out_glyph != nullptr)
+        bake = FontBakeLoadGlyph(g_FontCacheBaseLoader, atlas, src, baked, codepoint, out_glyph);
+    if (bake == FontBakeStatus::Pending)
+        return false;
+    if (bake == FontBakeStatus::Unavailable &&
+        !g_FontCacheBaseLoader->FontBakedLoadGlyph(atlas, src, baked, loader_data, codepoint, out_glyph, out_advance_x))
+        return false;
+
+    // 只记录完整光栅化的结果；仅取度量的调用之后还会再来一次完整加载
+    if (out_glyph == nullptr) return true;
+
+    FontCacheGlyph record;
+    memset(&record, 0, sizeof(record));
+    record.codepoint = codepoint;
+    record.size = baked->Size;
+    record.density = density;
+    record.oversampleH = (uint8_t)oversample_h;
+    record.oversampleV = (uint8_t)oversample_v;
+    record.advanceX = out_glyph->AdvanceX;
+    record.pixelOffset = (uint32_t)g_FontCacheNewPixels.size();
+
+    if (out_glyph->Visible) {
+        ImTextureRect* r = ImFontAtlasPackGetRect(atlas, out_glyph->PackId);
+        ImTextureData* tex = atlas->TexData;
+        record.visible = 1;
+        record.width = r->w;
+        record.height = r->h;
+        record.x0 = out_glyph->X0;
+        record.y0 = out_glyph->Y0;
+        record.x1 = out_glyph->X1;
+        record.y1 = out_glyph->Y1;
+
+        // 从图集回读（含后处理），统一存为 Alpha8
+        size_t base = g_FontCacheNewPixels.size();
+        g_FontCacheNewPixels.resize(base + (size_t)r->w * r->h);
+        unsigned char* dst = g_FontCacheNewPixels.data() + base;
+        for (int y = 0; y < r->h; y++) {
+            const unsigned char* row = (const unsigned char*)tex->GetPixelsAt(r->x, r->y + y);
+            if (tex->Format == ImTextureFormat_Alpha8) {
+                memcpy(dst + (size_t)y * r->w, row, r->w);
+            } else {
+                for (int x = 0; x < r->w; x++)
+                    dst[(size_t)y * r->w + x] = row[x * 4 + 3];
+            }
+        }
+    }
+
+    g_FontCacheIndex[key] = NEW_GLYPH_FLAG | (uint32_t)g_FontCacheNewGlyphs.size();
+    g_FontCacheNewGlyphs.push_back(record);
+    g_FontCacheStats.misses++;
+    return true;
+}
+
+// ========== 对外接口 ==========
+
+const ImFontLoader* FontCacheOpen(const std::string& path, const void* fontData, int fontDataSize, const ImFontConfig& cfg)
+{
+    auto begin = std::chrono::steady_clock::now();
+
+    ReleaseMapping();
+    g_FontCacheIndex.clear();
+    g_FontCacheNewGlyphs.clear();
+    g_FontCacheNewPixels.clear();
+    g_FontCacheStats = FontCacheStats();
+    g_FontCachePath = path;
+
+    memset(&g_FontCacheHeader, 0, sizeof(g_FontCacheHeader));
+    memcpy(g_FontCacheHeader.magic, FONT_CACHE_MAGIC, 4);
+    g_FontCacheHeader.formatVersion = FONT_CACHE_FORMAT_VERSION;
+    g_FontCacheHeader.imguiVersion = IMGUI_VERSION_NUM;
+    g_FontCacheHeader.fontHash = HashBytes(fontData, (size_t)fontDataSize, 0xCBF29CE484222325ull);
+    g_FontCacheHeader.configHash = HashConfig(cfg);
+
+    if (!MapCacheFile(path)) {
+        g_FontCacheStats.state = FontCacheState::Missing;
+    } else if (!ValidateAndIndex(g_FontCacheHeader.fontHash, g_FontCacheHeader.configHash)) {
+        // 不匹配的旧文件直接丢弃，退出时整体重写
+        ReleaseMapping();
+        g_FontCacheHeader.glyphCount = 0;
+        g_FontCacheHeader.pixelBytes = 0;
+        g_FontCacheStats.state = FontCacheState::Invalidated;
+    } else {
+        g_FontCacheStats.state = FontCacheState::Loaded;
+        g_FontCacheStats.cachedGlyphs = g_FontCacheHeader.glyphCount;
+        g_FontCacheStats.fileBytes = g_FontCacheViewSize;
+    }
+
+    g_FontCacheBaseLoader = ImFontAtlasGetFontLoaderForStbTruetype();
+    g_FontCacheLoader = *g_FontCacheBaseLoader;
+    g_FontCacheLoader.Name = "stb_truetype (cached)";
+    g_FontCacheLoader.FontBakedLoadGlyph = FontCache_FontBakedLoadGlyph;
+
+    g_FontCacheStats.openMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - begin).count();
+    return &g_FontCacheLoader;
+}
+
+void FontCacheSave(void)
+{
+    if (g_FontCachePath.empty() || g_FontCacheNewGlyphs.empty()) {
+        ReleaseMapping();
+        return;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+
+    // 旧记录 + 新记录，新记录的像素偏移整体后移
+    uint32_t oldCount = g_FontCacheGlyphs ? g_FontCacheHeader.glyphCount : 0;
+    uint64_t oldPixelBytes = g_FontCacheGlyphs ? g_FontCacheHeader.pixelBytes : 0;
+
+    FontCacheHeader header = g_FontCacheHeader;
+    header.glyphCount = oldCount + (uint32_t)g_FontCacheNewGlyphs.size();
+    header.pixelBytes = oldPixelBytes + g_FontCacheNewPixels.size();
+
+    std::vector<FontCacheGlyph> newGlyphs = g_FontCacheNewGlyphs;
+    for (auto& g : newGlyphs) g.pixelOffset += (uint32_t)oldPixelBytes;
+
+    std::string tempPath = g_FontCachePath + ".tmp";
+    FILE* f = fopen(tempPath.c_str(), "wb");
+    if (!f) {
+        ReleaseMapping();
+        return;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    if (ok && oldCount > 0) ok = fwrite(g_FontCacheGlyphs, sizeof(FontCacheGlyph), oldCount, f) == oldCount;
+    if (ok) ok = fwrite(newGlyphs.data(), sizeof(FontCacheGlyph), newGlyphs.size(), f) == newGlyphs.size();
+    if (ok && oldPixelBytes > 0) ok = fwrite(g_FontCachePixels, 1, (size_t)oldPixelBytes, f) == oldPixelBytes;
+    if (ok && !g_FontCacheNewPixels.empty())
+        ok = fwrite(g_FontCacheNewPixels.data(), 1, g_FontCacheNewPixels.size(), f) == g_FontCacheNewPixels.size();
+    ok = (fclose(f) == 0) && ok;
+
+    // 替换前必须先解除映射，否则 Windows 上无法覆盖
+    ReleaseMapping();
+    if (!ok) {
+        remove(tempPath.c_str());
+        return;
+    }
+#ifdef _WIN32
+    ok = MoveFileExA(tempPath.c_str(), g_FontCachePath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    ok = rename(tempPath.c_str(), g_FontCachePath.c_str()) == 0;
+#endif
+    if (!ok) remove(tempPath.c_str());
+
+    g_FontCacheNewGlyphs.clear();
+    g_FontCacheNewPixels.clear();
+    g_FontCacheIndex.clear();
+    g_FontCacheStats.lastSaveMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - begin).count();
+}
+
+const FontCacheStats& FontCacheGetStats(void)
+{
+    return g_FontCacheStats;
+}
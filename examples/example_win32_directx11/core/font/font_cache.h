@@ -0,0 +1,37 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <string>
+
+struct ImFontConfig;
+struct ImFontLoader;
+
+// ========== 字形磁盘缓存 ==========
+// 包装 stb_truetype 加载器：命中缓存的字形直接把位图拷进图集，跳过光栅化；
+// 未命中的字形照常光栅化并记录下来，退出时追加写回缓存文件。
+// 缓存按字体数据哈希、字体配置哈希和 ImGui 版本校验，任一变化都会整体作废。
+
+enum class FontCacheState {
+    Disabled,       // 未打开
+    Missing,        // 文件不存在，本次启动将重新生成
+    Invalidated,    // 字体/配置/版本不匹配或文件损坏，已忽略
+    Loaded          // 已映射并建立索引
+};
+
+struct FontCacheStats {
+    FontCacheState state = FontCacheState::Disabled;
+    uint32_t cachedGlyphs = 0;      // 文件中的字形数
+    uint64_t fileBytes = 0;
+    uint32_t hits = 0;              // 本次启动从缓存恢复的字形
+    uint32_t misses = 0;            // 本次启动新光栅化的字形
+    double openMs = 0.0;            // 哈希 + 映射 + 建索引耗时
+    double lastSaveMs = 0.0;
+};
+
+// 打开缓存文件并返回包装后的加载器，赋给 ImFontConfig::FontLoader
+const ImFontLoader* FontCacheOpen(const std::string& path, const void* fontData, int fontDataSize, const ImFontConfig& cfg);
+
+// 有新增字形时写回缓存（临时文件 + 替换），并释放映射
+void FontCacheSave(void);
+
+const FontCacheStats& FontCacheGetStats(void);
@@ -1,19 +1,226 @@
 ﻿#include "imgui.h"
+#include "imgui_internal.h"
+#include "font_load.h"
+#include "font_cache.h"
+#include "font_bake.h"
 #include "../../fonts/font_wqdkwm.h"
+#include <chrono>
+#include <string>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <unistd.h>
+#include <limits.h>
+#endif
+
+static FontLoadStats g_FontLoadStats;
+
+// 界面字符串中用到的非 ASCII 字符，启动后分帧预先烘焙，避免首次打开弹窗时卡顿。
+// 由 core/font/gen_prewarm_text.py 从 core/ 与 hardware/ 下的字符串字面量提取生成，不要手工编辑；
+// 新增界面文字后重新运行脚本。遗漏的字符仍会在首次绘制时按需烘焙。
+static const char* const g_PrewarmText =
+    "→●、。一万上下不与且两个中串临为主乘事二于交仅仍从代令以件任会传位低体何作使例"
+    "保倍值偏停储元先光入全公六共关其内写几出函分列删利别到制前剖加务动助勾包化区十单"
+    "占即压原发取变口只可台号合同名后吐吞含启周命和哈响器回围图在地址均块型域堆壳处备"
+    "复外多大失头如始字存它完定实容宽寄对导射将小少局展属峰工已希帧帮常平并序应度延建"
+    "开式引当录形径待必志快态性总恢情成或戳所打执扫批折拟择持挂指按换据排探接控掩描提"
+    "操支收改放效数整文断新无日时明映是显暂曲更替最有望期未本机条构析果染查栅标校样根"
+    "格检模横次止正步段每比求池没法波流测浏浮消混添清温渲源滚点烘热焙照版特状独率现理"
+    "生用电界留百的目直短码硬确示秒称移程空窗端符第等签简算类系索累约纹线组结绘续缓编"
+    "缺置耗能自至致舍色节英范行表要覆见览解触言计认记设访诊译询该详语误说请读象败起超"
+    "足路跳转轮载较输过运进连迭述退选逐速避部都配采释重量针钮销错长闭问间际除隔集零需"
+    "非面顶项须预首驻验高黄默（），：；";
+
+static const char* g_PrewarmCursor = nullptr;
+
+// 字形缓存与配置文件一样放在程序目录下
+static std::string GetFontCachePath(void)
+{
+#ifdef _WIN32
+    char path[MAX_PATH];
+    GetModuleFileNameA(NULL, path, MAX_PATH);
+    std::string fullPath(path);
+    size_t pos = fullPath.find_last_of("\\/");
+#else
+    char path[PATH_MAX];
+    ssize_t count = readlink("/proc/self/exe", path, PATH_MAX);
+    std::string fullPath(path, (count > 0) ? count : 0);
+    size_t pos = fullPath.find_last_of('/');
+#endif
+    std::string dir = (pos != std::string::npos) ? fullPath.substr(0, pos + 1) : "";
+    return dir + "i2c_font_cache.bin";
+}
 
 void LoadFont(void)
 {
+    auto begin = std::chrono::steady_clock::now();
     ImGuiIO& io = ImGui::GetIO();
 
     ImFontConfig font_cfg;
 
     font_cfg.FontDataOwnedByAtlas = false;
 
-    ImFont* fontdata = io.Fonts->AddFontFromMemoryTTF(
+    // 后端支持动态纹理时（DX11 后端已支持），字形在首次使用时才光栅化，
+    // 不再限定字符范围，字体内的符号（如 → ●）也能正常显示。
+    // 旧式后端只能在启动时一次性烘焙，仍需指定完整中文范围。
+    g_FontLoadStats.dynamicGlyphs = (io.BackendFlags & ImGuiBackendFlags_RendererHasTextures) != 0;
+    const ImWchar* glyph_ranges = g_FontLoadStats.dynamicGlyphs ? nullptr : io.Fonts->GetGlyphRangesChineseFull();
+
+    // 已光栅化过的字形从磁盘缓存恢复，不再经过 stb_truetype
+    font_cfg.SizePixels = 16.0f;
+    font_cfg.FontLoader = FontCacheOpen(GetFontCachePath(), font_data_data, (int)font_data_size, font_cfg);
+
+    io.Fonts->AddFontFromMemoryTTF(
         (void*)font_data_data,
         font_data_size,
         16.0f,
         &font_cfg,
-        io.Fonts->GetGlyphRangesChineseFull()
+        glyph_ranges
     );
+
+    g_FontLoadStats.prewarmTotal = 0;
+    for (const char* p = g_PrewarmText; *p; ) {
+        unsigned int c;
+        p += ImTextCharFromUtf8(&c, p, nullptr);
+        g_FontLoadStats.prewarmTotal++;
+    }
+    g_FontLoadStats.prewarmDone = 0;
+    g_PrewarmCursor = g_FontLoadStats.dynamicGlyphs ? g_PrewarmText : nullptr;
+
+    g_FontLoadStats.loadFontMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - begin).count();
+}
+
+bool PrewarmFontGlyphs(int maxGlyphs)
+{
+    if (g_PrewarmCursor == nullptr || *g_PrewarmCursor == 0) {
+        g_PrewarmCursor = nullptr;
+        return true;
+    }
+
+    // 按当前字体大小（含 DPI 缩放）烘焙，与界面实际绘制使用同一份 ImFontBaked。
+    // 预热本身已按帧分摊，不交给后台线程：返回时字形已在图集中，prewarmDone 才名副其实
+    ImFontBaked* baked = ImGui::GetFontBaked();
+    FontBakeBeginSynchronous();
+    for (int i = 0; i < maxGlyphs && *g_PrewarmCursor; i++) {
+        unsigned int c;
+        g_PrewarmCursor += ImTextCharFromUtf8(&c, g_PrewarmCursor, nullptr);
+        baked->FindGlyph((ImWchar)c);
+        g_FontLoadStats.prewarmDone++;
+    }
+    FontBakeEndSynchronous();
+    return *g_PrewarmCursor == 0;
+}
+
+void SetFirstFrameTime(double ms)
+{
+    g_FontLoadStats.firstFrameMs = ms;
+}
+
+const FontLoadStats& GetFontLoadStats(void)
+{
+    return g_FontLoadStats;
+}
+
+// ========== 文本微基准 ==========
+
+// 每轮复用同一个绘制列表，只回退写指针，避免把分配耗时算进去
+static void ResetBenchmarkDrawList(ImDrawList* drawList)
+{
+    drawList->VtxBuffer.resize(0);
+    drawList->IdxBuffer.resize(0);
+    drawList->_VtxWritePtr = drawList->VtxBuffer.Data;
+    drawList->_IdxWritePtr = drawList->IdxBuffer.Data;
+    drawList->_VtxCurrentIdx = 0;
+    drawList->CmdBuffer.back().ElemCount = 0;
+}
+
+static double MeasureRenderText(ImDrawList* drawList, ImFont* font, float size, const std::string* lines, int lineCount, int iterations, std::string* output)
+{
+    const ImVec4 clip(0.0f, 0.0f, 100000.0f, 100000.0f);
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        ResetBenchmarkDrawList(drawList);
+        for (int n = 0; n < lineCount; n++) {
+            font->RenderText(drawList, size, ImVec2(0.0f, size * n), IM_COL32_WHITE, clip,
+                lines[n].c_str(), lines[n].c_str() + lines[n].size(), 0.0f, ImDrawTextFlags_None);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    if (output != nullptr) {
+        output->assign(reinterpret_cast<const char*>(drawList->VtxBuffer.Data), drawList->VtxBuffer.size_in_bytes());
+        output->append(reinterpret_cast<const char*>(drawList->IdxBuffer.Data), drawList->IdxBuffer.size_in_bytes());
+    }
+    return seconds;
+}
+
+static double MeasureCalcTextSize(ImFont* font, float size, const std::string* lines, int lineCount, int iterations, float* width)
+{
+    float total = 0.0f;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (int n = 0; n < lineCount; n++)
+            total += font->CalcTextSizeA(size, FLT_MAX, 0.0f, lines[n].c_str(), lines[n].c_str() + lines[n].size()).x;
+    }
+    *width = total;
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+TextRenderBenchmarkResult RunTextRenderBenchmark(int iterations)
+{
+    TextRenderBenchmarkResult result;
+    ImFont* font = ImGui::GetFont();
+    const float size = ImGui::GetFontSize();
+
+    // 寄存器表常见内容：十六进制转储行，以及带中文说明的数值行
+    std::string lines[2];
+    char buf[8];
+    lines[0] = "0x50:";
+    for (int i = 0; i < 64; i++) {
+        snprintf(buf, sizeof(buf), " %02X", (i * 37 + 11) & 0xFF);
+        lines[0] += buf;
+    }
+    lines[1] = "输出电压 12.003 V, 电流 0.352 A, 温度 41.5 C, 状态 0x0080 (正常)";
+    const int mixedGlyphs = ImTextCountCharsFromUtf8(lines[1].c_str(), nullptr);
+    result.glyphsPerPass = ImTextCountCharsFromUtf8(lines[0].c_str(), nullptr) + mixedGlyphs;
+
+    ImDrawList drawList(ImGui::GetDrawListSharedData());
+    drawList._ResetForNewFrame();
+    drawList.PushClipRectFullScreen();
+    drawList.PushTexture(font->OwnerAtlas->TexRef);
+
+    // 先各跑一轮预热（加载字形、建立 ASCII 表），再交替测量
+    const ImFontFlags savedFlags = font->Flags;
+    std::string fastOutput, scalarOutput;
+    float fastWidth = 0.0f, scalarWidth = 0.0f;
+    MeasureRenderText(&drawList, font, size, lines, 2, 1, nullptr);
+
+    double calcFast = 0.0, calcScalar = 0.0, renderFast = 0.0, renderScalar = 0.0, mixedFast = 0.0, mixedScalar = 0.0;
+    for (int pass = 0; pass < 2; pass++) {
+        const bool scalar = (pass == 1);
+        if (scalar)
+            font->Flags |= ImFontFlags_NoAsciiFastPath;
+        else
+            font->Flags &= ~ImFontFlags_NoAsciiFastPath;
+
+        double& calc = scalar ? calcScalar : calcFast;
+        double& render = scalar ? renderScalar : renderFast;
+        double& mixed = scalar ? mixedScalar : mixedFast;
+        calc = MeasureCalcTextSize(font, size, lines, 2, iterations, scalar ? &scalarWidth : &fastWidth);
+        render = MeasureRenderText(&drawList, font, size, lines, 2, iterations, scalar ? &scalarOutput : &fastOutput);
+        mixed = MeasureRenderText(&drawList, font, size, &lines[1], 1, iterations, nullptr);
+    }
+    font->Flags = savedFlags;
+
+    const double glyphs = static_cast<double>(result.glyphsPerPass) * iterations / 1e6;
+    const double mixedTotal = static_cast<double>(mixedGlyphs) * iterations / 1e6;
+    result.calcFast = calcFast > 0.0 ? glyphs / calcFast : 0.0;
+    result.calcScalar = calcScalar > 0.0 ? glyphs / calcScalar : 0.0;
+    result.renderFast = renderFast > 0.0 ? glyphs / renderFast : 0.0;
+    result.renderScalar = renderScalar > 0.0 ? glyphs / renderScalar : 0.0;
+    result.mixedRenderFast = mixedFast > 0.0 ? mixedTotal / mixedFast : 0.0;
+    result.mixedRenderScalar = mixedScalar > 0.0 ? mixedTotal / mixedScalar : 0.0;
+    result.identical = (fastOutput == scalarOutput) && (fastWidth == scalarWidth);
+    return result;
 }
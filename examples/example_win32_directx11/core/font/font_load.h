@@ -0,0 +1,34 @@
+﻿#pragma once
+
+// 字体加载统计，用于在性能诊断窗口中查看启动耗时与图集占用
+struct FontLoadStats {
+    double loadFontMs = 0.0;        // LoadFont() 耗时
+    double firstFrameMs = 0.0;      // 进程启动到首帧 Present 完成
+    bool dynamicGlyphs = false;     // 后端支持 RendererHasTextures，字形按需烘焙
+    int prewarmTotal = 0;           // 预热字符总数
+    int prewarmDone = 0;            // 已预热字符数
+};
+
+// 加载内嵌中文字体（需在渲染后端初始化之后调用）
+void LoadFont(void);
+
+// 在 NewFrame() 之后调用，每帧最多烘焙 maxGlyphs 个预热字形；全部完成后返回 true
+bool PrewarmFontGlyphs(int maxGlyphs);
+
+void SetFirstFrameTime(double ms);
+const FontLoadStats& GetFontLoadStats(void);
+
+// 文本微基准：ImFont 的 ASCII 快速路径开启/关闭时 CalcTextSize 与 RenderText 的字形吞吐（百万字形/秒）
+struct TextRenderBenchmarkResult {
+    int glyphsPerPass = 0;          // 每轮测量的字形数（十六进制行 + 中英混排行）
+    double calcFast = 0.0;          // 快速路径
+    double calcScalar = 0.0;        // 逐字符解码 + 查表
+    double renderFast = 0.0;
+    double renderScalar = 0.0;
+    double mixedRenderFast = 0.0;   // 中英混排行单独测量，确认 CJK 回退路径不变慢
+    double mixedRenderScalar = 0.0;
+    bool identical = false;         // 两条路径生成的顶点/索引完全一致
+};
+
+// 使用当前字体和字号测量，需在 NewFrame() 之后调用
+TextRenderBenchmarkResult RunTextRenderBenchmark(int iterations);
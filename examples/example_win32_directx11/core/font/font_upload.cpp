@@ -0,0 +1,71 @@
+﻿#include "font_upload.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <algorithm>
+
+static FontUploadStats g_FontUploadStats;
+static ImGuiContext* g_FontUploadContext = nullptr;
+static ImGuiID g_FontUploadHookId = 0;
+
+// Render 结束：此时本帧的上传请求已全部排好，后端还没处理
+static void FontUploadOnRenderPost(ImGuiContext* ctx, ImGuiContextHook*)
+{
+    FontUploadStats& stats = g_FontUploadStats;
+    int requests = 0;
+    int uploads = 0;
+    uint64_t bytes = 0;
+
+    for (ImTextureData* tex : ctx->IO.Fonts->TexList) {
+        if (tex->Status == ImTextureStatus_WantCreate) {
+            requests++;
+            uploads++;
+            bytes += (uint64_t)tex->GetSizeInBytes();
+        } else if (tex->Status == ImTextureStatus_WantUpdates) {
+            requests += tex->Updates.Size;
+            if (stats.coalesce)
+                ImTextureDataCoalesceUpdates(tex, stats.maxOverhead, stats.uploadCostPixels);
+            uploads += tex->Updates.Size;
+            for (const ImTextureRect& r : tex->Updates)
+                bytes += (uint64_t)r.w * r.h * tex->BytesPerPixel;
+        }
+    }
+
+    stats.lastRequests = requests;
+    stats.lastUploads = uploads;
+    stats.lastBytes = bytes;
+    stats.peakBytes = std::max(stats.peakBytes, bytes);
+    stats.totalBytes += bytes;
+    stats.totalRequests += (uint32_t)requests;
+    stats.totalUploads += (uint32_t)uploads;
+    stats.history[stats.historyOffset] = (float)(bytes / 1024.0);
+    stats.historyOffset = (stats.historyOffset + 1) % FontUploadStats::HISTORY_SIZE;
+}
+
+void FontUploadInstall(void)
+{
+    if (g_FontUploadContext != nullptr) return;
+
+    g_FontUploadContext = ImGui::GetCurrentContext();
+    ImGuiContextHook hook;
+    hook.Type = ImGuiContextHookType_RenderPost;
+    hook.Callback = FontUploadOnRenderPost;
+    g_FontUploadHookId = ImGui::AddContextHook(g_FontUploadContext, &hook);
+}
+
+void FontUploadShutdown(void)
+{
+    if (g_FontUploadContext == nullptr) return;
+
+    ImGui::RemoveContextHook(g_FontUploadContext, g_FontUploadHookId);
+    g_FontUploadContext = nullptr;
+}
+
+void FontUploadSetCoalesce(bool enabled)
+{
+    g_FontUploadStats.coalesce = enabled;
+}
+
+const FontUploadStats& FontUploadGetStats(void)
+{
+    return g_FontUploadStats;
+}
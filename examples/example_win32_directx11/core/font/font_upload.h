@@ -0,0 +1,33 @@
+﻿#pragma once
+
+#include <cstdint>
+
+// ========== 图集纹理上传 ==========
+// 每个新字形在图集里排一条上传请求，DX11 后端逐条 UpdateSubresource。首次显示大段中文说明时一帧可能有上百条。
+// Render 结束时（后端上传之前）按面积开销合并相邻的请求，并统计每帧实际上传的字节数。
+
+struct FontUploadStats {
+    static constexpr int HISTORY_SIZE = 120;
+
+    bool coalesce = true;
+    float maxOverhead = 0.25f;      // 合并后多传的像素不超过实际需要的 25%，
+    int uploadCostPixels = 32 * 32; // 再加上这么多像素：为省一次 UpdateSubresource 值得多拷贝的量
+    int lastRequests = 0;           // 上一帧排队的上传请求
+    int lastUploads = 0;            // 合并后交给后端的次数
+    uint64_t lastBytes = 0;         // 上一帧上传字节数（含合并多传的部分，纹理重建按整张计）
+    uint64_t peakBytes = 0;
+    uint64_t totalBytes = 0;
+    uint32_t totalRequests = 0;
+    uint32_t totalUploads = 0;
+    float history[HISTORY_SIZE] = {};   // 每帧上传 KB，环形缓冲区，historyOffset 为最旧一项
+    int historyOffset = 0;
+};
+
+// 在 LoadFont() 之后调用，注册 RenderPost 钩子
+void FontUploadInstall(void);
+
+// 在 ImGui::DestroyContext() 之前调用
+void FontUploadShutdown(void);
+
+void FontUploadSetCoalesce(bool enabled);
+const FontUploadStats& FontUploadGetStats(void);
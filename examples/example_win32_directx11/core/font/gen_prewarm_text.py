@@ -0,0 +1,92 @@
+# -*- coding: utf-8 -*-
+# 重新生成 font_load.cpp 中的 g_PrewarmText：提取 core/ 与 hardware/ 下所有字符串字面量里的非 ASCII 字符。
+# 第三方代码（nlohmann、ExprTK）与注释不参与统计。新增或修改界面文字后在任意目录运行：
+#     python core/font/gen_prewarm_text.py
+import io
+import os
+import re
+
+APP_DIR = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", ".."))
+SCAN_DIRS = ["core", "hardware"]
+SKIP_DIRS = {"nlohmann", "ExprTK"}
+TARGET = os.path.join(APP_DIR, "core", "font", "font_load.cpp")
+BEGIN_MARK = "static const char* const g_PrewarmText ="
+CHARS_PER_LINE = 40
+
+
+def string_literals(text):
+    """按顺序返回源码中的字符串字面量内容，跳过注释与字符字面量。"""
+    i, n = 0, len(text)
+    while i < n:
+        c = text[i]
+        if text.startswith("//", i):
+            i = text.find("\n", i)
+            if i < 0:
+                return
+        elif text.startswith("/*", i):
+            i = text.find("*/", i + 2)
+            if i < 0:
+                return
+            i += 2
+        elif c == 'R' and text.startswith('R"', i):
+            m = re.compile(r'R"([^(\s]*)\(').match(text, i)
+            end = text.find(")" + m.group(1) + '"', m.end())
+            yield text[m.end():end]
+            i = end + len(m.group(1)) + 2
+        elif c == '"' or c == "'":
+            j = i + 1
+            while j < n and text[j] != c:
+                j += 2 if text[j] == "\\" else 1
+            if c == '"':
+                yield text[i + 1:j]
+            i = j + 1
+        else:
+            i += 1
+
+
+def read_source(path):
+    # 个别旧文件（hardware/simulator）仍是 GBK 编码
+    with io.open(path, "rb") as f:
+        data = f.read()
+    try:
+        return data.decode("utf-8-sig")
+    except UnicodeDecodeError:
+        return data.decode("gbk")
+
+
+def collect_chars():
+    chars = set()
+    for scan_dir in SCAN_DIRS:
+        for root, dirs, files in os.walk(os.path.join(APP_DIR, scan_dir)):
+            dirs[:] = [d for d in dirs if d not in SKIP_DIRS]
+            for name in files:
+                if not name.endswith((".cpp", ".h")):
+                    continue
+                path = os.path.join(root, name)
+                text = read_source(path)
+                if os.path.normcase(path) == os.path.normcase(TARGET):
+                    start = text.index(BEGIN_MARK)
+                    text = text[:start] + text[text.index(";", start) + 1:]
+                for literal in string_literals(text):
+                    chars.update(ch for ch in literal if ord(ch) > 0x7F)
+    return sorted(chars)
+
+
+def main():
+    chars = collect_chars()
+    lines = ["".join(chars[i:i + CHARS_PER_LINE]) for i in range(0, len(chars), CHARS_PER_LINE)]
+    block = BEGIN_MARK + "\n" + "\n".join('    "%s"' % line for line in lines) + ";"
+
+    with io.open(TARGET, encoding="utf-8-sig", newline="") as f:
+        text = f.read()
+    start = text.index(BEGIN_MARK)
+    end = text.index(";", start) + 1
+    if "\r\n" in text:
+        block = block.replace("\n", "\r\n")
+    with io.open(TARGET, "w", encoding="utf-8-sig", newline="") as f:
+        f.write(text[:start] + block + text[end:])
+    print("%d characters" % len(chars))
+
+
+if __name__ == "__main__":
+    main()
@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <atomic>
+#include "interned_string.h"
 
 namespace I2CDebugger {
 
@@ -10,17 +12,34 @@ namespace I2CDebugger {
     constexpr uint32_t BAUD_RATE_100K = 100000;
     constexpr uint32_t BAUD_RATE_400K = 400000;
 
+    // ========== 条目句柄 ==========
+    // 每个命令条目在创建时分配一个全局唯一的64位句柄，
+    // 排序/删除/切换命令组都不会改变它，硬件结果按句柄回传到所属条目
+    using EntryHandle = uint64_t;
+    constexpr EntryHandle INVALID_ENTRY_HANDLE = 0;
+
+    inline EntryHandle NewEntryHandle() {
+        static std::atomic<uint64_t> s_nextHandle{ 1 };
+        return s_nextHandle.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 命令组ID（与句柄同理，组在列表中的位置可能变化）
+    inline uint32_t NewGroupId() {
+        static std::atomic<uint32_t> s_nextGroupId{ 1 };
+        return s_nextGroupId.fetch_add(1, std::memory_order_relaxed);
+    }
+
     // ========== 解析配置结构 ==========
     struct ParseConfig {
         bool enabled = false;
-        std::string readFormula;      // 读取公式
-        std::string writeFormula;     // 写入公式
-        std::string alias;            // 别名（用于log表头）
+        InternedString readFormula;   // 读取公式
+        InternedString writeFormula;  // 写入公式
+        InternedString alias;         // 别名（用于log表头）
 
         // 运行时数据（不保存到JSON）
         double parsedValue = 0.0;
         bool parseSuccess = false;
-        std::string lastError;
+        InternedString lastError;
     };
 
     // ========== 错误类型枚举 ==========
@@ -28,6 +47,8 @@ namespace I2CDebugger {
         None = 0,
         SlaveNotResponse,    // 从机无响应
         DeviceDisconnected,  // 设备断开
+        SlaveSuspended,      // 从机连续无响应已被挂起，本次未访问总线（数据已过期）
+        VerifyMismatch,      // 写后回读与写入值不一致
         UnknownError
     };
 
@@ -48,11 +69,27 @@ namespace I2CDebugger {
     struct ResponsePacket {
         uint32_t controlId = 0;
         uint32_t commandId = 0;
+        EntryHandle entryHandle = INVALID_ENTRY_HANDLE;  // 所属条目（0 表示简单窗口等无条目操作）
+        uint32_t batchId = 0;                            // 所属批次（0 表示单次插入操作）
         std::vector<uint8_t> rawData;
         uint64_t timestamp = 0;
         bool success = false;
         ErrorType errorType = ErrorType::None;
-        std::string errorMsg;
+        InternedString errorDetail;     // 底层返回的错误描述（errorType 为错误码）
+        std::vector<uint8_t> writtenData;   // VerifyMismatch 时的实际写入值（rawData 为回读值），字节不进驻留池
+    };
+
+    // ========== 批次完成事件 ==========
+    // 读取全部/执行全部/每一轮周期执行结束时发送一次，替代按 commandId 猜测结束
+    struct BatchCompletion {
+        uint32_t controlId = 0;
+        uint32_t batchId = 0;
+        uint32_t groupId = 0;       // 周期批次所属命令组
+        uint32_t executedCount = 0;
+        uint32_t failedCount = 0;
+        uint32_t skippedCount = 0;  // 从机挂起而跳过的条目（周期批次）
+        bool aborted = false;       // 因停止或设备断开提前结束
+        uint64_t timestamp = 0;
     };
 
     // 注意：RegisterEntry, SingleTriggerEntry, PeriodicTriggerEntry, CommandGroup
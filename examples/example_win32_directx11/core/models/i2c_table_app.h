@@ -7,19 +7,26 @@
 
 namespace I2CDebugger {
 
+    // 触发条目的默认按钮名，所有条目共用同一个驻留编号
+    inline InternedString DefaultButtonName() {
+        static const InternedString s_name("执行");
+        return s_name;
+    }
+
     // ========== 寄存器表条目 ==========
     struct RegisterEntry {
+        EntryHandle handle = NewEntryHandle();
         uint8_t regAddress = 0x00;
         uint8_t length = 1;
         std::vector<uint8_t> data;
-        std::string description;
+        InternedString description;
 
         bool overrideSlaveAddr = false;
         uint8_t slaveAddress = 0x50;
 
         bool lastSuccess = true;
         ErrorType lastErrorType = ErrorType::None;
-        std::string lastError;
+        InternedString lastErrorDetail;
 
         // 解析配置
         ParseConfig parseConfig;
@@ -27,20 +34,28 @@ namespace I2CDebugger {
 
     // ========== 单次触发条目 ==========
     struct SingleTriggerEntry {
+        EntryHandle handle = NewEntryHandle();
         bool enabled = true;
         uint8_t regAddress = 0x00;
         uint8_t length = 1;
         std::vector<uint8_t> data;
         uint32_t delayMs = 0;
         CommandType type = CommandType::Read;
-        std::string buttonName = "执行";
+        InternedString buttonName = DefaultButtonName();
 
         bool overrideSlaveAddr = false;
         uint8_t slaveAddress = 0x50;
 
+        // 写入方式（仅写入命令）：writeMask 非 0 时按位掩码读-改-写，第 i 字节对应 data[i]
+        // （超出 4 字节的部分整字节写入）；verifyWrite 时写后立即回读校验
+        uint32_t writeMask = 0;
+        bool verifyWrite = false;
+
         bool lastSuccess = true;
         ErrorType lastErrorType = ErrorType::None;
-        std::string lastError;
+        InternedString lastErrorDetail;
+        std::vector<uint8_t> verifyWritten;     // 最近一次回读校验失败的写入值与回读值（悬停提示用）
+        std::vector<uint8_t> verifyReadback;
 
         // 解析配置
         ParseConfig parseConfig;
@@ -48,22 +63,29 @@ namespace I2CDebugger {
 
     // ========== 周期触发条目 ==========
     struct PeriodicTriggerEntry {
+        EntryHandle handle = NewEntryHandle();
         bool enabled = true;
         uint8_t regAddress = 0x00;
         uint8_t length = 1;
         std::vector<uint8_t> data;
         uint32_t delayMs = 0;
         CommandType type = CommandType::Read;
-        std::string buttonName = "执行";
+        InternedString buttonName = DefaultButtonName();
 
         // 从机地址覆写
         bool overrideSlaveAddr = false;
         uint8_t slaveAddress = 0x50;
 
+        // 写入方式（同单次触发条目）
+        uint32_t writeMask = 0;
+        bool verifyWrite = false;
+
         // 执行状态
         bool lastSuccess = true;
         ErrorType lastErrorType = ErrorType::None;
-        std::string lastError;
+        InternedString lastErrorDetail;
+        std::vector<uint8_t> verifyWritten;     // 同单次触发条目
+        std::vector<uint8_t> verifyReadback;
         uint32_t errorCount = 0;
 
         // 解析配置
@@ -85,6 +107,7 @@ namespace I2CDebugger {
 
     // ========== 命令组 ==========
     struct CommandGroup {
+        uint32_t id = NewGroupId();
         std::string name = "New Group";
         uint8_t slaveAddress = 0x50;
         uint32_t interval = 100;
@@ -96,6 +119,9 @@ namespace I2CDebugger {
 
         // 数据日志配置
         DataLogConfig logConfig;
+
+        // 运行时状态（不保存）
+        bool periodicRunning = false;
     };
 
     // ========== Tab类型枚举 ==========
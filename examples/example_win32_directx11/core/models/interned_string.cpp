@@ -0,0 +1,108 @@
+﻿// core/models/interned_string.cpp - 字符串驻留池
+#include "interned_string.h"
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace I2CDebugger {
+
+    namespace {
+
+        // 编号 → 字符串指针按块分配，块一旦分配不再移动，读取方无需加锁
+        constexpr uint32_t CHUNK_BITS = 12;
+        constexpr uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+        constexpr uint32_t MAX_CHUNKS = 4096;
+
+        // 查表键只引用字符，不拥有内存：查找时指向调用方的文本，插入后指向池中的副本
+        struct KeyView {
+            const char* data;
+            size_t size;
+        };
+
+        struct KeyHash {
+            size_t operator()(const KeyView& key) const {
+                uint64_t h = 14695981039346656037ull;   // FNV-1a
+                for (size_t i = 0; i < key.size; ++i) {
+                    h = (h ^ static_cast<unsigned char>(key.data[i])) * 1099511628211ull;
+                }
+                return static_cast<size_t>(h);
+            }
+        };
+
+        struct KeyEqual {
+            bool operator()(const KeyView& a, const KeyView& b) const {
+                return a.size == b.size && std::memcmp(a.data, b.data, a.size) == 0;
+            }
+        };
+
+        struct Pool {
+            std::mutex mutex;
+            std::deque<std::string> strings;                                // 尾部追加不移动已有元素
+            std::unordered_map<KeyView, uint32_t, KeyHash, KeyEqual> ids;   // 键指向 strings 中的字符
+            std::unique_ptr<const std::string*[]> chunks[MAX_CHUNKS];
+            uint32_t nextId = 1;
+            size_t bytes = 0;
+        };
+
+        Pool& GetPool() {
+            static Pool* s_pool = new Pool();   // 不析构，保证退出阶段其他静态对象仍可读取
+            return *s_pool;
+        }
+
+        const std::string& EmptyString() {
+            static const std::string s_empty;
+            return s_empty;
+        }
+
+    }
+
+    uint32_t InternedString::Intern(const std::string& text) {
+        return Intern(text.data(), text.size());
+    }
+
+    uint32_t InternedString::Intern(const char* text) {
+        if (!text) return 0;
+        return Intern(text, std::strlen(text));
+    }
+
+    uint32_t InternedString::Intern(const char* data, size_t size) {
+        if (size == 0) return 0;
+
+        Pool& pool = GetPool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        auto it = pool.ids.find(KeyView{ data, size });
+        if (it != pool.ids.end()) return it->second;
+
+        uint32_t id = pool.nextId;
+        uint32_t chunk = id >> CHUNK_BITS;
+        if (chunk >= MAX_CHUNKS) return 0;
+        if (!pool.chunks[chunk]) {
+            pool.chunks[chunk].reset(new const std::string*[CHUNK_SIZE]());
+        }
+
+        pool.strings.emplace_back(data, size);
+        const std::string& stored = pool.strings.back();
+        pool.ids.emplace(KeyView{ stored.data(), stored.size() }, id);
+        pool.chunks[chunk][id & (CHUNK_SIZE - 1)] = &stored;
+        pool.nextId++;
+        pool.bytes += size;
+        return id;
+    }
+
+    const std::string& InternedString::Lookup(uint32_t id) {
+        if (id == 0) return EmptyString();
+        return *GetPool().chunks[id >> CHUNK_BITS][id & (CHUNK_SIZE - 1)];
+    }
+
+    InternedString::PoolStats InternedString::GetPoolStats() {
+        Pool& pool = GetPool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        PoolStats stats;
+        stats.count = pool.nextId - 1;
+        stats.bytes = pool.bytes;
+        return stats;
+    }
+
+}
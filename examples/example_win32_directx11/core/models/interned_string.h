@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace I2CDebugger {
+
+    // ========== 驻留字符串 ==========
+    // 全局只增不减的字符串池，相同内容只存一份；条目里只保存 4 字节编号。
+    // 编号 0 固定为空串。池中字符串地址永不变化，读取不加锁，可跨线程传递；
+    // 驻留（构造/赋值）加锁，已存在的内容查表命中后不再分配内存。
+    class InternedString {
+    public:
+        InternedString() = default;
+        InternedString(const std::string& text) : m_id(Intern(text)) {}
+        InternedString(const char* text) : m_id(Intern(text)) {}
+
+        InternedString& operator=(const std::string& text) { m_id = Intern(text); return *this; }
+        InternedString& operator=(const char* text) { m_id = Intern(text); return *this; }
+
+        const std::string& str() const { return Lookup(m_id); }
+        const char* c_str() const { return str().c_str(); }
+        size_t size() const { return str().size(); }
+        bool empty() const { return m_id == 0; }
+        void clear() { m_id = 0; }
+        uint32_t id() const { return m_id; }
+
+        operator const std::string&() const { return str(); }
+
+        friend bool operator==(InternedString a, InternedString b) { return a.m_id == b.m_id; }
+        friend bool operator!=(InternedString a, InternedString b) { return a.m_id != b.m_id; }
+
+        struct PoolStats {
+            uint32_t count = 0;     // 不含空串
+            size_t bytes = 0;       // 字符内容总字节
+        };
+        static PoolStats GetPoolStats();
+
+    private:
+        static uint32_t Intern(const std::string& text);
+        static uint32_t Intern(const char* text);
+        static uint32_t Intern(const char* data, size_t size);    // 按指针+长度查表，只在插入时复制
+        static const std::string& Lookup(uint32_t id);
+
+        uint32_t m_id = 0;
+    };
+
+}
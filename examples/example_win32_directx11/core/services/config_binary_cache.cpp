@@ -0,0 +1,528 @@
+﻿#include "config_binary_cache.h"
+#include <cstring>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace I2CDebugger {
+
+    namespace {
+
+        // ========== 文件格式 ==========
+        // [FileHeader][GroupDirEntry x groupCount][组块 ...]
+        // 组块: [GroupHeader][RegisterRecord x n][TriggerRecord x n][TriggerRecord x n][数据区][字符串表]
+        // 所有块按 8 字节对齐，记录可直接从映射内存读取
+
+        const char CACHE_MAGIC[4] = { 'I', '2', 'C', 'B' };
+        const uint32_t CACHE_VERSION = 3;
+
+        struct BinString {
+            uint32_t offset;    // 组内字符串表偏移
+            uint32_t length;
+        };
+
+        struct BinParse {
+            uint8_t enabled;
+            uint8_t reserved[3];
+            BinString readFormula;
+            BinString writeFormula;
+            BinString alias;
+        };
+
+        struct RegisterRecord {
+            uint8_t regAddress;
+            uint8_t length;
+            uint8_t overrideSlaveAddr;
+            uint8_t slaveAddress;
+            BinString description;
+            BinParse parse;
+        };
+
+        // 单次/周期触发条目共用
+        struct TriggerRecord {
+            uint8_t enabled;
+            uint8_t regAddress;
+            uint8_t length;
+            uint8_t type;
+            uint8_t overrideSlaveAddr;
+            uint8_t slaveAddress;
+            uint8_t plotEnabled;
+            uint8_t verifyWrite;
+            uint32_t delayMs;
+            uint32_t dataOffset;    // 组内数据区偏移
+            uint32_t dataLength;
+            uint32_t writeMask;
+            uint32_t reserved;
+            BinString buttonName;
+            BinParse parse;
+        };
+
+        struct GroupHeader {
+            BinString name;
+            BinString logFilePath;
+            uint32_t interval;
+            uint8_t slaveAddress;
+            uint8_t logEnabled;
+            uint8_t logUseAlias;
+            uint8_t logIncludeTimestamp;
+            uint8_t logRawData;
+            uint8_t logParsedValue;
+            uint8_t reserved[2];
+            uint32_t registerCount;
+            uint32_t singleCount;
+            uint32_t periodicCount;
+            uint32_t dataBytes;
+            uint32_t stringBytes;
+        };
+
+        struct GroupDirEntry {
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        struct FileHeader {
+            char magic[4];
+            uint32_t version;
+            uint32_t headerSize;        // sizeof(FileHeader)，防止不同编译器布局不一致
+            uint32_t groupCount;
+            uint64_t jsonSize;
+            uint64_t jsonWriteTime;
+            ConfigCacheHeaderData data;
+        };
+
+        size_t Align8(size_t n) { return (n + 7) & ~static_cast<size_t>(7); }
+
+        // 组内字符串去重：相同的按钮名、公式、描述只存一份
+        class StringInterner {
+        public:
+            BinString Add(const std::string& str) {
+                if (str.empty()) return BinString{ 0, 0 };
+                auto it = m_index.find(str);
+                if (it != m_index.end()) return it->second;
+                BinString ref{ static_cast<uint32_t>(m_table.size()), static_cast<uint32_t>(str.size()) };
+                m_table += str;
+                m_index.emplace(str, ref);
+                return ref;
+            }
+            const std::string& Table() const { return m_table; }
+
+        private:
+            std::string m_table;
+            std::unordered_map<std::string, BinString> m_index;
+        };
+
+        BinParse EncodeParse(const ParseConfig& config, StringInterner& strings) {
+            BinParse p;
+            std::memset(&p, 0, sizeof(p));
+            p.enabled = config.enabled ? 1 : 0;
+            p.readFormula = strings.Add(config.readFormula);
+            p.writeFormula = strings.Add(config.writeFormula);
+            p.alias = strings.Add(config.alias);
+            return p;
+        }
+
+        template <typename Entry>
+        TriggerRecord EncodeTrigger(const Entry& e, bool plotEnabled, StringInterner& strings, std::string& data) {
+            TriggerRecord r;
+            std::memset(&r, 0, sizeof(r));
+            r.enabled = e.enabled ? 1 : 0;
+            r.regAddress = e.regAddress;
+            r.length = e.length;
+            r.type = static_cast<uint8_t>(e.type);
+            r.overrideSlaveAddr = e.overrideSlaveAddr ? 1 : 0;
+            r.slaveAddress = e.slaveAddress;
+            r.plotEnabled = plotEnabled ? 1 : 0;
+            r.verifyWrite = e.verifyWrite ? 1 : 0;
+            r.delayMs = e.delayMs;
+            r.writeMask = e.writeMask;
+            r.dataOffset = static_cast<uint32_t>(data.size());
+            r.dataLength = static_cast<uint32_t>(e.data.size());
+            data.append(reinterpret_cast<const char*>(e.data.data()), e.data.size());
+            r.buttonName = strings.Add(e.buttonName);
+            r.parse = EncodeParse(e.parseConfig, strings);
+            return r;
+        }
+
+        template <typename T>
+        void AppendPod(std::string& out, const T& value) {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        // ========== 解码 ==========
+        class GroupReader {
+        public:
+            GroupReader(const unsigned char* block, size_t size) : m_block(block), m_size(size) {}
+
+            bool Decode(CommandGroup& group) {
+                if (m_size < sizeof(GroupHeader)) return false;
+                GroupHeader h;
+                std::memcpy(&h, m_block, sizeof(h));
+
+                size_t recordsBytes = sizeof(GroupHeader)
+                    + static_cast<size_t>(h.registerCount) * sizeof(RegisterRecord)
+                    + (static_cast<size_t>(h.singleCount) + h.periodicCount) * sizeof(TriggerRecord);
+                if (recordsBytes + h.dataBytes + h.stringBytes > m_size) return false;
+
+                const unsigned char* records = m_block + sizeof(GroupHeader);
+                m_data = m_block + recordsBytes;
+                m_dataBytes = h.dataBytes;
+                m_strings = reinterpret_cast<const char*>(m_data + h.dataBytes);
+                m_stringBytes = h.stringBytes;
+
+                if (!String(h.name, group.name) || !String(h.logFilePath, group.logConfig.filePath)) return false;
+                group.interval = h.interval;
+                group.slaveAddress = h.slaveAddress;
+                group.logConfig.enabled = h.logEnabled != 0;
+                group.logConfig.useAlias = h.logUseAlias != 0;
+                group.logConfig.includeTimestamp = h.logIncludeTimestamp != 0;
+                group.logConfig.logRawData = h.logRawData != 0;
+                group.logConfig.logParsedValue = h.logParsedValue != 0;
+
+                group.registerEntries.resize(h.registerCount);
+                for (uint32_t i = 0; i < h.registerCount; ++i) {
+                    RegisterRecord r;
+                    std::memcpy(&r, records, sizeof(r));
+                    records += sizeof(r);
+                    RegisterEntry& e = group.registerEntries[i];
+                    e.regAddress = r.regAddress;
+                    e.length = r.length;
+                    e.overrideSlaveAddr = r.overrideSlaveAddr != 0;
+                    e.slaveAddress = r.slaveAddress;
+                    if (!String(r.description, e.description) || !Parse(r.parse, e.parseConfig)) return false;
+                }
+
+                group.singleTriggerEntries.resize(h.singleCount);
+                for (uint32_t i = 0; i < h.singleCount; ++i) {
+                    if (!Trigger(records, group.singleTriggerEntries[i])) return false;
+                    records += sizeof(TriggerRecord);
+                }
+
+                group.periodicTriggerEntries.resize(h.periodicCount);
+                for (uint32_t i = 0; i < h.periodicCount; ++i) {
+                    PeriodicTriggerEntry& e = group.periodicTriggerEntries[i];
+                    if (!Trigger(records, e)) return false;
+                    e.plotEnabled = records[offsetof(TriggerRecord, plotEnabled)] != 0;
+                    records += sizeof(TriggerRecord);
+                }
+                return true;
+            }
+
+        private:
+            bool String(const BinString& ref, std::string& out) const {
+                if (static_cast<uint64_t>(ref.offset) + ref.length > m_stringBytes) return false;
+                out.assign(m_strings + ref.offset, ref.length);
+                return true;
+            }
+
+            // 字符串表在组内已去重，同一偏移只驻留一次
+            bool String(const BinString& ref, InternedString& out) {
+                if (static_cast<uint64_t>(ref.offset) + ref.length > m_stringBytes) return false;
+                if (ref.length == 0) {
+                    out.clear();
+                    return true;
+                }
+                auto it = m_interned.find(ref.offset);
+                if (it == m_interned.end()) {
+                    m_scratch.assign(m_strings + ref.offset, ref.length);
+                    it = m_interned.emplace(ref.offset, InternedString(m_scratch)).first;
+                }
+                out = it->second;
+                return true;
+            }
+
+            bool Parse(const BinParse& p, ParseConfig& config) {
+                config.enabled = p.enabled != 0;
+                return String(p.readFormula, config.readFormula) && String(p.writeFormula, config.writeFormula) &&
+                    String(p.alias, config.alias);
+            }
+
+            template <typename Entry>
+            bool Trigger(const unsigned char* record, Entry& e) {
+                TriggerRecord r;
+                std::memcpy(&r, record, sizeof(r));
+                if (static_cast<uint64_t>(r.dataOffset) + r.dataLength > m_dataBytes) return false;
+                e.enabled = r.enabled != 0;
+                e.regAddress = r.regAddress;
+                e.length = r.length;
+                e.type = static_cast<CommandType>(r.type);
+                e.overrideSlaveAddr = r.overrideSlaveAddr != 0;
+                e.slaveAddress = r.slaveAddress;
+                e.verifyWrite = r.verifyWrite != 0;
+                e.writeMask = r.writeMask;
+                e.delayMs = r.delayMs;
+                e.data.assign(m_data + r.dataOffset, m_data + r.dataOffset + r.dataLength);
+                return String(r.buttonName, e.buttonName) && Parse(r.parse, e.parseConfig);
+            }
+
+            const unsigned char* m_block;
+            size_t m_size;
+            const unsigned char* m_data = nullptr;
+            size_t m_dataBytes = 0;
+            const char* m_strings = nullptr;
+            size_t m_stringBytes = 0;
+            std::unordered_map<uint32_t, InternedString> m_interned;
+            std::string m_scratch;
+        };
+
+        // 只读映射缓存文件，析构时释放
+        class MappedFile {
+        public:
+            explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+                m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (m_file == INVALID_HANDLE_VALUE) return;
+                LARGE_INTEGER size;
+                if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) return;
+                m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!m_mapping) return;
+                m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+                if (m_data) m_size = static_cast<size_t>(size.QuadPart);
+#else
+                std::ifstream file(path, std::ios::binary | std::ios::ate);
+                if (!file.is_open()) return;
+                std::streamsize size = file.tellg();
+                if (size <= 0) return;
+                m_buffer.resize(static_cast<size_t>(size));
+                file.seekg(0);
+                if (!file.read(reinterpret_cast<char*>(m_buffer.data()), size)) return;
+                m_data = m_buffer.data();
+                m_size = m_buffer.size();
+#endif
+            }
+
+            ~MappedFile() {
+#ifdef _WIN32
+                if (m_data) UnmapViewOfFile(m_data);
+                if (m_mapping) CloseHandle(m_mapping);
+                if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+#endif
+            }
+
+            const unsigned char* Data() const { return m_data; }
+            size_t Size() const { return m_size; }
+
+        private:
+            const unsigned char* m_data = nullptr;
+            size_t m_size = 0;
+#ifdef _WIN32
+            HANDLE m_file = INVALID_HANDLE_VALUE;
+            HANDLE m_mapping = nullptr;
+#else
+            std::vector<unsigned char> m_buffer;
+#endif
+        };
+
+        void CopyInputField(char* dst, size_t dstSize, const char* src, size_t srcSize) {
+            size_t n = dstSize < srcSize ? dstSize : srcSize;
+            std::memcpy(dst, src, n);
+            dst[dstSize - 1] = '\0';
+        }
+
+    } // namespace
+
+    std::string ConfigBinaryCache::GetCachePath(const std::string& jsonPath) {
+        size_t dot = jsonPath.find_last_of('.');
+        size_t slash = jsonPath.find_last_of("\\/");
+        if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+            return jsonPath.substr(0, dot) + ".cache";
+        }
+        return jsonPath + ".cache";
+    }
+
+    bool ConfigBinaryCache::GetFileStamp(const std::string& path, ConfigFileStamp& stamp) {
+#ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA attr;
+        if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &attr)) return false;
+        stamp.size = (static_cast<uint64_t>(attr.nFileSizeHigh) << 32) | attr.nFileSizeLow;
+        stamp.writeTime = (static_cast<uint64_t>(attr.ftLastWriteTime.dwHighDateTime) << 32) | attr.ftLastWriteTime.dwLowDateTime;
+#else
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) return false;
+        stamp.size = static_cast<uint64_t>(st.st_size);
+        stamp.writeTime = static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000ull + static_cast<uint64_t>(st.st_mtim.tv_nsec);
+#endif
+        return true;
+    }
+
+    std::shared_ptr<const std::string> ConfigBinaryCache::EncodeGroup(const CommandGroup& group) {
+        StringInterner strings;
+        std::string data;
+
+        GroupHeader h;
+        std::memset(&h, 0, sizeof(h));
+        h.name = strings.Add(group.name);
+        h.logFilePath = strings.Add(group.logConfig.filePath);
+        h.interval = group.interval;
+        h.slaveAddress = group.slaveAddress;
+        h.logEnabled = group.logConfig.enabled ? 1 : 0;
+        h.logUseAlias = group.logConfig.useAlias ? 1 : 0;
+        h.logIncludeTimestamp = group.logConfig.includeTimestamp ? 1 : 0;
+        h.logRawData = group.logConfig.logRawData ? 1 : 0;
+        h.logParsedValue = group.logConfig.logParsedValue ? 1 : 0;
+        h.registerCount = static_cast<uint32_t>(group.registerEntries.size());
+        h.singleCount = static_cast<uint32_t>(group.singleTriggerEntries.size());
+        h.periodicCount = static_cast<uint32_t>(group.periodicTriggerEntries.size());
+
+        std::string records;
+        records.reserve(h.registerCount * sizeof(RegisterRecord)
+            + (static_cast<size_t>(h.singleCount) + h.periodicCount) * sizeof(TriggerRecord));
+
+        for (const auto& e : group.registerEntries) {
+            RegisterRecord r;
+            std::memset(&r, 0, sizeof(r));
+            r.regAddress = e.regAddress;
+            r.length = e.length;
+            r.overrideSlaveAddr = e.overrideSlaveAddr ? 1 : 0;
+            r.slaveAddress = e.slaveAddress;
+            r.description = strings.Add(e.description);
+            r.parse = EncodeParse(e.parseConfig, strings);
+            AppendPod(records, r);
+        }
+        for (const auto& e : group.singleTriggerEntries) {
+            AppendPod(records, EncodeTrigger(e, false, strings, data));
+        }
+        for (const auto& e : group.periodicTriggerEntries) {
+            AppendPod(records, EncodeTrigger(e, e.plotEnabled, strings, data));
+        }
+
+        h.dataBytes = static_cast<uint32_t>(data.size());
+        h.stringBytes = static_cast<uint32_t>(strings.Table().size());
+
+        std::shared_ptr<std::string> block = std::make_shared<std::string>();
+        block->reserve(Align8(sizeof(h) + records.size() + data.size() + strings.Table().size()));
+        AppendPod(*block, h);
+        *block += records;
+        *block += data;
+        *block += strings.Table();
+        block->resize(Align8(block->size()), '\0');
+        return block;
+    }
+
+    ConfigCacheHeaderData ConfigBinaryCache::MakeHeaderData(const I2CSimpleAppData& simpleData, const I2CTableAppData& tableData) {
+        ConfigCacheHeaderData d;
+        d.simpleBaudRate = simpleData.baudRate;
+        std::memcpy(d.slaveAddrInput, simpleData.slaveAddrInput, sizeof(d.slaveAddrInput));
+        std::memcpy(d.regAddrInput, simpleData.regAddrInput, sizeof(d.regAddrInput));
+        std::memcpy(d.lengthInput, simpleData.lengthInput, sizeof(d.lengthInput));
+        std::memcpy(d.writeDataInput, simpleData.writeDataInput, sizeof(d.writeDataInput));
+        d.tableBaudRate = tableData.baudRate;
+        d.currentGroupIndex = tableData.currentGroupIndex;
+        return d;
+    }
+
+    bool ConfigBinaryCache::Write(
+        const std::string& cachePath,
+        const ConfigFileStamp& jsonStamp,
+        const ConfigCacheHeaderData& headerData,
+        const std::vector<std::shared_ptr<const std::string>>& groupBlocks)
+    {
+        FileHeader header;
+        std::memset(static_cast<void*>(&header), 0, sizeof(header));
+        std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+        header.version = CACHE_VERSION;
+        header.headerSize = sizeof(FileHeader);
+        header.groupCount = static_cast<uint32_t>(groupBlocks.size());
+        header.jsonSize = jsonStamp.size;
+        header.jsonWriteTime = jsonStamp.writeTime;
+        header.data = headerData;
+
+        std::vector<GroupDirEntry> dir(groupBlocks.size());
+        uint64_t offset = Align8(sizeof(FileHeader) + dir.size() * sizeof(GroupDirEntry));
+        for (size_t i = 0; i < groupBlocks.size(); ++i) {
+            dir[i].offset = offset;
+            dir[i].size = groupBlocks[i]->size();
+            offset += groupBlocks[i]->size();
+        }
+
+        std::string tempPath = cachePath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return false;
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            if (!dir.empty()) {
+                file.write(reinterpret_cast<const char*>(dir.data()), dir.size() * sizeof(GroupDirEntry));
+            }
+            static const char padding[8] = {};
+            size_t headBytes = sizeof(FileHeader) + dir.size() * sizeof(GroupDirEntry);
+            file.write(padding, Align8(headBytes) - headBytes);
+            for (const auto& block : groupBlocks) {
+                file.write(block->data(), block->size());
+            }
+            file.flush();
+            if (!file) {
+                file.close();
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+
+#ifdef _WIN32
+        bool ok = MoveFileExA(tempPath.c_str(), cachePath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        bool ok = std::rename(tempPath.c_str(), cachePath.c_str()) == 0;
+#endif
+        if (!ok) std::remove(tempPath.c_str());
+        return ok;
+    }
+
+    bool ConfigBinaryCache::Load(
+        const std::string& cachePath,
+        const ConfigFileStamp& jsonStamp,
+        I2CSimpleAppData& simpleData,
+        I2CTableAppData& tableData)
+    {
+        MappedFile file(cachePath);
+        if (!file.Data() || file.Size() < sizeof(FileHeader)) return false;
+
+        FileHeader header;
+        std::memcpy(&header, file.Data(), sizeof(header));
+        if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != CACHE_VERSION ||
+            header.headerSize != sizeof(FileHeader) ||
+            header.jsonSize != jsonStamp.size ||
+            header.jsonWriteTime != jsonStamp.writeTime) {
+            return false;
+        }
+
+        size_t dirBytes = static_cast<size_t>(header.groupCount) * sizeof(GroupDirEntry);
+        if (sizeof(FileHeader) + dirBytes > file.Size()) return false;
+        const GroupDirEntry* dir = reinterpret_cast<const GroupDirEntry*>(file.Data() + sizeof(FileHeader));
+
+        // 先解码到临时容器，全部成功后再替换
+        std::vector<CommandGroup> groups(header.groupCount);
+        for (uint32_t i = 0; i < header.groupCount; ++i) {
+            GroupDirEntry entry;
+            std::memcpy(&entry, dir + i, sizeof(entry));
+            if (entry.offset > file.Size() || entry.size > file.Size() - entry.offset) return false;
+            GroupReader reader(file.Data() + entry.offset, static_cast<size_t>(entry.size));
+            if (!reader.Decode(groups[i])) return false;
+        }
+
+        const ConfigCacheHeaderData& d = header.data;
+        simpleData.baudRate = d.simpleBaudRate;
+        CopyInputField(simpleData.slaveAddrInput, sizeof(simpleData.slaveAddrInput), d.slaveAddrInput, sizeof(d.slaveAddrInput));
+        CopyInputField(simpleData.regAddrInput, sizeof(simpleData.regAddrInput), d.regAddrInput, sizeof(d.regAddrInput));
+        CopyInputField(simpleData.lengthInput, sizeof(simpleData.lengthInput), d.lengthInput, sizeof(d.lengthInput));
+        CopyInputField(simpleData.writeDataInput, sizeof(simpleData.writeDataInput), d.writeDataInput, sizeof(d.writeDataInput));
+
+        tableData.baudRate = d.tableBaudRate;
+        tableData.currentGroupIndex = d.currentGroupIndex;
+        tableData.commandGroups = std::move(groups);
+        if (tableData.commandGroups.empty()) {
+            tableData.commandGroups.push_back(CommandGroup());
+        }
+        if (tableData.currentGroupIndex >= static_cast<int>(tableData.commandGroups.size())) {
+            tableData.currentGroupIndex = 0;
+        }
+        return true;
+    }
+
+}
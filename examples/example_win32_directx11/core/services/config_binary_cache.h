@@ -0,0 +1,57 @@
+﻿#pragma once
+#include "../models/i2c_simple_app.h"
+#include "../models/i2c_table_app.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace I2CDebugger {
+
+    // JSON 源文件的标识：大小 + 最后写入时间，缓存头中记录一份，不一致即视为过期
+    struct ConfigFileStamp {
+        uint64_t size = 0;
+        uint64_t writeTime = 0;
+    };
+
+    // 除命令组以外需要缓存的字段
+    struct ConfigCacheHeaderData {
+        uint32_t simpleBaudRate = 0;
+        char slaveAddrInput[16] = "";
+        char regAddrInput[16] = "";
+        char lengthInput[16] = "";
+        char writeDataInput[256] = "";
+        uint32_t tableBaudRate = 0;
+        int32_t currentGroupIndex = 0;
+    };
+
+    // ========== 配置二进制缓存 ==========
+    // 与 i2c_debugger_config.json 并存的只读缓存，JSON 始终是唯一的数据源。
+    // 每个命令组编码为独立的块：定长 POD 记录数组 + 原始数据区 + 组内去重的字符串表，
+    // 可直接在内存映射上读取；保存时未变更的组复用上次的块。
+    class ConfigBinaryCache {
+    public:
+        static std::string GetCachePath(const std::string& jsonPath);
+        static bool GetFileStamp(const std::string& path, ConfigFileStamp& stamp);
+
+        // 编码单个命令组
+        static std::shared_ptr<const std::string> EncodeGroup(const CommandGroup& group);
+
+        static ConfigCacheHeaderData MakeHeaderData(const I2CSimpleAppData& simpleData, const I2CTableAppData& tableData);
+
+        // 写入缓存（临时文件 + 替换）
+        static bool Write(
+            const std::string& cachePath,
+            const ConfigFileStamp& jsonStamp,
+            const ConfigCacheHeaderData& headerData,
+            const std::vector<std::shared_ptr<const std::string>>& groupBlocks);
+
+        // 缓存存在且与 jsonStamp 匹配时加载；任何不一致都返回 false，由调用方回退到 JSON
+        static bool Load(
+            const std::string& cachePath,
+            const ConfigFileStamp& jsonStamp,
+            I2CSimpleAppData& simpleData,
+            I2CTableAppData& tableData);
+    };
+
+}
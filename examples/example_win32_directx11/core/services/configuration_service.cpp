@@ -1,11 +1,443 @@
 ﻿#include "configuration_service.h"
 #include <fstream>
 #include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
 
 namespace I2CDebugger {
 
     using json = nlohmann::json;
 
+    // ============== 流式加载（SAX） ==============
+    // 不构建 JSON DOM，边解析边在目标 vector 中原地构造命令组和条目。
+    // 保存时写入的 commandGroupCount / entryCounts 按键名排序位于数组之前，用于预先 reserve。
+    // 提示来自文件本身，按文本长度封顶（每个数组元素至少占 "{}," 三个字节），损坏的计数不会触发巨量分配。
+    namespace {
+
+        class ConfigSaxHandler : public nlohmann::json_sax<json> {
+        public:
+            // 解析结果先落在这里，成功后再整体替换到应用数据，失败时不破坏现有配置
+            struct Result {
+                bool hasSimpleData = false;
+                bool hasBaudRate = false;
+                uint32_t simpleBaudRate = 0;
+                bool hasInput[4] = {};
+                std::string inputs[4];          // slaveAddr / regAddr / length / writeData
+
+                bool hasTableData = false;
+                bool hasTableBaudRate = false;
+                int tableBaudRate = 0;
+                bool hasCurrentGroupIndex = false;
+                int currentGroupIndex = 0;
+                bool hasCommandGroups = false;
+                std::vector<CommandGroup> groups;   // commandGroups 或单个命令组文件的 group
+            };
+
+            explicit ConfigSaxHandler(size_t textSize) : m_hintLimit(textSize / 3) {}
+
+            Result result;
+            std::string errorMessage;
+
+            // ---- 标量 ----
+            bool null() override { return true; }
+            bool boolean(bool val) override { OnBool(val); return true; }
+            bool number_integer(number_integer_t val) override { OnNumber(static_cast<int64_t>(val), static_cast<double>(val)); return true; }
+            bool number_unsigned(number_unsigned_t val) override { OnNumber(static_cast<int64_t>(val), static_cast<double>(val)); return true; }
+            bool number_float(number_float_t val, const string_t&) override { OnNumber(static_cast<int64_t>(val), val); return true; }
+            bool string(string_t& val) override { OnString(val); return true; }
+            bool binary(binary_t&) override { return true; }
+
+            // ---- 结构 ----
+            bool key(string_t& val) override { m_key.swap(val); return true; }
+
+            bool start_object(std::size_t) override {
+                Ctx next = Ctx::Skip;
+                Ctx top = Top();
+                if (m_stack.empty()) {
+                    next = Ctx::Root;
+                }
+                else if (top == Ctx::Root) {
+                    if (m_key == "simpleData") { next = Ctx::Simple; result.hasSimpleData = true; }
+                    else if (m_key == "tableData") { next = Ctx::Table; result.hasTableData = true; }
+                    else if (m_key == "group") { BeginGroup(); next = Ctx::Group; }
+                }
+                else if (top == Ctx::Groups) { BeginGroup(); next = Ctx::Group; }
+                else if (top == Ctx::Group && m_key == "logConfig") { next = Ctx::LogConfig; }
+                else if (top == Ctx::RegisterArray) {
+                    m_group->registerEntries.emplace_back();
+                    m_register = &m_group->registerEntries.back();
+                    m_parse = &m_register->parseConfig;
+                    next = Ctx::Register;
+                }
+                else if (top == Ctx::SingleArray) {
+                    m_group->singleTriggerEntries.emplace_back();
+                    m_single = &m_group->singleTriggerEntries.back();
+                    m_parse = &m_single->parseConfig;
+                    next = Ctx::Single;
+                }
+                else if (top == Ctx::PeriodicArray) {
+                    m_group->periodicTriggerEntries.emplace_back();
+                    m_periodic = &m_group->periodicTriggerEntries.back();
+                    m_parse = &m_periodic->parseConfig;
+                    next = Ctx::Periodic;
+                }
+                else if ((top == Ctx::Register || top == Ctx::Single || top == Ctx::Periodic) && m_key == "parseConfig") {
+                    next = Ctx::Parse;
+                }
+                m_stack.push_back(next);
+                return true;
+            }
+
+            bool end_object() override { m_stack.pop_back(); return true; }
+
+            bool start_array(std::size_t) override {
+                Ctx next = Ctx::Skip;
+                Ctx top = Top();
+                if (top == Ctx::Table && m_key == "commandGroups") {
+                    result.hasCommandGroups = true;
+                    result.groups.clear();
+                    if (m_groupCountHint > 0) result.groups.reserve(m_groupCountHint);
+                    next = Ctx::Groups;
+                }
+                else if (top == Ctx::Group) {
+                    if (m_key == "registerEntries") {
+                        m_group->registerEntries.reserve(m_entryCountHints[0]);
+                        next = Ctx::RegisterArray;
+                    }
+                    else if (m_key == "singleTriggerEntries") {
+                        m_group->singleTriggerEntries.reserve(m_entryCountHints[1]);
+                        next = Ctx::SingleArray;
+                    }
+                    else if (m_key == "periodicTriggerEntries") {
+                        m_group->periodicTriggerEntries.reserve(m_entryCountHints[2]);
+                        next = Ctx::PeriodicArray;
+                    }
+                    else if (m_key == "entryCounts") {
+                        m_hintIndex = 0;
+                        next = Ctx::EntryCounts;
+                    }
+                }
+                else if (top == Ctx::Single && m_key == "data") {
+                    m_single->data.clear();
+                    m_data = &m_single->data;
+                    next = Ctx::Data;
+                }
+                else if (top == Ctx::Periodic && m_key == "data") {
+                    m_periodic->data.clear();
+                    m_data = &m_periodic->data;
+                    next = Ctx::Data;
+                }
+                m_stack.push_back(next);
+                return true;
+            }
+
+            bool end_array() override { m_stack.pop_back(); return true; }
+
+            bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+                errorMessage = ex.what();
+                return false;
+            }
+
+        private:
+            enum class Ctx : uint8_t {
+                Skip, Root, Simple, Table, Groups, Group, LogConfig, EntryCounts,
+                RegisterArray, SingleArray, PeriodicArray,
+                Register, Single, Periodic, Parse, Data
+            };
+
+            Ctx Top() const { return m_stack.empty() ? Ctx::Skip : m_stack.back(); }
+
+            size_t ClampHint(int64_t v) const {
+                return static_cast<uint64_t>(v) > m_hintLimit ? m_hintLimit : static_cast<size_t>(v);
+            }
+
+            void BeginGroup() {
+                result.groups.emplace_back();
+                m_group = &result.groups.back();
+                m_entryCountHints[0] = m_entryCountHints[1] = m_entryCountHints[2] = 0;
+            }
+
+            // 三种条目共有的字段
+            template <typename Entry>
+            bool SetCommonNumber(Entry& entry, int64_t v) {
+                if (m_key == "regAddress") entry.regAddress = static_cast<uint8_t>(v);
+                else if (m_key == "length") entry.length = static_cast<uint8_t>(v);
+                else if (m_key == "slaveAddress") entry.slaveAddress = static_cast<uint8_t>(v);
+                else return false;
+                return true;
+            }
+
+            template <typename Entry>
+            bool SetTriggerNumber(Entry& entry, int64_t v) {
+                if (SetCommonNumber(entry, v)) return true;
+                if (m_key == "delayMs") entry.delayMs = static_cast<uint16_t>(v);
+                else if (m_key == "type") entry.type = static_cast<CommandType>(v);
+                else if (m_key == "writeMask") entry.writeMask = static_cast<uint32_t>(v);
+                else return false;
+                return true;
+            }
+
+            void OnNumber(int64_t v, double) {
+                switch (Top()) {
+                case Ctx::Simple:
+                    if (m_key == "baudRate") { result.hasBaudRate = true; result.simpleBaudRate = static_cast<uint32_t>(v); }
+                    break;
+                case Ctx::Table:
+                    if (m_key == "baudRate") { result.hasTableBaudRate = true; result.tableBaudRate = static_cast<int>(v); }
+                    else if (m_key == "currentGroupIndex") { result.hasCurrentGroupIndex = true; result.currentGroupIndex = static_cast<int>(v); }
+                    else if (m_key == "commandGroupCount" && v > 0) m_groupCountHint = ClampHint(v);
+                    break;
+                case Ctx::Group:
+                    if (m_key == "slaveAddress") m_group->slaveAddress = static_cast<uint8_t>(v);
+                    else if (m_key == "interval") m_group->interval = static_cast<uint32_t>(v);
+                    break;
+                case Ctx::EntryCounts:
+                    if (m_hintIndex < 3 && v > 0) m_entryCountHints[m_hintIndex] = ClampHint(v);
+                    m_hintIndex++;
+                    break;
+                case Ctx::Register: SetCommonNumber(*m_register, v); break;
+                case Ctx::Single: SetTriggerNumber(*m_single, v); break;
+                case Ctx::Periodic: SetTriggerNumber(*m_periodic, v); break;
+                case Ctx::Data: m_data->push_back(static_cast<uint8_t>(v)); break;
+                default: break;
+                }
+            }
+
+            void OnBool(bool v) {
+                switch (Top()) {
+                case Ctx::LogConfig: {
+                    DataLogConfig& c = m_group->logConfig;
+                    if (m_key == "enabled") c.enabled = v;
+                    else if (m_key == "useAlias") c.useAlias = v;
+                    else if (m_key == "includeTimestamp") c.includeTimestamp = v;
+                    else if (m_key == "logRawData") c.logRawData = v;
+                    else if (m_key == "logParsedValue") c.logParsedValue = v;
+                    break;
+                }
+                case Ctx::Register:
+                    if (m_key == "overrideSlaveAddr") m_register->overrideSlaveAddr = v;
+                    break;
+                case Ctx::Single:
+                    if (m_key == "enabled") m_single->enabled = v;
+                    else if (m_key == "overrideSlaveAddr") m_single->overrideSlaveAddr = v;
+                    else if (m_key == "verifyWrite") m_single->verifyWrite = v;
+                    break;
+                case Ctx::Periodic:
+                    if (m_key == "enabled") m_periodic->enabled = v;
+                    else if (m_key == "overrideSlaveAddr") m_periodic->overrideSlaveAddr = v;
+                    else if (m_key == "verifyWrite") m_periodic->verifyWrite = v;
+                    else if (m_key == "plotEnabled") m_periodic->plotEnabled = v;
+                    break;
+                case Ctx::Parse:
+                    if (m_key == "enabled") m_parse->enabled = v;
+                    break;
+                default: break;
+                }
+            }
+
+            void OnString(std::string& v) {
+                switch (Top()) {
+                case Ctx::Simple: {
+                    static const char* const inputKeys[4] = { "slaveAddrInput", "regAddrInput", "lengthInput", "writeDataInput" };
+                    for (int i = 0; i < 4; ++i) {
+                        if (m_key == inputKeys[i]) {
+                            result.hasInput[i] = true;
+                            result.inputs[i].swap(v);
+                            break;
+                        }
+                    }
+                    break;
+                }
+                case Ctx::Group:
+                    if (m_key == "name") m_group->name.swap(v);
+                    break;
+                case Ctx::LogConfig:
+                    if (m_key == "filePath") m_group->logConfig.filePath.swap(v);
+                    break;
+                case Ctx::Register:
+                    if (m_key == "description") m_register->description = v;
+                    break;
+                case Ctx::Single:
+                    if (m_key == "buttonName") m_single->buttonName = v;
+                    break;
+                case Ctx::Periodic:
+                    if (m_key == "buttonName") m_periodic->buttonName = v;
+                    break;
+                case Ctx::Parse:
+                    if (m_key == "readFormula") m_parse->readFormula = v;
+                    else if (m_key == "writeFormula") m_parse->writeFormula = v;
+                    else if (m_key == "alias") m_parse->alias = v;
+                    break;
+                default: break;
+                }
+            }
+
+            std::vector<Ctx> m_stack;
+            std::string m_key;
+
+            CommandGroup* m_group = nullptr;
+            RegisterEntry* m_register = nullptr;
+            SingleTriggerEntry* m_single = nullptr;
+            PeriodicTriggerEntry* m_periodic = nullptr;
+            ParseConfig* m_parse = nullptr;
+            std::vector<uint8_t>* m_data = nullptr;
+
+            size_t m_hintLimit;
+            size_t m_groupCountHint = 0;
+            size_t m_entryCountHints[3] = {};
+            int m_hintIndex = 0;
+        };
+
+        bool ReadWholeFile(const std::string& filePath, std::string& text) {
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file.is_open()) return false;
+            std::ostringstream ss;
+            ss << file.rdbuf();
+            text = ss.str();
+            return true;
+        }
+
+        void CopyInput(char* dst, size_t size, const std::string& src) {
+            std::strncpy(dst, src.c_str(), size - 1);
+            dst[size - 1] = '\0';
+        }
+
+        // ========== 命令组内容哈希（只覆盖会写入文件的字段） ==========
+        struct ContentHasher {
+            uint64_t h = 0xCBF29CE484222325ull;
+
+            void Bytes(const void* data, size_t size) {
+                const unsigned char* p = static_cast<const unsigned char*>(data);
+                for (size_t i = 0; i < size; ++i) {
+                    h = (h ^ p[i]) * 0x100000001B3ull;
+                }
+            }
+            template <typename T>
+            void Value(T v) { Bytes(&v, sizeof(v)); }
+            void String(const std::string& str) {
+                Value<uint32_t>(static_cast<uint32_t>(str.size()));
+                Bytes(str.data(), str.size());
+            }
+            void Parse(const ParseConfig& c) {
+                Value(c.enabled);
+                String(c.readFormula);
+                String(c.writeFormula);
+                String(c.alias);
+            }
+        };
+
+        uint64_t HashCommandGroup(const CommandGroup& group) {
+            ContentHasher hasher;
+            hasher.String(group.name);
+            hasher.Value(group.slaveAddress);
+            hasher.Value(group.interval);
+
+            const DataLogConfig& log = group.logConfig;
+            hasher.Value(log.enabled);
+            hasher.String(log.filePath);
+            hasher.Value(log.useAlias);
+            hasher.Value(log.includeTimestamp);
+            hasher.Value(log.logRawData);
+            hasher.Value(log.logParsedValue);
+
+            hasher.Value<uint32_t>(static_cast<uint32_t>(group.registerEntries.size()));
+            for (const auto& e : group.registerEntries) {
+                hasher.Value(e.regAddress);
+                hasher.Value(e.length);
+                hasher.String(e.description);
+                hasher.Value(e.overrideSlaveAddr);
+                hasher.Value(e.slaveAddress);
+                hasher.Parse(e.parseConfig);
+            }
+
+            hasher.Value<uint32_t>(static_cast<uint32_t>(group.singleTriggerEntries.size()));
+            for (const auto& e : group.singleTriggerEntries) {
+                hasher.Value(e.enabled);
+                hasher.Value(e.regAddress);
+                hasher.Value(e.length);
+                hasher.Value(e.delayMs);
+                hasher.Value(e.type);
+                hasher.String(e.buttonName);
+                hasher.Value(e.overrideSlaveAddr);
+                hasher.Value(e.slaveAddress);
+                hasher.Value(e.writeMask);
+                hasher.Value(e.verifyWrite);
+                hasher.Parse(e.parseConfig);
+                hasher.Value<uint32_t>(static_cast<uint32_t>(e.data.size()));
+                hasher.Bytes(e.data.data(), e.data.size());
+            }
+
+            hasher.Value<uint32_t>(static_cast<uint32_t>(group.periodicTriggerEntries.size()));
+            for (const auto& e : group.periodicTriggerEntries) {
+                hasher.Value(e.enabled);
+                hasher.Value(e.regAddress);
+                hasher.Value(e.length);
+                hasher.Value(e.delayMs);
+                hasher.Value(e.type);
+                hasher.String(e.buttonName);
+                hasher.Value(e.overrideSlaveAddr);
+                hasher.Value(e.slaveAddress);
+                hasher.Value(e.writeMask);
+                hasher.Value(e.verifyWrite);
+                hasher.Parse(e.parseConfig);
+                hasher.Value(e.plotEnabled);
+                hasher.Value<uint32_t>(static_cast<uint32_t>(e.data.size()));
+                hasher.Bytes(e.data.data(), e.data.size());
+            }
+            return hasher.h;
+        }
+
+        // dump(4) 的结果嵌入到更深层级时，为每个换行补上外层缩进
+        std::string IndentJson(const std::string& text, int indent) {
+            std::string pad(static_cast<size_t>(indent), ' ');
+            std::string out;
+            out.reserve(text.size() + text.size() / 16);
+            for (char c : text) {
+                out.push_back(c);
+                if (c == '\n') out += pad;
+            }
+            return out;
+        }
+
+        // 先写临时文件，成功后整体替换，写入过程中崩溃不会破坏原文件
+        bool WriteFileAtomically(const std::string& filePath, const std::string& content, std::string& error) {
+            std::string tempPath = filePath + ".tmp";
+            {
+                std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+                if (!file.is_open()) {
+                    error = "无法打开文件: " + tempPath;
+                    return false;
+                }
+                file.write(content.data(), static_cast<std::streamsize>(content.size()));
+                file.flush();
+                if (!file) {
+                    error = "写入失败: " + tempPath;
+                    file.close();
+                    std::remove(tempPath.c_str());
+                    return false;
+                }
+            }
+#ifdef _WIN32
+            bool ok = MoveFileExA(tempPath.c_str(), filePath.c_str(),
+                MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+            bool ok = std::rename(tempPath.c_str(), filePath.c_str()) == 0;
+#endif
+            if (!ok) {
+                error = "无法替换文件: " + filePath;
+                std::remove(tempPath.c_str());
+            }
+            return ok;
+        }
+
+    } // namespace
+
     // ============== ParseConfig 序列化 ==============
 
     json ConfigurationService::ParseConfigToJson(const ParseConfig& config) {
@@ -13,8 +445,7 @@ namespace I2CDebugger {
         j["enabled"] = config.enabled;
         j["readFormula"] = config.readFormula;
         j["writeFormula"] = config.writeFormula;
-        // 如果有 alias 字段
-        // j["alias"] = config.alias;
+        j["alias"] = config.alias;
         return j;
     }
 
@@ -23,7 +454,7 @@ namespace I2CDebugger {
         if (j.contains("enabled")) config.enabled = j["enabled"].get<bool>();
         if (j.contains("readFormula")) config.readFormula = j["readFormula"].get<std::string>();
         if (j.contains("writeFormula")) config.writeFormula = j["writeFormula"].get<std::string>();
-        // if (j.contains("alias")) config.alias = j["alias"].get<std::string>();
+        if (j.contains("alias")) config.alias = j["alias"].get<std::string>();
         return config;
     }
 
@@ -87,6 +518,8 @@ namespace I2CDebugger {
         j["buttonName"] = entry.buttonName;
         j["overrideSlaveAddr"] = entry.overrideSlaveAddr;
         j["slaveAddress"] = entry.slaveAddress;
+        j["writeMask"] = entry.writeMask;
+        j["verifyWrite"] = entry.verifyWrite;
         j["parseConfig"] = ParseConfigToJson(entry.parseConfig);
 
         if (!entry.data.empty()) {
@@ -105,6 +538,8 @@ namespace I2CDebugger {
         if (j.contains("buttonName")) entry.buttonName = j["buttonName"].get<std::string>();
         if (j.contains("overrideSlaveAddr")) entry.overrideSlaveAddr = j["overrideSlaveAddr"].get<bool>();
         if (j.contains("slaveAddress")) entry.slaveAddress = j["slaveAddress"].get<uint8_t>();
+        if (j.contains("writeMask")) entry.writeMask = j["writeMask"].get<uint32_t>();
+        if (j.contains("verifyWrite")) entry.verifyWrite = j["verifyWrite"].get<bool>();
         if (j.contains("parseConfig")) entry.parseConfig = JsonToParseConfig(j["parseConfig"]);
         if (j.contains("data")) entry.data = j["data"].get<std::vector<uint8_t>>();
         return entry;
@@ -122,6 +557,8 @@ namespace I2CDebugger {
         j["buttonName"] = entry.buttonName;
         j["overrideSlaveAddr"] = entry.overrideSlaveAddr;
         j["slaveAddress"] = entry.slaveAddress;
+        j["writeMask"] = entry.writeMask;
+        j["verifyWrite"] = entry.verifyWrite;
         j["parseConfig"] = ParseConfigToJson(entry.parseConfig);
         j["plotEnabled"] = entry.plotEnabled;
 
@@ -141,6 +578,8 @@ namespace I2CDebugger {
         if (j.contains("buttonName")) entry.buttonName = j["buttonName"].get<std::string>();
         if (j.contains("overrideSlaveAddr")) entry.overrideSlaveAddr = j["overrideSlaveAddr"].get<bool>();
         if (j.contains("slaveAddress")) entry.slaveAddress = j["slaveAddress"].get<uint8_t>();
+        if (j.contains("writeMask")) entry.writeMask = j["writeMask"].get<uint32_t>();
+        if (j.contains("verifyWrite")) entry.verifyWrite = j["verifyWrite"].get<bool>();
         if (j.contains("parseConfig")) entry.parseConfig = JsonToParseConfig(j["parseConfig"]);
         if (j.contains("plotEnabled")) entry.plotEnabled = j["plotEnabled"].get<bool>();
         if (j.contains("data")) entry.data = j["data"].get<std::vector<uint8_t>>();
@@ -156,6 +595,13 @@ namespace I2CDebugger {
         j["interval"] = group.interval;
         j["logConfig"] = DataLogConfigToJson(group.logConfig);
 
+        // 条目数提示，供流式加载预先 reserve
+        j["entryCounts"] = {
+            group.registerEntries.size(),
+            group.singleTriggerEntries.size(),
+            group.periodicTriggerEntries.size()
+        };
+
         j["registerEntries"] = json::array();
         for (const auto& entry : group.registerEntries) {
             j["registerEntries"].push_back(RegisterEntryToJson(entry));
@@ -256,19 +702,31 @@ namespace I2CDebugger {
 
     // ============== Table 数据序列化 ==============
 
-    json ConfigurationService::TableDataToJson(const I2CTableAppData& data) {
+    json ConfigurationService::TableDataToJson(const I2CTableAppData& data, bool withGroups) {
         json j;
         j["baudRate"] = data.baudRate;
         j["currentGroupIndex"] = data.currentGroupIndex;
+        j["commandGroupCount"] = data.commandGroups.size();
 
         j["commandGroups"] = json::array();
-        for (const auto& group : data.commandGroups) {
-            j["commandGroups"].push_back(CommandGroupToJson(group));
+        if (withGroups) {
+            for (const auto& group : data.commandGroups) {
+                j["commandGroups"].push_back(CommandGroupToJson(group));
+            }
         }
 
         return j;
     }
 
+    json ConfigurationService::GlobalConfigToJson(const I2CSimpleAppData& simpleData,
+        const I2CTableAppData& tableData, bool withGroups) {
+        json j;
+        j["version"] = "1.0";
+        j["simpleData"] = SimpleDataToJson(simpleData);
+        j["tableData"] = TableDataToJson(tableData, withGroups);
+        return j;
+    }
+
     void ConfigurationService::JsonToTableData(const json& j, I2CTableAppData& data) {
         if (j.contains("baudRate")) data.baudRate = j["baudRate"].get<int>();
         if (j.contains("currentGroupIndex")) data.currentGroupIndex = j["currentGroupIndex"].get<int>();
@@ -298,24 +756,206 @@ namespace I2CDebugger {
         const I2CTableAppData& tableData,
         const std::string& filePath)
     {
+        // 与后台保存共用同一份片段缓存和目标文件，先等后台任务结束
+        WaitForPendingSave();
+
+        std::unique_ptr<SaveJob> job = BuildSaveJob(simpleData, tableData, filePath);
+        ConfigSaveStatus status = GetSaveStatus();
+        bool ok = WriteSaveJob(*job, status);
+        if (!ok) {
+            m_lastError = status.lastError;
+        }
+
+        std::lock_guard<std::mutex> lock(m_saveMutex);
+        status.completedCount = m_saveStatus.completedCount + 1;
+        status.pending = false;
+        m_saveStatus = status;
+        return ok;
+    }
+
+    void ConfigurationService::SaveGlobalConfigurationAsync(
+        const I2CSimpleAppData& simpleData,
+        const I2CTableAppData& tableData,
+        const std::string& filePath)
+    {
+        std::unique_ptr<SaveJob> job = BuildSaveJob(simpleData, tableData, filePath);
+
+        std::lock_guard<std::mutex> lock(m_saveMutex);
+        m_pendingSave = std::move(job);
+        if (!m_saveThread.joinable()) {
+            m_saveThread = std::thread(&ConfigurationService::SaveWorker, this);
+        }
+        m_saveCv.notify_all();
+    }
+
+    void ConfigurationService::WaitForPendingSave() {
+        std::unique_lock<std::mutex> lock(m_saveMutex);
+        m_saveCv.wait(lock, [this] { return !m_pendingSave && !m_saveBusy; });
+    }
+
+    ConfigSaveStatus ConfigurationService::GetSaveStatus() const {
+        std::lock_guard<std::mutex> lock(m_saveMutex);
+        ConfigSaveStatus status = m_saveStatus;
+        status.pending = m_pendingSave != nullptr || m_saveBusy;
+        return status;
+    }
+
+    ConfigurationService::~ConfigurationService() {
+        {
+            std::lock_guard<std::mutex> lock(m_saveMutex);
+            m_saveStop = true;
+        }
+        m_saveCv.notify_all();
+        if (m_saveThread.joinable()) {
+            m_saveThread.join();
+        }
+    }
+
+    std::unique_ptr<ConfigurationService::SaveJob> ConfigurationService::BuildSaveJob(
+        const I2CSimpleAppData& simpleData,
+        const I2CTableAppData& tableData,
+        const std::string& filePath)
+    {
+        std::unique_ptr<SaveJob> job(new SaveJob());
+        job->requestTime = std::chrono::steady_clock::now();
+        job->filePath = filePath;
+        job->envelope = GlobalConfigToJson(simpleData, tableData, false).dump(4);
+        job->writeBinaryCache = m_binaryCacheEnabled;
+        if (job->writeBinaryCache) {
+            job->cacheHeader = ConfigBinaryCache::MakeHeaderData(simpleData, tableData);
+        }
+
+        job->groups.resize(tableData.commandGroups.size());
+        {
+            std::lock_guard<std::mutex> lock(m_fragmentMutex);
+            for (size_t i = 0; i < tableData.commandGroups.size(); ++i) {
+                const CommandGroup& group = tableData.commandGroups[i];
+                GroupSlot& slot = job->groups[i];
+                slot.id = group.id;
+                slot.hash = HashCommandGroup(group);
+
+                auto it = m_fragments.find(group.id);
+                if (it != m_fragments.end() && it->second.hash == slot.hash &&
+                    (it->second.binary || !job->writeBinaryCache)) {
+                    slot.fragment = it->second.text;
+                    slot.binary = it->second.binary;
+                }
+                else {
+                    slot.snapshot.reset(new CommandGroup(group));
+                }
+            }
+        }
+
+        job->snapshotMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - job->requestTime).count();
+        return job;
+    }
+
+    bool ConfigurationService::WriteSaveJob(SaveJob& job, ConfigSaveStatus& status) {
+        auto start = std::chrono::steady_clock::now();
+        status.snapshotMs = job.snapshotMs;
+        status.groupsWritten = 0;
+        status.groupsReused = 0;
+
         try {
-            json j;
-            j["version"] = "1.0";
-            j["simpleData"] = SimpleDataToJson(simpleData);
-            j["tableData"] = TableDataToJson(tableData);
+            // 外壳由 GlobalConfigToJson 生成，只把各组片段拼进其中的空 commandGroups 数组，
+            // 与整体序列化 dump(4) 的结果逐字节一致
+            std::unordered_map<uint32_t, GroupFragment> fragments;
+            size_t groupBytes = 0;
+            for (GroupSlot& slot : job.groups) {
+                if (!slot.fragment) {
+                    slot.fragment = std::make_shared<const std::string>(
+                        IndentJson(CommandGroupToJson(*slot.snapshot).dump(4), 12));
+                    if (job.writeBinaryCache) {
+                        slot.binary = ConfigBinaryCache::EncodeGroup(*slot.snapshot);
+                    }
+                    slot.snapshot.reset();
+                    status.groupsWritten++;
+                }
+                else {
+                    status.groupsReused++;
+                }
+                groupBytes += slot.fragment->size() + 16;
+                fragments[slot.id] = GroupFragment{ slot.hash, slot.fragment, slot.binary };
+            }
 
-            std::ofstream file(filePath);
-            if (!file.is_open()) {
-                m_lastError = "无法打开文件: " + filePath;
-                return false;
+            // 字符串值里的换行会被转义，带缩进的这一行只可能是 tableData 下的键
+            static const char kGroupsKey[] = "\n        \"commandGroups\": []";
+            size_t splice = job.envelope.find(kGroupsKey);
+            if (splice == std::string::npos) {
+                throw std::runtime_error("配置外壳缺少 commandGroups");
             }
+            splice += sizeof(kGroupsKey) - 3;   // 指向 "[]"
+
+            std::string out;
+            out.reserve(groupBytes + job.envelope.size() + 16);
+            out.append(job.envelope, 0, splice);
+            out += "[";
+            for (size_t i = 0; i < job.groups.size(); ++i) {
+                out += (i == 0) ? "\n            " : ",\n            ";
+                out += *job.groups[i].fragment;
+            }
+            out += job.groups.empty() ? "]" : "\n        ]";
+            out.append(job.envelope, splice + 2, std::string::npos);
+            out += "\n";
+
+            std::string error;
+            if (!WriteFileAtomically(job.filePath, out, error)) {
+                status.lastSuccess = false;
+                status.lastError = error;
+            }
+            else {
+                status.lastSuccess = true;
+                status.lastError.clear();
+                status.fileBytes = out.size();
+
+                // 缓存记录刚写出的 JSON 的大小和修改时间；缓存写失败不影响保存结果，下次加载回退到 JSON
+                status.binaryCacheWritten = false;
+                ConfigFileStamp stamp;
+                if (job.writeBinaryCache && ConfigBinaryCache::GetFileStamp(job.filePath, stamp)) {
+                    std::vector<std::shared_ptr<const std::string>> blocks;
+                    blocks.reserve(job.groups.size());
+                    for (const GroupSlot& slot : job.groups) blocks.push_back(slot.binary);
+                    status.binaryCacheWritten = ConfigBinaryCache::Write(
+                        ConfigBinaryCache::GetCachePath(job.filePath), stamp, job.cacheHeader, blocks);
+                }
 
-            file << std::setw(4) << j << std::endl;
-            return true;
+                // 只保留当前存在的命令组，删除的组不再占用缓存
+                std::lock_guard<std::mutex> lock(m_fragmentMutex);
+                m_fragments.swap(fragments);
+            }
         }
         catch (const std::exception& e) {
-            m_lastError = std::string("保存失败: ") + e.what();
-            return false;
+            status.lastSuccess = false;
+            status.lastError = std::string("保存失败: ") + e.what();
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        status.writeMs = std::chrono::duration<double, std::milli>(end - start).count();
+        status.latencyMs = std::chrono::duration<double, std::milli>(end - job.requestTime).count();
+        return status.lastSuccess;
+    }
+
+    void ConfigurationService::SaveWorker() {
+        std::unique_lock<std::mutex> lock(m_saveMutex);
+        while (true) {
+            m_saveCv.wait(lock, [this] { return m_pendingSave || m_saveStop; });
+            // 退出前仍把最后一次排队的保存写完
+            if (!m_pendingSave) break;
+
+            std::unique_ptr<SaveJob> job = std::move(m_pendingSave);
+            ConfigSaveStatus status = m_saveStatus;
+            m_saveBusy = true;
+            lock.unlock();
+
+            WriteSaveJob(*job, status);
+            job.reset();
+
+            lock.lock();
+            status.completedCount = m_saveStatus.completedCount + 1;
+            m_saveStatus = status;
+            m_saveBusy = false;
+            m_saveCv.notify_all();
         }
     }
 
@@ -324,25 +964,45 @@ namespace I2CDebugger {
         I2CTableAppData& tableData,
         const std::string& filePath)
     {
+        // 避免读到尚未写完的旧文件，随后又被排队中的旧快照覆盖
+        WaitForPendingSave();
+
+        m_lastLoadFromCache = false;
         try {
-            std::ifstream file(filePath);
-            if (!file.is_open()) {
+            ConfigFileStamp stamp;
+            if (!ConfigBinaryCache::GetFileStamp(filePath, stamp)) {
                 // 文件不存在不算错误，使用默认配置
                 m_lastError = "配置文件不存在，使用默认配置";
                 return true;
             }
 
-            json j;
-            file >> j;
+            std::string cachePath = ConfigBinaryCache::GetCachePath(filePath);
+            if (m_binaryCacheEnabled && ConfigBinaryCache::Load(cachePath, stamp, simpleData, tableData)) {
+                m_lastLoadFromCache = true;
+                return true;
+            }
 
-            if (j.contains("simpleData")) {
-                JsonToSimpleData(j["simpleData"], simpleData);
+            std::string text;
+            if (!ReadWholeFile(filePath, text)) {
+                m_lastError = "无法打开文件: " + filePath;
+                return false;
             }
 
-            if (j.contains("tableData")) {
-                JsonToTableData(j["tableData"], tableData);
+            bool complete = false;
+            if (!LoadGlobalConfigurationFromText(text, simpleData, tableData, &complete)) {
+                return false;
             }
 
+            // 缓存缺失或过期：用刚加载的数据重建，时间戳取读取前的值，读取期间文件若被改动下次会再次失效
+            if (m_binaryCacheEnabled && complete) {
+                std::vector<std::shared_ptr<const std::string>> blocks;
+                blocks.reserve(tableData.commandGroups.size());
+                for (const auto& group : tableData.commandGroups) {
+                    blocks.push_back(ConfigBinaryCache::EncodeGroup(group));
+                }
+                ConfigBinaryCache::Write(cachePath, stamp,
+                    ConfigBinaryCache::MakeHeaderData(simpleData, tableData), blocks);
+            }
             return true;
         }
         catch (const std::exception& e) {
@@ -351,6 +1011,162 @@ namespace I2CDebugger {
         }
     }
 
+    bool ConfigurationService::LoadGlobalConfigurationFromText(
+        const std::string& text,
+        I2CSimpleAppData& simpleData,
+        I2CTableAppData& tableData,
+        bool* complete)
+    {
+        ConfigSaxHandler handler(text.size());
+        if (!json::sax_parse(text, &handler)) {
+            m_lastError = "加载失败: " + handler.errorMessage;
+            return false;
+        }
+
+        ConfigSaxHandler::Result& r = handler.result;
+        if (complete) {
+            *complete = r.hasSimpleData && r.hasTableData && r.hasCommandGroups;
+        }
+        if (r.hasSimpleData) {
+            if (r.hasBaudRate) simpleData.baudRate = r.simpleBaudRate;
+            if (r.hasInput[0]) CopyInput(simpleData.slaveAddrInput, sizeof(simpleData.slaveAddrInput), r.inputs[0]);
+            if (r.hasInput[1]) CopyInput(simpleData.regAddrInput, sizeof(simpleData.regAddrInput), r.inputs[1]);
+            if (r.hasInput[2]) CopyInput(simpleData.lengthInput, sizeof(simpleData.lengthInput), r.inputs[2]);
+            if (r.hasInput[3]) CopyInput(simpleData.writeDataInput, sizeof(simpleData.writeDataInput), r.inputs[3]);
+        }
+
+        if (r.hasTableData) {
+            if (r.hasTableBaudRate) tableData.baudRate = r.tableBaudRate;
+            if (r.hasCurrentGroupIndex) tableData.currentGroupIndex = r.currentGroupIndex;
+            if (r.hasCommandGroups) tableData.commandGroups = std::move(r.groups);
+
+            // 确保至少有一个命令组
+            if (tableData.commandGroups.empty()) {
+                tableData.commandGroups.push_back(CommandGroup());
+            }
+
+            // 确保索引有效
+            if (tableData.currentGroupIndex >= static_cast<int>(tableData.commandGroups.size())) {
+                tableData.currentGroupIndex = 0;
+            }
+        }
+
+        return true;
+    }
+
+    // ============== 加载性能测试 ==============
+
+    ConfigLoadBenchmarkResult ConfigurationService::RunLoadBenchmark(int entryCount) {
+        using Clock = std::chrono::steady_clock;
+
+        ConfigLoadBenchmarkResult r;
+        if (entryCount < 100) entryCount = 100;
+
+        // 合成配置：每组 1000 条，按 2:1:1 分给寄存器表/单次/周期条目，模拟整套 PMBus 器件
+        const int entriesPerGroup = 1000;
+        I2CSimpleAppData simpleData;
+        I2CTableAppData tableData;
+        for (int remaining = entryCount; remaining > 0; remaining -= entriesPerGroup) {
+            int count = remaining < entriesPerGroup ? remaining : entriesPerGroup;
+            CommandGroup group;
+            group.name = "PMBus Page " + std::to_string(tableData.commandGroups.size());
+            group.logConfig.filePath = group.name + ".csv";
+            for (int i = 0; i < count; ++i) {
+                uint8_t reg = static_cast<uint8_t>(i);
+                switch (i % 4) {
+                case 0:
+                case 1: {
+                    RegisterEntry e;
+                    e.regAddress = reg;
+                    e.length = 2;
+                    e.description = "READ_VOUT channel " + std::to_string(i);
+                    e.parseConfig.enabled = true;
+                    e.parseConfig.readFormula = "(b1 << 8 | b0) * 0.001";
+                    group.registerEntries.push_back(e);
+                    break;
+                }
+                case 2: {
+                    SingleTriggerEntry e;
+                    e.regAddress = reg;
+                    e.type = CommandType::Write;
+                    e.data = { 0x01, 0x02 };
+                    e.buttonName = "OPERATION " + std::to_string(i);
+                    group.singleTriggerEntries.push_back(e);
+                    break;
+                }
+                default: {
+                    PeriodicTriggerEntry e;
+                    e.regAddress = reg;
+                    e.length = 2;
+                    e.buttonName = "READ_IOUT " + std::to_string(i);
+                    e.plotEnabled = true;
+                    e.parseConfig.enabled = true;
+                    e.parseConfig.readFormula = "w0 * 0.01";
+                    group.periodicTriggerEntries.push_back(e);
+                    break;
+                }
+                }
+            }
+            tableData.commandGroups.push_back(std::move(group));
+        }
+
+        ConfigurationService service;
+        std::string text = service.GlobalConfigToJson(simpleData, tableData).dump(4);
+
+        r.entryCount = entryCount;
+        r.groupCount = static_cast<int>(tableData.commandGroups.size());
+        r.fileBytes = text.size();
+
+        // 旧路径：构建 DOM 后逐字段 contains()/[] 查找
+        {
+            I2CSimpleAppData s;
+            I2CTableAppData t;
+            auto start = Clock::now();
+            json dom = json::parse(text);
+            service.JsonToSimpleData(dom["simpleData"], s);
+            service.JsonToTableData(dom["tableData"], t);
+            r.domLoadMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        // 流式加载
+        {
+            I2CSimpleAppData s;
+            I2CTableAppData t;
+            auto start = Clock::now();
+            r.success = service.LoadGlobalConfigurationFromText(text, s, t);
+            r.saxLoadMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            size_t loaded = 0;
+            for (const auto& g : t.commandGroups) {
+                loaded += g.registerEntries.size() + g.singleTriggerEntries.size() + g.periodicTriggerEntries.size();
+            }
+            r.success = r.success && loaded == static_cast<size_t>(entryCount);
+        }
+
+        // 二进制缓存：写到临时文件后映射读取，测完删除
+        {
+            std::string cachePath = "i2c_config_benchmark.cache";
+            ConfigFileStamp stamp;
+            stamp.size = text.size();
+            std::vector<std::shared_ptr<const std::string>> blocks;
+            for (const auto& group : tableData.commandGroups) {
+                blocks.push_back(ConfigBinaryCache::EncodeGroup(group));
+                r.binaryBytes += blocks.back()->size();
+            }
+            if (ConfigBinaryCache::Write(cachePath, stamp, ConfigBinaryCache::MakeHeaderData(simpleData, tableData), blocks)) {
+                I2CSimpleAppData s;
+                I2CTableAppData t;
+                auto start = Clock::now();
+                bool ok = ConfigBinaryCache::Load(cachePath, stamp, s, t);
+                r.binaryLoadMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                r.success = r.success && ok && t.commandGroups.size() == tableData.commandGroups.size();
+                std::remove(cachePath.c_str());
+            }
+        }
+
+        return r;
+    }
+
     // ============== 命令组导出/导入 ==============
 
     bool ConfigurationService::ExportCommandGroup(
@@ -390,30 +1206,33 @@ namespace I2CDebugger {
         bool asNewGroup)
     {
         try {
-            std::ifstream file(filePath);
-            if (!file.is_open()) {
+            std::string text;
+            if (!ReadWholeFile(filePath, text)) {
                 m_lastError = "无法打开文件: " + filePath;
                 return false;
             }
 
-            json j;
-            file >> j;
+            ConfigSaxHandler handler(text.size());
+            if (!json::sax_parse(text, &handler)) {
+                m_lastError = "导入失败: " + handler.errorMessage;
+                return false;
+            }
 
-            if (!j.contains("group")) {
+            if (handler.result.hasTableData || handler.result.groups.size() != 1) {
                 m_lastError = "无效的命令组文件";
                 return false;
             }
 
-            CommandGroup group = JsonToCommandGroup(j["group"]);
+            CommandGroup& group = handler.result.groups.front();
 
             if (asNewGroup) {
-                data.commandGroups.push_back(group);
+                data.commandGroups.push_back(std::move(group));
                 data.currentGroupIndex = static_cast<int>(data.commandGroups.size()) - 1;
             }
             else {
                 if (data.currentGroupIndex >= 0 &&
                     data.currentGroupIndex < static_cast<int>(data.commandGroups.size())) {
-                    data.commandGroups[data.currentGroupIndex] = group;
+                    data.commandGroups[data.currentGroupIndex] = std::move(group);
                 }
             }
 
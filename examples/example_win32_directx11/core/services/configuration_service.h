@@ -2,16 +2,50 @@
 #include "../models/i2c_simple_app.h"
 #include "../models/i2c_table_app.h"
 #include "../models/i2c_command.h"
+#include "config_binary_cache.h"
 #include <string>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include <chrono>
 #include "core/nlohmann/json.hpp"
 
 namespace I2CDebugger {
 
+    // 配置加载性能测试结果
+    struct ConfigLoadBenchmarkResult {
+        int entryCount = 0;
+        int groupCount = 0;
+        size_t fileBytes = 0;
+        double domLoadMs = 0.0;     // 旧实现：DOM + 逐字段查找
+        double saxLoadMs = 0.0;     // 流式加载
+        double binaryLoadMs = 0.0;  // 二进制缓存（映射 + 解码）
+        size_t binaryBytes = 0;
+        bool success = false;       // 流式加载的条目数与生成数一致
+    };
+
+    // 全局配置保存状态（后台保存完成后更新）
+    struct ConfigSaveStatus {
+        bool pending = false;           // 有保存任务排队或正在写入
+        bool lastSuccess = true;
+        uint64_t completedCount = 0;
+        double snapshotMs = 0.0;        // UI 线程：计算内容哈希 + 复制有变更的命令组
+        double writeMs = 0.0;           // 后台线程：序列化 + 写临时文件 + 替换
+        double latencyMs = 0.0;         // 发起保存到文件替换完成
+        int groupsWritten = 0;          // 重新序列化的命令组
+        int groupsReused = 0;           // 内容未变，复用上次的序列化结果
+        size_t fileBytes = 0;
+        bool binaryCacheWritten = false;
+        std::string lastError;
+    };
+
     class ConfigurationService {
     public:
         ConfigurationService() = default;
-        ~ConfigurationService() = default;
+        ~ConfigurationService();
 
         // ========== 全局配置（同时保存 Simple 和 Table 数据）==========
         bool SaveGlobalConfiguration(
@@ -24,16 +58,91 @@ namespace I2CDebugger {
             I2CTableAppData& tableData,
             const std::string& filePath);
 
+        // 在调用线程上只做快照，序列化和写文件交给后台线程；
+        // 连续请求时未开始的旧任务被新快照覆盖
+        void SaveGlobalConfigurationAsync(
+            const I2CSimpleAppData& simpleData,
+            const I2CTableAppData& tableData,
+            const std::string& filePath);
+
+        // 等待排队和进行中的保存完成（退出前调用）
+        void WaitForPendingSave();
+
+        ConfigSaveStatus GetSaveStatus() const;
+
+        // 在 JSON 旁维护二进制缓存（默认开启）；JSON 的大小或修改时间变化后缓存自动失效
+        void SetBinaryCacheEnabled(bool enabled) { m_binaryCacheEnabled = enabled; }
+        bool IsBinaryCacheEnabled() const { return m_binaryCacheEnabled; }
+        bool WasLastLoadFromCache() const { return m_lastLoadFromCache; }
+
         // ========== 单个命令组导出/导入 ==========
         bool ExportCommandGroup(const I2CTableAppData& data, int groupIndex, const std::string& filePath);
         bool ImportCommandGroup(I2CTableAppData& data, const std::string& filePath, bool asNewGroup);
 
         std::string GetLastError() const { return m_lastError; }
 
+        // 生成 entryCount 条目的合成配置，比较 DOM 与流式加载耗时
+        static ConfigLoadBenchmarkResult RunLoadBenchmark(int entryCount);
+
     private:
         std::string m_lastError;
 
-        // JSON 序列化辅助方法
+        // ========== 保存 ==========
+        // 命令组的快照：内容哈希与上次写出时一致则直接复用缓存的 JSON 片段，否则复制一份待序列化
+        struct GroupSlot {
+            uint32_t id = 0;
+            uint64_t hash = 0;
+            std::shared_ptr<const std::string> fragment;
+            std::shared_ptr<const std::string> binary;
+            std::unique_ptr<CommandGroup> snapshot;
+        };
+
+        struct SaveJob {
+            std::string filePath;
+            std::string envelope;       // GlobalConfigToJson(..., false).dump(4)，命令组片段在写出时拼入
+            bool writeBinaryCache = false;
+            ConfigCacheHeaderData cacheHeader;
+            std::vector<GroupSlot> groups;
+            std::chrono::steady_clock::time_point requestTime;
+            double snapshotMs = 0.0;
+        };
+
+        struct GroupFragment {
+            uint64_t hash = 0;
+            std::shared_ptr<const std::string> text;   // 已按 commandGroups 数组内的缩进排好
+            std::shared_ptr<const std::string> binary; // 二进制缓存中的组块
+        };
+
+        std::unique_ptr<SaveJob> BuildSaveJob(
+            const I2CSimpleAppData& simpleData,
+            const I2CTableAppData& tableData,
+            const std::string& filePath);
+        bool WriteSaveJob(SaveJob& job, ConfigSaveStatus& status);
+        void SaveWorker();
+
+        std::thread m_saveThread;                   // 首次异步保存时启动
+        mutable std::mutex m_saveMutex;
+        std::condition_variable m_saveCv;
+        bool m_saveStop = false;
+        bool m_saveBusy = false;
+        std::unique_ptr<SaveJob> m_pendingSave;
+        ConfigSaveStatus m_saveStatus;
+
+        std::mutex m_fragmentMutex;
+        std::unordered_map<uint32_t, GroupFragment> m_fragments;   // 组 ID -> 上次写出的片段
+
+        // 流式解析整份配置文本，成功后才写入 simpleData / tableData
+        // complete 返回文件是否包含完整的 simpleData 与命令组列表（只有完整的结果才能写入缓存）
+        bool LoadGlobalConfigurationFromText(
+            const std::string& text,
+            I2CSimpleAppData& simpleData,
+            I2CTableAppData& tableData,
+            bool* complete = nullptr);
+
+        bool m_binaryCacheEnabled = true;
+        bool m_lastLoadFromCache = false;
+
+        // JSON 序列化辅助方法（加载已改为流式解析，Json 到结构体的转换仅保留给性能对比）
         nlohmann::json ParseConfigToJson(const ParseConfig& config);
         ParseConfig JsonToParseConfig(const nlohmann::json& j);
 
@@ -56,8 +165,12 @@ namespace I2CDebugger {
         nlohmann::json SimpleDataToJson(const I2CSimpleAppData& data);
         void JsonToSimpleData(const nlohmann::json& j, I2CSimpleAppData& data);
 
-        // Table 数据序列化
-        nlohmann::json TableDataToJson(const I2CTableAppData& data);
+        // Table 数据序列化；withGroups 为 false 时 commandGroups 为空数组，其余字段照常输出
+        nlohmann::json TableDataToJson(const I2CTableAppData& data, bool withGroups = true);
         void JsonToTableData(const nlohmann::json& j, I2CTableAppData& data);
+
+        // 整份配置文件的根对象，整体序列化与分段保存共用
+        nlohmann::json GlobalConfigToJson(const I2CSimpleAppData& simpleData, const I2CTableAppData& tableData,
+            bool withGroups = true);
     };
 }
@@ -17,7 +17,7 @@ namespace I2CDebugger {
     struct PeriodicDataRow {
         std::chrono::system_clock::time_point timestamp;
         std::vector<std::pair<uint8_t, std::vector<uint8_t>>> rawDataList;  // <regAddr, rawData>
-        std::vector<std::pair<std::string, double>> parsedDataList;          // <alias, parsedValue>
+        std::vector<std::pair<InternedString, double>> parsedDataList;       // <alias, parsedValue>
     };
 
     class DataLogger {
@@ -56,7 +56,7 @@ namespace I2CDebugger {
         // 表头信息（记录哪些列需要输出）
         struct ColumnInfo {
             uint8_t regAddress;
-            std::string alias;
+            InternedString alias;
             bool hasAlias;
         };
         std::vector<ColumnInfo> m_columns;
@@ -1,4 +1,7 @@
 ﻿#include "expression_parser.h"
+#include "formula_compiler.h"
+#include "profiler.h"
+#include <chrono>
 
 // 禁用一些警告，ExprTK 头文件较大
 #ifdef _MSC_VER
@@ -14,13 +17,52 @@
 
 namespace I2CDebugger {
 
+    // 缓存上限，超出后整体清空（公式通常只有几十条）
+    static constexpr size_t MAX_CACHED_FORMULAS = 256;
+
+    // 输入停止多久后开始后台编译
+    static constexpr auto VALIDATION_DEBOUNCE = std::chrono::milliseconds(300);
+
+    struct CachedFormula {
+        bool valid = false;
+        bool useBytecode = false;
+        CompiledFormula bytecode;
+        std::unique_ptr<exprtk::expression<double>> expression;    // 子集外的公式
+        std::string errorMsg;
+    };
+
     ExpressionParser::ExpressionParser() {
         // 初始化变量数组
         for (int i = 0; i < 32; ++i) m_bytes[i] = 0;
         for (int i = 0; i < 16; ++i) m_words[i] = 0;
+
+        // 读取公式：b0-b31、w0-w15
+        m_readSymbols = std::make_unique<exprtk::symbol_table<double>>();
+        for (int i = 0; i < 32; ++i) {
+            m_readSymbols->add_variable("b" + std::to_string(i), m_bytes[i]);
+        }
+        for (int i = 0; i < 16; ++i) {
+            m_readSymbols->add_variable("w" + std::to_string(i), m_words[i]);
+        }
+        m_readSymbols->add_constants();
+
+        // 写入公式：value、v
+        m_writeSymbols = std::make_unique<exprtk::symbol_table<double>>();
+        m_writeSymbols->add_variable("value", m_value);
+        m_writeSymbols->add_variable("v", m_value);  // 简写
+        m_writeSymbols->add_constants();
     }
 
-    ExpressionParser::~ExpressionParser() = default;
+    ExpressionParser::~ExpressionParser() {
+        {
+            std::lock_guard<std::mutex> lock(m_validationMutex);
+            m_validationStop = true;
+        }
+        m_validationCv.notify_all();
+        if (m_validationThread.joinable()) {
+            m_validationThread.join();
+        }
+    }
 
     void ExpressionParser::SetByteVariables(const std::vector<uint8_t>& rawData) {
         // 清零
@@ -38,54 +80,200 @@ namespace I2CDebugger {
         }
     }
 
-    ParseResult ExpressionParser::EvaluateReadFormula(const std::string& formula,
-        const std::vector<uint8_t>& rawData) {
-        ParseResult result;
+    const CachedFormula& ExpressionParser::GetCompiled(const std::string& formula, bool isWrite) {
+        auto& cache = isWrite ? m_writeCache : m_readCache;
+        auto it = cache.find(formula);
+        if (it != cache.end()) {
+            return *it->second;
+        }
+
+        if (cache.size() >= MAX_CACHED_FORMULAS) {
+            std::lock_guard<std::mutex> lock(m_compileMutex);
+            cache.clear();
+        }
+
+        // 编辑弹窗里已在后台编译过的公式直接取用
+        std::unique_ptr<CachedFormula> cached = TakeValidatedArtifact(formula, isWrite);
+        if (!cached) {
+            cached = CompileFormula(formula, isWrite);
+        }
+
+        const CachedFormula& ref = *cached;
+        cache.emplace(formula, std::move(cached));
+        return ref;
+    }
+
+    std::unique_ptr<CachedFormula> ExpressionParser::CompileFormula(const std::string& formula, bool isWrite) {
+        auto cached = std::make_unique<CachedFormula>();
+        if (FormulaCompiler::Compile(formula, isWrite ? FormulaKind::Write : FormulaKind::Read, cached->bytecode)) {
+            cached->useBytecode = true;
+            cached->valid = true;
+            return cached;
+        }
+
+        std::lock_guard<std::mutex> lock(m_compileMutex);
+        cached->expression = std::make_unique<exprtk::expression<double>>();
+        cached->expression->register_symbol_table(isWrite ? *m_writeSymbols : *m_readSymbols);
 
+        exprtk::parser<double> parser;
+        if (parser.compile(formula, *cached->expression)) {
+            cached->valid = true;
+        }
+        else {
+            cached->errorMsg = parser.error();
+            cached->expression.reset();
+        }
+        return cached;
+    }
+
+    // ========== 后台校验 ==========
+
+    size_t ExpressionParser::FormulaKey(const std::string& formula, bool isWrite) {
+        size_t h = std::hash<std::string>()(formula);
+        return isWrite ? (h ^ 0x9e3779b97f4a7c15ull) : h;
+    }
+
+    FormulaCheckResult ExpressionParser::CheckFormulaAsync(const std::string& formula, bool isWrite) {
+        FormulaCheckResult result;
         if (formula.empty()) {
-            result.errorMsg = "公式为空";
             return result;
         }
 
-        if (rawData.empty()) {
-            result.errorMsg = "数据为空";
+        size_t key = FormulaKey(formula, isWrite);
+        {
+            std::lock_guard<std::mutex> lock(m_validationMutex);
+            auto it = m_validated.find(key);
+            if (it != m_validated.end() && it->second.isWrite == isWrite && it->second.formula == formula) {
+                return it->second.result;
+            }
+        }
+
+        // 字节码子集编译只需几微秒，直接在当前线程完成
+        auto cached = std::make_unique<CachedFormula>();
+        if (FormulaCompiler::Compile(formula, isWrite ? FormulaKind::Write : FormulaKind::Read, cached->bytecode)) {
+            cached->useBytecode = true;
+            cached->valid = true;
+            StoreValidation(formula, isWrite, std::move(cached));
+            result.state = FormulaCheckState::Valid;
+            result.bytecode = true;
             return result;
         }
 
-        // 设置字节变量
-        SetByteVariables(rawData);
+        // 其余交给后台线程；公式变化时重新计时（防抖）
+        {
+            std::lock_guard<std::mutex> lock(m_validationMutex);
+            ValidationRequest& request = m_pendingValidation[isWrite ? 1 : 0];
+            if (!request.active || request.formula != formula) {
+                request.active = true;
+                request.formula = formula;
+                request.submitTime = std::chrono::steady_clock::now();
+            }
+            if (!m_validationThread.joinable()) {
+                m_validationThread = std::thread(&ExpressionParser::ValidationWorker, this);
+            }
+        }
+        m_validationCv.notify_one();
 
-        // 创建符号表
-        exprtk::symbol_table<double> symbolTable;
+        result.state = FormulaCheckState::Pending;
+        return result;
+    }
 
-        // 注册字节变量 b0-b31
-        for (int i = 0; i < 32; ++i) {
-            std::string varName = "b" + std::to_string(i);
-            symbolTable.add_variable(varName, m_bytes[i]);
+    void ExpressionParser::StoreValidation(const std::string& formula, bool isWrite, std::unique_ptr<CachedFormula> artifact) {
+        std::lock_guard<std::mutex> lock(m_validationMutex);
+        if (m_validated.size() >= MAX_CACHED_FORMULAS) {
+            std::lock_guard<std::mutex> compileLock(m_compileMutex);
+            m_validated.clear();
         }
 
-        // 注册小端字变量 w0-w15
-        for (int i = 0; i < 16; ++i) {
-            std::string varName = "w" + std::to_string(i);
-            symbolTable.add_variable(varName, m_words[i]);
+        ValidationEntry& entry = m_validated[FormulaKey(formula, isWrite)];
+        entry.formula = formula;
+        entry.isWrite = isWrite;
+        entry.result.state = artifact->valid ? FormulaCheckState::Valid : FormulaCheckState::Invalid;
+        entry.result.bytecode = artifact->useBytecode;
+        entry.result.errorMsg = artifact->errorMsg;
+        {
+            std::lock_guard<std::mutex> compileLock(m_compileMutex);
+            entry.artifact = std::move(artifact);
         }
+    }
 
-        // 添加常用常量和函数
-        symbolTable.add_constants();
+    std::unique_ptr<CachedFormula> ExpressionParser::TakeValidatedArtifact(const std::string& formula, bool isWrite) {
+        std::lock_guard<std::mutex> lock(m_validationMutex);
+        auto it = m_validated.find(FormulaKey(formula, isWrite));
+        if (it == m_validated.end() || it->second.isWrite != isWrite || it->second.formula != formula) {
+            return nullptr;
+        }
+        return std::move(it->second.artifact);
+    }
 
-        // 创建表达式
-        exprtk::expression<double> expression;
-        expression.register_symbol_table(symbolTable);
+    void ExpressionParser::ValidationWorker() {
+        std::unique_lock<std::mutex> lock(m_validationMutex);
+        while (!m_validationStop) {
+            // 找到已过防抖时间的请求
+            auto now = std::chrono::steady_clock::now();
+            auto nextDeadline = std::chrono::steady_clock::time_point::max();
+            int ready = -1;
+            for (int i = 0; i < 2; ++i) {
+                const ValidationRequest& request = m_pendingValidation[i];
+                if (!request.active) continue;
+                auto deadline = request.submitTime + VALIDATION_DEBOUNCE;
+                if (deadline <= now) {
+                    ready = i;
+                    break;
+                }
+                if (deadline < nextDeadline) nextDeadline = deadline;
+            }
 
-        // 解析公式
-        exprtk::parser<double> parser;
-        if (!parser.compile(formula, expression)) {
-            result.errorMsg = "公式解析错误: " + parser.error();
+            if (ready < 0) {
+                if (nextDeadline == std::chrono::steady_clock::time_point::max()) {
+                    m_validationCv.wait(lock);
+                }
+                else {
+                    m_validationCv.wait_until(lock, nextDeadline);
+                }
+                continue;
+            }
+
+            std::string formula = std::move(m_pendingValidation[ready].formula);
+            bool isWrite = (ready == 1);
+            m_pendingValidation[ready].active = false;
+
+            lock.unlock();
+            std::unique_ptr<CachedFormula> artifact = CompileFormula(formula, isWrite);
+            StoreValidation(formula, isWrite, std::move(artifact));
+            lock.lock();
+        }
+    }
+
+    ParseResult ExpressionParser::EvaluateReadFormula(const std::string& formula,
+        const std::vector<uint8_t>& rawData) {
+        ProfileZone zone("ExpressionParser::EvaluateReadFormula");
+        ParseResult result;
+
+        if (formula.empty()) {
+            result.errorMsg = "公式为空";
             return result;
         }
 
-        // 计算结果
-        result.value = expression.value();
+        if (rawData.empty()) {
+            result.errorMsg = "数据为空";
+            return result;
+        }
+
+        const CachedFormula& cached = GetCompiled(formula, false);
+        if (!cached.valid) {
+            result.errorMsg = "公式解析错误: " + cached.errorMsg;
+            return result;
+        }
+
+        // 计算结果（字节码直接读取原始字节，只访问公式引用到的变量）
+        if (cached.useBytecode) {
+            result.value = cached.bytecode.Evaluate(rawData.data(), rawData.size(), 0.0);
+        }
+        else {
+            SetByteVariables(rawData);
+            result.value = cached.expression->value();
+        }
         result.success = true;
         return result;
     }
@@ -95,6 +283,7 @@ namespace I2CDebugger {
         size_t byteCount,
         bool& success,
         std::string& errorMsg) {
+        ProfileZone zone("ExpressionParser::EvaluateWriteFormula");
         std::vector<uint8_t> result;
         success = false;
 
@@ -108,26 +297,21 @@ namespace I2CDebugger {
             return result;
         }
 
-        // 创建符号表
-        exprtk::symbol_table<double> symbolTable;
-        m_value = value;
-        symbolTable.add_variable("value", m_value);
-        symbolTable.add_variable("v", m_value);  // 简写
-        symbolTable.add_constants();
-
-        // 创建表达式
-        exprtk::expression<double> expression;
-        expression.register_symbol_table(symbolTable);
-
-        // 解析公式
-        exprtk::parser<double> parser;
-        if (!parser.compile(formula, expression)) {
-            errorMsg = "公式解析错误: " + parser.error();
+        const CachedFormula& cached = GetCompiled(formula, true);
+        if (!cached.valid) {
+            errorMsg = "公式解析错误: " + cached.errorMsg;
             return result;
         }
 
         // 计算结果
-        double rawValue = expression.value();
+        double rawValue;
+        if (cached.useBytecode) {
+            rawValue = cached.bytecode.Evaluate(nullptr, 0, value);
+        }
+        else {
+            m_value = value;
+            rawValue = cached.expression->value();
+        }
         int64_t intValue = static_cast<int64_t>(rawValue);
 
         // 转换为字节数组（小端序）
@@ -145,6 +329,12 @@ namespace I2CDebugger {
             return false;
         }
 
+        // 字节码子集内的公式无需再经过 ExprTK
+        CompiledFormula compiled;
+        if (FormulaCompiler::Compile(formula, FormulaKind::Any, compiled)) {
+            return true;
+        }
+
         // 创建符号表，添加所有可能的变量
         exprtk::symbol_table<double> symbolTable;
 
@@ -191,11 +381,92 @@ namespace I2CDebugger {
             "  b0 * 0.1              : 单字节乘系数\n"
             "  (b1 << 8 | b0) / 100  : 转换后除以100\n"
             "  b0 & 0x0F             : 取低4位\n"
+            "  (w0 & 0x8000) ? (w0 - 65536) : w0 : 有符号16位\n"
             "\n"
             "写入公式:\n"
             "  value                 : 直接使用输入值\n"
             "  value * 100           : 输入值乘以100\n"
-            "  value / 0.1           : 输入值除以0.1\n";
+            "  value / 0.1           : 输入值除以0.1\n"
+            "\n"
+            "=== 运算符 ===\n"
+            "  + - * / %  & | ~ << >>  == != < <= > >=  && || !  ?:\n"
+            "  与 C 语言一致（/ 为浮点除法），支持 0x 十六进制常量；\n"
+            "  其它 ExprTK 函数（abs、pow 等）同样可用\n";
+    }
+
+    std::vector<FormulaBenchmarkResult> ExpressionParser::RunBenchmark(int iterations) {
+        using Clock = std::chrono::steady_clock;
+
+        // 典型 PMBus 公式及其 ExprTK 等价写法（ExprTK 不支持 <<、| 和十六进制）
+        struct BenchmarkCase {
+            const char* formula;
+            const char* exprtkFormula;
+        };
+        static const BenchmarkCase cases[] = {
+            { "(b1 << 8) | b0",                                    "shl(b1, 8) + b0" },
+            { "b0 * 0.1",                                          "b0 * 0.1" },
+            { "(b1 << 8 | b0) / 100",                              "(shl(b1, 8) + b0) / 100" },
+            { "b0 & 0x0F",                                         "b0 % 16" },
+            { "(w0 & 0x8000) ? (w0 - 65536) * 0.01 : w0 * 0.01",   "(w0 >= 32768) ? (w0 - 65536) * 0.01 : w0 * 0.01" },
+        };
+
+        if (iterations < 100) iterations = 100;
+        int compileIterations = iterations / 100;
+
+        std::vector<FormulaBenchmarkResult> results;
+        std::vector<uint8_t> data = { 0x34, 0x12, 0x56, 0x80 };
+        volatile double sink = 0.0;
+
+        for (const auto& item : cases) {
+            FormulaBenchmarkResult r;
+            r.formula = item.formula;
+
+            // 字节码
+            CompiledFormula compiled;
+            r.compiled = FormulaCompiler::Compile(item.formula, FormulaKind::Read, compiled);
+            r.instructionCount = compiled.GetInstructionCount();
+            if (r.compiled) {
+                auto start = Clock::now();
+                for (int i = 0; i < iterations; ++i) {
+                    data[0] = static_cast<uint8_t>(i);
+                    sink = sink + compiled.Evaluate(data.data(), data.size(), 0.0);
+                }
+                r.bytecodeNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+            }
+
+            // ExprTK（表达式预编译，只刷新变量）
+            ExpressionParser parser;
+            exprtk::expression<double> expression;
+            expression.register_symbol_table(*parser.m_readSymbols);
+            exprtk::parser<double> exprtkParser;
+            if (exprtkParser.compile(item.exprtkFormula, expression)) {
+                auto start = Clock::now();
+                for (int i = 0; i < iterations; ++i) {
+                    data[0] = static_cast<uint8_t>(i);
+                    parser.SetByteVariables(data);
+                    sink = sink + expression.value();
+                }
+                r.exprtkCachedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+
+                // 旧实现：每次求值都重建符号表并编译
+                start = Clock::now();
+                for (int i = 0; i < compileIterations; ++i) {
+                    exprtk::symbol_table<double> symbolTable;
+                    for (int b = 0; b < 32; ++b) symbolTable.add_variable("b" + std::to_string(b), parser.m_bytes[b]);
+                    for (int w = 0; w < 16; ++w) symbolTable.add_variable("w" + std::to_string(w), parser.m_words[w]);
+                    symbolTable.add_constants();
+                    exprtk::expression<double> fresh;
+                    fresh.register_symbol_table(symbolTable);
+                    exprtk::parser<double> freshParser;
+                    freshParser.compile(item.exprtkFormula, fresh);
+                    sink = sink + fresh.value();
+                }
+                r.exprtkCompileNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / compileIterations;
+            }
+
+            results.push_back(r);
+        }
+        return results;
     }
 
 }
@@ -4,6 +4,11 @@
 #include <vector>
 #include <memory>
 #include <cstdint>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 // ExprTK 编译较慢，使用前向声明
 namespace exprtk {
@@ -21,6 +26,32 @@ namespace I2CDebugger {
         std::string errorMsg;
     };
 
+    // 公式性能测试结果（每次求值耗时，单位 ns）
+    struct FormulaBenchmarkResult {
+        std::string formula;
+        bool compiled = false;          // 是否走字节码路径
+        size_t instructionCount = 0;
+        double bytecodeNs = 0.0;
+        double exprtkCachedNs = 0.0;    // 预编译的 ExprTK 表达式
+        double exprtkCompileNs = 0.0;   // 每次重新编译（旧实现）
+    };
+
+    // 公式后台校验状态
+    enum class FormulaCheckState {
+        Empty,      // 公式为空
+        Pending,    // 等待输入停止或正在编译
+        Valid,
+        Invalid
+    };
+
+    struct FormulaCheckResult {
+        FormulaCheckState state = FormulaCheckState::Empty;
+        bool bytecode = false;          // 字节码子集内（否则由 ExprTK 求值）
+        std::string errorMsg;
+    };
+
+    struct CachedFormula;
+
     class ExpressionParser {
     public:
         ExpressionParser();
@@ -45,18 +76,67 @@ namespace I2CDebugger {
         // 验证公式是否有效
         bool ValidateFormula(const std::string& formula, std::string& errorMsg);
 
+        // 非阻塞校验，供编辑弹窗每帧调用：输入停止一段时间后在后台线程编译，
+        // 结果按公式哈希缓存，编译产物在随后求值时直接进入求值缓存
+        FormulaCheckResult CheckFormulaAsync(const std::string& formula, bool isWrite);
+
         // 获取公式帮助文本
         static std::string GetFormulaHelp();
 
+        // 用典型 PMBus 公式比较字节码与 ExprTK 的求值耗时
+        static std::vector<FormulaBenchmarkResult> RunBenchmark(int iterations);
+
     private:
         // 设置字节变量 b0, b1, b2... 和 w0, w1...
         void SetByteVariables(const std::vector<uint8_t>& rawData);
 
+        // 查找或编译公式：优先编译为字节码，子集外的公式回退到 ExprTK
+        const CachedFormula& GetCompiled(const std::string& formula, bool isWrite);
+        std::unique_ptr<CachedFormula> CompileFormula(const std::string& formula, bool isWrite);
+
+        // ========== 后台校验 ==========
+        struct ValidationEntry {
+            std::string formula;
+            bool isWrite = false;
+            FormulaCheckResult result;
+            std::unique_ptr<CachedFormula> artifact;    // 尚未被求值缓存取走的编译结果
+        };
+
+        struct ValidationRequest {
+            bool active = false;
+            std::string formula;
+            std::chrono::steady_clock::time_point submitTime;
+        };
+
+        static size_t FormulaKey(const std::string& formula, bool isWrite);
+        void StoreValidation(const std::string& formula, bool isWrite, std::unique_ptr<CachedFormula> artifact);
+        std::unique_ptr<CachedFormula> TakeValidatedArtifact(const std::string& formula, bool isWrite);
+        void ValidationWorker();
+
         // 字节变量数组 (最多支持32字节)
         double m_bytes[32] = { 0 };
         double m_words[16] = { 0 };  // 小端字
         double m_value = 0;        // 用于写入公式的输入值
         double m_result = 0;       // 结果变量
+
+        // ExprTK 符号表绑定上面的成员变量，只建一次
+        std::unique_ptr<exprtk::symbol_table<double>> m_readSymbols;
+        std::unique_ptr<exprtk::symbol_table<double>> m_writeSymbols;
+
+        // 公式 → 编译结果
+        std::unordered_map<std::string, std::unique_ptr<CachedFormula>> m_readCache;
+        std::unordered_map<std::string, std::unique_ptr<CachedFormula>> m_writeCache;
+
+        // ExprTK 符号表的引用计数不是线程安全的，
+        // 编译/注册/销毁表达式都在此锁内进行（求值不需要）
+        std::mutex m_compileMutex;
+
+        std::thread m_validationThread;             // 首次需要时启动
+        std::mutex m_validationMutex;
+        std::condition_variable m_validationCv;
+        bool m_validationStop = false;
+        ValidationRequest m_pendingValidation[2];   // [0] 读取公式 [1] 写入公式，新输入覆盖旧请求
+        std::unordered_map<size_t, ValidationEntry> m_validated;
     };
 
 }
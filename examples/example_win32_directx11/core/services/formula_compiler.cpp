@@ -0,0 +1,734 @@
+﻿#include "formula_compiler.h"
+#include <cmath>
+#include <cctype>
+#include <cstdlib>
+
+namespace I2CDebugger {
+
+    namespace {
+
+        // double 转 int64，越界/NaN 时为 0（避免未定义行为）
+        inline int64_t ToInt(double v) {
+            if (!(v > -9.2e18 && v < 9.2e18)) return 0;
+            return static_cast<int64_t>(v);
+        }
+
+        union FormulaRegister {
+            int64_t i;
+            double f;
+        };
+
+        FormulaRegister Execute(const std::vector<FormulaInstr>& code, uint8_t resultReg,
+            const uint8_t* bytes, size_t byteCount, double value) {
+            FormulaRegister r[CompiledFormula::MAX_REGISTERS];
+
+            for (const FormulaInstr& in : code) {
+                FormulaRegister& d = r[in.dst];
+                const FormulaRegister& a = r[in.a];
+                const FormulaRegister& b = r[in.b];
+
+                switch (in.op) {
+                case FormulaOp::LoadConstI: d.i = in.imm; break;
+                case FormulaOp::LoadConstF: d.f = in.fimm; break;
+                case FormulaOp::LoadByte:
+                    d.i = in.a < byteCount ? bytes[in.a] : 0;
+                    break;
+                case FormulaOp::LoadWord: {
+                    size_t lo = static_cast<size_t>(in.a) * 2;
+                    d.i = (lo + 1 < byteCount) ? ((bytes[lo + 1] << 8) | bytes[lo]) : 0;
+                    break;
+                }
+                case FormulaOp::LoadValue: d.f = value; break;
+                case FormulaOp::IntToReal: d.f = static_cast<double>(a.i); break;
+                case FormulaOp::RealToInt: d.i = ToInt(a.f); break;
+
+                // 整数运算按无符号回绕，避免溢出未定义行为
+                case FormulaOp::AddI: d.i = static_cast<int64_t>(static_cast<uint64_t>(a.i) + static_cast<uint64_t>(b.i)); break;
+                case FormulaOp::SubI: d.i = static_cast<int64_t>(static_cast<uint64_t>(a.i) - static_cast<uint64_t>(b.i)); break;
+                case FormulaOp::MulI: d.i = static_cast<int64_t>(static_cast<uint64_t>(a.i) * static_cast<uint64_t>(b.i)); break;
+                case FormulaOp::ModI: d.i = (b.i == 0 || b.i == -1) ? 0 : a.i % b.i; break;
+                case FormulaOp::AddF: d.f = a.f + b.f; break;
+                case FormulaOp::SubF: d.f = a.f - b.f; break;
+                case FormulaOp::MulF: d.f = a.f * b.f; break;
+                case FormulaOp::DivF: d.f = a.f / b.f; break;
+                case FormulaOp::ModF: d.f = std::fmod(a.f, b.f); break;
+                case FormulaOp::NegI: d.i = static_cast<int64_t>(0 - static_cast<uint64_t>(a.i)); break;
+                case FormulaOp::NegF: d.f = -a.f; break;
+
+                case FormulaOp::BitAnd: d.i = a.i & b.i; break;
+                case FormulaOp::BitOr: d.i = a.i | b.i; break;
+                case FormulaOp::BitNot: d.i = ~a.i; break;
+                case FormulaOp::Shl: d.i = static_cast<int64_t>(static_cast<uint64_t>(a.i) << (b.i & 63)); break;
+                case FormulaOp::Shr: d.i = a.i >> (b.i & 63); break;
+
+                case FormulaOp::EqI: d.i = a.i == b.i; break;
+                case FormulaOp::NeI: d.i = a.i != b.i; break;
+                case FormulaOp::LtI: d.i = a.i < b.i; break;
+                case FormulaOp::LeI: d.i = a.i <= b.i; break;
+                case FormulaOp::GtI: d.i = a.i > b.i; break;
+                case FormulaOp::GeI: d.i = a.i >= b.i; break;
+                case FormulaOp::EqF: d.i = a.f == b.f; break;
+                case FormulaOp::NeF: d.i = a.f != b.f; break;
+                case FormulaOp::LtF: d.i = a.f < b.f; break;
+                case FormulaOp::LeF: d.i = a.f <= b.f; break;
+                case FormulaOp::GtF: d.i = a.f > b.f; break;
+                case FormulaOp::GeF: d.i = a.f >= b.f; break;
+                case FormulaOp::BoolI: d.i = a.i != 0; break;
+                case FormulaOp::BoolF: d.i = a.f != 0.0; break;
+                case FormulaOp::NotI: d.i = a.i == 0; break;
+                case FormulaOp::NotF: d.i = a.f == 0.0; break;
+
+                case FormulaOp::Select: d = a.i ? b : r[in.c]; break;
+                }
+            }
+            return r[resultReg];
+        }
+
+        enum class NodeKind { Const, Byte, Word, Value, Unary, Binary, Ternary };
+
+        enum class Op {
+            None,
+            // 一元
+            Neg, BitNot, LogicNot,
+            // 二元
+            Add, Sub, Mul, Div, Mod,
+            BitAnd, BitOr, Shl, Shr,
+            Eq, Ne, Lt, Le, Gt, Ge,
+            LogicAnd, LogicOr
+        };
+
+        struct Node {
+            NodeKind kind = NodeKind::Const;
+            Op op = Op::None;
+            bool isInt = true;
+            FormulaRegister constant = { 0 };
+            int index = 0;          // 变量下标
+            int lhs = -1;
+            int rhs = -1;
+            int third = -1;         // 三元运算的 false 分支
+        };
+
+        class Parser {
+        public:
+            Parser(const std::string& text, FormulaKind kind) : m_text(text), m_kind(kind) {}
+
+            bool Build(std::vector<FormulaInstr>& code, bool& resultIsInt, uint32_t& usedBytes);
+
+        private:
+            // ---------- 词法 ----------
+            void SkipSpace() {
+                while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) m_pos++;
+            }
+            char Peek(size_t offset = 0) const {
+                return m_pos + offset < m_text.size() ? m_text[m_pos + offset] : '\0';
+            }
+            bool Match(const char* token) {
+                SkipSpace();
+                size_t len = std::char_traits<char>::length(token);
+                if (m_text.compare(m_pos, len, token) != 0) return false;
+                m_pos += len;
+                return true;
+            }
+            // 单字符运算符，排除双字符形式（如 '&' 与 "&&"，'<' 与 "<<"）
+            bool MatchSingle(char c, char notFollowedBy1, char notFollowedBy2 = '\0') {
+                SkipSpace();
+                if (Peek() != c) return false;
+                char next = Peek(1);
+                if (next != '\0' && (next == notFollowedBy1 || next == notFollowedBy2)) return false;
+                m_pos++;
+                return true;
+            }
+
+            // ---------- 语法（按 C 运算符优先级） ----------
+            int ParseTernary();
+            int ParseLogicalOr();
+            int ParseLogicalAnd();
+            int ParseBitOr();
+            int ParseBitAnd();
+            int ParseEquality();
+            int ParseRelational();
+            int ParseShift();
+            int ParseAdditive();
+            int ParseMultiplicative();
+            int ParseUnary();
+            int ParsePrimary();
+            int ParseNumber();
+            int ParseIdentifier();
+
+            // ---------- 构建与化简 ----------
+            int Add(const Node& node) {
+                m_nodes.push_back(node);
+                return static_cast<int>(m_nodes.size()) - 1;
+            }
+            int MakeConst(bool isInt, FormulaRegister value) {
+                Node node;
+                node.kind = NodeKind::Const;
+                node.isInt = isInt;
+                node.constant = value;
+                return Add(node);
+            }
+            int MakeUnary(Op op, int child);
+            int MakeBinary(Op op, int lhs, int rhs);
+            int MakeTernary(int cond, int whenTrue, int whenFalse);
+            int FoldConstant(int nodeIndex);
+            bool IsConstValue(int nodeIndex, int64_t value) const;
+
+            // ---------- 代码生成 ----------
+            bool Emit(int nodeIndex, int reg, std::vector<FormulaInstr>& code, uint32_t& usedBytes);
+            void Convert(int reg, bool fromInt, bool toInt, std::vector<FormulaInstr>& code);
+
+            const std::string& m_text;
+            FormulaKind m_kind;
+            size_t m_pos = 0;
+            bool m_ok = true;
+            std::vector<Node> m_nodes;
+        };
+
+        int Parser::ParseTernary() {
+            int cond = ParseLogicalOr();
+            if (!m_ok) return -1;
+            if (Match("?")) {
+                int whenTrue = ParseTernary();
+                if (!m_ok || !Match(":")) { m_ok = false; return -1; }
+                int whenFalse = ParseTernary();
+                if (!m_ok) return -1;
+                return MakeTernary(cond, whenTrue, whenFalse);
+            }
+            return cond;
+        }
+
+        int Parser::ParseLogicalOr() {
+            int lhs = ParseLogicalAnd();
+            while (m_ok && Match("||")) {
+                int rhs = ParseLogicalAnd();
+                if (!m_ok) return -1;
+                lhs = MakeBinary(Op::LogicOr, lhs, rhs);
+            }
+            return lhs;
+        }
+
+        int Parser::ParseLogicalAnd() {
+            int lhs = ParseBitOr();
+            while (m_ok && Match("&&")) {
+                int rhs = ParseBitOr();
+                if (!m_ok) return -1;
+                lhs = MakeBinary(Op::LogicAnd, lhs, rhs);
+            }
+            return lhs;
+        }
+
+        int Parser::ParseBitOr() {
+            int lhs = ParseBitAnd();
+            while (m_ok && MatchSingle('|', '|')) {
+                int rhs = ParseBitAnd();
+                if (!m_ok) return -1;
+                lhs = MakeBinary(Op::BitOr, lhs, rhs);
+            }
+            return lhs;
+        }
+
+        int Parser::ParseBitAnd() {
+            int lhs = ParseEquality();
+            while (m_ok && MatchSingle('&', '&')) {
+                int rhs = ParseEquality();
+                if (!m_ok) return -1;
+                lhs = MakeBinary(Op::BitAnd, lhs, rhs);
+            }
+            return lhs;
+        }
+
+        int Parser::ParseEquality() {
+            int lhs = ParseRelational();
+            while (m_ok) {
+                Op op;
+                if (Match("==")) op = Op::Eq;
+                else if (Match("!=")) op = Op::Ne;
+                else break;
+                int rhs = ParseRelational();
+                if (!m_ok) return -1;
+                lhs = MakeBinary(op, lhs, rhs);
+            }
+            return lhs;
+        }
+
+        int Parser::ParseRelational() {
+            int lhs = ParseShift();
+            while (m_ok) {
+                Op op;
+                if (Match("<=")) op = Op::Le;
+                else if (Match(">=")) op = Op::Ge;
+                else if (MatchSingle('<', '<')) op = Op::Lt;
+                else if (MatchSingle('>', '>')) op = Op::Gt;
+                else break;
+                int rhs = ParseShift();
+                if (!m_ok) return -1;
+                lhs = MakeBinary(op, lhs, rhs);
+            }
+            return lhs;
+        }
+
+        int Parser::ParseShift() {
+            int lhs = ParseAdditive();
+            while (m_ok) {
+                Op op;
+                if (Match("<<")) op = Op::Shl;
+                else if (Match(">>")) op = Op::Shr;
+                else break;
+                int rhs = ParseAdditive();
+                if (!m_ok) return -1;
+                lhs = MakeBinary(op, lhs, rhs);
+            }
+            return lhs;
+        }
+
+        int Parser::ParseAdditive() {
+            int lhs = ParseMultiplicative();
+            while (m_ok) {
+                Op op;
+                if (Match("+")) op = Op::Add;
+                else if (Match("-")) op = Op::Sub;
+                else break;
+                int rhs = ParseMultiplicative();
+                if (!m_ok) return -1;
+                lhs = MakeBinary(op, lhs, rhs);
+            }
+            return lhs;
+        }
+
+        int Parser::ParseMultiplicative() {
+            int lhs = ParseUnary();
+            while (m_ok) {
+                Op op;
+                if (Match("*")) op = Op::Mul;
+                else if (Match("/")) op = Op::Div;
+                else if (Match("%")) op = Op::Mod;
+                else break;
+                int rhs = ParseUnary();
+                if (!m_ok) return -1;
+                lhs = MakeBinary(op, lhs, rhs);
+            }
+            return lhs;
+        }
+
+        int Parser::ParseUnary() {
+            if (Match("-")) {
+                int child = ParseUnary();
+                return m_ok ? MakeUnary(Op::Neg, child) : -1;
+            }
+            if (Match("+")) {
+                return ParseUnary();
+            }
+            if (Match("~")) {
+                int child = ParseUnary();
+                return m_ok ? MakeUnary(Op::BitNot, child) : -1;
+            }
+            if (MatchSingle('!', '=')) {
+                int child = ParseUnary();
+                return m_ok ? MakeUnary(Op::LogicNot, child) : -1;
+            }
+            return ParsePrimary();
+        }
+
+        int Parser::ParsePrimary() {
+            SkipSpace();
+            char c = Peek();
+            if (c == '(') {
+                m_pos++;
+                int inner = ParseTernary();
+                if (!m_ok || !Match(")")) { m_ok = false; return -1; }
+                return inner;
+            }
+            if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+                return ParseNumber();
+            }
+            if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+                return ParseIdentifier();
+            }
+            m_ok = false;
+            return -1;
+        }
+
+        int Parser::ParseNumber() {
+            const char* begin = m_text.c_str() + m_pos;
+            char* end = nullptr;
+            FormulaRegister value;
+            bool isInt = true;
+
+            if (Peek() == '0' && (Peek(1) == 'x' || Peek(1) == 'X')) {
+                if (!std::isxdigit(static_cast<unsigned char>(Peek(2)))) { m_ok = false; return -1; }
+                unsigned long long v = std::strtoull(begin, &end, 16);
+                if (v > static_cast<unsigned long long>(INT64_MAX)) { m_ok = false; return -1; }
+                value.i = static_cast<int64_t>(v);
+            }
+            else {
+                // 含小数点或指数的为浮点常量
+                size_t p = m_pos;
+                while (p < m_text.size() && std::isdigit(static_cast<unsigned char>(m_text[p]))) p++;
+                if (p < m_text.size() && (m_text[p] == '.' || m_text[p] == 'e' || m_text[p] == 'E')) {
+                    isInt = false;
+                    value.f = std::strtod(begin, &end);
+                }
+                else {
+                    unsigned long long v = std::strtoull(begin, &end, 10);
+                    if (v > static_cast<unsigned long long>(INT64_MAX)) { m_ok = false; return -1; }
+                    value.i = static_cast<int64_t>(v);
+                }
+            }
+
+            if (end == begin) { m_ok = false; return -1; }
+            m_pos += static_cast<size_t>(end - begin);
+
+            // ExprTK 允许 "2b0" 这类隐式乘法，交给 ExprTK 处理
+            char next = Peek();
+            if (std::isalnum(static_cast<unsigned char>(next)) || next == '_' || next == '.') {
+                m_ok = false;
+                return -1;
+            }
+            return MakeConst(isInt, value);
+        }
+
+        int Parser::ParseIdentifier() {
+            size_t start = m_pos;
+            while (m_pos < m_text.size() &&
+                (std::isalnum(static_cast<unsigned char>(m_text[m_pos])) || m_text[m_pos] == '_')) {
+                m_pos++;
+            }
+            std::string name = m_text.substr(start, m_pos - start);
+
+            Node node;
+            bool allowBytes = (m_kind != FormulaKind::Write);
+            bool allowValue = (m_kind != FormulaKind::Read);
+
+            if (allowValue && (name == "value" || name == "v")) {
+                node.kind = NodeKind::Value;
+                node.isInt = false;
+                return Add(node);
+            }
+
+            if (allowBytes && name.size() >= 2 && name.size() <= 3 && (name[0] == 'b' || name[0] == 'w')) {
+                bool digits = true;
+                for (size_t i = 1; i < name.size(); ++i) {
+                    if (!std::isdigit(static_cast<unsigned char>(name[i]))) digits = false;
+                }
+                int index = digits ? std::atoi(name.c_str() + 1) : -1;
+                bool leadingZero = name.size() == 3 && name[1] == '0';
+                int limit = (name[0] == 'b') ? 32 : 16;
+                if (digits && !leadingZero && index < limit) {
+                    node.kind = (name[0] == 'b') ? NodeKind::Byte : NodeKind::Word;
+                    node.index = index;
+                    node.isInt = true;
+                    return Add(node);
+                }
+            }
+
+            // 函数调用、常量（pi 等）和其它符号不在子集内
+            m_ok = false;
+            return -1;
+        }
+
+        bool Parser::IsConstValue(int nodeIndex, int64_t value) const {
+            const Node& node = m_nodes[nodeIndex];
+            if (node.kind != NodeKind::Const) return false;
+            return node.isInt ? node.constant.i == value : node.constant.f == static_cast<double>(value);
+        }
+
+        int Parser::MakeUnary(Op op, int child) {
+            Node node;
+            node.kind = NodeKind::Unary;
+            node.op = op;
+            node.lhs = child;
+            node.isInt = (op == Op::Neg) ? m_nodes[child].isInt : true;
+            int index = Add(node);
+            return m_nodes[child].kind == NodeKind::Const ? FoldConstant(index) : index;
+        }
+
+        int Parser::MakeBinary(Op op, int lhs, int rhs) {
+            const Node& l = m_nodes[lhs];
+            const Node& r = m_nodes[rhs];
+
+            Node node;
+            node.kind = NodeKind::Binary;
+            node.op = op;
+            node.lhs = lhs;
+            node.rhs = rhs;
+            switch (op) {
+            case Op::Add: case Op::Sub: case Op::Mul: case Op::Mod:
+                node.isInt = l.isInt && r.isInt;
+                break;
+            case Op::Div:
+                node.isInt = false;
+                break;
+            default:
+                node.isInt = true;
+                break;
+            }
+
+            if (l.kind == NodeKind::Const && r.kind == NodeKind::Const) {
+                return FoldConstant(Add(node));
+            }
+
+            // 恒等化简：结果类型与保留的操作数一致时才化简
+            bool lSame = (l.isInt == node.isInt);
+            bool rSame = (r.isInt == node.isInt);
+            switch (op) {
+            case Op::Add:
+            case Op::BitOr:
+                if (IsConstValue(rhs, 0) && lSame) return lhs;
+                if (IsConstValue(lhs, 0) && rSame) return rhs;
+                break;
+            case Op::Sub:
+            case Op::Shl:
+            case Op::Shr:
+                if (IsConstValue(rhs, 0) && lSame) return lhs;
+                break;
+            case Op::Mul:
+                if (IsConstValue(rhs, 1) && lSame) return lhs;
+                if (IsConstValue(lhs, 1) && rSame) return rhs;
+                // 整数乘 0 / 与 0：丢弃另一侧的变量引用
+                if (node.isInt && (IsConstValue(rhs, 0) || IsConstValue(lhs, 0))) {
+                    FormulaRegister zero;
+                    zero.i = 0;
+                    return MakeConst(true, zero);
+                }
+                break;
+            case Op::BitAnd:
+                if (IsConstValue(rhs, 0) || IsConstValue(lhs, 0)) {
+                    FormulaRegister zero;
+                    zero.i = 0;
+                    return MakeConst(true, zero);
+                }
+                break;
+            default:
+                break;
+            }
+            return Add(node);
+        }
+
+        int Parser::MakeTernary(int cond, int whenTrue, int whenFalse) {
+            Node node;
+            node.kind = NodeKind::Ternary;
+            node.lhs = cond;
+            node.rhs = whenTrue;
+            node.third = whenFalse;
+            node.isInt = m_nodes[whenTrue].isInt && m_nodes[whenFalse].isInt;
+
+            const Node& c = m_nodes[cond];
+            if (c.kind == NodeKind::Const) {
+                // 条件为常量：只保留被选中的分支
+                bool taken = c.isInt ? (c.constant.i != 0) : (c.constant.f != 0.0);
+                int branch = taken ? whenTrue : whenFalse;
+                if (m_nodes[branch].isInt == node.isInt) return branch;
+                if (m_nodes[branch].kind == NodeKind::Const) {
+                    FormulaRegister value;
+                    value.f = static_cast<double>(m_nodes[branch].constant.i);
+                    return MakeConst(false, value);
+                }
+            }
+            return Add(node);
+        }
+
+        // 用字节码解释器本身求常量子树的值，保证与运行期语义一致
+        int Parser::FoldConstant(int nodeIndex) {
+            std::vector<FormulaInstr> code;
+            uint32_t usedBytes = 0;
+            if (!Emit(nodeIndex, 0, code, usedBytes)) {
+                m_ok = true;        // 寄存器不足时保留原节点
+                return nodeIndex;
+            }
+            return MakeConst(m_nodes[nodeIndex].isInt, Execute(code, 0, nullptr, 0, 0.0));
+        }
+
+        void Parser::Convert(int reg, bool fromInt, bool toInt, std::vector<FormulaInstr>& code) {
+            if (fromInt == toInt) return;
+            FormulaInstr instr;
+            instr.op = toInt ? FormulaOp::RealToInt : FormulaOp::IntToReal;
+            instr.dst = static_cast<uint8_t>(reg);
+            instr.a = static_cast<uint8_t>(reg);
+            code.push_back(instr);
+        }
+
+        bool Parser::Emit(int nodeIndex, int reg, std::vector<FormulaInstr>& code, uint32_t& usedBytes) {
+            if (reg >= CompiledFormula::MAX_REGISTERS) {
+                m_ok = false;
+                return false;
+            }
+
+            const Node& node = m_nodes[nodeIndex];
+            FormulaInstr instr;
+            instr.dst = static_cast<uint8_t>(reg);
+
+            switch (node.kind) {
+            case NodeKind::Const:
+                instr.op = node.isInt ? FormulaOp::LoadConstI : FormulaOp::LoadConstF;
+                instr.imm = node.isInt ? node.constant.i : 0;
+                instr.fimm = node.isInt ? 0.0 : node.constant.f;
+                code.push_back(instr);
+                return true;
+
+            case NodeKind::Byte:
+                instr.op = FormulaOp::LoadByte;
+                instr.a = static_cast<uint8_t>(node.index);
+                usedBytes |= 1u << node.index;
+                code.push_back(instr);
+                return true;
+
+            case NodeKind::Word:
+                instr.op = FormulaOp::LoadWord;
+                instr.a = static_cast<uint8_t>(node.index);
+                usedBytes |= 3u << (node.index * 2);
+                code.push_back(instr);
+                return true;
+
+            case NodeKind::Value:
+                instr.op = FormulaOp::LoadValue;
+                code.push_back(instr);
+                return true;
+
+            case NodeKind::Unary: {
+                const Node& child = m_nodes[node.lhs];
+                if (!Emit(node.lhs, reg, code, usedBytes)) return false;
+                instr.a = static_cast<uint8_t>(reg);
+                switch (node.op) {
+                case Op::Neg:
+                    instr.op = child.isInt ? FormulaOp::NegI : FormulaOp::NegF;
+                    break;
+                case Op::BitNot:
+                    Convert(reg, child.isInt, true, code);
+                    instr.op = FormulaOp::BitNot;
+                    break;
+                default:
+                    instr.op = child.isInt ? FormulaOp::NotI : FormulaOp::NotF;
+                    break;
+                }
+                code.push_back(instr);
+                return true;
+            }
+
+            case NodeKind::Binary: {
+                const Node& l = m_nodes[node.lhs];
+                const Node& r = m_nodes[node.rhs];
+                bool bothInt = l.isInt && r.isInt;
+
+                // 操作数类型：位运算取整；比较按公共类型；逻辑运算先转成 0/1
+                bool operandInt;
+                switch (node.op) {
+                case Op::BitAnd: case Op::BitOr: case Op::Shl: case Op::Shr:
+                    operandInt = true;
+                    break;
+                case Op::Div:
+                    operandInt = false;
+                    break;
+                case Op::LogicAnd: case Op::LogicOr:
+                    operandInt = true;
+                    break;
+                default:
+                    operandInt = bothInt;
+                    break;
+                }
+
+                bool logical = (node.op == Op::LogicAnd || node.op == Op::LogicOr);
+
+                if (!Emit(node.lhs, reg, code, usedBytes)) return false;
+                if (logical) {
+                    FormulaInstr b;
+                    b.op = l.isInt ? FormulaOp::BoolI : FormulaOp::BoolF;
+                    b.dst = b.a = static_cast<uint8_t>(reg);
+                    code.push_back(b);
+                }
+                else {
+                    Convert(reg, l.isInt, operandInt, code);
+                }
+
+                if (!Emit(node.rhs, reg + 1, code, usedBytes)) return false;
+                if (logical) {
+                    FormulaInstr b;
+                    b.op = r.isInt ? FormulaOp::BoolI : FormulaOp::BoolF;
+                    b.dst = b.a = static_cast<uint8_t>(reg + 1);
+                    code.push_back(b);
+                }
+                else {
+                    Convert(reg + 1, r.isInt, operandInt, code);
+                }
+
+                instr.a = static_cast<uint8_t>(reg);
+                instr.b = static_cast<uint8_t>(reg + 1);
+                switch (node.op) {
+                case Op::Add: instr.op = operandInt ? FormulaOp::AddI : FormulaOp::AddF; break;
+                case Op::Sub: instr.op = operandInt ? FormulaOp::SubI : FormulaOp::SubF; break;
+                case Op::Mul: instr.op = operandInt ? FormulaOp::MulI : FormulaOp::MulF; break;
+                case Op::Mod: instr.op = operandInt ? FormulaOp::ModI : FormulaOp::ModF; break;
+                case Op::Div: instr.op = FormulaOp::DivF; break;
+                case Op::BitAnd: case Op::LogicAnd: instr.op = FormulaOp::BitAnd; break;
+                case Op::BitOr: case Op::LogicOr: instr.op = FormulaOp::BitOr; break;
+                case Op::Shl: instr.op = FormulaOp::Shl; break;
+                case Op::Shr: instr.op = FormulaOp::Shr; break;
+                case Op::Eq: instr.op = operandInt ? FormulaOp::EqI : FormulaOp::EqF; break;
+                case Op::Ne: instr.op = operandInt ? FormulaOp::NeI : FormulaOp::NeF; break;
+                case Op::Lt: instr.op = operandInt ? FormulaOp::LtI : FormulaOp::LtF; break;
+                case Op::Le: instr.op = operandInt ? FormulaOp::LeI : FormulaOp::LeF; break;
+                case Op::Gt: instr.op = operandInt ? FormulaOp::GtI : FormulaOp::GtF; break;
+                case Op::Ge: instr.op = operandInt ? FormulaOp::GeI : FormulaOp::GeF; break;
+                default:
+                    m_ok = false;
+                    return false;
+                }
+                code.push_back(instr);
+                return true;
+            }
+
+            case NodeKind::Ternary: {
+                const Node& c = m_nodes[node.lhs];
+                if (!Emit(node.lhs, reg, code, usedBytes)) return false;
+                if (!c.isInt) {
+                    FormulaInstr b;
+                    b.op = FormulaOp::BoolF;
+                    b.dst = b.a = static_cast<uint8_t>(reg);
+                    code.push_back(b);
+                }
+                if (!Emit(node.rhs, reg + 1, code, usedBytes)) return false;
+                Convert(reg + 1, m_nodes[node.rhs].isInt, node.isInt, code);
+                if (!Emit(node.third, reg + 2, code, usedBytes)) return false;
+                Convert(reg + 2, m_nodes[node.third].isInt, node.isInt, code);
+
+                instr.op = FormulaOp::Select;
+                instr.a = static_cast<uint8_t>(reg);
+                instr.b = static_cast<uint8_t>(reg + 1);
+                instr.c = static_cast<uint8_t>(reg + 2);
+                code.push_back(instr);
+                return true;
+            }
+            }
+            return false;
+        }
+
+        bool Parser::Build(std::vector<FormulaInstr>& code, bool& resultIsInt, uint32_t& usedBytes) {
+            int root = ParseTernary();
+            SkipSpace();
+            if (!m_ok || root < 0 || m_pos != m_text.size()) return false;
+
+            code.clear();
+            usedBytes = 0;
+            if (!Emit(root, 0, code, usedBytes)) return false;
+
+            resultIsInt = m_nodes[root].isInt;
+            return true;
+        }
+
+    }
+
+    double CompiledFormula::Evaluate(const uint8_t* bytes, size_t byteCount, double value) const {
+        FormulaRegister result = Execute(m_code, m_resultReg, bytes, byteCount, value);
+        return m_resultIsInt ? static_cast<double>(result.i) : result.f;
+    }
+
+    bool FormulaCompiler::Compile(const std::string& formula, FormulaKind kind, CompiledFormula& out) {
+        Parser parser(formula, kind);
+        CompiledFormula compiled;
+        if (!parser.Build(compiled.m_code, compiled.m_resultIsInt, compiled.m_usedBytes)) {
+            return false;
+        }
+        out = std::move(compiled);
+        return true;
+    }
+
+}
@@ -0,0 +1,84 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace I2CDebugger {
+
+    // ========== 公式字节码 ==========
+    // 寄存器式指令，每个寄存器在编译期确定为整数(int64)或浮点(double)
+    enum class FormulaOp : uint8_t {
+        LoadConstI,     // dst = imm
+        LoadConstF,     // dst = fimm
+        LoadByte,       // dst = bN（越界为0）
+        LoadWord,       // dst = wN（越界为0）
+        LoadValue,      // dst = value（写入公式）
+        IntToReal,      // dst = (double)a
+        RealToInt,      // dst = (int64)a，向零截断
+
+        AddI, SubI, MulI, ModI,
+        AddF, SubF, MulF, DivF, ModF,
+        NegI, NegF,
+
+        BitAnd, BitOr, BitNot, Shl, Shr,
+
+        EqI, NeI, LtI, LeI, GtI, GeI,
+        EqF, NeF, LtF, LeF, GtF, GeF,
+        BoolI, BoolF,   // dst = (a != 0)
+        NotI, NotF,     // dst = (a == 0)
+
+        Select          // dst = a ? b : c（a 为整数）
+    };
+
+    struct FormulaInstr {
+        FormulaOp op;
+        uint8_t dst = 0;
+        uint8_t a = 0;
+        uint8_t b = 0;
+        uint8_t c = 0;
+        int64_t imm = 0;
+        double fimm = 0.0;
+    };
+
+    // 公式可用的变量集合
+    enum class FormulaKind {
+        Read,       // b0-b31, w0-w15
+        Write,      // value, v
+        Any         // 仅用于校验
+    };
+
+    // 编译后的公式，Evaluate 不分配内存、不查符号表
+    class CompiledFormula {
+    public:
+        static constexpr int MAX_REGISTERS = 32;
+
+        double Evaluate(const uint8_t* bytes, size_t byteCount, double value) const;
+
+        bool IsConstant() const {
+            return m_code.size() == 1 &&
+                (m_code[0].op == FormulaOp::LoadConstI || m_code[0].op == FormulaOp::LoadConstF);
+        }
+        size_t GetInstructionCount() const { return m_code.size(); }
+        uint32_t GetUsedByteMask() const { return m_usedBytes; }     // 实际引用到的字节（w 变量按两个字节计）
+
+    private:
+        friend class FormulaCompiler;
+
+        std::vector<FormulaInstr> m_code;
+        uint8_t m_resultReg = 0;
+        bool m_resultIsInt = false;
+        uint32_t m_usedBytes = 0;
+    };
+
+    // ========== 公式编译器 ==========
+    // 只支持常用子集：整数/浮点/十六进制常量、b*/w*/value 变量、
+    // + - * / %、& | ~ << >>、比较、&& || !、三元运算和括号。
+    // 运算符语义与 C 一致（/ 始终为浮点除法）；不在子集内的公式返回 false，
+    // 由调用方回退到 ExprTK。
+    class FormulaCompiler {
+    public:
+        static bool Compile(const std::string& formula, FormulaKind kind, CompiledFormula& out);
+    };
+
+}
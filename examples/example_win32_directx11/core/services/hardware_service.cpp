@@ -1,5 +1,9 @@
 ﻿#include "hardware_service.h"
+#include "profiler.h"
 #include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 
 namespace I2CDebugger {
 
@@ -16,7 +20,7 @@ namespace I2CDebugger {
 
     void HardwareService::Stop() {
         m_running = false;
-        m_periodicRunning = false;
+        ClearPeriodicPrograms();
         m_taskCv.notify_all();
 
         if (m_workerThread.joinable()) {
@@ -40,13 +44,32 @@ namespace I2CDebugger {
         return ErrorType::UnknownError;
     }
 
+    void HardwareService::PostDataPacket(const ResponsePacket& packet) {
+        if (m_dataCallback) {
+            std::lock_guard<std::mutex> cbLock(m_callbackMutex);
+            m_callbackQueue.push([this, packet]() {
+                m_dataCallback(packet);
+                });
+        }
+    }
+
+    void HardwareService::PostBatchCompletion(const BatchCompletion& batch) {
+        if (m_batchCallback) {
+            std::lock_guard<std::mutex> cbLock(m_callbackMutex);
+            m_callbackQueue.push([this, batch]() {
+                m_batchCallback(batch);
+                });
+        }
+    }
+
     void HardwareService::HandleDeviceDisconnected() {
         {
             std::lock_guard<std::mutex> lock(m_deviceMutex);
             m_pmbus.Close();
         }
         m_isConnected = false;
-        m_periodicRunning = false;
+        ClearPeriodicPrograms();
+        ResetSlaveHealth();
 
         {
             std::lock_guard<std::mutex> lock(m_taskMutex);
@@ -130,46 +153,194 @@ namespace I2CDebugger {
         m_taskCv.notify_one();
     }
 
-    void HardwareService::ReadAllRegisters(uint8_t defaultSlaveAddr,
+    uint32_t HardwareService::ReadAllRegisters(uint8_t defaultSlaveAddr,
         const std::vector<RegisterEntry>& entries) {
         HardwareTask task;
         task.type = TaskType::ReadAllRegisters;
         task.slaveAddr = defaultSlaveAddr;
         task.registerEntries = entries;
         task.controlId = 1;
+        task.batchId = m_nextBatchId.fetch_add(1);
         std::lock_guard<std::mutex> lock(m_taskMutex);
         m_taskQueue.push(task);
         m_taskCv.notify_one();
+        return task.batchId;
     }
 
-    void HardwareService::ExecuteAllSingleTrigger(uint8_t defaultSlaveAddr,
+    uint32_t HardwareService::ExecuteAllSingleTrigger(uint8_t defaultSlaveAddr,
         const std::vector<SingleTriggerEntry>& entries) {
         HardwareTask task;
         task.type = TaskType::ExecuteAllCommands;
         task.slaveAddr = defaultSlaveAddr;
         task.singleEntries = entries;
         task.controlId = 2;
+        task.batchId = m_nextBatchId.fetch_add(1);
         std::lock_guard<std::mutex> lock(m_taskMutex);
         m_taskQueue.push(task);
         m_taskCv.notify_one();
+        return task.batchId;
     }
 
-    void HardwareService::StartPeriodicExecution(uint8_t defaultSlaveAddr,
+    uint32_t HardwareService::StartPeriodicExecution(uint32_t groupId, uint8_t defaultSlaveAddr,
         const std::vector<PeriodicTriggerEntry>& entries,
         uint32_t intervalMs) {
-        m_periodicEntries = entries;
-        m_periodicSlaveAddr = defaultSlaveAddr;
-        m_periodicIntervalMs = intervalMs;
-        m_periodicRunning = true;
+        PeriodicProgram program;
+        program.groupId = groupId;
+        program.batchId = m_nextBatchId.fetch_add(1);
+        program.slaveAddr = defaultSlaveAddr;
+        program.intervalMs = intervalMs;
+        program.entries = entries;
+        program.staleEpoch.assign(entries.size(), 0);
+        program.nextCycleAt = std::chrono::steady_clock::now();
+        uint32_t batchId = program.batchId;
+
+        {
+            std::lock_guard<std::mutex> lock(m_periodicMutex);
+            // 同一组重复启动时替换原程序
+            for (auto it = m_periodicPrograms.begin(); it != m_periodicPrograms.end(); ++it) {
+                if (it->groupId == groupId) {
+                    m_periodicPrograms.erase(it);
+                    break;
+                }
+            }
+            m_periodicPrograms.push_back(std::move(program));
+            m_periodicRunning = true;
+        }
         m_taskCv.notify_one();
+        return batchId;
     }
 
-    void HardwareService::StopPeriodicExecution() {
+    void HardwareService::StopPeriodicExecution(uint32_t groupId) {
+        std::lock_guard<std::mutex> lock(m_periodicMutex);
+        for (auto it = m_periodicPrograms.begin(); it != m_periodicPrograms.end(); ++it) {
+            if (it->groupId == groupId) {
+                m_periodicPrograms.erase(it);
+                break;
+            }
+        }
+        m_periodicRunning = !m_periodicPrograms.empty();
+    }
+
+    void HardwareService::StopAllPeriodicExecution() {
+        ClearPeriodicPrograms();
+    }
+
+    void HardwareService::ClearPeriodicPrograms() {
+        std::lock_guard<std::mutex> lock(m_periodicMutex);
+        m_periodicPrograms.clear();
         m_periodicRunning = false;
     }
 
+    // 只在断开时调用：停止周期执行不代表从机状态变了，挂起与退避应继续有效
+    void HardwareService::ResetSlaveHealth() {
+        std::lock_guard<std::mutex> lock(m_periodicMutex);
+        for (auto& health : m_slaveHealth) {
+            health = SlaveHealth();
+        }
+    }
+
+    void HardwareService::UpdateSlaveHealth(uint8_t slaveAddr, ErrorType errorType,
+        std::chrono::steady_clock::time_point now) {
+        std::lock_guard<std::mutex> lock(m_periodicMutex);
+        SlaveHealth& health = m_slaveHealth[slaveAddr & 0x7F];
+
+        if (errorType == ErrorType::None) {
+            health.consecutiveNaks = 0;
+            health.suspended = false;
+            health.backoffMs = 0;
+            return;
+        }
+        if (errorType != ErrorType::SlaveNotResponse) return;
+
+        health.consecutiveNaks++;
+        if (health.suspended) {
+            // 探测失败，退避间隔翻倍
+            health.backoffMs = (std::min)(health.backoffMs * 2, SLAVE_PROBE_MAX_MS);
+            health.nextProbeAt = now + std::chrono::milliseconds(health.backoffMs);
+        }
+        else if (health.consecutiveNaks >= SLAVE_SUSPEND_THRESHOLD) {
+            health.suspended = true;
+            health.suspendEpoch++;
+            health.suspendCount++;
+            health.backoffMs = SLAVE_PROBE_MIN_MS;
+            health.nextProbeAt = now + std::chrono::milliseconds(health.backoffMs);
+        }
+    }
+
+    bool HardwareService::IsPeriodicRunning(uint32_t groupId) const {
+        std::lock_guard<std::mutex> lock(m_periodicMutex);
+        for (const auto& program : m_periodicPrograms) {
+            if (program.groupId == groupId) return true;
+        }
+        return false;
+    }
+
+    BusLoadStats HardwareService::GetBusLoadStats() const {
+        BusLoadStats stats;
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            stats.busyPercent = m_busyPercent;
+            stats.utilizationPercent = m_utilizationPercent;
+            stats.bytesPerSecond = m_bytesPerSecond;
+            stats.hidOverheadRatio = m_hidOverheadRatio;
+            stats.transactionsPerSecond = m_transactionsPerSecond;
+            stats.timeoutSwitches = m_timeoutSwitches;
+            stats.timeoutReuses = m_timeoutReuses;
+
+            for (int addr = 0; addr < 128; ++addr) {
+                for (int cls = 0; cls < 2; ++cls) {
+                    const LatencyProfile& profile = m_latencyProfiles[addr][cls];
+                    if (profile.timeoutMs == DEFAULT_RESPONSE_TIMEOUT && profile.fallbackCount == 0) continue;
+                    SlaveTimeoutInfo info;
+                    info.address = static_cast<uint8_t>(addr);
+                    info.isWrite = (cls == 1);
+                    info.timeoutMs = profile.timeoutMs;
+                    info.percentileMs = profile.percentileMs;
+                    info.sampleCount = profile.sampleCount;
+                    info.fallbackCount = profile.fallbackCount;
+                    stats.timeoutProfiles.push_back(info);
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_periodicMutex);
+        for (const auto& program : m_periodicPrograms) {
+            PeriodicGroupLoad load;
+            load.groupId = program.groupId;
+            load.intervalMs = program.intervalMs;
+            load.lastCycleMs = program.lastCycleMs;
+            load.lastBusyMs = program.lastBusyMs;
+            load.overrunCount = program.overrunCount;
+
+            PeriodicCapacity capacity = EstimatePeriodicCapacity(program.entries);
+            load.wireMs = capacity.wireMs;
+            load.maxPollRateHz = capacity.maxPollRateHz;
+            stats.groups.push_back(load);
+
+            if (program.intervalMs > 0) {
+                stats.demandPercent += program.lastBusyMs / program.intervalMs * 100.0;
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        for (int addr = 0; addr < 128; ++addr) {
+            const SlaveHealth& health = m_slaveHealth[addr];
+            if (!health.suspended) continue;
+            SuspendedSlaveInfo info;
+            info.address = static_cast<uint8_t>(addr);
+            info.consecutiveNaks = health.consecutiveNaks;
+            info.backoffMs = health.backoffMs;
+            info.nextProbeInMs = (std::max)(0.0,
+                std::chrono::duration<double, std::milli>(health.nextProbeAt - now).count());
+            info.suspendCount = health.suspendCount;
+            info.skippedCount = health.skippedCount;
+            stats.suspendedSlaves.push_back(info);
+        }
+        return stats;
+    }
+
     void HardwareService::InsertSingleRead(uint8_t slaveAddr, uint8_t regAddr, uint8_t length,
-        uint32_t controlId, uint32_t commandId) {
+        uint32_t controlId, uint32_t commandId, EntryHandle entryHandle) {
         HardwareTask task;
         task.type = TaskType::ReadRegister;
         task.slaveAddr = slaveAddr;
@@ -177,6 +348,7 @@ namespace I2CDebugger {
         task.length = length;
         task.controlId = controlId;
         task.commandId = commandId;
+        task.entryHandle = entryHandle;
         std::lock_guard<std::mutex> lock(m_taskMutex);
         m_priorityQueue.push(task);
         m_taskCv.notify_one();
@@ -184,7 +356,7 @@ namespace I2CDebugger {
 
     void HardwareService::InsertSingleWrite(uint8_t slaveAddr, uint8_t regAddr,
         const std::vector<uint8_t>& data,
-        uint32_t controlId, uint32_t commandId) {
+        uint32_t controlId, uint32_t commandId, EntryHandle entryHandle) {
         HardwareTask task;
         task.type = TaskType::WriteRegister;
         task.slaveAddr = slaveAddr;
@@ -192,24 +364,45 @@ namespace I2CDebugger {
         task.data = data;
         task.controlId = controlId;
         task.commandId = commandId;
+        task.entryHandle = entryHandle;
         std::lock_guard<std::mutex> lock(m_taskMutex);
         m_priorityQueue.push(task);
         m_taskCv.notify_one();
     }
 
-    void HardwareService::InsertSingleCommand(uint8_t slaveAddr, uint8_t regAddr, uint32_t controlId, uint32_t commandId) {
+    void HardwareService::InsertSingleCommand(uint8_t slaveAddr, uint8_t regAddr, uint32_t controlId, uint32_t commandId, EntryHandle entryHandle) {
         HardwareTask task;
         task.type = TaskType::SendCommand;
         task.slaveAddr = slaveAddr;
         task.regAddr = regAddr;
         task.controlId = controlId;
         task.commandId = commandId;
+        task.entryHandle = entryHandle;
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        m_priorityQueue.push(task);
+        m_taskCv.notify_one();
+    }
+
+    void HardwareService::InsertFusedWrite(uint8_t slaveAddr, uint8_t regAddr,
+        const std::vector<uint8_t>& data, uint32_t writeMask, bool verifyWrite,
+        uint32_t controlId, uint32_t commandId, EntryHandle entryHandle) {
+        HardwareTask task;
+        task.type = TaskType::FusedWrite;
+        task.slaveAddr = slaveAddr;
+        task.regAddr = regAddr;
+        task.data = data;
+        task.writeMask = writeMask;
+        task.verifyWrite = verifyWrite;
+        task.controlId = controlId;
+        task.commandId = commandId;
+        task.entryHandle = entryHandle;
         std::lock_guard<std::mutex> lock(m_taskMutex);
         m_priorityQueue.push(task);
         m_taskCv.notify_one();
     }
 
     void HardwareService::ProcessCallbacks() {
+        ProfileZone zone("HardwareService::ProcessCallbacks");
         std::queue<std::function<void()>> callbacks;
         {
             std::lock_guard<std::mutex> lock(m_callbackMutex);
@@ -235,6 +428,7 @@ namespace I2CDebugger {
     }
 
     void HardwareService::WorkerThread() {
+        Profiler::SetThreadName("硬件线程");
         while (m_running) {
             HardwareTask task;
             bool hasTask = false;
@@ -252,8 +446,15 @@ namespace I2CDebugger {
                     hasTask = true;
                 }
                 else if (m_periodicRunning && m_isConnected) {
+                    // 每次只执行一条周期命令，保证插入命令和各组之间的公平交错
                     lock.unlock();
-                    ExecutePeriodicTask();
+                    std::chrono::steady_clock::duration idleWait{};
+                    if (!ExecutePeriodicStep(idleWait)) {
+                        lock.lock();
+                        if (m_priorityQueue.empty() && m_taskQueue.empty()) {
+                            m_taskCv.wait_for(lock, idleWait);
+                        }
+                    }
                     continue;
                 }
                 else {
@@ -268,7 +469,288 @@ namespace I2CDebugger {
         }
     }
 
+    uint32_t HardwareService::EstimateWireBytes(CommandType type, uint8_t length, size_t dataSize) {
+        switch (type) {
+        case CommandType::Read:
+            // 地址(W) + 寄存器 + 地址(R) + 数据
+            return 3u + length;
+        case CommandType::Write:
+            // 地址(W) + 寄存器 + 数据
+            return 2u + static_cast<uint32_t>(dataSize);
+        case CommandType::SendCommand:
+            // 地址(W) + 命令
+            return 2u;
+        }
+        return 0;
+    }
+
+    double HardwareService::EstimateWireTimeUs(CommandType type, uint8_t length, size_t dataSize, uint32_t baudRate) {
+        if (baudRate == 0) return 0.0;
+
+        uint32_t bits = EstimateWireBytes(type, length, dataSize) * 9u;
+        bits += 2;  // START + STOP
+        if (type == CommandType::Read) {
+            bits += 1;  // 重复 START
+        }
+        return bits * 1000000.0 / baudRate;
+    }
+
+    PeriodicCapacity HardwareService::EstimatePeriodicCapacity(const std::vector<PeriodicTriggerEntry>& entries) const {
+        double overheadMs;
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            overheadMs = m_overheadPerTransactionMs;
+        }
+
+        PeriodicCapacity capacity;
+        uint32_t baudRate = m_baudRate;
+        for (const auto& entry : entries) {
+            if (!entry.enabled) continue;
+            double wireMs = EstimateWireTimeUs(entry.type, entry.length, entry.data.size(), baudRate) / 1000.0;
+            int transactions = 1;
+            if (entry.type == CommandType::Write && !entry.data.empty()) {
+                // 组合写入的读-改-写/回读各多一次读事务
+                uint8_t readLength = static_cast<uint8_t>(entry.data.size());
+                int extraReads = (entry.writeMask != 0 ? 1 : 0) + (entry.verifyWrite ? 1 : 0);
+                wireMs += extraReads * EstimateWireTimeUs(CommandType::Read, readLength, 0, baudRate) / 1000.0;
+                transactions += extraReads;
+            }
+            capacity.wireMs += wireMs;
+            capacity.predictedCycleMs += wireMs + overheadMs * transactions + entry.delayMs;
+        }
+        if (capacity.predictedCycleMs > 0.0) {
+            capacity.maxPollRateHz = 1000.0 / capacity.predictedCycleMs;
+        }
+        return capacity;
+    }
+
+    void HardwareService::RecordBusActivity(std::chrono::steady_clock::duration busy, double wireUs, uint32_t wireBytes) {
+        auto now = std::chrono::steady_clock::now();
+        m_loadWindowBusy += busy;
+        m_loadWindowTransactions++;
+        m_loadWindowWireUs += wireUs;
+        m_loadWindowBytes += wireBytes;
+
+        auto window = now - m_loadWindowStart;
+        if (window >= std::chrono::seconds(1)) {
+            double windowSec = std::chrono::duration<double>(window).count();
+            double busySec = std::chrono::duration<double>(m_loadWindowBusy).count();
+            double wireSec = m_loadWindowWireUs / 1000000.0;
+
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            m_busyPercent = busySec / windowSec * 100.0;
+            m_utilizationPercent = wireSec / windowSec * 100.0;
+            m_bytesPerSecond = m_loadWindowBytes / windowSec;
+            m_transactionsPerSecond = static_cast<uint32_t>(m_loadWindowTransactions / windowSec);
+            if (wireSec > 0.0) {
+                m_hidOverheadRatio = busySec / wireSec;
+            }
+
+            // 每事务固定开销做滑动平均，用于预估周期程序的最短周期
+            double overheadMs = (busySec - wireSec) * 1000.0 / m_loadWindowTransactions;
+            if (overheadMs > 0.0) {
+                m_overheadPerTransactionMs = m_overheadPerTransactionMs * 0.7 + overheadMs * 0.3;
+            }
+
+            m_loadWindowStart = now;
+            m_loadWindowBusy = std::chrono::steady_clock::duration::zero();
+            m_loadWindowTransactions = 0;
+            m_loadWindowWireUs = 0.0;
+            m_loadWindowBytes = 0;
+        }
+    }
+
+    namespace {
+        int TimeoutClass(CommandType type) {
+            return type == CommandType::Read ? 0 : 1;
+        }
+    }
+
+    uint32_t HardwareService::GetAdaptiveTimeout(uint8_t slaveAddr, CommandType type) const {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        return m_latencyProfiles[slaveAddr & 0x7F][TimeoutClass(type)].timeoutMs;
+    }
+
+    void HardwareService::RecordLatency(uint8_t slaveAddr, CommandType type, int ret, uint32_t timeoutMs,
+        std::chrono::steady_clock::duration elapsed) {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        LatencyProfile& profile = m_latencyProfiles[slaveAddr & 0x7F][TimeoutClass(type)];
+
+        if (ret < 0) {
+            // NAK 与响应超时返回同一个错误码，无法区分；学习值下失败就回到默认值重新学习
+            if (ret == SLAVE_NOT_RESPONSE && timeoutMs < DEFAULT_RESPONSE_TIMEOUT) {
+                uint32_t fallbackCount = profile.fallbackCount + 1;
+                profile = LatencyProfile();
+                profile.fallbackCount = fallbackCount;
+            }
+            return;
+        }
+
+        profile.samplesMs[profile.sampleCount % LATENCY_SAMPLE_COUNT] =
+            std::chrono::duration<float, std::milli>(elapsed).count();
+        profile.sampleCount++;
+        if (profile.sampleCount < ADAPTIVE_TIMEOUT_MIN_SAMPLES) return;
+
+        float sorted[LATENCY_SAMPLE_COUNT];
+        int count = static_cast<int>((std::min)(profile.sampleCount, static_cast<uint32_t>(LATENCY_SAMPLE_COUNT)));
+        std::copy(profile.samplesMs, profile.samplesMs + count, sorted);
+        int rank = static_cast<int>(std::ceil(count * ADAPTIVE_TIMEOUT_PERCENTILE)) - 1;
+        rank = (std::max)(0, (std::min)(rank, count - 1));
+        std::nth_element(sorted, sorted + rank, sorted + count);
+        profile.percentileMs = sorted[rank];
+
+        double timeout = std::ceil(profile.percentileMs * ADAPTIVE_TIMEOUT_FACTOR) + ADAPTIVE_TIMEOUT_MARGIN_MS;
+        timeout = (std::max)(timeout, static_cast<double>(ADAPTIVE_TIMEOUT_MIN_MS));
+        timeout = (std::min)(timeout, static_cast<double>(DEFAULT_RESPONSE_TIMEOUT));
+        profile.timeoutMs = static_cast<uint32_t>(timeout);
+    }
+
+    void HardwareService::ResetLatencyProfiles() {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        for (auto& slave : m_latencyProfiles) {
+            for (auto& profile : slave) {
+                profile = LatencyProfile();
+            }
+        }
+        m_timeoutSwitches = 0;
+        m_timeoutReuses = 0;
+    }
+
+    int HardwareService::ExecuteCommand(uint8_t slaveAddr, CommandType type, uint8_t regAddr, uint8_t length,
+        const std::vector<uint8_t>& data, ResponsePacket& packet) {
+        std::lock_guard<std::mutex> lock(m_deviceMutex);
+        return ExecuteCommandLocked(slaveAddr, type, regAddr, length, data, packet);
+    }
+
+    int HardwareService::ExecuteCommandLocked(uint8_t slaveAddr, CommandType type, uint8_t regAddr, uint8_t length,
+        const std::vector<uint8_t>& data, ResponsePacket& packet) {
+        int ret = 0;
+        uint32_t timeoutMs = GetAdaptiveTimeout(slaveAddr, type);
+        auto start = std::chrono::steady_clock::now();
+
+        // 设备当前值不短于所需值、且不超过其 ADAPTIVE_TIMEOUT_REUSE_RATIO 倍时直接沿用，
+        // 多个从机交错访问时不会因为几毫秒的差别反复下发；下发失败时按默认值处理
+        uint32_t current = m_pmbus.GetResponseTimeout();
+        bool timeoutReused = (current >= timeoutMs && current <= timeoutMs * ADAPTIVE_TIMEOUT_REUSE_RATIO);
+        if (timeoutReused) {
+            timeoutMs = current;
+        }
+        else if (!m_pmbus.SetResponseTimeout(timeoutMs)) {
+            timeoutMs = DEFAULT_RESPONSE_TIMEOUT;
+        }
+        uint32_t timeoutSwitches = m_pmbus.GetTimeoutSwitchCount();
+        auto transferStart = std::chrono::steady_clock::now();
+
+        switch (type) {
+        case CommandType::Read: {
+            std::vector<uint8_t> result;
+            ret = m_pmbus.Read(slaveAddr, regAddr, length, result);
+            if (ret >= 0) {
+                packet.rawData = result;
+            }
+            break;
+        }
+        case CommandType::Write:
+            ret = m_pmbus.Write(slaveAddr, regAddr, data);
+            break;
+        case CommandType::SendCommand:
+            ret = m_pmbus.SendByte(slaveAddr, regAddr);
+            break;
+        }
+
+        if (ret < 0) {
+            packet.errorDetail = m_pmbus.GetLastError();
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        RecordBusActivity(end - start,
+            EstimateWireTimeUs(type, length, data.size(), m_baudRate),
+            EstimateWireBytes(type, length, data.size()));
+        RecordLatency(slaveAddr, type, ret, timeoutMs, end - transferStart);
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            m_timeoutSwitches = timeoutSwitches;
+            if (timeoutReused) m_timeoutReuses++;
+        }
+
+        packet.success = (ret >= 0);
+        packet.errorType = GetErrorType(ret);
+        UpdateSlaveHealth(slaveAddr, packet.errorType, std::chrono::steady_clock::now());
+        return ret;
+    }
+
+    namespace {
+        // 掩码第 i 字节作用于 data[i]；0 表示整体写入，超出 4 字节的部分不受掩码限制
+        uint8_t WriteMaskByte(uint32_t writeMask, size_t index) {
+            if (writeMask == 0 || index >= 4) return 0xFF;
+            return static_cast<uint8_t>(writeMask >> (index * 8));
+        }
+
+        void CopyResult(const ResponsePacket& from, ResponsePacket& to) {
+            to.success = from.success;
+            to.errorType = from.errorType;
+            to.errorDetail = from.errorDetail;
+        }
+    }
+
+    int HardwareService::ExecuteFusedWrite(uint8_t slaveAddr, uint8_t regAddr, const std::vector<uint8_t>& data,
+        uint32_t writeMask, bool verifyWrite, ResponsePacket& packet) {
+        std::lock_guard<std::mutex> lock(m_deviceMutex);
+        uint8_t length = static_cast<uint8_t>(data.size());
+        if (data.empty() || (writeMask == 0 && !verifyWrite)) {
+            return ExecuteCommandLocked(slaveAddr, CommandType::Write, regAddr, length, data, packet);
+        }
+
+        // 读-改-写：掩码外的位保持从机当前值
+        std::vector<uint8_t> value = data;
+        if (writeMask != 0) {
+            ResponsePacket readPacket;
+            int ret = ExecuteCommandLocked(slaveAddr, CommandType::Read, regAddr, length, {}, readPacket);
+            if (ret < 0) {
+                CopyResult(readPacket, packet);
+                return ret;
+            }
+            if (readPacket.rawData.size() < value.size()) {
+                packet.success = false;
+                packet.errorType = ErrorType::UnknownError;
+                packet.errorDetail = "读-改-写: 读取长度不足";
+                return -1;
+            }
+            for (size_t i = 0; i < value.size(); ++i) {
+                uint8_t mask = WriteMaskByte(writeMask, i);
+                value[i] = static_cast<uint8_t>((readPacket.rawData[i] & ~mask) | (data[i] & mask));
+            }
+        }
+
+        int ret = ExecuteCommandLocked(slaveAddr, CommandType::Write, regAddr, length, value, packet);
+        if (ret < 0) return ret;
+        packet.rawData = value;
+        if (!verifyWrite) return ret;
+
+        // 回读校验：只比较掩码内的位，其余位可能是从机自行变化的状态位
+        ResponsePacket readPacket;
+        ret = ExecuteCommandLocked(slaveAddr, CommandType::Read, regAddr, length, {}, readPacket);
+        if (ret < 0) {
+            CopyResult(readPacket, packet);
+            return ret;
+        }
+        bool match = readPacket.rawData.size() >= value.size();
+        for (size_t i = 0; match && i < value.size(); ++i) {
+            match = ((readPacket.rawData[i] ^ value[i]) & WriteMaskByte(writeMask, i)) == 0;
+        }
+        packet.rawData = readPacket.rawData;
+        if (!match) {
+            packet.success = false;
+            packet.errorType = ErrorType::VerifyMismatch;
+            // 描述只用固定文本：字节每次可能不同，拼进描述会让驻留池无限增长
+            packet.errorDetail = "回读校验失败";
+            packet.writtenData = std::move(value);
+        }
+        return ret;
+    }
+
     void HardwareService::ProcessTask(const HardwareTask& task) {
+        ProfileZone zone("HardwareService::ProcessTask");
         auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count();
 
@@ -282,7 +764,10 @@ namespace I2CDebugger {
             std::string errorMsg;
 
             if (success) {
+                // 波特率或设备变化后旧的耗时样本不再适用
+                ResetLatencyProfiles();
                 success = m_pmbus.Configure(task.baudRate);
+                m_baudRate = task.baudRate;
                 if (!success) {
                     errorMsg = m_pmbus.GetLastError();
                     m_pmbus.Close();
@@ -308,7 +793,8 @@ namespace I2CDebugger {
                 m_pmbus.Close();
             }
             m_isConnected = false;
-            m_periodicRunning = false;
+            ClearPeriodicPrograms();
+            ResetSlaveHealth();
 
             if (m_connectCallback) {
                 std::lock_guard<std::mutex> cbLock(m_callbackMutex);
@@ -354,125 +840,49 @@ namespace I2CDebugger {
             break;
         }
 
-        case TaskType::ReadRegister: {
+        case TaskType::FusedWrite: {
             ResponsePacket packet;
             packet.controlId = task.controlId;
             packet.commandId = task.commandId;
+            packet.entryHandle = task.entryHandle;
             packet.timestamp = now;
 
-            std::vector<uint8_t> result;
-            int ret;
-            {
-                std::lock_guard<std::mutex> lock(m_deviceMutex);
-                ret = m_pmbus.Read(task.slaveAddr, task.regAddr, task.length, result);
-                if (ret < 0) {
-                    packet.errorMsg = m_pmbus.GetLastError();
-                }
-            }
-
-            packet.success = (ret >= 0);
-            packet.errorType = GetErrorType(ret);
-            if (packet.success) {
-                packet.rawData = result;
-            }
+            int ret = ExecuteFusedWrite(task.slaveAddr, task.regAddr, task.data, task.writeMask, task.verifyWrite, packet);
 
+            PostDataPacket(packet);
             if (ret == DEVICE_NOT_CONNECTED) {
-                if (m_dataCallback) {
-                    std::lock_guard<std::mutex> cbLock(m_callbackMutex);
-                    m_callbackQueue.push([this, packet]() {
-                        m_dataCallback(packet);
-                        });
-                }
                 HandleDeviceDisconnected();
-                break;
-            }
-
-            if (m_dataCallback) {
-                std::lock_guard<std::mutex> cbLock(m_callbackMutex);
-                m_callbackQueue.push([this, packet]() {
-                    m_dataCallback(packet);
-                    });
-            }
-            break;
-        }
-
-        case TaskType::WriteRegister: {
-            ResponsePacket packet;
-            packet.controlId = task.controlId;
-            packet.commandId = task.commandId;
-            packet.timestamp = now;
-
-            int ret;
-            {
-                std::lock_guard<std::mutex> lock(m_deviceMutex);
-                ret = m_pmbus.Write(task.slaveAddr, task.regAddr, task.data);
-                if (ret < 0) {
-                    packet.errorMsg = m_pmbus.GetLastError();
-                }
-            }
-
-            packet.success = (ret >= 0);
-            packet.errorType = GetErrorType(ret);
-
-            if (ret == DEVICE_NOT_CONNECTED) {
-                if (m_dataCallback) {
-                    std::lock_guard<std::mutex> cbLock(m_callbackMutex);
-                    m_callbackQueue.push([this, packet]() {
-                        m_dataCallback(packet);
-                        });
-                }
-                HandleDeviceDisconnected();
-                break;
-            }
-
-            if (m_dataCallback) {
-                std::lock_guard<std::mutex> cbLock(m_callbackMutex);
-                m_callbackQueue.push([this, packet]() {
-                    m_dataCallback(packet);
-                    });
             }
             break;
         }
 
+        case TaskType::ReadRegister:
+        case TaskType::WriteRegister:
         case TaskType::SendCommand: {
             ResponsePacket packet;
             packet.controlId = task.controlId;
             packet.commandId = task.commandId;
+            packet.entryHandle = task.entryHandle;
             packet.timestamp = now;
 
-            int ret;
-            {
-                std::lock_guard<std::mutex> lock(m_deviceMutex);
-                ret = m_pmbus.SendByte(task.slaveAddr, task.regAddr);
-                if (ret < 0) {
-                    packet.errorMsg = m_pmbus.GetLastError();
-                }
-            }
+            CommandType type = CommandType::Read;
+            if (task.type == TaskType::WriteRegister) type = CommandType::Write;
+            else if (task.type == TaskType::SendCommand) type = CommandType::SendCommand;
 
-            packet.success = (ret >= 0);
-            packet.errorType = GetErrorType(ret);
+            int ret = ExecuteCommand(task.slaveAddr, type, task.regAddr, task.length, task.data, packet);
 
+            PostDataPacket(packet);
             if (ret == DEVICE_NOT_CONNECTED) {
-                if (m_dataCallback) {
-                    std::lock_guard<std::mutex> cbLock(m_callbackMutex);
-                    m_callbackQueue.push([this, packet]() {
-                        m_dataCallback(packet);
-                        });
-                }
                 HandleDeviceDisconnected();
-                break;
-            }
-
-            if (m_dataCallback) {
-                std::lock_guard<std::mutex> cbLock(m_callbackMutex);
-                m_callbackQueue.push([this, packet]() {
-                    m_dataCallback(packet);
-                    });
             }
             break;
         }
 
         case TaskType::ReadAllRegisters: {
+            BatchCompletion batch;
+            batch.controlId = 1;
+            batch.batchId = task.batchId;
+
             for (size_t i = 0; i < task.registerEntries.size() && m_isConnected; i++) {
                 ProcessPriorityTasks();
                 if (!m_isConnected) break;
@@ -482,42 +892,36 @@ namespace I2CDebugger {
                 ResponsePacket packet;
                 packet.controlId = 1;
                 packet.commandId = static_cast<uint32_t>(i);
+                packet.entryHandle = entry.handle;
+                packet.batchId = task.batchId;
                 packet.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
                     std::chrono::system_clock::now().time_since_epoch()).count();
 
-                std::vector<uint8_t> result;
-                int ret;
-                {
-                    std::lock_guard<std::mutex> lock(m_deviceMutex);
-                    ret = m_pmbus.Read(slaveAddr, entry.regAddress, entry.length, result);
-                    if (ret < 0) {
-                        packet.errorMsg = m_pmbus.GetLastError();
-                    }
-                }
-
-                packet.success = (ret >= 0);
-                packet.errorType = GetErrorType(ret);
+                int ret = ExecuteCommand(slaveAddr, CommandType::Read, entry.regAddress, entry.length, {}, packet);
+                batch.executedCount++;
+                if (!packet.success) batch.failedCount++;
 
-                if (packet.success) {
-                    packet.rawData = result;
-                }
-
-                if (m_dataCallback) {
-                    std::lock_guard<std::mutex> cbLock(m_callbackMutex);
-                    m_callbackQueue.push([this, packet]() {
-                        m_dataCallback(packet);
-                        });
-                }
+                PostDataPacket(packet);
 
                 if (ret == DEVICE_NOT_CONNECTED) {
                     HandleDeviceDisconnected();
                     break;
                 }
             }
+
+            batch.aborted = batch.executedCount < task.registerEntries.size();
+            batch.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            PostBatchCompletion(batch);
             break;
         }
 
         case TaskType::ExecuteAllCommands: {
+            BatchCompletion batch;
+            batch.controlId = 2;
+            batch.batchId = task.batchId;
+            bool interrupted = false;
+
             for (size_t i = 0; i < task.singleEntries.size() && m_isConnected; i++) {
                 ProcessPriorityTasks();
                 if (!m_isConnected) break;
@@ -530,46 +934,22 @@ namespace I2CDebugger {
                 ResponsePacket packet;
                 packet.controlId = 2;
                 packet.commandId = static_cast<uint32_t>(i);
+                packet.entryHandle = entry.handle;
+                packet.batchId = task.batchId;
                 packet.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
                     std::chrono::system_clock::now().time_since_epoch()).count();
 
-                int ret = 0;
+                int ret = (entry.type == CommandType::Write)
+                    ? ExecuteFusedWrite(slaveAddr, entry.regAddress, entry.data, entry.writeMask, entry.verifyWrite, packet)
+                    : ExecuteCommand(slaveAddr, entry.type, entry.regAddress, entry.length, entry.data, packet);
+                batch.executedCount++;
+                if (!packet.success) batch.failedCount++;
 
-                {
-                    std::lock_guard<std::mutex> lock(m_deviceMutex);
-                    switch (entry.type) {
-                    case CommandType::Read: {
-                        std::vector<uint8_t> result;
-                        ret = m_pmbus.Read(slaveAddr, entry.regAddress, entry.length, result);
-                        if (ret >= 0) {
-                            packet.rawData = result;
-                        }
-                        break;
-                    }
-                    case CommandType::Write:ret = m_pmbus.Write(slaveAddr, entry.regAddress, entry.data);
-                        break;
-                    case CommandType::SendCommand:
-                        ret = m_pmbus.SendByte(slaveAddr, entry.regAddress);
-                        break;
-                    }
-
-                    if (ret < 0) {
-                        packet.errorMsg = m_pmbus.GetLastError();
-                    }
-                }
-
-                packet.success = (ret >= 0);
-                packet.errorType = GetErrorType(ret);
-
-                if (m_dataCallback) {
-                    std::lock_guard<std::mutex> cbLock(m_callbackMutex);
-                    m_callbackQueue.push([this, packet]() {
-                        m_dataCallback(packet);
-                        });
-                }
+                PostDataPacket(packet);
 
                 if (ret == DEVICE_NOT_CONNECTED) {
                     HandleDeviceDisconnected();
+                    interrupted = true;
                     break;
                 }
 
@@ -577,6 +957,11 @@ namespace I2CDebugger {
                     std::this_thread::sleep_for(std::chrono::milliseconds(entry.delayMs));
                 }
             }
+
+            batch.aborted = interrupted || !m_isConnected;
+            batch.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            PostBatchCompletion(batch);
             break;
         }
 
@@ -585,79 +970,193 @@ namespace I2CDebugger {
         }
     }
 
-    void HardwareService::ExecutePeriodicTask() {
-        if (!m_isConnected || !m_periodicRunning) return;
+    bool HardwareService::ExecutePeriodicStep(std::chrono::steady_clock::duration& idleWait) {
+        ProfileZone zone("HardwareService::ExecutePeriodicStep");
+        using Clock = std::chrono::steady_clock;
+
+        PeriodicTriggerEntry entry;
+        uint32_t groupId = 0;
+        uint32_t batchId = 0;
+        uint8_t slaveAddr = 0;
+        size_t index = 0;
+        bool found = false;
+
+        // 本次新标记为过期的条目（解锁后再回传）
+        struct StaleEntry {
+            EntryHandle handle;
+            uint32_t batchId;
+            uint32_t index;
+        };
+        std::vector<StaleEntry> stale;
+        std::vector<BatchCompletion> completed;
+
+        auto now = Clock::now();
+        idleWait = std::chrono::milliseconds(50);
 
-        auto startTime = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_periodicMutex);
+            size_t count = m_periodicPrograms.size();
 
-        for (size_t i = 0; i < m_periodicEntries.size() && m_periodicRunning && m_isConnected; i++) {
-            ProcessPriorityTasks();
-            if (!m_isConnected || !m_periodicRunning) break;
+            // 轮询各组，找到第一个已到期的条目
+            for (size_t n = 0; n < count && !found; n++) {
+                size_t pi = (m_periodicRoundRobin + n) % count;
+                PeriodicProgram& program = m_periodicPrograms[pi];
 
-            const auto& entry = m_periodicEntries[i];
-            if (!entry.enabled) continue;
+                auto readyAt = program.inCycle ? program.resumeAt : program.nextCycleAt;
+                if (readyAt > now) {
+                    idleWait = (std::min)(idleWait, readyAt - now);
+                    continue;
+                }
+
+                if (!program.inCycle) {
+                    program.inCycle = true;
+                    program.cursor = 0;
+                    program.cycleStart = now;
+                    program.cycleBusy = Clock::duration::zero();
+                    program.batch = BatchCompletion();
+                    program.batch.controlId = 3;
+                    program.batch.batchId = program.batchId;
+                    program.batch.groupId = program.groupId;
+                }
+
+                // 跳过禁用条目和已挂起从机的条目；探测时间已到的条目照常执行，充当探测
+                while (program.cursor < program.entries.size()) {
+                    const PeriodicTriggerEntry& candidate = program.entries[program.cursor];
+                    if (candidate.enabled) {
+                        uint8_t addr = candidate.overrideSlaveAddr ? candidate.slaveAddress : program.slaveAddr;
+                        SlaveHealth& health = m_slaveHealth[addr & 0x7F];
+                        if (!health.suspended || now >= health.nextProbeAt) break;
+
+                        health.skippedCount++;
+                        program.batch.skippedCount++;
+                        if (program.staleEpoch[program.cursor] != health.suspendEpoch) {
+                            program.staleEpoch[program.cursor] = health.suspendEpoch;
+                            stale.push_back({ candidate.handle, program.batchId, static_cast<uint32_t>(program.cursor) });
+                        }
+                    }
+                    program.cursor++;
+                }
+
+                if (program.cursor >= program.entries.size()) {
+                    // 整轮都被跳过时也要上报，日志照常写一行（挂起条目为 NaN）
+                    if (FinishPeriodicCycle(program, now)) completed.push_back(program.batch);
+                    auto wait = program.nextCycleAt - now;
+                    if (wait > Clock::duration::zero()) {
+                        idleWait = (std::min)(idleWait, wait);
+                    }
+                    continue;
+                }
 
-            uint8_t slaveAddr = entry.overrideSlaveAddr ? entry.slaveAddress : m_periodicSlaveAddr;
+                entry = program.entries[program.cursor];
+                index = program.cursor;
+                groupId = program.groupId;
+                batchId = program.batchId;
+                slaveAddr = entry.overrideSlaveAddr ? entry.slaveAddress : program.slaveAddr;
+                m_periodicRoundRobin = pi + 1;
+                found = true;
+            }
+        }
 
+        if (!stale.empty()) {
+            static const InternedString s_staleDetail("从机连续无响应，已暂停轮询，等待探测恢复");
             ResponsePacket packet;
             packet.controlId = 3;
-            packet.commandId = static_cast<uint32_t>(i);
+            packet.success = false;
+            packet.errorType = ErrorType::SlaveSuspended;
+            packet.errorDetail = s_staleDetail;
             packet.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::system_clock::now().time_since_epoch()).count();
+            for (const auto& item : stale) {
+                packet.entryHandle = item.handle;
+                packet.batchId = item.batchId;
+                packet.commandId = item.index;
+                PostDataPacket(packet);
+            }
+        }
 
-            int ret = 0;
+        // 完成事件排在过期包之后，写日志行时条目已标记为过期
+        for (const auto& batch : completed) {
+            PostBatchCompletion(batch);
+        }
 
-            {
-                std::lock_guard<std::mutex> lock(m_deviceMutex);
+        if (!found) {
+            if (idleWait < std::chrono::milliseconds(1)) {
+                idleWait = std::chrono::milliseconds(1);
+            }
+            return false;
+        }
 
-                switch (entry.type) {
-                case CommandType::Read: {
-                    std::vector<uint8_t> result;
-                    ret = m_pmbus.Read(slaveAddr, entry.regAddress, entry.length, result);
-                    if (ret >= 0) {
-                        packet.rawData = result;
-                    }
-                    break;
-                }
-                case CommandType::Write:
-                    ret = m_pmbus.Write(slaveAddr, entry.regAddress, entry.data);
-                    break;
-                case CommandType::SendCommand:
-                    ret = m_pmbus.SendByte(slaveAddr, entry.regAddress);
-                    break;
-                }
+        ResponsePacket packet;
+        packet.controlId = 3;
+        packet.commandId = static_cast<uint32_t>(index);
+        packet.entryHandle = entry.handle;
+        packet.batchId = batchId;
+        packet.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        auto start = Clock::now();
+        int ret = (entry.type == CommandType::Write)
+            ? ExecuteFusedWrite(slaveAddr, entry.regAddress, entry.data, entry.writeMask, entry.verifyWrite, packet)
+            : ExecuteCommand(slaveAddr, entry.type, entry.regAddress, entry.length, entry.data, packet);
+        auto end = Clock::now();
 
-                if (ret < 0) {
-                    packet.errorMsg = m_pmbus.GetLastError();
+        PostDataPacket(packet);
+
+        if (ret == DEVICE_NOT_CONNECTED) {
+            // 断开前把所有未完成的轮次标记为 aborted
+            std::vector<BatchCompletion> aborted;
+            {
+                std::lock_guard<std::mutex> lock(m_periodicMutex);
+                for (auto& program : m_periodicPrograms) {
+                    if (!program.inCycle) continue;
+                    program.batch.aborted = true;
+                    program.batch.timestamp = packet.timestamp;
+                    aborted.push_back(program.batch);
                 }
             }
+            for (const auto& batch : aborted) {
+                PostBatchCompletion(batch);
+            }
+            HandleDeviceDisconnected();
+            return true;
+        }
 
-            packet.success = (ret >= 0);
-            packet.errorType = GetErrorType(ret);
+        std::lock_guard<std::mutex> lock(m_periodicMutex);
+        for (auto& program : m_periodicPrograms) {
+            // 执行期间该组可能已被停止或重新启动
+            if (program.groupId != groupId || program.batchId != batchId || !program.inCycle) continue;
 
-            if (m_dataCallback) {
-                std::lock_guard<std::mutex> cbLock(m_callbackMutex);
-                m_callbackQueue.push([this, packet]() {
-                    m_dataCallback(packet);
-                    });
-            }
+            program.batch.executedCount++;
+            if (!packet.success) program.batch.failedCount++;
+            program.cycleBusy += end - start;
+            program.cursor = index + 1;
+            program.resumeAt = end + std::chrono::milliseconds(entry.delayMs);
 
-            if (ret == DEVICE_NOT_CONNECTED) {
-                HandleDeviceDisconnected();
-                return;
+            if (program.cursor >= program.entries.size() && entry.delayMs == 0) {
+                if (FinishPeriodicCycle(program, end)) PostBatchCompletion(program.batch);
             }
+            break;
+        }
+        return true;
+    }
 
-            if (entry.delayMs > 0) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(entry.delayMs));
-            }
+    // 返回本轮是否需要上报完成事件（有条目执行或被跳过），由调用方在合适的时机发送
+    bool HardwareService::FinishPeriodicCycle(PeriodicProgram& program, std::chrono::steady_clock::time_point now) {
+        bool report = program.batch.executedCount > 0 || program.batch.skippedCount > 0;
+        if (report) {
+            program.batch.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
         }
 
-        if (m_periodicRunning && m_isConnected) {
-            auto elapsed = std::chrono::steady_clock::now() - startTime;
-            auto remaining = std::chrono::milliseconds(m_periodicIntervalMs) - elapsed;
-            if (remaining.count() > 0) {
-                std::this_thread::sleep_for(remaining);
-            }
+        program.lastCycleMs = std::chrono::duration<double, std::milli>(now - program.cycleStart).count();
+        program.lastBusyMs = std::chrono::duration<double, std::milli>(program.cycleBusy).count();
+
+        program.nextCycleAt = program.cycleStart + std::chrono::milliseconds(program.intervalMs);
+        if (program.nextCycleAt < now) {
+            program.nextCycleAt = now;
+            program.overrunCount++;
         }
+        program.inCycle = false;
+        return report;
     }
 }
@@ -9,6 +9,7 @@
 #include <thread>
 #include <atomic>
 #include <condition_variable>
+#include <chrono>
 
 namespace I2CDebugger {
 
@@ -20,6 +21,7 @@ namespace I2CDebugger {
         ReadRegister,
         WriteRegister,
         SendCommand,
+        FusedWrite,
         ReadAllRegisters,
         ExecuteAllCommands,
         StartPeriodic,
@@ -35,20 +37,139 @@ namespace I2CDebugger {
         std::vector<uint8_t> data;
         uint32_t controlId = 0;
         uint32_t commandId = 0;
+        EntryHandle entryHandle = INVALID_ENTRY_HANDLE;
+        uint32_t batchId = 0;
         uint32_t baudRate = BAUD_RATE_100K;
         uint32_t delayMs = 0;
         CommandType cmdType = CommandType::Read;
+        uint32_t writeMask = 0;
+        bool verifyWrite = false;
         std::vector<RegisterEntry> registerEntries;
         std::vector<SingleTriggerEntry> singleEntries;
         std::vector<PeriodicTriggerEntry> periodicEntries;
         uint32_t intervalMs = 100;
     };
 
+    // ========== 周期程序（每个命令组一份） ==========
+    struct PeriodicProgram {
+        uint32_t groupId = 0;
+        uint32_t batchId = 0;
+        uint8_t slaveAddr = 0;
+        uint32_t intervalMs = 100;
+        std::vector<PeriodicTriggerEntry> entries;
+        std::vector<uint32_t> staleEpoch;                       // 条目已按第几次挂起标记过期
+
+        // 调度状态（持有 m_periodicMutex 时访问）
+        size_t cursor = 0;                                      // 本轮下一个条目
+        bool inCycle = false;
+        std::chrono::steady_clock::time_point cycleStart;
+        std::chrono::steady_clock::time_point nextCycleAt;      // 下一轮最早开始时间
+        std::chrono::steady_clock::time_point resumeAt;         // 条目延时结束时间
+        BatchCompletion batch;
+        std::chrono::steady_clock::duration cycleBusy{};        // 本轮占用总线时间
+
+        // 统计
+        double lastCycleMs = 0.0;       // 上一轮实际周期
+        double lastBusyMs = 0.0;        // 上一轮总线占用
+        uint32_t overrunCount = 0;      // 未能按间隔开始的轮数
+    };
+
+    // ========== 从机健康状态（周期执行熔断） ==========
+    // 连续 NAK 达到阈值后挂起该从机：周期条目不再访问总线，直接标记为过期；
+    // 按指数退避的间隔用下一个到期条目做一次探测，任何一次成功的事务都会立即恢复
+    constexpr uint32_t SLAVE_SUSPEND_THRESHOLD = 3;
+    constexpr uint32_t SLAVE_PROBE_MIN_MS = 200;
+    constexpr uint32_t SLAVE_PROBE_MAX_MS = 5000;
+
+    struct SlaveHealth {
+        uint32_t consecutiveNaks = 0;
+        bool suspended = false;
+        uint32_t suspendEpoch = 0;      // 每次挂起加一
+        uint32_t suspendCount = 0;
+        uint32_t backoffMs = 0;
+        std::chrono::steady_clock::time_point nextProbeAt;
+        uint64_t skippedCount = 0;      // 挂起期间跳过的周期条目
+    };
+
+    struct SuspendedSlaveInfo {
+        uint8_t address = 0;
+        uint32_t consecutiveNaks = 0;
+        uint32_t backoffMs = 0;
+        double nextProbeInMs = 0.0;
+        uint32_t suspendCount = 0;
+        uint64_t skippedCount = 0;
+    };
+
+    // ========== 自适应响应超时 ==========
+    // 按从机、读/写分别记录最近的事务耗时，取 P99 乘安全系数再加余量作为该类事务的 HID 响应超时，
+    // 限制在 [ADAPTIVE_TIMEOUT_MIN_MS, DEFAULT_RESPONSE_TIMEOUT] 之间；样本不足时使用默认值。
+    // 使用学习值的事务失败时清空样本回到默认值，避免把偶发的慢响应误判为 NAK
+    constexpr uint32_t ADAPTIVE_TIMEOUT_MIN_MS = 10;
+    constexpr uint32_t ADAPTIVE_TIMEOUT_MARGIN_MS = 5;
+    constexpr double ADAPTIVE_TIMEOUT_FACTOR = 3.0;
+    constexpr double ADAPTIVE_TIMEOUT_PERCENTILE = 0.99;
+    constexpr uint32_t ADAPTIVE_TIMEOUT_MIN_SAMPLES = 16;
+    constexpr uint32_t ADAPTIVE_TIMEOUT_REUSE_RATIO = 2;     // 设备当前超时在所需值 1~2 倍内时不切换
+    constexpr int LATENCY_SAMPLE_COUNT = 32;
+
+    struct LatencyProfile {
+        float samplesMs[LATENCY_SAMPLE_COUNT] = {};
+        uint32_t sampleCount = 0;                       // 累计样本数，超过容量后环形覆盖
+        uint32_t timeoutMs = DEFAULT_RESPONSE_TIMEOUT;  // 当前使用的超时
+        double percentileMs = 0.0;
+        uint32_t fallbackCount = 0;                     // 学习值下失败、回退默认值的次数
+    };
+
+    struct SlaveTimeoutInfo {
+        uint8_t address = 0;
+        bool isWrite = false;           // 写/发送命令，否则为读
+        uint32_t timeoutMs = 0;
+        double percentileMs = 0.0;
+        uint32_t sampleCount = 0;
+        uint32_t fallbackCount = 0;
+    };
+
+    // ========== 总线负载统计 ==========
+    struct PeriodicGroupLoad {
+        uint32_t groupId = 0;
+        uint32_t intervalMs = 0;
+        double lastCycleMs = 0.0;
+        double lastBusyMs = 0.0;
+        uint32_t overrunCount = 0;
+        double wireMs = 0.0;            // 一轮理论线上时间
+        double maxPollRateHz = 0.0;     // 单独运行时可达到的最高轮询频率
+    };
+
+    struct BusLoadStats {
+        double busyPercent = 0.0;       // 最近一秒实测总线占用（含 HID 往返）
+        double utilizationPercent = 0.0;// 最近一秒理论线上时间占比（SCL 实际在传输的时间）
+        double demandPercent = 0.0;     // 各组 上一轮占用/间隔 之和，>100% 表示周期会被拉长
+        double bytesPerSecond = 0.0;    // 线上字节数（地址、寄存器、数据）
+        double hidOverheadRatio = 0.0;  // 实测耗时 / 理论线上时间
+        uint32_t transactionsPerSecond = 0;
+        std::vector<PeriodicGroupLoad> groups;
+        std::vector<SuspendedSlaveInfo> suspendedSlaves;
+        std::vector<SlaveTimeoutInfo> timeoutProfiles;  // 已学习出非默认超时的从机
+        uint32_t timeoutSwitches = 0;   // 实际下发超时配置的次数
+        uint64_t timeoutReuses = 0;     // 超时与设备当前值相同、省去 HID 配置往返的事务数
+    };
+
+    // 周期程序的容量预估（启动前即可计算）
+    struct PeriodicCapacity {
+        double wireMs = 0.0;            // 一轮理论线上时间
+        double predictedCycleMs = 0.0;  // 按实测 HID 开销预估的一轮耗时（含条目延时）
+        double maxPollRateHz = 0.0;
+    };
+
+    // 未测得实际开销前，每个事务的默认 HID 往返开销
+    constexpr double DEFAULT_HID_OVERHEAD_MS = 2.0;
+
     // ========== 回调类型定义 ==========
     using ConnectCallback = std::function<void(bool success, const std::string& deviceName, const std::string& errorMsg)>;
     using DisconnectCallback = std::function<void()>;
     using ScanCallback = std::function<void(bool success, const std::vector<uint8_t>& slaves, const std::string& errorMsg)>;
     using DataCallback = std::function<void(const ResponsePacket& packet)>;
+    using BatchCallback = std::function<void(const BatchCompletion& batch)>;
 
     // ========== 硬件服务类 ==========
     class HardwareService {
@@ -74,30 +195,40 @@ namespace I2CDebugger {
         void SendCommand(uint8_t slaveAddr, uint8_t regAddr,
             uint32_t controlId, uint32_t commandId);
 
-        // 批量操作
-        void ReadAllRegisters(uint8_t defaultSlaveAddr, const std::vector<RegisterEntry>& entries);
-        void ExecuteAllSingleTrigger(uint8_t defaultSlaveAddr, const std::vector<SingleTriggerEntry>& entries);
+        // 批量操作（返回批次ID，结束时通过 BatchCallback 通知）
+        uint32_t ReadAllRegisters(uint8_t defaultSlaveAddr, const std::vector<RegisterEntry>& entries);
+        uint32_t ExecuteAllSingleTrigger(uint8_t defaultSlaveAddr, const std::vector<SingleTriggerEntry>& entries);
 
-        // 周期执行
-        void StartPeriodicExecution(uint8_t defaultSlaveAddr,
+        // 周期执行（按命令组独立启停，多个组在同一总线上轮流交错执行；
+        // 每轮结束发送一次 BatchCompletion，批次ID在该组运行期间不变）
+        uint32_t StartPeriodicExecution(uint32_t groupId, uint8_t defaultSlaveAddr,
             const std::vector<PeriodicTriggerEntry>& entries,
             uint32_t intervalMs);
-        void StopPeriodicExecution();
+        void StopPeriodicExecution(uint32_t groupId);
+        void StopAllPeriodicExecution();
 
         // 优先级插入（周期执行期间的单次操作）
         void InsertSingleRead(uint8_t slaveAddr, uint8_t regAddr, uint8_t length,
-            uint32_t controlId, uint32_t commandId);
+            uint32_t controlId, uint32_t commandId, EntryHandle entryHandle = INVALID_ENTRY_HANDLE);
         void InsertSingleWrite(uint8_t slaveAddr, uint8_t regAddr,
             const std::vector<uint8_t>& data,
-            uint32_t controlId, uint32_t commandId);
+            uint32_t controlId, uint32_t commandId, EntryHandle entryHandle = INVALID_ENTRY_HANDLE);
         void InsertSingleCommand(uint8_t slaveAddr, uint8_t regAddr,
-            uint32_t controlId, uint32_t commandId);
+            uint32_t controlId, uint32_t commandId, EntryHandle entryHandle = INVALID_ENTRY_HANDLE);
+
+        // 组合写入：writeMask 非 0 时先读出当前值、只替换掩码内的位再写回（读-改-写），
+        // verifyWrite 时写入后立即回读比较；各步在一次设备锁内连续执行，不会被其他事务插入，
+        // 只回传一个结果包（rawData 为回读值或实际写入值，校验不一致时 errorType 为 VerifyMismatch）
+        void InsertFusedWrite(uint8_t slaveAddr, uint8_t regAddr,
+            const std::vector<uint8_t>& data, uint32_t writeMask, bool verifyWrite,
+            uint32_t controlId, uint32_t commandId, EntryHandle entryHandle = INVALID_ENTRY_HANDLE);
 
         // 回调设置
         void SetConnectCallback(ConnectCallback callback) { m_connectCallback = callback; }
         void SetDisconnectCallback(DisconnectCallback callback) { m_disconnectCallback = callback; }
         void SetScanCallback(ScanCallback callback) { m_scanCallback = callback; }
         void SetDataCallback(DataCallback callback) { m_dataCallback = callback; }
+        void SetBatchCallback(BatchCallback callback) { m_batchCallback = callback; }
 
         // 在主线程中处理回调
         void ProcessCallbacks();
@@ -105,15 +236,42 @@ namespace I2CDebugger {
         // 状态查询
         bool IsConnected() const { return m_isConnected; }
         bool IsPeriodicRunning() const { return m_periodicRunning; }
+        bool IsPeriodicRunning(uint32_t groupId) const;
+        BusLoadStats GetBusLoadStats() const;
+        PeriodicCapacity EstimatePeriodicCapacity(const std::vector<PeriodicTriggerEntry>& entries) const;
+
+        // 按 I2C 帧格式计算一次事务的理论线上时间（微秒）：
+        // 每字节 8 位数据 + 1 位 ACK，外加 START/重复START/STOP 各 1 位
+        static double EstimateWireTimeUs(CommandType type, uint8_t length, size_t dataSize, uint32_t baudRate);
+        static uint32_t EstimateWireBytes(CommandType type, uint8_t length, size_t dataSize);
 
     private:
         // 工作线程
         void WorkerThread();
         void ProcessTask(const HardwareTask& task);
-        void ExecutePeriodicTask();
+        bool ExecutePeriodicStep(std::chrono::steady_clock::duration& idleWait);
+        bool FinishPeriodicCycle(PeriodicProgram& program, std::chrono::steady_clock::time_point now);
+        void ClearPeriodicPrograms();
+        void ResetSlaveHealth();
+        void UpdateSlaveHealth(uint8_t slaveAddr, ErrorType errorType, std::chrono::steady_clock::time_point now);
         void ProcessPriorityTasks();
         void HandleDeviceDisconnected();
         ErrorType GetErrorType(int returnValue);  // 修复：分开两行
+        void PostDataPacket(const ResponsePacket& packet);
+        void PostBatchCompletion(const BatchCompletion& batch);
+
+        // 所有总线事务的统一入口（加设备锁、填充数据包、记录总线占用）
+        int ExecuteCommand(uint8_t slaveAddr, CommandType type, uint8_t regAddr, uint8_t length,
+            const std::vector<uint8_t>& data, ResponsePacket& packet);
+        int ExecuteCommandLocked(uint8_t slaveAddr, CommandType type, uint8_t regAddr, uint8_t length,
+            const std::vector<uint8_t>& data, ResponsePacket& packet);     // 调用方已持有 m_deviceMutex
+        int ExecuteFusedWrite(uint8_t slaveAddr, uint8_t regAddr, const std::vector<uint8_t>& data,
+            uint32_t writeMask, bool verifyWrite, ResponsePacket& packet);
+        void RecordBusActivity(std::chrono::steady_clock::duration busy, double wireUs, uint32_t wireBytes);
+        uint32_t GetAdaptiveTimeout(uint8_t slaveAddr, CommandType type) const;
+        void RecordLatency(uint8_t slaveAddr, CommandType type, int ret, uint32_t timeoutMs,
+            std::chrono::steady_clock::duration elapsed);
+        void ResetLatencyProfiles();
 
         // 工作线程
         std::thread m_workerThread;               // 修复：单独一行
@@ -132,15 +290,40 @@ namespace I2CDebugger {
         DisconnectCallback m_disconnectCallback;
         ScanCallback m_scanCallback;
         DataCallback m_dataCallback;
+        BatchCallback m_batchCallback;
 
         // 回调队列（用于线程安全的回调）
         std::queue<std::function<void()>> m_callbackQueue;
         std::mutex m_callbackMutex;
 
         // 周期执行数据
-        std::vector<PeriodicTriggerEntry> m_periodicEntries;
-        uint8_t m_periodicSlaveAddr = 0;
-        uint32_t m_periodicIntervalMs = 100;
+        std::vector<PeriodicProgram> m_periodicPrograms;
+        size_t m_periodicRoundRobin = 0;
+        SlaveHealth m_slaveHealth[128];                 // 按 7 位地址索引，同样由 m_periodicMutex 保护
+        mutable std::mutex m_periodicMutex;
+
+        // 总线负载统计（工作线程累加，每秒发布一次快照）
+        std::chrono::steady_clock::time_point m_loadWindowStart = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::duration m_loadWindowBusy{};
+        uint32_t m_loadWindowTransactions = 0;
+        double m_loadWindowWireUs = 0.0;
+        uint64_t m_loadWindowBytes = 0;
+        double m_busyPercent = 0.0;
+        double m_utilizationPercent = 0.0;
+        double m_bytesPerSecond = 0.0;
+        double m_hidOverheadRatio = 0.0;
+        double m_overheadPerTransactionMs = DEFAULT_HID_OVERHEAD_MS;  // 实测耗时与线上时间之差（滑动平均）
+        uint32_t m_transactionsPerSecond = 0;
+        mutable std::mutex m_statsMutex;
+        std::atomic<uint32_t> m_baudRate{ BAUD_RATE_100K };
+
+        // 自适应超时（按 7 位地址、读/写索引，由 m_statsMutex 保护）
+        LatencyProfile m_latencyProfiles[128][2];
+        uint32_t m_timeoutSwitches = 0;
+        uint64_t m_timeoutReuses = 0;
+
+        // 批次ID分配
+        std::atomic<uint32_t> m_nextBatchId{ 1 };
 
         // 硬件设备
         PMBus m_pmbus;
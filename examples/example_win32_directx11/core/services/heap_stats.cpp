@@ -0,0 +1,101 @@
+﻿// core/services/heap_stats.cpp - 全局堆分配计数
+#include "heap_stats.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace I2CDebugger {
+
+    namespace {
+
+        // 常量初始化，早于任何动态初始化中的 new
+        std::atomic<uint64_t> s_allocCount{ 0 };
+        std::atomic<uint64_t> s_freeCount{ 0 };
+        std::atomic<uint64_t> s_allocBytes{ 0 };
+
+        // 以下只由界面线程访问
+        struct FrameHistory {
+            HeapStats::Counters frameStart;
+            HeapStats::Counters lastFrame;
+            float history[HeapStats::HISTORY_SIZE] = {};
+            int offset = 0;
+        };
+
+        FrameHistory& GetFrameHistory() {
+            static FrameHistory s_history;
+            return s_history;
+        }
+
+        void* CountedAlloc(std::size_t size) noexcept {
+            void* ptr = std::malloc(size != 0 ? size : 1);
+            if (ptr != nullptr) {
+                s_allocCount.fetch_add(1, std::memory_order_relaxed);
+                s_allocBytes.fetch_add(size, std::memory_order_relaxed);
+            }
+            return ptr;
+        }
+
+        void CountedFree(void* ptr) noexcept {
+            if (ptr == nullptr) return;
+            s_freeCount.fetch_add(1, std::memory_order_relaxed);
+            std::free(ptr);
+        }
+
+    }
+
+    HeapStats::Counters HeapStats::GetTotals() {
+        Counters totals;
+        totals.allocCount = s_allocCount.load(std::memory_order_relaxed);
+        totals.freeCount = s_freeCount.load(std::memory_order_relaxed);
+        totals.allocBytes = s_allocBytes.load(std::memory_order_relaxed);
+        return totals;
+    }
+
+    void HeapStats::BeginFrame() {
+        FrameHistory& frames = GetFrameHistory();
+        const Counters now = GetTotals();
+        frames.lastFrame.allocCount = now.allocCount - frames.frameStart.allocCount;
+        frames.lastFrame.freeCount = now.freeCount - frames.frameStart.freeCount;
+        frames.lastFrame.allocBytes = now.allocBytes - frames.frameStart.allocBytes;
+        frames.frameStart = now;
+
+        frames.history[frames.offset] = static_cast<float>(frames.lastFrame.allocCount);
+        frames.offset = (frames.offset + 1) % HISTORY_SIZE;
+    }
+
+    const HeapStats::Counters& HeapStats::GetLastFrame() {
+        return GetFrameHistory().lastFrame;
+    }
+
+    const float* HeapStats::GetHistory() {
+        return GetFrameHistory().history;
+    }
+
+    int HeapStats::GetHistoryOffset() {
+        return GetFrameHistory().offset;
+    }
+
+}
+
+// 替换全局分配函数（未替换的对齐版本仍走运行库默认实现，不计数）
+void* operator new(std::size_t size) {
+    void* ptr = I2CDebugger::CountedAlloc(size);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    void* ptr = I2CDebugger::CountedAlloc(size);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return I2CDebugger::CountedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return I2CDebugger::CountedAlloc(size); }
+
+void operator delete(void* ptr) noexcept { I2CDebugger::CountedFree(ptr); }
+void operator delete[](void* ptr) noexcept { I2CDebugger::CountedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { I2CDebugger::CountedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { I2CDebugger::CountedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { I2CDebugger::CountedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { I2CDebugger::CountedFree(ptr); }
@@ -0,0 +1,31 @@
+﻿#pragma once
+
+#include <cstdint>
+
+namespace I2CDebugger {
+
+    // ========== 堆分配统计 ==========
+    // heap_stats.cpp 替换了全局 operator new/delete，所有线程的分配都按次数和字节累计（relaxed 原子量）。
+    // 界面线程每帧开始调用 BeginFrame()，记录上一帧的增量，用来检查稳定刷新时是否还有堆分配。
+    // ImGui 自身经 IM_ALLOC 的分配另见 Metrics 窗口的 "Memory allocations"。
+    class HeapStats {
+    public:
+        struct Counters {
+            uint64_t allocCount = 0;
+            uint64_t freeCount = 0;
+            uint64_t allocBytes = 0;
+        };
+
+        static constexpr int HISTORY_SIZE = 120;
+
+        static Counters GetTotals();
+
+        // 在每帧开始处（界面线程）调用
+        static void BeginFrame();
+        static const Counters& GetLastFrame();
+        // 最近 HISTORY_SIZE 帧的分配次数，环形缓冲区，GetHistoryOffset() 为最旧一项
+        static const float* GetHistory();
+        static int GetHistoryOffset();
+    };
+
+}
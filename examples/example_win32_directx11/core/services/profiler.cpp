@@ -0,0 +1,245 @@
+﻿// core/services/profiler.cpp - 作用域计时区段与 Chrome trace 导出
+#include "profiler.h"
+#include "imgui.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace I2CDebugger {
+
+    namespace {
+
+        constexpr uint64_t EVENT_CAPACITY = 1u << 14;   // 每线程保留的区段数
+        constexpr int FRAME_CAPACITY = 300;
+
+        // 读取方与写入方并发访问同一槽位，字段用 relaxed 原子量，x86 上与普通读写相同
+        struct EventSlot {
+            std::atomic<const char*> name{ nullptr };
+            std::atomic<int64_t> begin{ 0 };
+            std::atomic<int64_t> end{ 0 };
+            std::atomic<uint32_t> depth{ 0 };
+        };
+
+        struct ThreadBuffer {
+            uint32_t index = 0;
+            std::string name;                           // 受 Registry::mutex 保护
+            std::unique_ptr<EventSlot[]> slots{ new EventSlot[EVENT_CAPACITY] };
+            std::atomic<uint64_t> written{ 0 };         // 已写入总数，写完槽位后 release 发布
+            std::atomic<uint64_t> clearedAt{ 0 };       // 此前的条目视为已清除
+            uint32_t depth = 0;                         // 仅所属线程访问
+        };
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;    // 线程退出后保留，数据仍可导出
+            std::atomic<bool> enabled{ false };
+
+            // 帧边界只由界面线程读写
+            int64_t frameBegins[FRAME_CAPACITY] = {};
+            int frameCount = 0;
+        };
+
+        Registry& GetRegistry() {
+            static Registry* s_registry = new Registry();   // 不析构，工作线程可能晚于静态对象析构退出
+            return *s_registry;
+        }
+
+        thread_local ThreadBuffer* t_buffer = nullptr;
+
+        ThreadBuffer& GetThreadBuffer() {
+            if (t_buffer == nullptr) {
+                Registry& registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                registry.buffers.emplace_back(new ThreadBuffer());
+                t_buffer = registry.buffers.back().get();
+                t_buffer->index = static_cast<uint32_t>(registry.buffers.size() - 1);
+            }
+            return *t_buffer;
+        }
+
+        // 从新到旧扫描，区段按结束时间写入，结束时间早于 begin 后即可停止
+        void CollectBuffer(const ThreadBuffer& buffer, int64_t begin, int64_t end, std::vector<Profiler::Event>& out) {
+            const uint64_t written = buffer.written.load(std::memory_order_acquire);
+            const uint64_t cleared = buffer.clearedAt.load(std::memory_order_relaxed);
+            const uint64_t oldest = std::max(written > EVENT_CAPACITY ? written - EVENT_CAPACITY : 0, cleared);
+
+            std::vector<std::pair<uint64_t, Profiler::Event>> copied;
+            for (uint64_t i = written; i > oldest; i--) {
+                const EventSlot& slot = buffer.slots[(i - 1) & (EVENT_CAPACITY - 1)];
+                Profiler::Event event;
+                event.name = slot.name.load(std::memory_order_relaxed);
+                event.begin = slot.begin.load(std::memory_order_relaxed);
+                event.end = slot.end.load(std::memory_order_relaxed);
+                event.depth = slot.depth.load(std::memory_order_relaxed);
+                if (event.end < begin) break;
+                if (event.begin <= end) copied.emplace_back(i - 1, event);
+            }
+
+            // 复制期间写入方可能已绕回覆盖了最旧的槽位，这些条目丢弃
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t after = buffer.written.load(std::memory_order_relaxed);
+            const uint64_t valid = after > EVENT_CAPACITY ? after - EVENT_CAPACITY : 0;
+            for (auto it = copied.rbegin(); it != copied.rend(); ++it) {
+                if (it->first >= valid) out.push_back(it->second);
+            }
+        }
+
+        void WriteJsonString(std::ostream& out, const char* text) {
+            out << '"';
+            for (const char* p = text ? text : ""; *p; p++) {
+                const unsigned char c = static_cast<unsigned char>(*p);
+                if (c == '"' || c == '\\') {
+                    out << '\\' << *p;
+                }
+                else if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out << buf;
+                }
+                else {
+                    out << *p;
+                }
+            }
+            out << '"';
+        }
+
+    }
+
+    int64_t Profiler::Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void Profiler::SetEnabled(bool enabled) {
+        GetRegistry().enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool Profiler::IsEnabled() {
+        return GetRegistry().enabled.load(std::memory_order_relaxed);
+    }
+
+    int64_t Profiler::ZoneBegin() {
+        if (!GetRegistry().enabled.load(std::memory_order_relaxed)) return 0;
+        GetThreadBuffer().depth++;
+        return Now();
+    }
+
+    void Profiler::ZoneEnd(const char* name, int64_t begin) {
+        const int64_t end = Now();
+        ThreadBuffer& buffer = GetThreadBuffer();
+        buffer.depth--;
+
+        const uint64_t index = buffer.written.load(std::memory_order_relaxed);
+        EventSlot& slot = buffer.slots[index & (EVENT_CAPACITY - 1)];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.begin.store(begin, std::memory_order_relaxed);
+        slot.end.store(end, std::memory_order_relaxed);
+        slot.depth.store(buffer.depth, std::memory_order_relaxed);
+        buffer.written.store(index + 1, std::memory_order_release);
+    }
+
+    void Profiler::BeginFrame() {
+        Registry& registry = GetRegistry();
+        if (!registry.enabled.load(std::memory_order_relaxed)) return;
+        registry.frameBegins[registry.frameCount % FRAME_CAPACITY] = Now();
+        registry.frameCount++;
+    }
+
+    std::vector<Profiler::Frame> Profiler::GetFrames() {
+        Registry& registry = GetRegistry();
+        std::vector<Frame> frames;
+        const int available = std::min(registry.frameCount, FRAME_CAPACITY);
+        for (int i = registry.frameCount - available; i + 1 < registry.frameCount; i++) {
+            Frame frame;
+            frame.begin = registry.frameBegins[i % FRAME_CAPACITY];
+            frame.end = registry.frameBegins[(i + 1) % FRAME_CAPACITY];
+            frames.push_back(frame);
+        }
+        return frames;
+    }
+
+    void Profiler::SetThreadName(const char* name) {
+        ThreadBuffer& buffer = GetThreadBuffer();
+        std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+        buffer.name = name;
+    }
+
+    std::vector<Profiler::ThreadEvents> Profiler::Collect(int64_t begin, int64_t end) {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::vector<ThreadEvents> result;
+        for (const auto& buffer : registry.buffers) {
+            ThreadEvents thread;
+            CollectBuffer(*buffer, begin, end, thread.events);
+            if (thread.events.empty()) continue;
+            thread.threadIndex = buffer->index;
+            thread.name = buffer->name.empty() ? "线程 " + std::to_string(buffer->index) : buffer->name;
+            result.push_back(std::move(thread));
+        }
+        return result;
+    }
+
+    void Profiler::Clear() {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto& buffer : registry.buffers) {
+            buffer->clearedAt.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+        registry.frameCount = 0;
+    }
+
+    bool Profiler::ExportChromeTrace(const std::string& path, std::string& errorMsg) {
+        std::vector<ThreadEvents> threads = Collect(LLONG_MIN, LLONG_MAX);
+        if (threads.empty()) {
+            errorMsg = "没有可导出的区段";
+            return false;
+        }
+
+        int64_t origin = LLONG_MAX;
+        for (const auto& thread : threads) {
+            for (const auto& event : thread.events) origin = std::min(origin, event.begin);
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            errorMsg = "无法打开文件: " + path;
+            return false;
+        }
+
+        // 时间单位为微秒；"X" 为带时长的完整事件，"M" 为线程名元数据
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        char buf[96];
+        for (const auto& thread : threads) {
+            file << (first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << thread.threadIndex
+                << ",\"args\":{\"name\":";
+            WriteJsonString(file, thread.name.c_str());
+            file << "}}";
+            first = false;
+            for (const auto& event : thread.events) {
+                file << ",\n{\"ph\":\"X\",\"name\":";
+                WriteJsonString(file, event.name);
+                std::snprintf(buf, sizeof(buf), ",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    thread.threadIndex, (event.begin - origin) / 1000.0, (event.end - event.begin) / 1000.0);
+                file << buf;
+            }
+        }
+        file << "\n]}\n";
+
+        if (!file.good()) {
+            errorMsg = "写入失败: " + path;
+            return false;
+        }
+        return true;
+    }
+
+}
+
+// imgui_user_config.h 中 IM_PROFILE_SCOPE 使用的区段，供 ImGui 内部计时
+ImProfileZone::ImProfileZone(const char* name) : Name(name), Begin(I2CDebugger::Profiler::ZoneBegin()) {}
+ImProfileZone::~ImProfileZone() { if (Begin != 0) I2CDebugger::Profiler::ZoneEnd(Name, Begin); }
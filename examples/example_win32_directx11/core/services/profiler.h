@@ -0,0 +1,80 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace I2CDebugger {
+
+    // ========== CPU 剖析 ==========
+    // 作用域计时区段：构造时记录开始时间，析构时把完整区段写入本线程的环形缓冲区。
+    // 每个线程一个缓冲区，只有所属线程写入（原子下标发布，无锁）；界面线程按时间范围读取，
+    // 读取期间被覆盖的条目会被丢弃。未启用时构造/析构只读一个原子标志。
+    // 区段名必须是字符串字面量或生命周期足够长的字符串（只保存指针）。
+    //     void App::Render() {
+    //         ProfileZone zone("App::Render");
+    //         ...
+    //     }
+    // ImGui 内部的 NewFrame/EndFrame/Render 与表格布局通过 imgui_user_config.h 中的 IM_PROFILE_SCOPE 接入。
+    class ProfileZone {
+    public:
+        explicit ProfileZone(const char* name);
+        ~ProfileZone();
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+    private:
+        const char* m_name;
+        int64_t m_begin;        // 0 表示开始时未启用
+    };
+
+    class Profiler {
+    public:
+        struct Event {
+            const char* name = nullptr;
+            int64_t begin = 0;          // 纳秒，steady_clock
+            int64_t end = 0;
+            uint32_t depth = 0;         // 同一线程内的嵌套层数
+        };
+
+        struct ThreadEvents {
+            uint32_t threadIndex = 0;   // 按注册顺序，界面线程通常为 0
+            std::string name;
+            std::vector<Event> events;  // 按结束时间排序
+        };
+
+        struct Frame {
+            int64_t begin = 0;
+            int64_t end = 0;
+        };
+
+        static void SetEnabled(bool enabled);
+        static bool IsEnabled();
+
+        // 在每帧开始处（界面线程）调用，记录帧边界
+        static void BeginFrame();
+        // 最近的帧，旧帧在前；不含尚未结束的当前帧
+        static std::vector<Frame> GetFrames();
+
+        // 为当前线程的缓冲区命名，显示在时间线和导出文件中
+        static void SetThreadName(const char* name);
+
+        // 收集与 [begin, end] 相交的区段，每个有事件的线程一项
+        static std::vector<ThreadEvents> Collect(int64_t begin, int64_t end);
+
+        // 导出缓冲区中全部区段为 Chrome trace JSON（chrome://tracing、Perfetto 可打开）
+        static bool ExportChromeTrace(const std::string& path, std::string& errorMsg);
+
+        static int64_t Now();
+        static void Clear();
+
+        // ZoneBegin 返回 0 表示未启用，对应的 ZoneEnd 不记录
+        static int64_t ZoneBegin();
+        static void ZoneEnd(const char* name, int64_t begin);
+    };
+
+    inline ProfileZone::ProfileZone(const char* name) : m_name(name), m_begin(Profiler::ZoneBegin()) {}
+    inline ProfileZone::~ProfileZone() { if (m_begin != 0) Profiler::ZoneEnd(m_name, m_begin); }
+
+}
@@ -0,0 +1,880 @@
+﻿#include "register_map.h"
+#include "expression_parser.h"
+#include "core/nlohmann/json.hpp"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <map>
+
+namespace I2CDebugger {
+
+    using json = nlohmann::json;
+
+    namespace {
+
+        bool ReadWholeFile(const std::string& filePath, std::string& text) {
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file.is_open()) return false;
+            std::ostringstream ss;
+            ss << file.rdbuf();
+            text = ss.str();
+            return true;
+        }
+
+        std::string Trim(const std::string& s) {
+            size_t b = 0, e = s.size();
+            while (b < e && std::isspace(static_cast<unsigned char>(s[b]))) b++;
+            while (e > b && std::isspace(static_cast<unsigned char>(s[e - 1]))) e--;
+            return s.substr(b, e - b);
+        }
+
+        std::string ToLower(std::string s) {
+            for (auto& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            return s;
+        }
+
+        // "0x1A" / "1Ah" / "26"
+        bool ParseUInt(const std::string& text, uint32_t& value) {
+            std::string s = Trim(text);
+            if (s.empty()) return false;
+            int base = 10;
+            if (s.size() > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+                s = s.substr(2);
+                base = 16;
+            }
+            else if (s.size() > 1 && (s.back() == 'h' || s.back() == 'H')) {
+                s.pop_back();
+                base = 16;
+            }
+            char* end = nullptr;
+            unsigned long v = std::strtoul(s.c_str(), &end, base);
+            if (end == s.c_str() || *end != '\0') return false;
+            value = static_cast<uint32_t>(v);
+            return true;
+        }
+
+        bool ParseDouble(const std::string& text, double& value) {
+            std::string s = Trim(text);
+            if (s.empty()) return false;
+            char* end = nullptr;
+            double v = std::strtod(s.c_str(), &end);
+            if (end == s.c_str() || *end != '\0') return false;
+            value = v;
+            return true;
+        }
+
+        bool ParseBool(const std::string& text) {
+            std::string s = ToLower(Trim(text));
+            return s == "1" || s == "true" || s == "yes" || s == "y" || s == "signed" || s == "是";
+        }
+
+        bool IsReadOnlyAccess(const std::string& text) {
+            std::string s = ToLower(Trim(text));
+            return s == "ro" || s == "r" || s == "read-only" || s == "readonly" || s == "只读";
+        }
+
+        // "7:4" / "[7:4]" / "3"
+        bool ParseBits(const std::string& text, uint8_t& msb, uint8_t& lsb) {
+            std::string s = Trim(text);
+            if (!s.empty() && s.front() == '[') s.erase(0, 1);
+            if (!s.empty() && s.back() == ']') s.pop_back();
+            uint32_t hi = 0, lo = 0;
+            size_t colon = s.find(':');
+            if (colon == std::string::npos) {
+                if (!ParseUInt(s, hi)) return false;
+                lo = hi;
+            }
+            else {
+                if (!ParseUInt(s.substr(0, colon), hi) || !ParseUInt(s.substr(colon + 1), lo)) return false;
+                if (hi < lo) std::swap(hi, lo);
+            }
+            if (hi > 31) return false;
+            msb = static_cast<uint8_t>(hi);
+            lsb = static_cast<uint8_t>(lo);
+            return true;
+        }
+
+        // 位宽按 bit 给出（8/16/24/32）
+        bool WidthToBytes(uint32_t bits, uint8_t& bytes) {
+            if (bits == 0 || bits > 32 || bits % 8 != 0) return false;
+            bytes = static_cast<uint8_t>(bits / 8);
+            return true;
+        }
+
+        // ========== CSV ==========
+        // 返回下一条记录的 [begin, end)，引号内的换行属于同一条记录；pos 移到下一条记录开头
+        bool NextCsvRecord(const std::string& text, size_t& pos, size_t& begin, size_t& end) {
+            if (pos >= text.size()) return false;
+            begin = pos;
+            bool quoted = false;
+            size_t i = pos;
+            for (; i < text.size(); ++i) {
+                char c = text[i];
+                if (c == '"') quoted = !quoted;
+                else if (c == '\n' && !quoted) break;
+            }
+            end = i;
+            if (end > begin && text[end - 1] == '\r') end--;
+            pos = (i < text.size()) ? i + 1 : i;
+            return true;
+        }
+
+        void SplitCsvRecord(const std::string& text, size_t begin, size_t end, std::vector<std::string>& cells) {
+            cells.clear();
+            cells.emplace_back();
+            bool quoted = false;
+            for (size_t i = begin; i < end; ++i) {
+                char c = text[i];
+                if (quoted) {
+                    if (c == '"') {
+                        if (i + 1 < end && text[i + 1] == '"') { cells.back().push_back('"'); ++i; }
+                        else quoted = false;
+                    }
+                    else {
+                        cells.back().push_back(c);
+                    }
+                }
+                else if (c == '"') quoted = true;
+                else if (c == ',') cells.emplace_back();
+                else cells.back().push_back(c);
+            }
+            for (auto& cell : cells) cell = Trim(cell);
+        }
+
+        bool IsBlankOrComment(const std::string& text, size_t begin, size_t end) {
+            while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) begin++;
+            return begin == end || text[begin] == '#';
+        }
+
+        struct ColumnAlias {
+            const char* name;
+            int column;
+        };
+
+        // 与 RegisterMap::CsvColumn 的顺序一致
+        const ColumnAlias kColumnAliases[] = {
+            { "address", 0 }, { "addr", 0 }, { "地址", 0 },
+            { "name", 1 }, { "register", 1 }, { "名称", 1 },
+            { "width", 2 }, { "size", 2 }, { "位宽", 2 },
+            { "field", 3 }, { "字段", 3 },
+            { "bits", 4 }, { "bit", 4 }, { "位", 4 },
+            { "scale", 5 }, { "系数", 5 },
+            { "offset", 6 }, { "偏移", 6 },
+            { "unit", 7 }, { "单位", 7 },
+            { "signed", 8 }, { "有符号", 8 },
+            { "access", 9 }, { "访问", 9 },
+            { "description", 10 }, { "desc", 10 }, { "描述", 10 },
+            { "slave", 11 }, { "从机地址", 11 },
+        };
+
+        const std::string& Cell(const std::vector<std::string>& cells, int column) {
+            static const std::string empty;
+            return (column >= 0 && column < static_cast<int>(cells.size())) ? cells[column] : empty;
+        }
+
+        // ========== JSON 结构扫描（只定位区间，不建 DOM） ==========
+        size_t SkipWs(const std::string& t, size_t p) {
+            while (p < t.size() && std::isspace(static_cast<unsigned char>(t[p]))) p++;
+            return p;
+        }
+
+        size_t SkipString(const std::string& t, size_t p) {
+            // p 指向开头的引号
+            for (++p; p < t.size(); ++p) {
+                if (t[p] == '\\') ++p;
+                else if (t[p] == '"') return p + 1;
+            }
+            return std::string::npos;
+        }
+
+        size_t SkipValue(const std::string& t, size_t p) {
+            if (p >= t.size()) return std::string::npos;
+            if (t[p] == '"') return SkipString(t, p);
+            if (t[p] == '{' || t[p] == '[') {
+                int depth = 0;
+                while (p < t.size()) {
+                    char c = t[p];
+                    if (c == '"') {
+                        p = SkipString(t, p);
+                        if (p == std::string::npos) return p;
+                        continue;
+                    }
+                    if (c == '{' || c == '[') depth++;
+                    else if (c == '}' || c == ']') {
+                        if (--depth == 0) return p + 1;
+                    }
+                    ++p;
+                }
+                return std::string::npos;
+            }
+            while (p < t.size() && t[p] != ',' && t[p] != '}' && t[p] != ']' &&
+                !std::isspace(static_cast<unsigned char>(t[p]))) p++;
+            return p;
+        }
+
+        bool JsonToUInt(const json& v, uint32_t& out) {
+            if (v.is_number_unsigned() || v.is_number_integer()) {
+                if (v.get<int64_t>() < 0) return false;
+                out = static_cast<uint32_t>(v.get<uint64_t>());
+                return true;
+            }
+            if (v.is_string()) return ParseUInt(v.get<std::string>(), out);
+            return false;
+        }
+
+        double JsonToDouble(const json& obj, const char* key, double fallback) {
+            auto it = obj.find(key);
+            if (it == obj.end()) return fallback;
+            if (it->is_number()) return it->get<double>();
+            double v = fallback;
+            if (it->is_string() && ParseDouble(it->get<std::string>(), v)) return v;
+            return fallback;
+        }
+
+        std::string JsonToString(const json& obj, const char* key) {
+            auto it = obj.find(key);
+            return (it != obj.end() && it->is_string()) ? it->get<std::string>() : std::string();
+        }
+
+        bool JsonToBool(const json& obj, const char* key) {
+            auto it = obj.find(key);
+            if (it == obj.end()) return false;
+            if (it->is_boolean()) return it->get<bool>();
+            if (it->is_string()) return ParseBool(it->get<std::string>());
+            if (it->is_number()) return it->get<double>() != 0.0;
+            return false;
+        }
+
+        // ========== 公式生成 ==========
+        std::string FormatNumber(double v) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%.10g", v);
+            return buf;
+        }
+
+        std::string HexMask(uint32_t mask) {
+            char buf[16];
+            std::snprintf(buf, sizeof(buf), "0x%X", mask);
+            return buf;
+        }
+
+        // 线上字节序拼成整数：大端 "(b0 << 8 | b1)"，小端 "(b1 << 8 | b0)"
+        std::string RawExpression(int byteCount, bool bigEndian) {
+            if (byteCount <= 1) return "b0";
+            std::string expr = "(";
+            for (int i = 0; i < byteCount; ++i) {
+                int byteIndex = bigEndian ? i : byteCount - 1 - i;
+                int shift = 8 * (byteCount - 1 - i);
+                if (i > 0) expr += " | ";
+                expr += "b" + std::to_string(byteIndex);
+                if (shift > 0) expr += " << " + std::to_string(shift);
+            }
+            return expr + ")";
+        }
+
+        std::string SignExtend(const std::string& expr, int bits) {
+            char half[24], full[24];
+            std::snprintf(half, sizeof(half), "%llu", 1ull << (bits - 1));
+            std::snprintf(full, sizeof(full), "%llu", 1ull << bits);
+            return "(" + expr + " >= " + half + " ? " + expr + " - " + full + " : " + expr + ")";
+        }
+
+        std::string ApplyScale(std::string expr, double scale, double offset) {
+            if (scale != 1.0) expr += " * " + FormatNumber(scale);
+            if (offset > 0.0) expr += " + " + FormatNumber(offset);
+            else if (offset < 0.0) expr += " - " + FormatNumber(-offset);
+            return expr;
+        }
+
+        // 写入公式：工程值还原为原始整数，大端寄存器再做字节交换（写入结果按小端拆成字节）。
+        // 求值结果转整数时向零截断，3.3 / 0.001 = 3299.9999... 会写成 3299，所以先四舍五入
+        std::string WriteExpression(int byteCount, bool bigEndian, double scale, double offset) {
+            std::string raw = "value";
+            if (offset != 0.0) raw = "(value - " + FormatNumber(offset) + ")";
+            if (scale != 1.0) raw = "(" + raw + " / " + FormatNumber(scale) + ")";
+            if (raw != "value") raw = "(" + raw + " >= 0 ? " + raw + " + 0.5 : " + raw + " - 0.5)";
+            if (!bigEndian || byteCount <= 1) return raw;
+
+            std::string expr;
+            for (int i = 0; i < byteCount; ++i) {
+                int srcShift = 8 * (byteCount - 1 - i);
+                int dstShift = 8 * i;
+                if (i > 0) expr += " | ";
+                std::string byteExpr = srcShift > 0 ? "(" + raw + " >> " + std::to_string(srcShift) + " & 0xFF)"
+                                                    : "(" + raw + " & 0xFF)";
+                expr += dstShift > 0 ? byteExpr + " << " + std::to_string(dstShift) : byteExpr;
+            }
+            return expr;
+        }
+
+        std::string Describe(const std::string& name, const std::string& description,
+            const std::string& unit, bool readOnly) {
+            std::string text = name;
+            if (!description.empty()) {
+                if (!text.empty()) text += " - ";
+                text += description;
+            }
+            if (!unit.empty()) text += " [" + unit + "]";
+            if (readOnly) text += text.empty() ? "(RO)" : " (RO)";
+            return text;
+        }
+
+    } // namespace
+
+    // ========== 打开与索引 ==========
+
+    bool RegisterMap::Open(const std::string& filePath) {
+        Close();
+
+        std::string text;
+        if (!ReadWholeFile(filePath, text)) {
+            m_lastError = "无法打开文件: " + filePath;
+            return false;
+        }
+        if (text.size() >= 3 && static_cast<unsigned char>(text[0]) == 0xEF &&
+            static_cast<unsigned char>(text[1]) == 0xBB && static_cast<unsigned char>(text[2]) == 0xBF) {
+            text.erase(0, 3);
+        }
+        if (text.size() > UINT32_MAX) {
+            m_lastError = "文件过大";
+            return false;
+        }
+
+        m_filePath = filePath;
+        m_text = std::move(text);
+
+        size_t first = SkipWs(m_text, 0);
+        m_isJson = first < m_text.size() && m_text[first] == '{';
+
+        bool ok = false;
+        try {
+            ok = m_isJson ? IndexJson() : IndexCsv();
+        }
+        catch (const std::exception& e) {
+            m_lastError = std::string("解析失败: ") + e.what();
+            ok = false;
+        }
+
+        if (ok && m_index.empty()) {
+            m_lastError = "文件中没有可导入的寄存器";
+            ok = false;
+        }
+        if (!ok) {
+            std::string error = m_lastError;
+            Close();
+            m_lastError = error;
+            return false;
+        }
+
+        m_index.shrink_to_fit();
+        if (m_deviceName.empty()) {
+            size_t slash = filePath.find_last_of("/\\");
+            std::string stem = (slash == std::string::npos) ? filePath : filePath.substr(slash + 1);
+            size_t dot = stem.find_last_of('.');
+            m_deviceName = (dot == std::string::npos) ? stem : stem.substr(0, dot);
+        }
+        return true;
+    }
+
+    void RegisterMap::Close() {
+        m_filePath.clear();
+        std::string().swap(m_text);
+        m_deviceName.clear();
+        m_lastError.clear();
+        m_isJson = false;
+        m_bigEndian = true;
+        m_defaultSlave = 0x50;
+        m_skippedCount = 0;
+        std::vector<RegisterMapIndexEntry>().swap(m_index);
+        for (int i = 0; i < ROW_CACHE_SIZE; ++i) {
+            m_rowCacheKey[i] = -1;
+            m_rowCache[i] = RegisterMapRow();
+        }
+    }
+
+    bool RegisterMap::IndexCsv() {
+        for (int c = 0; c < ColCount; ++c) m_csvColumns[c] = -1;
+
+        std::vector<std::string> cells;
+        bool haveHeader = false;
+        int current = -1;           // 当前寄存器在 m_index 中的下标，-1 表示被跳过
+        bool haveRegister = false;
+        uint32_t currentAddress = 0;
+        int lineNumber = 0;
+
+        size_t pos = 0, begin = 0, end = 0;
+        while (NextCsvRecord(m_text, pos, begin, end)) {
+            lineNumber++;
+            if (IsBlankOrComment(m_text, begin, end)) {
+                // "# key=value" 指令
+                std::string line = Trim(m_text.substr(begin, end - begin));
+                size_t eq = line.find('=');
+                if (!line.empty() && eq != std::string::npos) {
+                    std::string key = ToLower(Trim(line.substr(1, eq - 1)));
+                    std::string value = Trim(line.substr(eq + 1));
+                    uint32_t v = 0;
+                    if (key == "device") m_deviceName = value;
+                    else if (key == "slave" && ParseUInt(value, v) && v <= 0x7F) m_defaultSlave = static_cast<uint8_t>(v);
+                    else if (key == "byteorder") m_bigEndian = ToLower(value) != "little";
+                }
+                continue;
+            }
+
+            SplitCsvRecord(m_text, begin, end, cells);
+
+            if (!haveHeader) {
+                for (int i = 0; i < static_cast<int>(cells.size()); ++i) {
+                    std::string name = ToLower(cells[i]);
+                    for (const auto& alias : kColumnAliases) {
+                        if (name == alias.name && m_csvColumns[alias.column] < 0) {
+                            m_csvColumns[alias.column] = i;
+                        }
+                    }
+                }
+                if (m_csvColumns[ColAddress] < 0) {
+                    m_lastError = "CSV 表头缺少 address 列";
+                    return false;
+                }
+                haveHeader = true;
+                continue;
+            }
+
+            const std::string& addressCell = Cell(cells, m_csvColumns[ColAddress]);
+            bool isField = !Cell(cells, m_csvColumns[ColField]).empty();
+
+            uint32_t address = 0;
+            bool hasAddress = ParseUInt(addressCell, address);
+            if (!addressCell.empty() && !hasAddress) {
+                m_lastError = "第 " + std::to_string(lineNumber) + " 行地址无效: " + addressCell;
+                return false;
+            }
+
+            // 字段行沿用上一寄存器；带了不同地址的字段行隐式开始新寄存器
+            bool startsRegister = !isField || (hasAddress && (!haveRegister || address != currentAddress));
+            if (startsRegister) {
+                if (!hasAddress) {
+                    m_lastError = "第 " + std::to_string(lineNumber) + " 行缺少地址";
+                    return false;
+                }
+
+                haveRegister = true;
+                currentAddress = address;
+                current = -1;
+
+                uint32_t widthBits = 8;
+                uint8_t byteCount = 1;
+                const std::string& widthCell = Cell(cells, m_csvColumns[ColWidth]);
+                if (!widthCell.empty() && !ParseUInt(widthCell, widthBits)) widthBits = 0;
+
+                uint32_t slave = m_defaultSlave;
+                const std::string& slaveCell = Cell(cells, m_csvColumns[ColSlave]);
+                bool slaveOk = slaveCell.empty() || (ParseUInt(slaveCell, slave) && slave <= 0x7F);
+
+                if (address > 0xFF || !WidthToBytes(widthBits, byteCount) || !slaveOk) {
+                    m_skippedCount++;
+                    continue;
+                }
+
+                RegisterMapIndexEntry entry;
+                entry.textOffset = static_cast<uint32_t>(begin);
+                entry.textLength = static_cast<uint32_t>(end - begin);
+                entry.address = static_cast<uint16_t>(address);
+                entry.slaveAddress = static_cast<uint8_t>(slave);
+                entry.byteCount = byteCount;
+                entry.fieldCount = isField ? 1 : 0;
+                m_index.push_back(entry);
+                current = static_cast<int>(m_index.size()) - 1;
+            }
+            else if (current >= 0) {
+                RegisterMapIndexEntry& entry = m_index[current];
+                entry.textLength = static_cast<uint32_t>(end - entry.textOffset);
+                entry.fieldCount++;
+            }
+        }
+
+        if (!haveHeader) {
+            m_lastError = "CSV 文件缺少表头";
+            return false;
+        }
+        return true;
+    }
+
+    bool RegisterMap::IndexJson() {
+        const std::string& t = m_text;
+        size_t p = SkipWs(t, 0);
+        if (p >= t.size() || t[p] != '{') {
+            m_lastError = "JSON 根节点必须是对象";
+            return false;
+        }
+
+        // 第一遍：定位顶层键，registers 只记区间
+        size_t registersBegin = std::string::npos, registersEnd = std::string::npos;
+        p = SkipWs(t, p + 1);
+        while (p < t.size() && t[p] != '}') {
+            if (t[p] != '"') break;
+            size_t keyEnd = SkipString(t, p);
+            if (keyEnd == std::string::npos) break;
+            std::string key = t.substr(p + 1, keyEnd - p - 2);
+
+            p = SkipWs(t, keyEnd);
+            if (p >= t.size() || t[p] != ':') break;
+            size_t valueBegin = SkipWs(t, p + 1);
+            size_t valueEnd = SkipValue(t, valueBegin);
+            if (valueEnd == std::string::npos) break;
+
+            if (key == "registers") {
+                registersBegin = valueBegin;
+                registersEnd = valueEnd;
+            }
+            else if (key == "device" || key == "slaveAddress" || key == "byteOrder") {
+                json value = json::parse(t.begin() + valueBegin, t.begin() + valueEnd);
+                uint32_t v = 0;
+                if (key == "device" && value.is_string()) m_deviceName = value.get<std::string>();
+                else if (key == "slaveAddress" && JsonToUInt(value, v) && v <= 0x7F) m_defaultSlave = static_cast<uint8_t>(v);
+                else if (key == "byteOrder" && value.is_string()) m_bigEndian = ToLower(value.get<std::string>()) != "little";
+            }
+
+            p = SkipWs(t, valueEnd);
+            if (p < t.size() && t[p] == ',') p = SkipWs(t, p + 1);
+        }
+        if (p >= t.size() || t[p] != '}') {
+            m_lastError = "JSON 格式错误（位置 " + std::to_string(p) + "）";
+            return false;
+        }
+        if (registersBegin == std::string::npos || t[registersBegin] != '[') {
+            m_lastError = "JSON 中缺少 registers 数组";
+            return false;
+        }
+
+        // 第二遍：逐个元素临时解析出地址/宽度/从机地址，解析结果不保留
+        p = SkipWs(t, registersBegin + 1);
+        int elementIndex = 0;
+        while (p < registersEnd && t[p] != ']') {
+            size_t elementEnd = SkipValue(t, p);
+            if (elementEnd == std::string::npos || elementEnd > registersEnd) {
+                m_lastError = "registers 数组格式错误";
+                return false;
+            }
+
+            json reg = json::parse(t.begin() + p, t.begin() + elementEnd);
+            uint32_t address = 0, widthBits = 8, slave = m_defaultSlave;
+            uint8_t byteCount = 1;
+            if (!reg.is_object() || !reg.contains("address") || !JsonToUInt(reg["address"], address)) {
+                m_lastError = "第 " + std::to_string(elementIndex) + " 个寄存器缺少有效地址";
+                return false;
+            }
+            bool ok = address <= 0xFF;
+            if (reg.contains("width") && !JsonToUInt(reg["width"], widthBits)) ok = false;
+            if (reg.contains("slave") && (!JsonToUInt(reg["slave"], slave) || slave > 0x7F)) ok = false;
+            if (!WidthToBytes(widthBits, byteCount)) ok = false;
+
+            if (ok) {
+                auto fields = reg.find("fields");
+                RegisterMapIndexEntry entry;
+                entry.textOffset = static_cast<uint32_t>(p);
+                entry.textLength = static_cast<uint32_t>(elementEnd - p);
+                entry.address = static_cast<uint16_t>(address);
+                entry.slaveAddress = static_cast<uint8_t>(slave);
+                entry.byteCount = byteCount;
+                entry.fieldCount = (fields != reg.end() && fields->is_array())
+                    ? static_cast<uint16_t>(fields->size()) : 0;
+                m_index.push_back(entry);
+            }
+            else {
+                m_skippedCount++;
+            }
+
+            elementIndex++;
+            p = SkipWs(t, elementEnd);
+            if (p < registersEnd && t[p] == ',') p = SkipWs(t, p + 1);
+        }
+        return true;
+    }
+
+    // ========== 按需展开 ==========
+
+    const RegisterMapRow& RegisterMap::GetRow(int row) {
+        int slot = row % ROW_CACHE_SIZE;
+        if (m_rowCacheKey[slot] != row) {
+            RegisterMapRow& cached = m_rowCache[slot];
+            cached = RegisterMapRow();
+            ParseRow(m_index[row], cached);
+            m_rowCacheKey[slot] = row;
+        }
+        return m_rowCache[slot];
+    }
+
+    bool RegisterMap::ParseRow(const RegisterMapIndexEntry& entry, RegisterMapRow& row) const {
+        row.address = entry.address;
+        row.slaveAddress = entry.slaveAddress;
+        row.byteCount = entry.byteCount;
+        try {
+            return m_isJson ? ParseJsonRow(entry, row) : ParseCsvRow(entry, row);
+        }
+        catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    bool RegisterMap::ParseCsvRow(const RegisterMapIndexEntry& entry, RegisterMapRow& row) const {
+        std::vector<std::string> cells;
+        size_t pos = entry.textOffset, begin = 0, end = 0;
+        size_t limit = static_cast<size_t>(entry.textOffset) + entry.textLength;
+        bool first = true;
+
+        while (pos < limit && NextCsvRecord(m_text, pos, begin, end)) {
+            if (IsBlankOrComment(m_text, begin, end)) continue;
+            SplitCsvRecord(m_text, begin, end, cells);
+
+            const std::string& fieldName = Cell(cells, m_csvColumns[ColField]);
+            if (first) {
+                row.readOnly = IsReadOnlyAccess(Cell(cells, m_csvColumns[ColAccess]));
+                if (fieldName.empty()) {
+                    row.name = Cell(cells, m_csvColumns[ColName]);
+                    row.description = Cell(cells, m_csvColumns[ColDescription]);
+                    row.unit = Cell(cells, m_csvColumns[ColUnit]);
+                    row.isSigned = ParseBool(Cell(cells, m_csvColumns[ColSigned]));
+                    ParseDouble(Cell(cells, m_csvColumns[ColScale]), row.scale);
+                    ParseDouble(Cell(cells, m_csvColumns[ColOffset]), row.offset);
+                    first = false;
+                    continue;
+                }
+                // 隐式寄存器：名称取字段行的 name 列
+                row.name = Cell(cells, m_csvColumns[ColName]);
+                first = false;
+            }
+
+            if (fieldName.empty()) continue;
+            RegisterMapField field;
+            field.name = fieldName;
+            field.description = Cell(cells, m_csvColumns[ColDescription]);
+            field.unit = Cell(cells, m_csvColumns[ColUnit]);
+            field.isSigned = ParseBool(Cell(cells, m_csvColumns[ColSigned]));
+            ParseDouble(Cell(cells, m_csvColumns[ColScale]), field.scale);
+            ParseDouble(Cell(cells, m_csvColumns[ColOffset]), field.offset);
+            if (!ParseBits(Cell(cells, m_csvColumns[ColBits]), field.msb, field.lsb)) {
+                field.msb = static_cast<uint8_t>(row.byteCount * 8 - 1);
+                field.lsb = 0;
+            }
+            row.fields.push_back(std::move(field));
+        }
+        return true;
+    }
+
+    bool RegisterMap::ParseJsonRow(const RegisterMapIndexEntry& entry, RegisterMapRow& row) const {
+        auto begin = m_text.begin() + entry.textOffset;
+        json reg = json::parse(begin, begin + entry.textLength);
+
+        row.name = JsonToString(reg, "name");
+        row.description = JsonToString(reg, "description");
+        row.unit = JsonToString(reg, "unit");
+        row.readOnly = IsReadOnlyAccess(JsonToString(reg, "access"));
+        row.isSigned = JsonToBool(reg, "signed");
+        row.scale = JsonToDouble(reg, "scale", 1.0);
+        row.offset = JsonToDouble(reg, "offset", 0.0);
+
+        auto fields = reg.find("fields");
+        if (fields != reg.end() && fields->is_array()) {
+            row.fields.reserve(fields->size());
+            for (const auto& f : *fields) {
+                if (!f.is_object()) continue;
+                RegisterMapField field;
+                field.name = JsonToString(f, "name");
+                field.description = JsonToString(f, "description");
+                field.unit = JsonToString(f, "unit");
+                field.isSigned = JsonToBool(f, "signed");
+                field.scale = JsonToDouble(f, "scale", 1.0);
+                field.offset = JsonToDouble(f, "offset", 0.0);
+
+                auto bits = f.find("bits");
+                bool bitsOk = false;
+                if (bits != f.end()) {
+                    if (bits->is_string()) {
+                        bitsOk = ParseBits(bits->get<std::string>(), field.msb, field.lsb);
+                    }
+                    else if (bits->is_number_unsigned() && bits->get<uint32_t>() <= 31) {
+                        field.msb = field.lsb = static_cast<uint8_t>(bits->get<uint32_t>());
+                        bitsOk = true;
+                    }
+                }
+                if (!bitsOk) {
+                    field.msb = static_cast<uint8_t>(row.byteCount * 8 - 1);
+                    field.lsb = 0;
+                }
+                row.fields.push_back(std::move(field));
+            }
+        }
+        return true;
+    }
+
+    // ========== 生成条目与命令组 ==========
+
+    void RegisterMap::AppendEntries(const RegisterMapRow& row, bool includeFields, bool bigEndian,
+        std::vector<RegisterEntry>& out) {
+        const int totalBits = row.byteCount * 8;
+        const std::string raw = RawExpression(row.byteCount, bigEndian);
+        const double scale = (row.scale != 0.0) ? row.scale : 1.0;
+
+        RegisterEntry reg;
+        reg.regAddress = static_cast<uint8_t>(row.address);
+        reg.length = row.byteCount;
+        reg.data.assign(row.byteCount, 0);
+        reg.description = Describe(row.name, row.description, row.unit, row.readOnly);
+        reg.parseConfig.alias = row.name;
+
+        // 单字节且无换算时直接看原始值即可
+        if (row.byteCount > 1 || row.isSigned || scale != 1.0 || row.offset != 0.0) {
+            std::string value = row.isSigned ? SignExtend(raw, totalBits) : raw;
+            reg.parseConfig.enabled = true;
+            reg.parseConfig.readFormula = ApplyScale(value, scale, row.offset);
+            if (!row.readOnly) {
+                reg.parseConfig.writeFormula = WriteExpression(row.byteCount, bigEndian, scale, row.offset);
+            }
+        }
+        out.push_back(std::move(reg));
+
+        if (!includeFields) return;
+
+        for (const auto& field : row.fields) {
+            if (field.msb >= totalBits) continue;
+            const int bits = field.msb - field.lsb + 1;
+            const double fieldScale = (field.scale != 0.0) ? field.scale : 1.0;
+
+            std::string value = raw;
+            if (bits < totalBits) {
+                uint32_t mask = (bits >= 32) ? 0xFFFFFFFFu : ((1u << bits) - 1u);
+                value = field.lsb > 0
+                    ? "(" + raw + " >> " + std::to_string(field.lsb) + " & " + HexMask(mask) + ")"
+                    : "(" + raw + " & " + HexMask(mask) + ")";
+            }
+            if (field.isSigned) value = SignExtend(value, bits);
+
+            char range[16];
+            if (bits == 1) std::snprintf(range, sizeof(range), "[%d]", field.lsb);
+            else std::snprintf(range, sizeof(range), "[%d:%d]", field.msb, field.lsb);
+            std::string fieldName = row.name.empty() ? field.name : row.name + "." + field.name;
+
+            // 位字段只生成读取公式：单独写字段需要读-改-写，仍由寄存器行完成
+            RegisterEntry entry;
+            entry.regAddress = static_cast<uint8_t>(row.address);
+            entry.length = row.byteCount;
+            entry.data.assign(row.byteCount, 0);
+            entry.description = Describe(fieldName + range, field.description, field.unit, row.readOnly);
+            entry.parseConfig.enabled = true;
+            entry.parseConfig.alias = fieldName;
+            entry.parseConfig.readFormula = ApplyScale(value, fieldScale, field.offset);
+            out.push_back(std::move(entry));
+        }
+    }
+
+    int RegisterMap::BuildCommandGroups(const RegisterMapImportOptions& options, std::vector<CommandGroup>& groups) {
+        const int rowCount = GetRowCount();
+        int first = options.firstRow < 0 ? 0 : options.firstRow;
+        int last = (options.rowCount < 0) ? rowCount : first + options.rowCount;
+        if (last > rowCount) last = rowCount;
+        const size_t maxEntries = static_cast<size_t>(options.maxEntriesPerGroup > 0 ? options.maxEntriesPerGroup : 256);
+
+        struct SlaveGroups {
+            size_t groupIndex = 0;      // 当前在 groups 中的位置
+            int part = 0;
+        };
+        std::map<uint8_t, SlaveGroups> bySlave;
+        bool multipleSlaves = false;
+        for (int i = first; i < last && !multipleSlaves; ++i) {
+            multipleSlaves = m_index[i].slaveAddress != m_index[first].slaveAddress;
+        }
+
+        const size_t groupsBefore = groups.size();
+        RegisterMapRow row;
+        std::vector<RegisterEntry> entries;
+
+        for (int i = first; i < last; ++i) {
+            const RegisterMapIndexEntry& indexEntry = m_index[i];
+            row = RegisterMapRow();
+            ParseRow(indexEntry, row);
+            entries.clear();
+            AppendEntries(row, options.includeFields, m_bigEndian, entries);
+
+            auto found = bySlave.find(indexEntry.slaveAddress);
+            bool needNewGroup = (found == bySlave.end());
+            if (!needNewGroup) {
+                const auto& current = groups[found->second.groupIndex].registerEntries;
+                needNewGroup = !current.empty() && current.size() + entries.size() > maxEntries;
+            }
+
+            if (needNewGroup) {
+                SlaveGroups& slot = bySlave[indexEntry.slaveAddress];
+                slot.part++;
+                slot.groupIndex = groups.size();
+
+                CommandGroup group;
+                group.name = m_deviceName;
+                if (multipleSlaves) {
+                    char suffix[16];
+                    std::snprintf(suffix, sizeof(suffix), " @0x%02X", indexEntry.slaveAddress);
+                    group.name += suffix;
+                }
+                if (slot.part > 1) group.name += " #" + std::to_string(slot.part);
+                group.slaveAddress = indexEntry.slaveAddress;
+                groups.push_back(std::move(group));
+                found = bySlave.find(indexEntry.slaveAddress);
+            }
+
+            auto& target = groups[found->second.groupIndex].registerEntries;
+            for (auto& entry : entries) {
+                target.push_back(std::move(entry));
+            }
+        }
+
+        return static_cast<int>(groups.size() - groupsBefore);
+    }
+
+    std::vector<WriteFormulaCheck> RegisterMap::RunWriteFormulaChecks() {
+        struct CheckCase {
+            int byteCount;
+            bool bigEndian;
+            double scale;
+            double offset;
+            double value;
+            int64_t expected;
+        };
+        static const CheckCase cases[] = {
+            { 2, false, 0.001,  0.0,   3.3,    3300 },  // 3.3 / 0.001 = 3299.9999...
+            { 2, true,  0.001,  0.0,   3.3,    3300 },
+            { 2, false, 0.01,   0.0,  -1.15,   -115 },
+            { 2, false, 0.1,  -40.0,   25.3,    653 },
+            { 1, false, 0.0625, 0.0,   1.1,      18 },  // 17.6 舍入到 18
+        };
+
+        std::vector<WriteFormulaCheck> results;
+        ExpressionParser parser;
+        for (const auto& item : cases) {
+            WriteFormulaCheck check;
+            check.formula = WriteExpression(item.byteCount, item.bigEndian, item.scale, item.offset);
+            check.value = item.value;
+            check.expected = item.expected;
+
+            bool success = false;
+            std::string error;
+            std::vector<uint8_t> bytes = parser.EvaluateWriteFormula(check.formula, item.value, item.byteCount, success, error);
+            if (success) {
+                // 写入字节按小端排列；大端寄存器的公式已交换过字节，这里还原回数值
+                uint64_t raw = 0;
+                for (int i = 0; i < item.byteCount; ++i) {
+                    int shift = item.bigEndian ? 8 * (item.byteCount - 1 - i) : 8 * i;
+                    raw |= static_cast<uint64_t>(bytes[i]) << shift;
+                }
+                const int bits = 8 * item.byteCount;
+                if (raw & (1ull << (bits - 1))) raw -= 1ull << bits;
+                check.actual = static_cast<int64_t>(raw);
+                check.ok = check.actual == check.expected;
+            }
+            results.push_back(std::move(check));
+        }
+        return results;
+    }
+
+} // namespace I2CDebugger
@@ -0,0 +1,132 @@
+﻿#pragma once
+
+#include "../models/i2c_table_app.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace I2CDebugger {
+
+    // ========== 寄存器描述（按需展开） ==========
+    struct RegisterMapField {
+        std::string name;
+        std::string description;
+        std::string unit;
+        uint8_t msb = 7;
+        uint8_t lsb = 0;
+        bool isSigned = false;
+        double scale = 1.0;
+        double offset = 0.0;
+    };
+
+    struct RegisterMapRow {
+        uint16_t address = 0;
+        uint8_t slaveAddress = 0x50;
+        uint8_t byteCount = 1;              // 寄存器宽度（字节）
+        bool readOnly = false;
+        bool isSigned = false;
+        double scale = 1.0;
+        double offset = 0.0;
+        std::string name;
+        std::string description;
+        std::string unit;
+        std::vector<RegisterMapField> fields;
+    };
+
+    // 索引项：只记录定位和分组需要的数值，名称/描述/字段留在源文本里，展开时再解析
+    struct RegisterMapIndexEntry {
+        uint32_t textOffset = 0;
+        uint32_t textLength = 0;
+        uint16_t address = 0;
+        uint8_t slaveAddress = 0x50;
+        uint8_t byteCount = 1;
+        uint16_t fieldCount = 0;
+    };
+
+    // 写入公式舍入自检的一项：工程值经生成的写入公式还原为原始整数
+    struct WriteFormulaCheck {
+        std::string formula;
+        double value = 0.0;
+        int64_t expected = 0;
+        int64_t actual = 0;
+        bool ok = false;
+    };
+
+    struct RegisterMapImportOptions {
+        int firstRow = 0;
+        int rowCount = -1;                  // -1 表示到末尾
+        bool includeFields = true;          // 每个位字段额外生成一行（带取位公式）
+        int maxEntriesPerGroup = 256;
+    };
+
+    // ========== 寄存器映射导入 ==========
+    // 支持两种厂商描述格式：
+    //   CSV：表头列 address,name,width,field,bits,scale,offset,unit,signed,access,description,slave
+    //        （列顺序任意，可用中文列名）；field 为空的行是寄存器，非空的行是上一寄存器的位字段；
+    //        "# key=value" 注释行设置 device / slave / byteOrder
+    //   JSON：{ "device", "slaveAddress", "byteOrder", "registers": [ { "address", "name", "width",
+    //          "scale", "offset", "unit", "signed", "access", "description", "fields": [ { "name", "bits", ... } ] } ] }
+    // Open 只建立每个寄存器的文本区间索引；GetRow 按需解析单行并放入小型缓存，
+    // 生成命令组时也逐行展开，不会同时持有整张表的字符串。
+    class RegisterMap {
+    public:
+        bool Open(const std::string& filePath);
+        void Close();
+
+        bool IsOpen() const { return !m_text.empty(); }
+        const std::string& GetFilePath() const { return m_filePath; }
+        const std::string& GetDeviceName() const { return m_deviceName; }
+        const std::string& GetLastError() const { return m_lastError; }
+
+        int GetRowCount() const { return static_cast<int>(m_index.size()); }
+        const RegisterMapIndexEntry& GetIndexEntry(int row) const { return m_index[row]; }
+        int GetSkippedCount() const { return m_skippedCount; }   // 地址超出 8 位等原因跳过的寄存器
+
+        // 索引本身占用的内存（不含源文本）
+        size_t GetIndexBytes() const { return m_index.capacity() * sizeof(RegisterMapIndexEntry); }
+        size_t GetTextBytes() const { return m_text.size(); }
+
+        // 展开单行；返回的引用在下一次 GetRow 前有效
+        const RegisterMapRow& GetRow(int row);
+
+        // 由一行生成寄存器表条目：寄存器本身一行，includeFields 时每个位字段再一行
+        static void AppendEntries(const RegisterMapRow& row, bool includeFields, bool bigEndian,
+            std::vector<RegisterEntry>& out);
+
+        // 按从机地址拆分并生成命令组，追加到 groups；返回生成的组数
+        int BuildCommandGroups(const RegisterMapImportOptions& options, std::vector<CommandGroup>& groups);
+
+        // 用不能精确表示为二进制小数的工程值（如 3.3 V @ 0.001 V/LSB）检查写入公式的舍入，供诊断窗口调用
+        static std::vector<WriteFormulaCheck> RunWriteFormulaChecks();
+
+    private:
+        bool IndexCsv();
+        bool IndexJson();
+        bool ParseRow(const RegisterMapIndexEntry& entry, RegisterMapRow& row) const;
+        bool ParseCsvRow(const RegisterMapIndexEntry& entry, RegisterMapRow& row) const;
+        bool ParseJsonRow(const RegisterMapIndexEntry& entry, RegisterMapRow& row) const;
+
+        // CSV 列下标（-1 表示不存在）
+        enum CsvColumn {
+            ColAddress, ColName, ColWidth, ColField, ColBits, ColScale, ColOffset,
+            ColUnit, ColSigned, ColAccess, ColDescription, ColSlave, ColCount
+        };
+
+        std::string m_filePath;
+        std::string m_text;
+        std::string m_deviceName;
+        std::string m_lastError;
+        bool m_isJson = false;
+        bool m_bigEndian = true;
+        uint8_t m_defaultSlave = 0x50;
+        int m_csvColumns[ColCount] = {};
+        int m_skippedCount = 0;
+        std::vector<RegisterMapIndexEntry> m_index;
+
+        // 直接映射的展开缓存，供列表预览等按可见行访问
+        static constexpr int ROW_CACHE_SIZE = 64;
+        RegisterMapRow m_rowCache[ROW_CACHE_SIZE];
+        int m_rowCacheKey[ROW_CACHE_SIZE] = {};
+    };
+
+}
@@ -0,0 +1,518 @@
+﻿#include "diagnostics_window.h"
+#include "../widgets/cached_text.h"
+#include "../widgets/deferred_draw.h"
+#include "../../services/heap_stats.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "../../font/font_cache.h"
+#include "../../font/font_bake.h"
+#include "../../font/font_upload.h"
+
+namespace I2CDebugger {
+
+    namespace {
+
+        // 原实现：逐字节查表 CRC32c，支持 "###"
+        struct ReferenceCrc32c {
+            ImU32 table[256];
+
+            ReferenceCrc32c() {
+                for (ImU32 i = 0; i < 256; i++) {
+                    ImU32 crc = i;
+                    for (int bit = 0; bit < 8; bit++) {
+                        crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+                    }
+                    table[i] = crc;
+                }
+            }
+
+            ImU32 HashData(const void* data, size_t size, ImU32 seed) const {
+                ImU32 crc = ~seed;
+                const unsigned char* p = static_cast<const unsigned char*>(data);
+                while (size-- > 0) crc = (crc >> 8) ^ table[(crc & 0xFF) ^ *p++];
+                return ~crc;
+            }
+
+            ImU32 HashStr(const char* str, ImU32 seed) const {
+                seed = ~seed;
+                ImU32 crc = seed;
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(str);
+                while (unsigned char c = *p++) {
+                    if (c == '#' && p[0] == '#' && p[1] == '#') {
+                        crc = seed;
+                        p += 2;
+                        continue;
+                    }
+                    crc = (crc >> 8) ^ table[(crc & 0xFF) ^ c];
+                }
+                return ~crc;
+            }
+        };
+
+        // 寄存器表/单次/周期表一行内会计算 ID 的标签
+        const char* const kRowLabels[] = {
+            "##reg", "##len", "##data", "##desc", "##parsed", "##delay", "属性", "读取", "写入", "解析###parse",
+        };
+        constexpr int kBenchRows = 1000;
+
+        const char* HashBackendName() {
+#if defined(IMGUI_USE_FAST_HASH)
+            return "快速哈希 (8 字节字)";
+#elif defined(IMGUI_ENABLE_SSE4_2_CRC)
+            return "CRC32c (SSE 4.2 指令)";
+#else
+            return "CRC32c (查表)";
+#endif
+        }
+
+        // 一帧：每行 PushID(int) 后对各标签取 ID，返回累加值防止被优化掉
+        template <typename HashInt, typename HashLabel>
+        ImU32 HashTableFrame(ImU32 tableId, HashInt hashInt, HashLabel hashLabel) {
+            ImU32 sink = 0;
+            for (int row = 0; row < kBenchRows; row++) {
+                const ImU32 rowId = hashInt(row, tableId);
+                for (const char* label : kRowLabels) {
+                    sink += hashLabel(label, rowId);
+                }
+            }
+            return sink;
+        }
+
+        IdHashBenchmarkResult RunIdHashBenchmark(int frames) {
+            static const ReferenceCrc32c s_reference;
+            IdHashBenchmarkResult result;
+            result.backend = HashBackendName();
+            result.idsPerFrame = kBenchRows * (1 + IM_ARRAYSIZE(kRowLabels));
+
+            auto currentInt = [](int n, ImU32 seed) { return ImHashData(&n, sizeof(n), seed); };
+            auto currentLabel = [](const char* label, ImU32 seed) { return ImHashStr(label, 0, seed); };
+            auto referenceInt = [](int n, ImU32 seed) { return s_reference.HashData(&n, sizeof(n), seed); };
+            auto referenceLabel = [](const char* label, ImU32 seed) { return s_reference.HashStr(label, seed); };
+
+            const ImU32 tableId = ImHashStr("RegisterTable");
+#if defined(IMGUI_USE_FAST_HASH)
+            result.identical = true;
+#else
+            result.identical = HashTableFrame(tableId, currentInt, currentLabel) == HashTableFrame(tableId, referenceInt, referenceLabel)
+                && ImHashStr("label###id") == s_reference.HashStr("id", 0);
+#endif
+
+            volatile ImU32 sink = 0;
+            auto begin = std::chrono::steady_clock::now();
+            for (int i = 0; i < frames; i++) sink += HashTableFrame(tableId + i, currentInt, currentLabel);
+            auto middle = std::chrono::steady_clock::now();
+            for (int i = 0; i < frames; i++) sink += HashTableFrame(tableId + i, referenceInt, referenceLabel);
+            auto end = std::chrono::steady_clock::now();
+
+            const double currentUs = std::chrono::duration<double, std::micro>(middle - begin).count();
+            const double referenceUs = std::chrono::duration<double, std::micro>(end - middle).count();
+            const double ids = static_cast<double>(result.idsPerFrame) * frames;
+            result.current = currentUs > 0.0 ? ids / currentUs : 0.0;
+            result.reference = referenceUs > 0.0 ? ids / referenceUs : 0.0;
+            result.frameUs = currentUs / frames;
+            result.referenceFrameUs = referenceUs / frames;
+            return result;
+        }
+
+        constexpr int MAX_STROKE_POINTS = 16384;
+
+        // 合成多通道采样：每通道 2 * points 个点，按时刻交错存放（同一时刻各通道相邻），与采集记录的布局一致
+        void GeneratePlotSamples(std::vector<float>& samples, int channels, int points) {
+            samples.resize(static_cast<size_t>(channels) * points * 2);
+            for (int i = 0; i < points * 2; i++) {
+                const float t = static_cast<float>(i) / points;
+                for (int channel = 0; channel < channels; channel++) {
+                    const float frequency = 2.0f + channel * 0.75f;
+                    samples[static_cast<size_t>(i) * channels + channel] = std::sin(t * frequency * 6.2831853f) * 0.8f
+                        + std::sin(t * frequency * 7.0f * 6.2831853f) * 0.2f;
+                }
+            }
+        }
+
+    }
+
+    void DiagnosticsWindow::Render(bool* p_open)
+    {
+        ImGui::SetNextWindowSize(ImVec2(640, 400), ImGuiCond_FirstUseEver);
+
+        if (!ImGui::Begin("性能诊断", p_open)) {
+            ImGui::End();
+            return;
+        }
+
+        if (ImGui::CollapsingHeader("公式求值", ImGuiTreeNodeFlags_DefaultOpen)) {
+            RenderFormulaBenchmark();
+            RenderWriteFormulaChecks();
+        }
+
+        if (ImGui::CollapsingHeader("配置加载")) {
+            RenderConfigLoadBenchmark();
+        }
+
+        if (ImGui::CollapsingHeader("字体")) {
+            RenderFontStats();
+        }
+
+        if (ImGui::CollapsingHeader("文本渲染")) {
+            RenderTextBenchmark();
+        }
+
+        if (ImGui::CollapsingHeader("并行绘制")) {
+            RenderDeferredDrawBenchmark();
+        }
+
+        if (ImGui::CollapsingHeader("单元格缓存")) {
+            RenderCachedTextStats();
+        }
+
+        if (ImGui::CollapsingHeader("ID 哈希")) {
+            RenderIdHashBenchmark();
+        }
+
+        if (ImGui::CollapsingHeader("堆分配")) {
+            RenderHeapStats();
+        }
+
+        if (ImGui::CollapsingHeader("字符串池")) {
+            RenderStringPoolStats();
+        }
+
+        ImGui::End();
+    }
+
+    void DiagnosticsWindow::RenderFormulaBenchmark()
+    {
+        ImGui::SetNextItemWidth(120);
+        ImGui::InputInt("迭代次数", &m_formulaIterations, 10000, 100000);
+        if (m_formulaIterations < 1000) m_formulaIterations = 1000;
+
+        ImGui::SameLine();
+        if (ImGui::Button("运行##Formula")) {
+            m_formulaResults = ExpressionParser::RunBenchmark(m_formulaIterations);
+        }
+
+        if (m_formulaResults.empty()) {
+            ImGui::TextDisabled("比较字节码与 ExprTK 的单次求值耗时 (ns)");
+            return;
+        }
+
+        ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+        if (ImGui::BeginTable("FormulaBenchmark", 5, flags)) {
+            ImGui::TableSetupColumn("公式", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("指令数");
+            ImGui::TableSetupColumn("字节码");
+            ImGui::TableSetupColumn("ExprTK");
+            ImGui::TableSetupColumn("ExprTK(每次编译)");
+            ImGui::TableHeadersRow();
+
+            for (const auto& r : m_formulaResults) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(r.formula.c_str());
+                ImGui::TableNextColumn();
+                if (r.compiled) ImGui::Text("%zu", r.instructionCount);
+                else ImGui::TextDisabled("回退");
+                ImGui::TableNextColumn();
+                if (r.compiled) ImGui::Text("%.1f", r.bytecodeNs);
+                else ImGui::TextDisabled("-");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", r.exprtkCachedNs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f", r.exprtkCompileNs);
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    void DiagnosticsWindow::RenderConfigLoadBenchmark()
+    {
+        ImGui::SetNextItemWidth(120);
+        ImGui::InputInt("条目数", &m_configEntryCount, 10000, 50000);
+        if (m_configEntryCount < 1000) m_configEntryCount = 1000;
+
+        ImGui::SameLine();
+        if (ImGui::Button("运行##ConfigLoad")) {
+            m_configResult = ConfigurationService::RunLoadBenchmark(m_configEntryCount);
+            m_hasConfigResult = true;
+        }
+
+        if (!m_hasConfigResult) {
+            ImGui::TextDisabled("生成合成配置（每组 1000 条），比较 DOM、流式加载与二进制缓存的耗时");
+            return;
+        }
+
+        const ConfigLoadBenchmarkResult& r = m_configResult;
+        ImGui::Text("%d 条目 / %d 组, JSON %.1f MB", r.entryCount, r.groupCount, r.fileBytes / (1024.0 * 1024.0));
+        ImGui::Text("DOM 加载: %.1f ms", r.domLoadMs);
+        ImGui::Text("流式加载: %.1f ms", r.saxLoadMs);
+        ImGui::Text("二进制缓存: %.1f ms (%.1f MB)", r.binaryLoadMs, r.binaryBytes / (1024.0 * 1024.0));
+        if (!r.success) {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "(条目数不一致)");
+        }
+    }
+
+    // 寄存器表导入生成的写入公式：工程值不能精确表示时也要写入最接近的原始值
+    void DiagnosticsWindow::RenderWriteFormulaChecks()
+    {
+        if (ImGui::Button("写入公式舍入自检")) {
+            m_writeChecks = RegisterMap::RunWriteFormulaChecks();
+        }
+        if (m_writeChecks.empty()) return;
+
+        ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+        if (ImGui::BeginTable("WriteFormulaChecks", 4, flags)) {
+            ImGui::TableSetupColumn("写入公式", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("工程值");
+            ImGui::TableSetupColumn("期望");
+            ImGui::TableSetupColumn("结果");
+            ImGui::TableHeadersRow();
+
+            for (const auto& check : m_writeChecks) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(check.formula.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%g", check.value);
+                ImGui::TableNextColumn();
+                ImGui::Text("%lld", static_cast<long long>(check.expected));
+                ImGui::TableNextColumn();
+                if (check.ok) ImGui::Text("%lld", static_cast<long long>(check.actual));
+                else ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%lld", static_cast<long long>(check.actual));
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    void DiagnosticsWindow::RenderFontStats()
+    {
+        const FontLoadStats& stats = GetFontLoadStats();
+        ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+
+        ImGui::Text("字形烘焙: %s", stats.dynamicGlyphs ? "按需 (动态纹理)" : "启动时全部烘焙");
+        ImGui::Text("LoadFont 耗时: %.2f ms", stats.loadFontMs);
+        ImGui::Text("启动到首帧: %.1f ms", stats.firstFrameMs);
+        ImGui::Text("预热字形: %d / %d", stats.prewarmDone, stats.prewarmTotal);
+
+        if (atlas->TexData != nullptr) {
+            ImTextureData* tex = atlas->TexData;
+            ImGui::Text("图集纹理: %d x %d, %.2f MB", tex->Width, tex->Height,
+                tex->GetSizeInBytes() / (1024.0 * 1024.0));
+        }
+        ImGui::Text("当前字号已烘焙字形: %d", ImGui::GetFontBaked()->Glyphs.Size);
+
+        ImGui::Separator();
+        const FontCacheStats& cache = FontCacheGetStats();
+        const char* state = "未启用";
+        switch (cache.state) {
+        case FontCacheState::Missing:     state = "无缓存文件 (本次生成)"; break;
+        case FontCacheState::Invalidated: state = "已失效 (字体/配置/版本变化)"; break;
+        case FontCacheState::Loaded:      state = "已加载"; break;
+        default: break;
+        }
+        ImGui::Text("字形缓存: %s", state);
+        ImGui::Text("缓存字形: %u, 文件 %.2f MB, 打开耗时 %.2f ms",
+            cache.cachedGlyphs, cache.fileBytes / (1024.0 * 1024.0), cache.openMs);
+        ImGui::Text("本次命中: %u, 新光栅化: %u", cache.hits, cache.misses);
+
+        ImGui::Separator();
+        const FontBakeStats bake = FontBakeGetStats();
+        bool bakeEnabled = FontBakeIsEnabled();
+        if (ImGui::Checkbox("后台光栅化新字形", &bakeEnabled)) {
+            FontBakeSetEnabled(bakeEnabled);
+        }
+        ImGui::SameLine();
+        ImGui::TextDisabled("(%d 线程，ASCII 仍同步)", bake.workers);
+        ImGui::Text("已提交: %u, 已完成: %u, 已打包: %u, 等待中: %d",
+            bake.queued, bake.completed, bake.packed, bake.pending);
+        ImGui::Text("光栅化: 平均 %.3f ms, 最长 %.3f ms",
+            bake.completed ? bake.rasterMs / bake.completed : 0.0, bake.maxRasterMs);
+
+        ImGui::Separator();
+        const FontUploadStats& upload = FontUploadGetStats();
+        bool coalesce = upload.coalesce;
+        if (ImGui::Checkbox("合并图集上传区域", &coalesce)) {
+            FontUploadSetCoalesce(coalesce);
+        }
+        ImGui::Text("上一帧上传: %d 个请求 -> %d 次, %.1f KB（峰值 %.1f KB）",
+            upload.lastRequests, upload.lastUploads, upload.lastBytes / 1024.0, upload.peakBytes / 1024.0);
+        ImGui::Text("累计上传: %u 个请求 -> %u 次, %.2f MB",
+            upload.totalRequests, upload.totalUploads, upload.totalBytes / (1024.0 * 1024.0));
+        ImGui::PlotHistogram("##UploadHistory", upload.history, FontUploadStats::HISTORY_SIZE,
+            upload.historyOffset, "每帧上传 KB", 0.0f, FLT_MAX, ImVec2(0, 60));
+    }
+
+    void DiagnosticsWindow::RenderTextBenchmark()
+    {
+        ImGui::SetNextItemWidth(120);
+        ImGui::InputInt("迭代次数##Text", &m_textIterations, 1000, 10000);
+        if (m_textIterations < 100) m_textIterations = 100;
+
+        ImGui::SameLine();
+        if (ImGui::Button("运行##Text")) {
+            m_textResult = RunTextRenderBenchmark(m_textIterations);
+            m_hasTextResult = true;
+        }
+
+        if (!m_hasTextResult) {
+            ImGui::TextDisabled("十六进制转储行与中英混排行，比较 ASCII 快速路径开启/关闭的吞吐 (百万字形/秒)");
+            return;
+        }
+
+        const TextRenderBenchmarkResult& r = m_textResult;
+        ImGui::Text("每轮 %d 字形", r.glyphsPerPass);
+        ImGui::Text("CalcTextSize: %.1f / %.1f (%.2fx)", r.calcFast, r.calcScalar,
+            r.calcScalar > 0.0 ? r.calcFast / r.calcScalar : 0.0);
+        ImGui::Text("RenderText: %.1f / %.1f (%.2fx)", r.renderFast, r.renderScalar,
+            r.renderScalar > 0.0 ? r.renderFast / r.renderScalar : 0.0);
+        ImGui::Text("中英混排 RenderText: %.1f / %.1f", r.mixedRenderFast, r.mixedRenderScalar);
+        if (!r.identical) {
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "两条路径输出不一致");
+        }
+    }
+
+    void DiagnosticsWindow::RenderDeferredDrawBenchmark()
+    {
+        bool enabled = DeferredDraw::IsEnabled();
+        if (ImGui::Checkbox("工作线程构建自绘内容", &enabled)) {
+            DeferredDraw::SetEnabled(enabled);
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("批量折线 (AddPolylineValues)", &m_deferredBulkPolyline);
+        ImGui::SetNextItemWidth(120);
+        ImGui::SliderInt("曲线数", &m_deferredPlotCount, 1, 16);
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(120);
+        ImGui::SliderInt("点数", &m_deferredPlotPoints, 500, 200000, "%d", ImGuiSliderFlags_Logarithmic);
+        ImGui::SameLine();
+        ImGui::Checkbox("运行##Deferred", &m_deferredPlotsRunning);
+
+        const DeferredDraw::Stats& stats = DeferredDraw::GetStats();
+        ImGui::Text("上一帧: %d 个任务, %d 线程, 几何构建 %.2f ms, 共 %d 点, 顶点 %d", stats.jobs, stats.threads, stats.buildMs,
+            m_deferredPlotsRunning ? m_deferredPlotCount * m_deferredPlotPoints : 0, ImGui::GetIO().MetricsRenderVertices);
+        if (!m_deferredPlotsRunning) {
+            ImGui::TextDisabled("每帧绘制多条滚动波形，比较逐点 PathLineTo 与批量折线、主线程与工作线程构建的耗时");
+            return;
+        }
+
+        const int channels = m_deferredPlotCount;
+        const int points = m_deferredPlotPoints;
+        if (m_plotSampleChannels != channels || m_plotSamplePoints != points) {
+            GeneratePlotSamples(m_plotSamples, channels, points);
+            m_plotSampleChannels = channels;
+            m_plotSamplePoints = points;
+        }
+
+        // 每秒滚动 10% 的点数。采样在提交后、Render 结束前不会改动，构建函数可直接读取
+        const int offset = static_cast<int>(ImGui::GetTime() * points * 0.1) % points;
+        const float* samples = m_plotSamples.data() + static_cast<size_t>(offset) * channels;
+        const bool bulk = m_deferredBulkPolyline;
+        const float width = ImGui::GetContentRegionAvail().x;
+        for (int plot = 0; plot < channels; plot++) {
+            const float* values = samples + plot;
+            // 构建函数在工作线程执行，只按值捕获参数，只用 ImDrawList 几何接口
+            DeferredDraw::Submit(ImVec2(width, 80.0f), [=](ImDrawList* drawList, const ImVec2& min, const ImVec2& max) {
+                drawList->AddRectFilled(min, max, IM_COL32(30, 30, 36, 255));
+                for (int i = 1; i < 4; i++) {
+                    float y = min.y + (max.y - min.y) * i / 4.0f;
+                    drawList->AddLine(ImVec2(min.x, y), ImVec2(max.x, y), IM_COL32(70, 70, 80, 255));
+                }
+
+                const float midY = (min.y + max.y) * 0.5f;
+                const float amplitude = (max.y - min.y) * 0.45f;
+                const float stepX = (max.x - min.x) / (points - 1);
+                const ImU32 color = IM_COL32(90, 200, 255, 255);
+                if (bulk) {
+                    drawList->AddPolylineValues(values, points, ImVec2(min.x, midY), ImVec2(stepX, -amplitude),
+                        color, 1.0f, static_cast<int>(channels * sizeof(float)));
+                }
+                else {
+                    // 16 位索引下单次描边不能超过 65536 个顶点，分段描边，相邻段共用一个点
+                    for (int begin = 0; begin < points - 1; begin += MAX_STROKE_POINTS - 1) {
+                        const int end = std::min(begin + MAX_STROKE_POINTS, points);
+                        drawList->PathClear();
+                        for (int i = begin; i < end; i++) {
+                            drawList->PathLineTo(ImVec2(min.x + stepX * i, midY - values[static_cast<size_t>(i) * channels] * amplitude));
+                        }
+                        drawList->PathStroke(color, ImDrawFlags_None, 1.0f);
+                    }
+                }
+            });
+        }
+    }
+
+    void DiagnosticsWindow::RenderCachedTextStats()
+    {
+        CachedText::Stats stats = CachedText::GetStats();
+        const int total = stats.replayed + stats.recorded;
+        ImGui::Text("上一帧可见单元格: 复用顶点 %d, 重新排版 %d", stats.replayed, stats.recorded);
+        if (total > 0) {
+            ImGui::ProgressBar(static_cast<float>(stats.replayed) / total, ImVec2(200, 0), "命中率");
+        }
+        ImGui::TextDisabled("寄存器值、状态与只读解析值在内容不变时直接复制上一帧的顶点");
+    }
+
+    void DiagnosticsWindow::RenderIdHashBenchmark()
+    {
+        ImGui::SetNextItemWidth(120);
+        ImGui::InputInt("帧数##Hash", &m_hashFrames, 50, 500);
+        if (m_hashFrames < 10) m_hashFrames = 10;
+
+        ImGui::SameLine();
+        if (ImGui::Button("运行##Hash")) {
+            m_hashResult = RunIdHashBenchmark(m_hashFrames);
+            m_hasHashResult = true;
+        }
+
+        ImGui::Text("当前帧时间: %.2f ms", 1000.0f / ImGui::GetIO().Framerate);
+        if (!m_hasHashResult) {
+            ImGui::TextDisabled("模拟 1000 行表格每帧的 PushID 与控件标签哈希，比较当前实现与逐字节查表 CRC32c");
+            return;
+        }
+
+        const IdHashBenchmarkResult& r = m_hashResult;
+        ImGui::Text("实现: %s", r.backend);
+        ImGui::Text("吞吐: %.1f / %.1f 百万 ID/秒 (%.2fx)", r.current, r.reference,
+            r.reference > 0.0 ? r.current / r.reference : 0.0);
+        ImGui::Text("每帧 %d 个 ID: %.1f us / %.1f us", r.idsPerFrame, r.frameUs, r.referenceFrameUs);
+        if (!r.identical) {
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "与原实现结果不一致");
+        }
+    }
+
+    void DiagnosticsWindow::RenderHeapStats()
+    {
+        const HeapStats::Counters& frame = HeapStats::GetLastFrame();
+        const HeapStats::Counters totals = HeapStats::GetTotals();
+        ImGui::Text("上一帧 new/delete: %llu 次分配, %.1f KB, %llu 次释放（所有线程）",
+            static_cast<unsigned long long>(frame.allocCount), frame.allocBytes / 1024.0,
+            static_cast<unsigned long long>(frame.freeCount));
+        ImGui::Text("累计: %llu 次分配, %.1f MB, 未释放 %lld 块",
+            static_cast<unsigned long long>(totals.allocCount), totals.allocBytes / (1024.0 * 1024.0),
+            static_cast<long long>(totals.allocCount - totals.freeCount));
+        ImGui::PlotHistogram("##HeapHistory", HeapStats::GetHistory(), HeapStats::HISTORY_SIZE,
+            HeapStats::GetHistoryOffset(), "每帧分配次数", 0.0f, FLT_MAX, ImVec2(0, 60));
+
+        ImGuiContext& g = *GImGui;
+        const ImGuiFrameArena& arena = g.FrameArena;
+        ImGui::Text("ImGui MemAlloc 上一帧: %d 次, %d B", g.DebugAllocInfo.LastFrameAllocCount, g.DebugAllocInfo.LastFrameAllocBytes);
+        ImGui::Text("帧内存储区: 上一帧 %d B / %d 次, 峰值 %d B, 已保留 %d B（%d 块）",
+            arena.LastFrameUsedBytes, arena.LastFrameAllocCount, arena.HighWaterMark, arena.ReservedBytes, arena.Blocks.Size);
+        ImGui::TextDisabled("每帧重建的临时字符串与指针表改用 ImGui::MemAllocFrame()，下一帧 NewFrame 时整体回收");
+    }
+
+    void DiagnosticsWindow::RenderStringPoolStats()
+    {
+        InternedString::PoolStats pool = InternedString::GetPoolStats();
+        ImGui::Text("驻留字符串: %u 个, %.1f KB", pool.count, pool.bytes / 1024.0);
+        ImGui::TextDisabled("描述、按钮名、别名、公式和错误详情只保存 4 字节编号");
+        ImGui::Text("条目大小: 寄存器 %d B, 单次 %d B, 周期 %d B",
+            static_cast<int>(sizeof(RegisterEntry)),
+            static_cast<int>(sizeof(SingleTriggerEntry)),
+            static_cast<int>(sizeof(PeriodicTriggerEntry)));
+    }
+
+}
@@ -0,0 +1,64 @@
+﻿#pragma once
+
+#include "../../services/expression_parser.h"
+#include "../../services/configuration_service.h"
+#include "../../services/register_map.h"
+#include "../../font/font_load.h"
+#include <vector>
+
+namespace I2CDebugger {
+
+    // ID 哈希微基准：模拟寄存器表每行的 PushID + 控件标签，单位百万 ID/秒
+    struct IdHashBenchmarkResult {
+        const char* backend = "";       // 编译期选择的 ImHashStr/ImHashData 实现
+        int idsPerFrame = 0;            // 模拟 1000 行表格一帧计算的 ID 数
+        double current = 0.0;           // 当前实现
+        double reference = 0.0;         // 逐字节查表 CRC32c（原实现）
+        double frameUs = 0.0;           // 当前实现计算一帧 ID 的耗时
+        double referenceFrameUs = 0.0;
+        bool identical = false;         // 与原实现结果一致（快速哈希不要求一致）
+    };
+
+    // 性能诊断窗口：在程序内运行各模块的微基准测试
+    class DiagnosticsWindow {
+    public:
+        void Render(bool* p_open = nullptr);
+
+    private:
+        void RenderFormulaBenchmark();
+        void RenderWriteFormulaChecks();
+        void RenderFontStats();
+        void RenderConfigLoadBenchmark();
+        void RenderStringPoolStats();
+        void RenderTextBenchmark();
+        void RenderDeferredDrawBenchmark();
+        void RenderCachedTextStats();
+        void RenderIdHashBenchmark();
+        void RenderHeapStats();
+
+        std::vector<FormulaBenchmarkResult> m_formulaResults;
+        int m_formulaIterations = 100000;
+        std::vector<WriteFormulaCheck> m_writeChecks;
+
+        ConfigLoadBenchmarkResult m_configResult;
+        bool m_hasConfigResult = false;
+        int m_configEntryCount = 50000;
+
+        TextRenderBenchmarkResult m_textResult;
+        bool m_hasTextResult = false;
+        int m_textIterations = 20000;
+
+        IdHashBenchmarkResult m_hashResult;
+        bool m_hasHashResult = false;
+        int m_hashFrames = 200;
+
+        bool m_deferredPlotsRunning = false;
+        bool m_deferredBulkPolyline = true;
+        int m_deferredPlotCount = 8;
+        int m_deferredPlotPoints = 4000;
+        std::vector<float> m_plotSamples;       // 各通道交错存放，见 GeneratePlotSamples()
+        int m_plotSampleChannels = 0;
+        int m_plotSamplePoints = 0;
+    };
+
+}
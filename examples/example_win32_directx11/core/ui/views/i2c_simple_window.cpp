@@ -1,5 +1,6 @@
 ﻿#include "i2c_simple_window.h"
 #include "../../viewmodels/i2c_simple_viewmodel.h"
+#include "../../services/profiler.h"
 #include "imgui.h"
 #include <cstdio>
 
@@ -35,6 +36,7 @@ static void DrawActivityIndicator(ActivityIndicator& indicator) {
 
 void I2CSimpleWindow::Render(bool* p_open)
 {
+    ProfileZone zone("I2CSimpleWindow::Render");
     auto& data = m_viewModel->GetData();
 
     ImGui::SetNextWindowSize(ImVec2(450, 500), ImGuiCond_FirstUseEver);
@@ -198,8 +200,10 @@ void I2CSimpleWindow::RenderSimpleOperation()
             ImGui::Text("读取结果:");
             ImGui::SameLine();
             {
-                std::string result = m_viewModel->FormatHexData(data.readData);
-                ImGui::TextColored(ImVec4(0.0f, 1.0f, 1.0f, 1.0f), "%s", result.empty() ? "-" : result.c_str());
+                const size_t resultSize = data.readData.size() * 3 + 1;
+                char* result = static_cast<char*>(ImGui::MemAllocFrame(resultSize));
+                const size_t resultLen = m_viewModel->FormatHexData(data.readData, result, resultSize);
+                ImGui::TextColored(ImVec4(0.0f, 1.0f, 1.0f, 1.0f), "%s", resultLen == 0 ? "-" : result);
             }
             break;
         case OperationType::Write:
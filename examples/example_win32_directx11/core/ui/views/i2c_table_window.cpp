@@ -1,7 +1,9 @@
 ﻿#include "i2c_table_window.h"
 #include "../../viewmodels/i2c_table_viewmodel.h"
+#include "../../services/profiler.h"
 #include "imgui.h"
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
 
@@ -54,6 +56,12 @@ namespace I2CDebugger {
         else if (errorType == ErrorType::DeviceDisconnected) {
             return ImVec4(1.0f, 0.0f, 0.0f, 1.0f);
         }
+        else if (errorType == ErrorType::SlaveSuspended) {
+            return ImVec4(0.6f, 0.6f, 0.6f, 1.0f);
+        }
+        else if (errorType == ErrorType::VerifyMismatch) {
+            return ImVec4(1.0f, 0.3f, 0.8f, 1.0f);
+        }
         return ImVec4(1.0f, 0.5f, 0.0f, 1.0f);
     }
 
@@ -63,10 +71,58 @@ namespace I2CDebugger {
         switch (errorType) {
         case ErrorType::SlaveNotResponse: return "NAK";
         case ErrorType::DeviceDisconnected: return "断开";
+        case ErrorType::SlaveSuspended: return "挂起";
+        case ErrorType::VerifyMismatch: return "校验失败";
         default: return "错误";
         }
     }
 
+    // 状态列：内容只随读写结果变化，走单元格顶点缓存
+    // 校验失败的写入/回读字节只在悬停时格式化
+    static void AppendHexBytes(std::string& text, const std::vector<uint8_t>& bytes) {
+        char buf[4];
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            std::snprintf(buf, sizeof(buf), i == 0 ? "%02X" : " %02X", bytes[i]);
+            text += buf;
+        }
+    }
+
+    static void RenderStatusCell(CachedText& cell, bool hasResult, bool success, ErrorType errorType,
+        const std::string& errorDetail, const std::vector<uint8_t>* verifyWritten = nullptr,
+        const std::vector<uint8_t>* verifyReadback = nullptr) {
+        if (!hasResult) {
+            if (!cell.Replay(CachedText::HashString("-"), ImVec4(0.5f, 0.5f, 0.5f, 1.0f))) {
+                cell.Record("-");
+            }
+            return;
+        }
+        const char* statusText = GetStatusText(success, errorType);
+        if (!cell.Replay(CachedText::HashString(statusText), GetStatusColor(success, errorType))) {
+            cell.Record(statusText);
+        }
+        if (!success && ImGui::IsItemHovered()) {
+            if (errorType == ErrorType::VerifyMismatch && verifyWritten && verifyReadback) {
+                std::string text = errorDetail + ": 写入 ";
+                AppendHexBytes(text, *verifyWritten);
+                text += ", 回读 ";
+                AppendHexBytes(text, *verifyReadback);
+                ImGui::SetTooltip("%s", text.c_str());
+            }
+            else {
+                ImGui::SetTooltip("%s", errorDetail.c_str());
+            }
+        }
+    }
+
+    // 只读解析值：按数值缓存，避免每帧格式化与排版
+    static void RenderParsedValueCell(CachedText& cell, double value) {
+        if (!cell.Replay(CachedText::HashBytes(&value, sizeof(value)))) {
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), "%.4g", value);
+            cell.Record(buf);
+        }
+    }
+
     void I2CTableWindow::RenderGroupSelector()
     {
         auto& data = m_viewModel->GetData();
@@ -74,14 +130,15 @@ namespace I2CDebugger {
         ImGui::Text("命令表:");
         ImGui::SameLine();
 
-        std::vector<const char*> groupNames;
-        for (const auto& g : data.commandGroups) {
-            groupNames.push_back(g.name.c_str());
+        // 名称指针表每帧重建，放在帧内存储区
+        const int groupCount = static_cast<int>(data.commandGroups.size());
+        const char** groupNames = static_cast<const char**>(ImGui::MemAllocFrame(sizeof(const char*) * (groupCount > 0 ? groupCount : 1)));
+        for (int i = 0; i < groupCount; i++) {
+            groupNames[i] = data.commandGroups[i].name.c_str();
         }
 
         ImGui::SetNextItemWidth(250);
-        if (ImGui::Combo("##GroupSelect", &data.currentGroupIndex,
-            groupNames.data(), static_cast<int>(groupNames.size()))) {
+        if (ImGui::Combo("##GroupSelect", &data.currentGroupIndex, groupNames, groupCount)) {
             auto& group = m_viewModel->GetCurrentGroup();
             std::snprintf(m_slaveAddrInput, sizeof(m_slaveAddrInput), "0x%02X", group.slaveAddress);
             std::snprintf(m_intervalInput, sizeof(m_intervalInput), "%u", group.interval);
@@ -109,6 +166,10 @@ namespace I2CDebugger {
             m_showImportPopup = true;
             std::strncpy(m_importPathBuffer, "", sizeof(m_importPathBuffer));
         }
+        ImGui::SameLine();
+        if (ImGui::Button("寄存器映射")) {
+            m_showRegisterMapPopup = true;
+        }
     }
 
     void I2CTableWindow::Render(bool* p_open)
@@ -156,6 +217,7 @@ namespace I2CDebugger {
 
         RenderExportPopup();
         RenderImportPopup();
+        RenderRegisterMapPopup();
 
         ImGui::End();
     }
@@ -270,6 +332,139 @@ namespace I2CDebugger {
         }
     }
 
+    void I2CTableWindow::RenderRegisterMapPopup()
+    {
+        if (m_showRegisterMapPopup) {
+            ImGui::OpenPopup("导入寄存器映射");
+        }
+
+        if (ImGui::BeginPopupModal("导入寄存器映射", &m_showRegisterMapPopup, ImGuiWindowFlags_AlwaysAutoResize)) {
+            RegisterMap& map = m_viewModel->GetRegisterMap();
+
+            ImGui::Text("寄存器描述文件 (CSV/JSON):");
+            ImGui::SetNextItemWidth(500);
+            ImGui::InputText("##regmappath", m_registerMapPathBuffer, sizeof(m_registerMapPathBuffer));
+            ImGui::SameLine();
+            if (ImGui::Button("浏览...", ImVec2(80, 0))) {
+#ifdef _WIN32
+                OPENFILENAMEA ofn;
+                char szFile[512] = "";
+                ZeroMemory(&ofn, sizeof(ofn));
+                ofn.lStructSize = sizeof(ofn);
+                ofn.hwndOwner = NULL;
+                ofn.lpstrFile = szFile;
+                ofn.nMaxFile = sizeof(szFile);
+                ofn.lpstrFilter = "Register Maps\0*.csv;*.json\0All Files\0*.*\0";
+                ofn.nFilterIndex = 1;
+                ofn.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST;
+
+                if (GetOpenFileNameA(&ofn)) {
+                    std::strncpy(m_registerMapPathBuffer, szFile, sizeof(m_registerMapPathBuffer) - 1);
+                }
+#endif
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("打开", ImVec2(80, 0)) && strlen(m_registerMapPathBuffer) > 0) {
+                m_viewModel->OpenRegisterMap(m_registerMapPathBuffer);
+                m_registerMapFirstRow = 0;
+                m_registerMapRowCount = -1;
+            }
+
+            if (!map.GetLastError().empty()) {
+                ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", map.GetLastError().c_str());
+            }
+
+            if (map.IsOpen()) {
+                ImGui::Text("设备: %s    寄存器: %d", map.GetDeviceName().c_str(), map.GetRowCount());
+                if (map.GetSkippedCount() > 0) {
+                    ImGui::SameLine();
+                    ImGui::TextDisabled("（跳过 %d 个：地址超出 8 位或位宽无效）", map.GetSkippedCount());
+                }
+                ImGui::TextDisabled("索引 %.1f KB，源文本 %.1f KB，仅展开可见行",
+                    map.GetIndexBytes() / 1024.0, map.GetTextBytes() / 1024.0);
+
+                // 预览：只展开裁剪器给出的可见行
+                ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY |
+                    ImGuiTableFlags_SizingStretchProp;
+                if (ImGui::BeginTable("RegisterMapPreview", 6, flags, ImVec2(680, 280))) {
+                    ImGui::TableSetupScrollFreeze(0, 1);
+                    ImGui::TableSetupColumn("序号", ImGuiTableColumnFlags_WidthFixed, 50);
+                    ImGui::TableSetupColumn("从机", ImGuiTableColumnFlags_WidthFixed, 40);
+                    ImGui::TableSetupColumn("地址", ImGuiTableColumnFlags_WidthFixed, 40);
+                    ImGui::TableSetupColumn("位宽", ImGuiTableColumnFlags_WidthFixed, 40);
+                    ImGui::TableSetupColumn("字段", ImGuiTableColumnFlags_WidthFixed, 40);
+                    ImGui::TableSetupColumn("名称 / 描述", ImGuiTableColumnFlags_WidthStretch);
+                    ImGui::TableHeadersRow();
+
+                    ImGuiListClipper clipper;
+                    clipper.Begin(map.GetRowCount());
+                    while (clipper.Step()) {
+                        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                            const RegisterMapRow& row = map.GetRow(i);
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn(); ImGui::Text("%d", i);
+                            ImGui::TableNextColumn(); ImGui::Text("0x%02X", row.slaveAddress);
+                            ImGui::TableNextColumn(); ImGui::Text("0x%02X", row.address);
+                            ImGui::TableNextColumn(); ImGui::Text("%d", row.byteCount * 8);
+                            ImGui::TableNextColumn(); ImGui::Text("%d", static_cast<int>(row.fields.size()));
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%s", row.name.c_str());
+                            if (!row.description.empty()) {
+                                ImGui::SameLine();
+                                ImGui::TextDisabled("%s", row.description.c_str());
+                            }
+                        }
+                    }
+                    ImGui::EndTable();
+                }
+
+                ImGui::SetNextItemWidth(120);
+                ImGui::InputInt("起始行", &m_registerMapFirstRow);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(120);
+                ImGui::InputInt("行数 (-1 全部)", &m_registerMapRowCount);
+                ImGui::SetNextItemWidth(120);
+                ImGui::InputInt("每组最多条目", &m_registerMapMaxEntries);
+                ImGui::SameLine();
+                ImGui::Checkbox("位字段单独成行", &m_registerMapIncludeFields);
+
+                if (m_registerMapFirstRow < 0) m_registerMapFirstRow = 0;
+                if (m_registerMapRowCount < -1) m_registerMapRowCount = -1;
+                if (m_registerMapMaxEntries < 1) m_registerMapMaxEntries = 1;
+            }
+
+            ImGui::Spacing();
+
+            ImGui::BeginDisabled(!map.IsOpen());
+            if (ImGui::Button("生成命令组", ImVec2(100, 0))) {
+                RegisterMapImportOptions options;
+                options.firstRow = m_registerMapFirstRow;
+                options.rowCount = m_registerMapRowCount;
+                options.includeFields = m_registerMapIncludeFields;
+                options.maxEntriesPerGroup = m_registerMapMaxEntries;
+
+                if (m_viewModel->ImportRegisterMap(options) > 0) {
+                    auto& group = m_viewModel->GetCurrentGroup();
+                    std::snprintf(m_slaveAddrInput, sizeof(m_slaveAddrInput), "0x%02X", group.slaveAddress);
+                    std::snprintf(m_intervalInput, sizeof(m_intervalInput), "%u", group.interval);
+                    m_viewModel->CloseRegisterMap();
+                    m_showRegisterMapPopup = false;
+                    ImGui::CloseCurrentPopup();
+                }
+            }
+            ImGui::EndDisabled();
+
+            ImGui::SameLine();
+            if (ImGui::Button("取消", ImVec2(80, 0))) {
+                m_viewModel->CloseRegisterMap();
+                m_showRegisterMapPopup = false;
+                ImGui::CloseCurrentPopup();
+            }
+
+            ImGui::EndPopup();
+        }
+    }
+
     void I2CTableWindow::RenderSlaveAddressInput()
     {
         auto& data = m_viewModel->GetData();
@@ -292,6 +487,18 @@ namespace I2CDebugger {
             if (ImGui::InputText("##Interval", m_intervalInput, sizeof(m_intervalInput))) {
                 group.interval = static_cast<uint32_t>(std::stoul(m_intervalInput));
             }
+
+            // 设定间隔短于总线可达到的最短周期时提前提示，避免周期被悄悄拉长
+            PeriodicCapacity capacity = m_viewModel->EstimateCurrentGroupCapacity();
+            if (capacity.predictedCycleMs > group.interval) {
+                ImGui::SameLine();
+                ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.0f, 1.0f), "(!) 最短约 %.1f ms", capacity.predictedCycleMs);
+                if (ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("按当前波特率和实测 HID 开销，一轮至少需要 %.1f ms\n"
+                        "（线上时间 %.2f ms），最高约 %.1f Hz",
+                        capacity.predictedCycleMs, capacity.wireMs, capacity.maxPollRateHz);
+                }
+            }
         }
 
         // ========== 右侧状态显示 ==========
@@ -309,6 +516,63 @@ namespace I2CDebugger {
         }
     }
 
+    void I2CTableWindow::RenderBusLoad()
+    {
+        BusLoadStats stats = m_viewModel->GetBusLoadStats();
+
+        // 需求超过总线能力时标红：各组无法按设定间隔完成
+        ImVec4 color = ImVec4(0.0f, 1.0f, 0.0f, 1.0f);
+        if (stats.demandPercent >= 100.0 || stats.busyPercent >= 95.0) {
+            color = ImVec4(1.0f, 0.0f, 0.0f, 1.0f);
+        }
+        else if (stats.demandPercent >= 70.0) {
+            color = ImVec4(1.0f, 0.8f, 0.0f, 1.0f);
+        }
+        ImGui::TextColored(color, "总线占用: %.0f%% (需求 %.0f%%)", stats.busyPercent, stats.demandPercent);
+        bool hovered = ImGui::IsItemHovered();
+        if (!stats.suspendedSlaves.empty()) {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.0f, 1.0f), "挂起从机: %d", static_cast<int>(stats.suspendedSlaves.size()));
+            hovered = hovered || ImGui::IsItemHovered();
+        }
+
+        if (hovered) {
+            ImGui::BeginTooltip();
+            ImGui::Text("事务数: %u /s", stats.transactionsPerSecond);
+            ImGui::Text("线上利用率: %.1f%%  吞吐: %.0f B/s", stats.utilizationPercent, stats.bytesPerSecond);
+            ImGui::Text("HID 开销倍数: %.1fx", stats.hidOverheadRatio);
+            ImGui::Separator();
+            for (const auto& load : stats.groups) {
+                const char* name = "?";
+                for (const auto& group : m_viewModel->GetData().commandGroups) {
+                    if (group.id == load.groupId) {
+                        name = group.name.c_str();
+                        break;
+                    }
+                }
+                ImGui::Text("%s: 间隔 %u ms, 实际 %.1f ms, 占用 %.1f ms, 超时 %u 轮, 最高 %.1f Hz",
+                    name, load.intervalMs, load.lastCycleMs, load.lastBusyMs, load.overrunCount, load.maxPollRateHz);
+            }
+            if (!stats.suspendedSlaves.empty()) {
+                ImGui::Separator();
+                for (const auto& slave : stats.suspendedSlaves) {
+                    ImGui::Text("从机 0x%02X: 连续 NAK %u 次, 退避 %u ms, %.0f ms 后探测, 已跳过 %llu 条 (第 %u 次挂起)",
+                        slave.address, slave.consecutiveNaks, slave.backoffMs, slave.nextProbeInMs,
+                        static_cast<unsigned long long>(slave.skippedCount), slave.suspendCount);
+                }
+            }
+            ImGui::Separator();
+            ImGui::Text("响应超时: 下发 %u 次, 复用 %llu 次 (默认 %u ms)", stats.timeoutSwitches,
+                static_cast<unsigned long long>(stats.timeoutReuses), DEFAULT_RESPONSE_TIMEOUT);
+            for (const auto& profile : stats.timeoutProfiles) {
+                ImGui::Text("从机 0x%02X %s: 超时 %u ms (P99 %.1f ms, %u 样本, 回退 %u 次)",
+                    profile.address, profile.isWrite ? "写" : "读", profile.timeoutMs,
+                    profile.percentileMs, profile.sampleCount, profile.fallbackCount);
+            }
+            ImGui::EndTooltip();
+        }
+    }
+
     void I2CTableWindow::RenderLogSettingsPopup()
     {
         if (m_showLogSettingsPopup) {
@@ -376,6 +640,7 @@ namespace I2CDebugger {
 
     void I2CTableWindow::RenderRegisterTableTab()
     {
+        ProfileZone zone("I2CTableWindow::RenderRegisterTableTab");
         auto& data = m_viewModel->GetData();
         auto& entries = m_viewModel->GetCurrentGroup1().registerEntries;
 
@@ -394,8 +659,10 @@ namespace I2CDebugger {
             ImGui::TableSetupColumn("属性", ImGuiTableColumnFlags_WidthFixed, 45);
             ImGui::TableHeadersRow();
 
+            if (m_registerCells.size() != entries.size()) m_registerCells.resize(entries.size());
             for (int i = 0; i < static_cast<int>(entries.size()); i++) {
                 auto& entry = entries[i];
+                CachedRow& cells = m_registerCells[i];
                 ImGui::TableNextRow();
                 ImGui::PushID(i);
 
@@ -425,21 +692,17 @@ namespace I2CDebugger {
                 }
 
                 ImGui::TableSetColumnIndex(3);
-                std::string dataStr = m_viewModel->FormatHexData(entry.data);
-                ImGui::TextUnformatted(dataStr.empty() ? "-" : dataStr.c_str());
+                if (!cells.value.Replay(CachedText::HashBytes(entry.data.data(), entry.data.size()))) {
+                    // 长度不定，用帧内存储区，不走堆分配
+                    const size_t dataSize = entry.data.size() * 3 + 1;
+                    char* dataStr = static_cast<char*>(ImGui::MemAllocFrame(dataSize));
+                    const size_t dataLen = m_viewModel->FormatHexData(entry.data, dataStr, dataSize);
+                    cells.value.Record(dataLen == 0 ? "-" : dataStr);
+                }
 
                 ImGui::TableSetColumnIndex(4);
-                if (entry.data.empty() && entry.lastErrorType == ErrorType::None) {
-                    ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "-");
-                }
-                else {
-                    ImVec4 color = GetStatusColor(entry.lastSuccess, entry.lastErrorType);
-                    const char* statusText = GetStatusText(entry.lastSuccess, entry.lastErrorType);
-                    ImGui::TextColored(color, "%s", statusText);
-                    if (!entry.lastSuccess && ImGui::IsItemHovered()) {
-                        ImGui::SetTooltip("%s", entry.lastError.c_str());
-                    }
-                }
+                RenderStatusCell(cells.status, !entry.data.empty() || entry.lastErrorType != ErrorType::None,
+                    entry.lastSuccess, entry.lastErrorType, entry.lastErrorDetail);
 
                 ImGui::TableSetColumnIndex(5);
                 char descBuf[128];
@@ -455,6 +718,7 @@ namespace I2CDebugger {
                     m_showPropertyPopup = true;
                     m_propertyEditIndex = i;
                     m_propertyTabType = 0;
+                    m_propertyIsWrite = false;
                     m_propertyOverride = entry.overrideSlaveAddr;
                     std::snprintf(m_propertySlaveAddr, sizeof(m_propertySlaveAddr),
                         "0x%02X", entry.slaveAddress);
@@ -509,6 +773,7 @@ namespace I2CDebugger {
 
     void I2CTableWindow::RenderSingleTriggerTab()
     {
+        ProfileZone zone("I2CTableWindow::RenderSingleTriggerTab");
         auto& data = m_viewModel->GetData();
         auto& entries = m_viewModel->GetCurrentGroup1().singleTriggerEntries;
 
@@ -577,8 +842,10 @@ namespace I2CDebugger {
             ImGui::TableSetColumnIndex(9);  ImGui::TableHeader("解析");
             ImGui::TableSetColumnIndex(10); ImGui::TableHeader("操作");
 
+            if (m_singleCells.size() != entries.size()) m_singleCells.resize(entries.size());
             for (int i = 0; i < static_cast<int>(entries.size()); i++) {
                 auto& entry = entries[i];
+                CachedRow& cells = m_singleCells[i];
                 ImGui::TableNextRow();
                 ImGui::PushID(i + 1000);
 
@@ -618,10 +885,8 @@ namespace I2CDebugger {
 
                 // 列4: 寄存器值(Raw) - 可编辑
                 ImGui::TableSetColumnIndex(4);
-                std::string dataStr = m_viewModel->FormatHexData(entry.data);
                 char dataBuf[256];
-                std::strncpy(dataBuf, dataStr.c_str(), sizeof(dataBuf) - 1);
-                dataBuf[sizeof(dataBuf) - 1] = '\0';
+                m_viewModel->FormatHexData(entry.data, dataBuf, sizeof(dataBuf));
                 ImGui::SetNextItemWidth(-FLT_MIN);
                 if (ImGui::InputText("##data", dataBuf, sizeof(dataBuf))) {
                     entry.data = m_viewModel->ParseHexDataInput(dataBuf);
@@ -654,7 +919,7 @@ namespace I2CDebugger {
                     else if (isReadType) {
                         // 读取命令：只显示解析值
                         if (entry.parseConfig.parseSuccess) {
-                            ImGui::Text("%.4g", entry.parseConfig.parsedValue);
+                            RenderParsedValueCell(cells.value, entry.parseConfig.parsedValue);
                         }
                         else if (!entry.data.empty()) {
                             ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "ERR");
@@ -676,17 +941,9 @@ namespace I2CDebugger {
 
                 // 列6: 状态
                 ImGui::TableSetColumnIndex(6);
-                if (entry.data.empty() && entry.lastErrorType == ErrorType::None) {
-                    ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "-");
-                }
-                else {
-                    ImVec4 color = GetStatusColor(entry.lastSuccess, entry.lastErrorType);
-                    const char* statusText = GetStatusText(entry.lastSuccess, entry.lastErrorType);
-                    ImGui::TextColored(color, "%s", statusText);
-                    if (!entry.lastSuccess && ImGui::IsItemHovered()) {
-                        ImGui::SetTooltip("%s", entry.lastError.c_str());
-                    }
-                }
+                RenderStatusCell(cells.status, !entry.data.empty() || entry.lastErrorType != ErrorType::None,
+                    entry.lastSuccess, entry.lastErrorType, entry.lastErrorDetail,
+                    &entry.verifyWritten, &entry.verifyReadback);
 
                 // 列7: 延时
                 ImGui::TableSetColumnIndex(7);
@@ -750,6 +1007,10 @@ namespace I2CDebugger {
                     m_propertyOverride = entry.overrideSlaveAddr;
                     std::snprintf(m_propertySlaveAddr, sizeof(m_propertySlaveAddr),
                         "0x%02X", entry.slaveAddress);
+                    m_propertyIsWrite = isWriteType;
+                    m_propertyVerifyWrite = entry.verifyWrite;
+                    std::snprintf(m_propertyWriteMask, sizeof(m_propertyWriteMask),
+                        "0x%08X", entry.writeMask);
                 }
 
                 ImGui::PopID();
@@ -798,6 +1059,26 @@ namespace I2CDebugger {
         if (ImGui::Button("下移##single", ImVec2(50, 0))) { m_viewModel->MoveSingleEntryDown(); }
     }
 
+    void I2CTableWindow::RenderFormulaStatus(const char* formula, bool isWrite)
+    {
+        FormulaCheckResult check = m_viewModel->CheckFormula(formula, isWrite);
+        switch (check.state) {
+        case FormulaCheckState::Empty:
+            break;
+        case FormulaCheckState::Pending:
+            ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "校验中...");
+            break;
+        case FormulaCheckState::Valid:
+            ImGui::TextColored(ImVec4(0.0f, 0.8f, 0.0f, 1.0f), check.bytecode ? "公式有效" : "公式有效 (ExprTK)");
+            break;
+        case FormulaCheckState::Invalid:
+            ImGui::PushTextWrapPos(ImGui::GetCursorPosX() + 300);
+            ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "公式错误: %s", check.errorMsg.c_str());
+            ImGui::PopTextWrapPos();
+            break;
+        }
+    }
+
     void I2CTableWindow::RenderRegisterParsePopup()
     {
         if (!m_showRegisterParsePopup) return;
@@ -829,6 +1110,7 @@ namespace I2CDebugger {
             ImGui::Text("解析公式 (Raw字节 → 十进制值):");
             ImGui::SetNextItemWidth(300);
             ImGui::InputText("##RegFormula", m_readFormulaInput, sizeof(m_readFormulaInput));
+            RenderFormulaStatus(m_readFormulaInput, false);
             ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
                 "示例: (b1 << 8) | b0, w0 * 0.1, b0 / 10.0");
 
@@ -916,6 +1198,7 @@ namespace I2CDebugger {
             ImGui::Text("读取公式 (Raw字节 → 十进制值):");
             ImGui::SetNextItemWidth(300);
             ImGui::InputText("##SingleReadFormula", m_readFormulaInput, sizeof(m_readFormulaInput));
+            RenderFormulaStatus(m_readFormulaInput, false);
             ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
                 "示例: (b1 << 8) | b0, w0 * 0.1");
 
@@ -926,6 +1209,7 @@ namespace I2CDebugger {
                 ImGui::Text("写入公式 (十进制值 → Raw字节):");
                 ImGui::SetNextItemWidth(300);
                 ImGui::InputText("##SingleWriteFormula", m_writeFormulaInput, sizeof(m_writeFormulaInput));
+                RenderFormulaStatus(m_writeFormulaInput, true);
                 ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
                     "示例: value, value * 10");
             }
@@ -984,6 +1268,7 @@ namespace I2CDebugger {
 
     void I2CTableWindow::RenderPeriodicTriggerTab()
     {
+        ProfileZone zone("I2CTableWindow::RenderPeriodicTriggerTab");
         auto& data = m_viewModel->GetData();
         auto& entries = m_viewModel->GetCurrentGroup1().periodicTriggerEntries;
 
@@ -1057,8 +1342,10 @@ namespace I2CDebugger {
             ImGui::TableSetColumnIndex(10); ImGui::TableHeader("曲线");
             ImGui::TableSetColumnIndex(11); ImGui::TableHeader("操作");
 
+            if (m_periodicCells.size() != entries.size()) m_periodicCells.resize(entries.size());
             for (int i = 0; i < static_cast<int>(entries.size()); i++) {
                 auto& entry = entries[i];
+                CachedRow& cells = m_periodicCells[i];
                 ImGui::TableNextRow();
                 ImGui::PushID(i + 2000);
 
@@ -1098,10 +1385,8 @@ namespace I2CDebugger {
 
                 // 列4: 寄存器值(Raw) - 可编辑
                 ImGui::TableSetColumnIndex(4);
-                std::string dataStr = m_viewModel->FormatHexData(entry.data);
                 char dataBuf[256];
-                std::strncpy(dataBuf, dataStr.c_str(), sizeof(dataBuf) - 1);
-                dataBuf[sizeof(dataBuf) - 1] = '\0';
+                m_viewModel->FormatHexData(entry.data, dataBuf, sizeof(dataBuf));
                 ImGui::SetNextItemWidth(-FLT_MIN);
                 if (ImGui::InputText("##data", dataBuf, sizeof(dataBuf))) {
                     entry.data = m_viewModel->ParseHexDataInput(dataBuf);
@@ -1136,7 +1421,7 @@ namespace I2CDebugger {
                     else if (isReadType) {
                         // 读取命令：只显示解析值
                         if (entry.parseConfig.parseSuccess) {
-                            ImGui::Text("%.4g", entry.parseConfig.parsedValue);
+                            RenderParsedValueCell(cells.value, entry.parseConfig.parsedValue);
                         }
                         else {
                             ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "ERR");
@@ -1155,17 +1440,9 @@ namespace I2CDebugger {
 
                 // 列6: 状态
                 ImGui::TableSetColumnIndex(6);
-                if (entry.data.empty() && entry.lastErrorType == ErrorType::None) {
-                    ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "-");
-                }
-                else {
-                    ImVec4 color = GetStatusColor(entry.lastSuccess, entry.lastErrorType);
-                    const char* statusText = GetStatusText(entry.lastSuccess, entry.lastErrorType);
-                    ImGui::TextColored(color, "%s", statusText);
-                    if (!entry.lastSuccess && ImGui::IsItemHovered()) {
-                        ImGui::SetTooltip("%s", entry.lastError.c_str());
-                    }
-                }
+                RenderStatusCell(cells.status, !entry.data.empty() || entry.lastErrorType != ErrorType::None,
+                    entry.lastSuccess, entry.lastErrorType, entry.lastErrorDetail,
+                    &entry.verifyWritten, &entry.verifyReadback);
 
                 // 列7: 错误计数（NAK次数）
                 ImGui::TableSetColumnIndex(7);
@@ -1264,6 +1541,10 @@ namespace I2CDebugger {
                     m_propertyOverride = entry.overrideSlaveAddr;
                     std::snprintf(m_propertySlaveAddr, sizeof(m_propertySlaveAddr),
                         "0x%02X", entry.slaveAddress);
+                    m_propertyIsWrite = isWriteType;
+                    m_propertyVerifyWrite = entry.verifyWrite;
+                    std::snprintf(m_propertyWriteMask, sizeof(m_propertyWriteMask),
+                        "0x%08X", entry.writeMask);
                 }
 
                 ImGui::PopID();
@@ -1282,8 +1563,8 @@ namespace I2CDebugger {
             ImGui::BeginDisabled();
         }
 
-        // 周期触发开始/停止按钮
-        if (data.isPeriodicRunning) {
+        // 周期触发开始/停止按钮（仅作用于当前组，其他组继续运行）
+        if (m_viewModel->IsCurrentGroupPeriodicRunning()) {
             if (ImGui::Button("停止周期触发")) {
                 m_viewModel->StopPeriodicExecution();
             }
@@ -1304,6 +1585,20 @@ namespace I2CDebugger {
             }
         }
 
+        int runningGroups = m_viewModel->GetRunningPeriodicGroupCount();
+        if (runningGroups > 0) {
+            ImGui::SameLine();
+            if (ImGui::Button("全部停止")) {
+                m_viewModel->StopAllPeriodicExecution();
+            }
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("%d 个命令组正在周期触发", runningGroups);
+            }
+
+            ImGui::SameLine();
+            RenderBusLoad();
+        }
+
         // 清零NAK计数按钮
         ImGui::SameLine();
         if (ImGui::Button("清零NAK计数")) {
@@ -1412,6 +1707,7 @@ namespace I2CDebugger {
             ImGui::Text("读取公式 (Raw字节 → 十进制值):");
             ImGui::SetNextItemWidth(-1);
             ImGui::InputText("##ReadFormula", m_readFormulaInput, sizeof(m_readFormulaInput));
+            RenderFormulaStatus(m_readFormulaInput, false);
             ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
                 "示例: (b1 << 8) | b0, w0 * 0.1, b0 / 10.0");
 
@@ -1421,6 +1717,7 @@ namespace I2CDebugger {
             ImGui::Text("写入公式 (十进制值 → Raw字节):");
             ImGui::SetNextItemWidth(-1);
             ImGui::InputText("##WriteFormula", m_writeFormulaInput, sizeof(m_writeFormulaInput));
+            RenderFormulaStatus(m_writeFormulaInput, true);
             ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
                 "示例: value, value * 10, value / 0.1");
 
@@ -1518,6 +1815,20 @@ namespace I2CDebugger {
                 ImGui::InputText("##propSlaveAddr", m_propertySlaveAddr, sizeof(m_propertySlaveAddr));
             }
 
+            if (m_propertyIsWrite) {
+                ImGui::Spacing();
+                ImGui::Separator();
+                ImGui::Spacing();
+                ImGui::Checkbox("写后回读校验", &m_propertyVerifyWrite);
+                ImGui::Text("位掩码:");
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(100);
+                ImGui::InputText("##propWriteMask", m_propertyWriteMask, sizeof(m_propertyWriteMask),
+                    ImGuiInputTextFlags_CharsHexadecimal);
+                ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
+                    "非 0 时读-改-写，只改掩码内的位；最低字节对应第 1 个数据字节");
+            }
+
             ImGui::Spacing();
             ImGui::Separator();
             ImGui::Spacing();
@@ -1530,12 +1841,22 @@ namespace I2CDebugger {
                     group.registerEntries[m_propertyEditIndex].slaveAddress = addr;
                 }
                 else if (m_propertyTabType == 1 && m_propertyEditIndex < static_cast<int>(group.singleTriggerEntries.size())) {
-                    group.singleTriggerEntries[m_propertyEditIndex].overrideSlaveAddr = m_propertyOverride;
-                    group.singleTriggerEntries[m_propertyEditIndex].slaveAddress = addr;
+                    auto& entry = group.singleTriggerEntries[m_propertyEditIndex];
+                    entry.overrideSlaveAddr = m_propertyOverride;
+                    entry.slaveAddress = addr;
+                    if (m_propertyIsWrite) {
+                        entry.verifyWrite = m_propertyVerifyWrite;
+                        entry.writeMask = static_cast<uint32_t>(std::strtoul(m_propertyWriteMask, nullptr, 16));
+                    }
                 }
                 else if (m_propertyTabType == 2 && m_propertyEditIndex < static_cast<int>(group.periodicTriggerEntries.size())) {
-                    group.periodicTriggerEntries[m_propertyEditIndex].overrideSlaveAddr = m_propertyOverride;
-                    group.periodicTriggerEntries[m_propertyEditIndex].slaveAddress = addr;
+                    auto& entry = group.periodicTriggerEntries[m_propertyEditIndex];
+                    entry.overrideSlaveAddr = m_propertyOverride;
+                    entry.slaveAddress = addr;
+                    if (m_propertyIsWrite) {
+                        entry.verifyWrite = m_propertyVerifyWrite;
+                        entry.writeMask = static_cast<uint32_t>(std::strtoul(m_propertyWriteMask, nullptr, 16));
+                    }
                 }
 
                 m_showPropertyPopup = false;
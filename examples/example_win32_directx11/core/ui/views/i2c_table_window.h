@@ -1,6 +1,8 @@
 ﻿#pragma once
 #include "../../viewmodels/i2c_table_viewmodel.h"
+#include "../widgets/cached_text.h"
 #include <memory>
+#include <vector>
 #include <chrono>  // 添加这个头文件
 
 namespace I2CDebugger {
@@ -26,6 +28,7 @@ namespace I2CDebugger {
         void RenderRenamePopup();
         void RenderExportPopup();
         void RenderImportPopup();
+        void RenderRegisterMapPopup();          // 厂商寄存器描述导入
         // 同步输入框缓冲区与数据模型
         void SyncInputBuffersFromModel();
         void RenderLogControls();  // 添加这一行声明
@@ -35,6 +38,8 @@ namespace I2CDebugger {
         void RenderRegisterParsePopup();        // 新增：寄存器表解析弹窗
         void RenderSingleParsePopup();          // 新增：单次触发解析弹窗
         void RenderLogSettingsPopup();          // 新增：日志设置弹窗
+        void RenderBusLoad();                   // 总线负载显示
+        void RenderFormulaStatus(const char* formula, bool isWrite);  // 公式校验结果
         void RenderDataLogSettingsPopup();
 
         std::shared_ptr<I2CTableViewModel> m_viewModel;
@@ -50,12 +55,16 @@ namespace I2CDebugger {
         bool m_showParsePopup = false;
         bool m_showExportPopup = false;
         bool m_showImportPopup = false;
+        bool m_showRegisterMapPopup = false;
 
         //弹窗编辑数据
         int m_propertyEditIndex = -1;
         int m_propertyTabType = 0;
         bool m_propertyOverride = false;
         char m_propertySlaveAddr[16] = "0x50";
+        bool m_propertyIsWrite = false;
+        bool m_propertyVerifyWrite = false;
+        char m_propertyWriteMask[16] = "0x00000000";
 
         int m_buttonNameEditIndex = -1;
         int m_buttonNameTabType = 0;
@@ -71,6 +80,13 @@ namespace I2CDebugger {
         char m_exportPathBuffer[512] = "";
         char m_importPathBuffer[512] = "";
 
+        // 寄存器映射导入
+        char m_registerMapPathBuffer[512] = "";
+        int m_registerMapFirstRow = 0;
+        int m_registerMapRowCount = -1;
+        int m_registerMapMaxEntries = 256;
+        bool m_registerMapIncludeFields = true;
+
         // 解析配置弹窗相关
         bool m_showParseConfigPopup = false;
         int m_parseConfigEntryIndex = -1;
@@ -97,6 +113,15 @@ namespace I2CDebugger {
         bool m_showDataLogSettingsPopup = false;
         char m_logFilePathBuffer[512] = "";
 
+        // 只读文本单元格的顶点缓存，按行索引
+        struct CachedRow {
+            CachedText value;       // 寄存器值 / 解析值
+            CachedText status;
+        };
+        std::vector<CachedRow> m_registerCells;
+        std::vector<CachedRow> m_singleCells;
+        std::vector<CachedRow> m_periodicCells;
+
         // 辅助函数
         std::string GenerateCSVHeaderPreview();
     };
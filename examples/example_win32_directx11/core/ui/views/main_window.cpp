@@ -1,6 +1,8 @@
 ﻿#include "main_window.h"
 #include "i2c_simple_window.h"
 #include "i2c_table_window.h"
+#include "diagnostics_window.h"
+#include "profiler_window.h"
 #include "imgui.h"
 
 namespace I2CDebugger {
@@ -10,6 +12,8 @@ namespace I2CDebugger {
     {
         m_simpleWindow = std::make_unique<I2CSimpleWindow>(simpleVM);
         m_tableWindow = std::make_unique<I2CTableWindow>(tableVM);
+        m_diagnosticsWindow = std::make_unique<DiagnosticsWindow>();
+        m_profilerWindow = std::make_unique<ProfilerWindow>();
     }
 
     MainWindow::~MainWindow() = default;
@@ -30,6 +34,9 @@ namespace I2CDebugger {
             if (ImGui::BeginMenu("窗口")) {
                 ImGui::MenuItem("简单命令操作窗口", nullptr, &m_showSimpleWindow);
                 ImGui::MenuItem("多命令表操作窗口", nullptr, &m_showTableWindow);
+                ImGui::Separator();
+                ImGui::MenuItem("性能诊断", nullptr, &m_showDiagnosticsWindow);
+                ImGui::MenuItem("性能剖析", nullptr, &m_showProfilerWindow);
                 ImGui::EndMenu();
             }
             if (ImGui::BeginMenu("帮助")) {
@@ -47,6 +54,14 @@ namespace I2CDebugger {
         if (m_showTableWindow) {
             m_tableWindow->Render(&m_showTableWindow);
         }
+
+        if (m_showDiagnosticsWindow) {
+            m_diagnosticsWindow->Render(&m_showDiagnosticsWindow);
+        }
+
+        if (m_showProfilerWindow) {
+            m_profilerWindow->Render(&m_showProfilerWindow);
+        }
     }
 
 }
@@ -8,6 +8,8 @@ namespace I2CDebugger {
     class I2CTableViewModel;
     class I2CSimpleWindow;
     class I2CTableWindow;
+    class DiagnosticsWindow;
+    class ProfilerWindow;
 
     class MainWindow {
     public:
@@ -23,9 +25,13 @@ namespace I2CDebugger {
     private:
         std::unique_ptr<I2CSimpleWindow> m_simpleWindow;
         std::unique_ptr<I2CTableWindow> m_tableWindow;
+        std::unique_ptr<DiagnosticsWindow> m_diagnosticsWindow;
+        std::unique_ptr<ProfilerWindow> m_profilerWindow;
 
         bool m_showSimpleWindow = true;
         bool m_showTableWindow = true;
+        bool m_showDiagnosticsWindow = false;
+        bool m_showProfilerWindow = false;
 
     };
 
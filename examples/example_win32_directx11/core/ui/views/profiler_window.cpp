@@ -0,0 +1,273 @@
+﻿#include "profiler_window.h"
+#include "imgui.h"
+#include <algorithm>
+#include <map>
+
+namespace I2CDebugger {
+
+    namespace {
+
+        constexpr float FRAME_GRAPH_HEIGHT = 60.0f;
+        constexpr double TARGET_FRAME_MS = 1000.0 / 60.0;
+
+        double ToMs(int64_t ns) {
+            return ns / 1000000.0;
+        }
+
+        // 同名区段颜色固定，便于跨帧对照
+        ImU32 ZoneColor(const char* name) {
+            unsigned int hash = 2166136261u;
+            for (const char* p = name; *p; p++) {
+                hash = (hash ^ static_cast<unsigned char>(*p)) * 16777619u;
+            }
+            return ImColor::HSV((hash % 360) / 360.0f, 0.45f, 0.75f);
+        }
+
+        struct ZoneTotal {
+            std::string thread;
+            int count = 0;
+            double totalMs = 0.0;
+            double maxMs = 0.0;
+        };
+
+    }
+
+    void ProfilerWindow::Render(bool* p_open)
+    {
+        ImGui::SetNextWindowSize(ImVec2(900, 600), ImGuiCond_FirstUseEver);
+
+        if (!ImGui::Begin("性能剖析", p_open)) {
+            ImGui::End();
+            return;
+        }
+
+        RenderToolbar();
+
+        if (!m_paused) {
+            m_frames = Profiler::GetFrames();
+            if (!m_frames.empty()) {
+                SelectFrame(static_cast<int>(m_frames.size()) - 1);
+                m_selectedFrame = -1;
+            }
+        }
+
+        if (m_frames.empty()) {
+            ImGui::TextDisabled("勾选\"记录\"后开始采集。界面线程每帧、硬件线程每条事务都会记录区段");
+            ImGui::End();
+            return;
+        }
+
+        RenderFrameGraph();
+        ImGui::Separator();
+        RenderTimeline();
+        ImGui::Separator();
+        RenderZoneSummary();
+
+        ImGui::End();
+    }
+
+    void ProfilerWindow::RenderToolbar()
+    {
+        bool enabled = Profiler::IsEnabled();
+        if (ImGui::Checkbox("记录", &enabled)) {
+            Profiler::SetEnabled(enabled);
+        }
+        ImGui::SameLine();
+        if (ImGui::Checkbox("暂停", &m_paused) && !m_paused) {
+            m_selectedFrame = -1;
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("清除")) {
+            Profiler::Clear();
+            m_frames.clear();
+            m_threads.clear();
+            m_selectedFrame = -1;
+        }
+
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(240);
+        ImGui::InputText("##ExportPath", m_exportPath, sizeof(m_exportPath));
+        ImGui::SameLine();
+        if (ImGui::Button("导出 Chrome trace")) {
+            std::string error;
+            m_exportSuccess = Profiler::ExportChromeTrace(m_exportPath, error);
+            m_exportStatus = m_exportSuccess ? std::string("已导出: ") + m_exportPath : error;
+        }
+        if (!m_exportStatus.empty()) {
+            ImGui::SameLine();
+            if (m_exportSuccess) ImGui::TextDisabled("%s", m_exportStatus.c_str());
+            else ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", m_exportStatus.c_str());
+        }
+    }
+
+    void ProfilerWindow::SelectFrame(int index)
+    {
+        m_selectedFrame = index;
+        m_viewFrame = m_frames[index];
+        m_threads = Profiler::Collect(m_viewFrame.begin, m_viewFrame.end);
+    }
+
+    // 帧耗时柱状图：点击某一帧后暂停并显示该帧
+    void ProfilerWindow::RenderFrameGraph()
+    {
+        const int count = static_cast<int>(m_frames.size());
+        double maxMs = TARGET_FRAME_MS * 2.0;
+        for (const auto& frame : m_frames) {
+            maxMs = std::max(maxMs, ToMs(frame.end - frame.begin));
+        }
+
+        const ImVec2 size(ImGui::GetContentRegionAvail().x, FRAME_GRAPH_HEIGHT);
+        const ImVec2 min = ImGui::GetCursorScreenPos();
+        const ImVec2 max(min.x + size.x, min.y + size.y);
+        ImGui::InvisibleButton("##FrameGraph", size);
+        const bool hovered = ImGui::IsItemHovered();
+
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        drawList->AddRectFilled(min, max, IM_COL32(30, 30, 36, 255));
+        const float targetY = max.y - static_cast<float>(TARGET_FRAME_MS / maxMs) * size.y;
+        drawList->AddLine(ImVec2(min.x, targetY), ImVec2(max.x, targetY), IM_COL32(90, 90, 100, 255));
+
+        const float barWidth = size.x / count;
+        const int shownFrame = m_selectedFrame >= 0 ? m_selectedFrame : count - 1;
+        int hoveredFrame = -1;
+        if (hovered) {
+            hoveredFrame = std::min(static_cast<int>((ImGui::GetIO().MousePos.x - min.x) / barWidth), count - 1);
+        }
+        for (int i = 0; i < count; i++) {
+            const double ms = ToMs(m_frames[i].end - m_frames[i].begin);
+            const float x0 = min.x + i * barWidth;
+            const float y0 = max.y - static_cast<float>(ms / maxMs) * size.y;
+            ImU32 color = ms > TARGET_FRAME_MS * 1.5 ? IM_COL32(230, 110, 70, 255) : IM_COL32(90, 170, 110, 255);
+            if (i == shownFrame) color = IM_COL32(255, 220, 80, 255);
+            else if (i == hoveredFrame) color = IM_COL32(200, 200, 200, 255);
+            drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x0 + std::max(barWidth - 1.0f, 1.0f), max.y), color);
+        }
+
+        if (hoveredFrame >= 0) {
+            ImGui::SetTooltip("%.2f ms", ToMs(m_frames[hoveredFrame].end - m_frames[hoveredFrame].begin));
+            if (ImGui::IsItemClicked()) {
+                m_paused = true;
+                SelectFrame(hoveredFrame);
+            }
+        }
+
+        ImGui::Text("帧耗时 %.2f ms（黄色为当前显示帧，横线为 60 FPS）", ToMs(m_viewFrame.end - m_viewFrame.begin));
+    }
+
+    // 各线程一条泳道，区段按嵌套深度分行，时间范围为选中帧
+    void ProfilerWindow::RenderTimeline()
+    {
+        const double spanNs = static_cast<double>(std::max<int64_t>(m_viewFrame.end - m_viewFrame.begin, 1));
+        const float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+        const float labelWidth = 90.0f;
+
+        ImGui::BeginChild("##Timeline", ImVec2(0, ImGui::GetContentRegionAvail().y * 0.6f), ImGuiChildFlags_Borders);
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        const ImVec2 mouse = ImGui::GetIO().MousePos;
+
+        for (const auto& thread : m_threads) {
+            uint32_t maxDepth = 0;
+            for (const auto& event : thread.events) maxDepth = std::max(maxDepth, event.depth);
+
+            const ImVec2 laneMin = ImGui::GetCursorScreenPos();
+            const float laneWidth = ImGui::GetContentRegionAvail().x;
+            const ImVec2 laneSize(laneWidth, rowHeight * (maxDepth + 1));
+            ImGui::PushID(static_cast<int>(thread.threadIndex));
+            ImGui::InvisibleButton("##Lane", ImVec2(laneSize.x, laneSize.y));
+            const bool laneHovered = ImGui::IsItemHovered();
+            ImGui::PopID();
+
+            drawList->AddText(ImVec2(laneMin.x, laneMin.y + 2.0f), ImGui::GetColorU32(ImGuiCol_Text), thread.name.c_str());
+            const float x0 = laneMin.x + labelWidth;
+            const float width = laneSize.x - labelWidth;
+            const ImVec2 clipMin(x0, laneMin.y);
+            const ImVec2 clipMax(laneMin.x + laneSize.x, laneMin.y + laneSize.y);
+            drawList->PushClipRect(clipMin, clipMax, true);
+            drawList->AddRectFilled(clipMin, clipMax, IM_COL32(30, 30, 36, 255));
+
+            const Profiler::Event* hoveredEvent = nullptr;
+            for (const auto& event : thread.events) {
+                float left = x0 + static_cast<float>((event.begin - m_viewFrame.begin) / spanNs) * width;
+                float right = x0 + static_cast<float>((event.end - m_viewFrame.begin) / spanNs) * width;
+                right = std::max(right, left + 1.0f);
+                const float top = laneMin.y + event.depth * rowHeight;
+                const ImVec2 rectMin(left, top);
+                const ImVec2 rectMax(right, top + rowHeight - 1.0f);
+                drawList->AddRectFilled(rectMin, rectMax, ZoneColor(event.name));
+
+                // 区段足够宽时在其内部显示名称
+                if (right - left > 30.0f) {
+                    const ImVec4 textClip(std::max(left, clipMin.x) + 2.0f, top, std::min(right, clipMax.x) - 2.0f, top + rowHeight);
+                    drawList->AddText(nullptr, 0.0f, ImVec2(textClip.x, top + 2.0f), IM_COL32(20, 20, 20, 255), event.name, nullptr, 0.0f, &textClip);
+                }
+                if (laneHovered && mouse.x >= left && mouse.x < right && mouse.y >= rectMin.y && mouse.y < rectMax.y) {
+                    hoveredEvent = &event;
+                }
+            }
+            drawList->PopClipRect();
+
+            if (hoveredEvent != nullptr) {
+                ImGui::SetTooltip("%s\n%.3f ms\n帧内 %.3f ms 处开始", hoveredEvent->name,
+                    ToMs(hoveredEvent->end - hoveredEvent->begin), ToMs(hoveredEvent->begin - m_viewFrame.begin));
+            }
+            ImGui::Spacing();
+        }
+
+        if (m_threads.empty()) {
+            ImGui::TextDisabled("该帧没有记录到区段");
+        }
+        ImGui::EndChild();
+    }
+
+    // 选中帧内按区段名汇总，按总耗时排序
+    void ProfilerWindow::RenderZoneSummary()
+    {
+        std::map<std::string, ZoneTotal> totals;
+        for (const auto& thread : m_threads) {
+            for (const auto& event : thread.events) {
+                // 与帧边界相交的部分才计入
+                const int64_t begin = std::max(event.begin, m_viewFrame.begin);
+                const int64_t end = std::min(event.end, m_viewFrame.end);
+                const double ms = ToMs(std::max<int64_t>(end - begin, 0));
+                ZoneTotal& total = totals[thread.name + "/" + event.name];
+                total.thread = thread.name;
+                total.count++;
+                total.totalMs += ms;
+                total.maxMs = std::max(total.maxMs, ms);
+            }
+        }
+
+        std::vector<std::pair<std::string, ZoneTotal>> sorted(totals.begin(), totals.end());
+        std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, ZoneTotal>& a, const std::pair<std::string, ZoneTotal>& b) {
+            return a.second.totalMs > b.second.totalMs;
+        });
+
+        ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit;
+        if (ImGui::BeginTable("ZoneSummary", 5, flags)) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("区段", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("线程");
+            ImGui::TableSetupColumn("次数");
+            ImGui::TableSetupColumn("总计 ms");
+            ImGui::TableSetupColumn("最长 ms");
+            ImGui::TableHeadersRow();
+
+            for (const auto& item : sorted) {
+                const ZoneTotal& total = item.second;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(item.first.c_str() + total.thread.size() + 1);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(total.thread.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%d", total.count);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", total.totalMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", total.maxMs);
+            }
+            ImGui::EndTable();
+        }
+    }
+
+}
@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include "../../services/profiler.h"
+#include <string>
+#include <vector>
+
+namespace I2CDebugger {
+
+    // 性能剖析窗口：帧耗时柱状图 + 选中帧各线程的区段时间线，可导出 Chrome trace
+    class ProfilerWindow {
+    public:
+        void Render(bool* p_open = nullptr);
+
+    private:
+        void RenderToolbar();
+        void RenderFrameGraph();
+        void RenderTimeline();
+        void RenderZoneSummary();
+        void SelectFrame(int index);
+
+        std::vector<Profiler::Frame> m_frames;
+        int m_selectedFrame = -1;               // m_frames 下标，-1 表示跟随最新帧
+        bool m_paused = false;
+        Profiler::Frame m_viewFrame;            // 当前显示的时间范围
+        std::vector<Profiler::ThreadEvents> m_threads;
+
+        char m_exportPath[512] = "profile_trace.json";
+        std::string m_exportStatus;
+        bool m_exportSuccess = false;
+    };
+
+}
@@ -0,0 +1,103 @@
+﻿// core/ui/widgets/cached_text.cpp - 缓存文本单元格
+#include "cached_text.h"
+#include "imgui_internal.h"
+
+namespace I2CDebugger {
+
+    namespace {
+
+        struct Counters {
+            int frame = -1;
+            CachedText::Stats current;
+            CachedText::Stats last;
+        };
+
+        Counters& GetCounters() {
+            static Counters s_counters;
+            return s_counters;
+        }
+
+        // 按帧号翻转计数，不需要额外的帧回调
+        CachedText::Stats& CurrentStats() {
+            Counters& counters = GetCounters();
+            const int frame = ImGui::GetFrameCount();
+            if (counters.frame != frame) {
+                counters.last = counters.current;
+                counters.current = CachedText::Stats();
+                counters.frame = frame;
+            }
+            return counters.current;
+        }
+
+        ImVec2 TextPos(const ImGuiWindow* window) {
+            return ImVec2(window->DC.CursorPos.x, window->DC.CursorPos.y + window->DC.CurrLineTextBaseOffset);
+        }
+
+    }
+
+    bool CachedText::Replay(ImGuiID contentKey) {
+        return Replay(contentKey, ImGui::GetStyleColorVec4(ImGuiCol_Text));
+    }
+
+    bool CachedText::Replay(ImGuiID contentKey, const ImVec4& color) {
+        ImGuiWindow* window = ImGui::GetCurrentWindow();
+        if (window->SkipItems) return true;
+
+        // 最终键覆盖所有影响输出的状态：内容、颜色（含全局透明度）、字体与字号
+        ImGuiContext& g = *GImGui;
+        const ImU32 col = ImGui::GetColorU32(color);
+        const float fontSize = g.FontSize;
+        ImGuiID key = contentKey;
+        key = ImHashData(&col, sizeof(col), key);
+        key = ImHashData(&g.FontBaked, sizeof(g.FontBaked), key);
+        key = ImHashData(&fontSize, sizeof(fontSize), key);
+        m_key = key;
+        m_color = color;
+
+        if (m_sizeKey != key) return false;
+
+        // 内容未变时尺寸已知：滚出可见区域的单元格直接占位，不再格式化
+        const ImVec2 pos = TextPos(window);
+        const ImRect bb(pos, ImVec2(pos.x + m_size.x, pos.y + m_size.y));
+        const bool visible = ImGui::IsRectVisible(bb.Min, bb.Max);
+        if (visible && !window->DrawList->SegmentCanReplay(&m_segment, key, pos)) return false;
+
+        ImGui::ItemSize(m_size, 0.0f);
+        if (!ImGui::ItemAdd(bb, 0) || !visible) return true;
+        window->DrawList->SegmentReplay(&m_segment, pos);
+        CurrentStats().replayed++;
+        return true;
+    }
+
+    void CachedText::Record(const char* text) {
+        ImGuiWindow* window = ImGui::GetCurrentWindow();
+        const ImVec2 pos = TextPos(window);
+        ImDrawList* drawList = window->DrawList;
+        drawList->SegmentBegin(&m_segment);
+        ImGui::PushStyleColor(ImGuiCol_Text, m_color);
+        ImGui::TextUnformatted(text);
+        ImGui::PopStyleColor();
+        // 跨越裁剪边界时顶点记录无效，下一帧继续走排版路径；尺寸总是可用
+        m_size = ImGui::GetItemRectSize();
+        m_sizeKey = m_key;
+        drawList->SegmentEnd(&m_segment, m_key, pos, m_size);
+        CurrentStats().recorded++;
+    }
+
+    ImGuiID CachedText::HashBytes(const void* data, size_t size, ImGuiID seed) {
+        return ImHashData(data, size, seed);
+    }
+
+    ImGuiID CachedText::HashString(const char* text, ImGuiID seed) {
+        return ImHashStr(text, 0, seed);
+    }
+
+    CachedText::Stats CachedText::GetStats() {
+        Counters& counters = GetCounters();
+        const int frame = ImGui::GetFrameCount();
+        if (counters.frame == frame) return counters.last;
+        if (counters.frame == frame - 1) return counters.current;
+        return Stats();
+    }
+
+}
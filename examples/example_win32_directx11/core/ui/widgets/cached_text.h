@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include "imgui.h"
+#include <cstddef>
+
+namespace I2CDebugger {
+
+    // ========== 缓存文本单元格 ==========
+    // 表格中只读的文本单元格（寄存器值、状态、解析值）大多数帧内容不变，却每帧重新排版生成顶点。
+    // 每个单元格保留一个 CachedText：内容键、颜色、字体与裁剪矩形都未变时直接复制上一次的顶点
+    // （滚动时整体平移），否则由调用方格式化文本后重新记录。
+    // 用法：
+    //     if (!cell.Replay(CachedText::HashBytes(data.data(), data.size()), color)) {
+    //         cell.Record(FormatText(data).c_str());
+    //     }
+    // 两种路径都会提交一个与 ImGui::TextUnformatted 相同的条目，之后可照常使用 IsItemHovered。
+    class CachedText {
+    public:
+        // 可重放（或单元格被整体裁剪、无需绘制）时返回 true
+        bool Replay(ImGuiID contentKey, const ImVec4& color);
+        bool Replay(ImGuiID contentKey);        // 使用当前文字颜色
+        // 紧接在返回 false 的 Replay 之后调用
+        void Record(const char* text);
+
+        void Invalidate() { m_segment.Invalidate(); m_sizeKey = 0; }
+
+        static ImGuiID HashBytes(const void* data, size_t size, ImGuiID seed = 0);
+        static ImGuiID HashString(const char* text, ImGuiID seed = 0);
+
+        struct Stats {
+            int replayed = 0;       // 上一帧直接复制顶点的单元格
+            int recorded = 0;       // 上一帧重新排版的单元格
+        };
+        static Stats GetStats();
+
+    private:
+        ImDrawListSegment m_segment;
+        ImVec2 m_size;              // 最近一次记录的条目尺寸
+        ImGuiID m_sizeKey = 0;      // m_size 对应的键
+        ImGuiID m_key = 0;          // 本帧 Replay 计算的键，供 Record 使用
+        ImVec4 m_color;
+    };
+
+}
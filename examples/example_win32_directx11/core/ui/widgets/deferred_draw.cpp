@@ -0,0 +1,303 @@
+﻿// core/ui/widgets/deferred_draw.cpp - 多线程延迟绘制
+#include "deferred_draw.h"
+#include "../../services/profiler.h"
+#include "imgui_internal.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace I2CDebugger {
+
+    namespace {
+
+        struct Job {
+            std::unique_ptr<ImDrawList> drawList;   // 跨帧复用，保留已分配的缓冲区
+            ImDrawList* owner = nullptr;            // 所属窗口的绘制列表
+            ImGuiWindow* root = nullptr;            // 所属窗口的根窗口（不穿过弹出窗口）
+            ImGuiViewportP* viewport = nullptr;
+            bool inserted = false;                  // 本帧已插入绘制数据
+            ImVec2 min, max;
+            DeferredDraw::BuildFn build;
+        };
+
+        struct Pool {
+            std::vector<std::thread> threads;
+            std::mutex mutex;
+            std::condition_variable startCv;
+            std::condition_variable doneCv;
+            uint64_t generation = 0;
+            int finishedWorkers = 0;
+            bool stop = false;
+
+            // 每个线程一份 ImDrawListSharedData：AddPolyline 等会写其中的 TempBuffer，不能共用。
+            // [0] 给主线程，[1..] 依次给工作线程
+            std::vector<std::unique_ptr<ImDrawListSharedData>> scratch;
+
+            std::vector<std::unique_ptr<Job>> jobs;
+            std::vector<ImDrawList*> rootLists;     // OnRenderPost 的临时表，跨帧复用
+            int jobCount = 0;                       // 本帧已提交
+            std::atomic<int> nextJob{ 0 };
+
+            ImGuiContext* context = nullptr;
+            ImGuiID hookIds[3] = {};
+            bool enabled = false;
+            DeferredDraw::Stats stats;
+            int inlineJobs = 0;                     // 未启用时同步执行的任务数与耗时
+            double inlineMs = 0.0;
+        };
+
+        Pool& GetPool() {
+            static Pool s_pool;
+            return s_pool;
+        }
+
+        // 同步上下文共享数据中的只读部分（纹理坐标、曲线细分精度等），保留各自的临时缓冲区
+        void SyncSharedData(ImDrawListSharedData& dst, const ImDrawListSharedData& src) {
+            dst.TexUvWhitePixel = src.TexUvWhitePixel;
+            dst.TexUvLines = src.TexUvLines;
+            dst.FontAtlas = src.FontAtlas;
+            dst.Font = src.Font;
+            dst.FontSize = src.FontSize;
+            dst.FontScale = src.FontScale;
+            dst.CurveTessellationTol = src.CurveTessellationTol;
+            dst.InitialFringeScale = src.InitialFringeScale;
+            dst.InitialFlags = src.InitialFlags;
+            dst.ClipRectFullscreen = src.ClipRectFullscreen;
+            dst.SetCircleTessellationMaxError(src.CircleSegmentMaxError);
+        }
+
+        void RunJobs(Pool& pool, int slot) {
+            ProfileZone zone("DeferredDraw::RunJobs");
+            ImDrawListSharedData* scratch = pool.scratch[slot].get();
+            for (int i = pool.nextJob.fetch_add(1); i < pool.jobCount; i = pool.nextJob.fetch_add(1)) {
+                Job& job = *pool.jobs[i];
+                ImDrawListSharedData* shared = job.drawList->_Data;
+                job.drawList->_Data = scratch;
+                job.build(job.drawList.get(), job.min, job.max);
+                job.drawList->_Data = shared;
+                job.build = nullptr;                // 尽早释放捕获的数据
+            }
+        }
+
+        void WorkerLoop(Pool& pool, int slot) {
+            Profiler::SetThreadName("绘制线程");
+            uint64_t seen = 0;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(pool.mutex);
+                    pool.startCv.wait(lock, [&]() { return pool.stop || pool.generation != seen; });
+                    if (pool.stop) return;
+                    seen = pool.generation;
+                }
+                RunJobs(pool, slot);
+                {
+                    std::lock_guard<std::mutex> lock(pool.mutex);
+                    pool.finishedWorkers++;
+                }
+                pool.doneCv.notify_one();
+            }
+        }
+
+        // NewFrame 开始：丢弃上一帧未经 Render 的任务
+        void OnNewFramePre(ImGuiContext*, ImGuiContextHook*) {
+            Pool& pool = GetPool();
+            for (int i = 0; i < pool.jobCount; i++) {
+                pool.jobs[i]->build = nullptr;
+            }
+            pool.jobCount = 0;
+            pool.inlineJobs = 0;
+            pool.inlineMs = 0.0;
+        }
+
+        // Render 开始（所有窗口已提交）：并行构建，主线程也参与
+        void OnRenderPre(ImGuiContext*, ImGuiContextHook*) {
+            Pool& pool = GetPool();
+            if (pool.jobCount == 0) {
+                pool.stats = DeferredDraw::Stats();
+                pool.stats.jobs = pool.inlineJobs;
+                pool.stats.threads = 1;
+                pool.stats.buildMs = pool.inlineMs;
+                return;
+            }
+
+            auto begin = std::chrono::steady_clock::now();
+            for (auto& scratch : pool.scratch) {
+                SyncSharedData(*scratch, *ImGui::GetDrawListSharedData());
+            }
+
+            // 当前上下文按线程保存（imgui_user_config.h），工作线程里 ImVector 扩容走 IM_ALLOC/IM_FREE
+            // 时看到的是空上下文，不会写分配统计（这部分分配不计入 Metrics）
+            pool.nextJob = 0;
+            {
+                std::lock_guard<std::mutex> lock(pool.mutex);
+                pool.finishedWorkers = 0;
+                pool.generation++;
+            }
+            pool.startCv.notify_all();
+            RunJobs(pool, 0);
+            {
+                std::unique_lock<std::mutex> lock(pool.mutex);
+                pool.doneCv.wait(lock, [&]() { return pool.finishedWorkers == static_cast<int>(pool.threads.size()); });
+            }
+
+            pool.stats.jobs = pool.jobCount;
+            pool.stats.threads = static_cast<int>(pool.threads.size()) + 1;
+            pool.stats.buildMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - begin).count();
+        }
+
+        // Render 结束：插到所属根窗口范围（根窗口、其子窗口、此前插入的同根延迟列表）的末尾。
+        // 子窗口紧跟根窗口绘制，弹出窗口和提示框是独立的根窗口，排在后面，所以仍盖在延迟内容之上。
+        // 顺序插入，同一根窗口的多个任务保持提交顺序
+        void OnRenderPost(ImGuiContext* ctx, ImGuiContextHook*) {
+            Pool& pool = GetPool();
+            int vertices = 0;
+            for (int i = 0; i < pool.jobCount; i++) {
+                Job& job = *pool.jobs[i];
+                job.inserted = false;
+                ImDrawData* drawData = &job.viewport->DrawDataP;
+                ImVector<ImDrawList*>& lists = drawData->CmdLists;
+                if (std::find(lists.begin(), lists.end(), job.owner) == lists.end()) continue;  // 所属窗口本帧未绘制
+
+                pool.rootLists.clear();
+                for (ImGuiWindow* window : ctx->Windows) {
+                    if (window->RootWindow == job.root) pool.rootLists.push_back(window->DrawList);
+                }
+                for (int j = 0; j < i; j++) {
+                    const Job& prev = *pool.jobs[j];
+                    if (prev.inserted && prev.root == job.root) pool.rootLists.push_back(prev.drawList.get());
+                }
+                int insertAt = 0;
+                for (int n = 0; n < lists.Size; n++) {
+                    if (std::find(pool.rootLists.begin(), pool.rootLists.end(), lists[n]) != pool.rootLists.end()) {
+                        insertAt = n + 1;
+                    }
+                }
+
+                job.drawList->_PopUnusedDrawCmd();
+                ImVector<ImDrawList*> added;
+                ImGui::AddDrawListToDrawDataEx(drawData, &added, job.drawList.get());
+                if (added.Size == 0) continue;
+                lists.insert(lists.begin() + insertAt, job.drawList.get());
+                job.inserted = true;
+                vertices += job.drawList->VtxBuffer.Size;
+                ctx->IO.MetricsRenderVertices += job.drawList->VtxBuffer.Size;
+                ctx->IO.MetricsRenderIndices += job.drawList->IdxBuffer.Size;
+            }
+            pool.stats.vertices = vertices;
+            pool.jobCount = 0;
+        }
+
+    }
+
+    void DeferredDraw::Install(int workerCount) {
+        Pool& pool = GetPool();
+        if (pool.context != nullptr) return;
+
+        if (workerCount <= 0) {
+            int cores = static_cast<int>(std::thread::hardware_concurrency());
+            workerCount = std::min(std::max(cores - 1, 1), 8);
+        }
+
+        pool.context = ImGui::GetCurrentContext();
+        const ImGuiContextHookType types[3] = {
+            ImGuiContextHookType_NewFramePre, ImGuiContextHookType_RenderPre, ImGuiContextHookType_RenderPost };
+        const ImGuiContextHookCallback callbacks[3] = { OnNewFramePre, OnRenderPre, OnRenderPost };
+        for (int i = 0; i < 3; i++) {
+            ImGuiContextHook hook;
+            hook.Type = types[i];
+            hook.Callback = callbacks[i];
+            pool.hookIds[i] = ImGui::AddContextHook(pool.context, &hook);
+        }
+
+        pool.stop = false;
+        for (int i = 0; i <= workerCount; i++) {
+            pool.scratch.emplace_back(new ImDrawListSharedData());
+        }
+        for (int i = 0; i < workerCount; i++) {
+            pool.threads.emplace_back(WorkerLoop, std::ref(pool), i + 1);
+        }
+    }
+
+    void DeferredDraw::Shutdown() {
+        Pool& pool = GetPool();
+        if (pool.context == nullptr) return;
+
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            pool.stop = true;
+        }
+        pool.startCv.notify_all();
+        for (auto& thread : pool.threads) {
+            thread.join();
+        }
+        pool.threads.clear();
+
+        for (ImGuiID id : pool.hookIds) {
+            ImGui::RemoveContextHook(pool.context, id);
+        }
+        // ImDrawList 析构时要从共享数据中注销，必须在销毁上下文之前释放
+        pool.jobs.clear();
+        pool.scratch.clear();
+        pool.jobCount = 0;
+        pool.context = nullptr;
+    }
+
+    void DeferredDraw::SetEnabled(bool enabled) {
+        GetPool().enabled = enabled;
+    }
+
+    bool DeferredDraw::IsEnabled() {
+        Pool& pool = GetPool();
+        return pool.enabled && pool.context != nullptr;
+    }
+
+    void DeferredDraw::Submit(const ImVec2& size, BuildFn build) {
+        ImGuiWindow* window = ImGui::GetCurrentWindow();
+        if (window->SkipItems) return;
+        const ImVec2 min = ImGui::GetCursorScreenPos();
+        const ImVec2 max(min.x + size.x, min.y + size.y);
+        ImGui::Dummy(size);
+        if (!ImGui::IsItemVisible()) return;
+
+        Pool& pool = GetPool();
+        if (!IsEnabled()) {
+            auto begin = std::chrono::steady_clock::now();
+            build(window->DrawList, min, max);
+            pool.inlineJobs++;
+            pool.inlineMs += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - begin).count();
+            return;
+        }
+
+        if (pool.jobCount == static_cast<int>(pool.jobs.size())) {
+            pool.jobs.emplace_back(new Job());
+            pool.jobs.back()->drawList.reset(new ImDrawList(ImGui::GetDrawListSharedData()));
+        }
+        Job& job = *pool.jobs[pool.jobCount++];
+
+        // 沿用所属窗口当前的裁剪矩形和纹理
+        const ImDrawCmdHeader& header = window->DrawList->_CmdHeader;
+        ImDrawList* drawList = job.drawList.get();
+        drawList->_ResetForNewFrame();
+        drawList->PushClipRect(ImVec2(header.ClipRect.x, header.ClipRect.y), ImVec2(header.ClipRect.z, header.ClipRect.w));
+        drawList->PushTexture(header.TexRef);
+
+        job.owner = window->DrawList;
+        job.root = window->RootWindow;
+        job.viewport = window->Viewport;
+        job.min = min;
+        job.max = max;
+        job.build = std::move(build);
+    }
+
+    const DeferredDraw::Stats& DeferredDraw::GetStats() {
+        return GetPool().stats;
+    }
+
+}
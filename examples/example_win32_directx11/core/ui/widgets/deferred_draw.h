@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include "imgui.h"
+#include <functional>
+
+namespace I2CDebugger {
+
+    // ========== 延迟绘制 ==========
+    // 自绘内容较重的控件（曲线、波形、逐行状态图形）可以把几何生成推迟到 ImGui::Render()：
+    // Submit 只在当前窗口占位并记录构建函数，Render 开始时由工作线程并行写入各自的 ImDrawList，
+    // 结束时插到所属根窗口（含其子窗口）最后一个绘制列表之后（AddDrawListToDrawDataEx），
+    // 盖在该窗口的内容之上，之后绘制的弹出窗口、提示框仍在其上层。
+    // 构建函数在工作线程执行：只能调用 ImDrawList 的几何接口（线、矩形、多段线），
+    // 不能调用 ImGui:: 函数，也不能绘制文字（字形按需烘焙会修改图集）；用到的数据需按值捕获。
+    // 未启用时 Submit 直接在当前窗口的绘制列表上同步执行，输出相同。
+    class DeferredDraw {
+    public:
+        using BuildFn = std::function<void(ImDrawList* drawList, const ImVec2& min, const ImVec2& max)>;
+
+        struct Stats {
+            int jobs = 0;               // 上一帧提交的绘制任务
+            int threads = 0;            // 参与构建的线程数（含主线程）
+            int vertices = 0;
+            double buildMs = 0.0;       // 上一帧几何构建耗时（并行模式为整个并行阶段的墙钟时间）
+        };
+
+        // 在 ImGui::CreateContext() 之后调用；workerCount 为 0 时按 CPU 核数决定
+        static void Install(int workerCount = 0);
+        // 在 ImGui::DestroyContext() 之前调用
+        static void Shutdown();
+
+        static void SetEnabled(bool enabled);
+        static bool IsEnabled();
+
+        // 在当前窗口占用 size 大小的区域并提交绘制，区域被裁剪掉时不执行
+        static void Submit(const ImVec2& size, BuildFn build);
+
+        static const Stats& GetStats();
+    };
+
+}
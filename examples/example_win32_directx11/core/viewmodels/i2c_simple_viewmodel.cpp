@@ -135,4 +135,20 @@ namespace I2CDebugger {
         return oss.str();
     }
 
+    size_t I2CSimpleViewModel::FormatHexData(const std::vector<uint8_t>& data, char* out, size_t outSize) const
+    {
+        static const char HEX_DIGITS[] = "0123456789ABCDEF";
+        if (outSize == 0) return 0;
+        size_t pos = 0;
+        for (size_t i = 0; i < data.size(); i++) {
+            const size_t needed = (i > 0) ? 3 : 2;
+            if (pos + needed >= outSize) break;
+            if (i > 0) out[pos++] = ' ';
+            out[pos++] = HEX_DIGITS[data[i] >> 4];
+            out[pos++] = HEX_DIGITS[data[i] & 0x0F];
+        }
+        out[pos] = '\0';
+        return pos;
+    }
+
 }
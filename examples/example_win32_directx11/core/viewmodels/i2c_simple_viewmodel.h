@@ -22,6 +22,8 @@ namespace I2CDebugger {
         uint8_t ParseHexInput(const char* input) const;
         std::vector<uint8_t> ParseHexDataInput(const char* input) const;
         std::string FormatHexData(const std::vector<uint8_t>& data) const;
+        // 写入调用方缓冲区（不分配堆内存），放不下的字节截断；返回写入的字符数
+        size_t FormatHexData(const std::vector<uint8_t>& data, char* out, size_t outSize) const;
 
     private:
         I2CSimpleAppData m_data;
@@ -2,6 +2,7 @@
 #include "i2c_table_viewmodel.h"
 #include "../services/data_logger.h"
 #include "../services/expression_parser.h"  // 新增：引入表达式解析器
+#include "../services/profiler.h"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
@@ -11,7 +12,6 @@ namespace I2CDebugger {
     I2CTableViewModel::I2CTableViewModel(std::shared_ptr<HardwareService> hardwareService)
         : m_hardwareService(hardwareService)
         , m_expressionParser(std::make_unique<ExpressionParser>())
-        , m_dataLogger(std::make_unique<DataLogger>())  // 新增
     {
         // 初始化默认命令组
         CommandGroup group1;
@@ -42,21 +42,45 @@ namespace I2CDebugger {
 
     I2CTableViewModel::~I2CTableViewModel() {
         // 确保停止日志记录
-        if (m_dataLogger && m_dataLogger->IsActive()) {
-            m_dataLogger->Stop();
+        for (auto& item : m_dataLoggers) {
+            if (item.second->IsActive()) {
+                item.second->Stop();
+            }
         }
     }
 
     // ============== 数据日志方法实现 ==============
 
+    DataLogger* I2CTableViewModel::FindLogger(uint32_t groupId) const {
+        auto it = m_dataLoggers.find(groupId);
+        return it != m_dataLoggers.end() ? it->second.get() : nullptr;
+    }
+
+    bool I2CTableViewModel::IsDataLoggingActive() const {
+        DataLogger* logger = FindLogger(GetCurrentGroup().id);
+        return logger && logger->IsActive();
+    }
+
+    uint32_t I2CTableViewModel::GetLoggedDataCount() const {
+        DataLogger* logger = FindLogger(GetCurrentGroup().id);
+        return logger ? logger->GetLoggedCount() : 0;
+    }
+
     bool I2CTableViewModel::StartDataLogging(const std::string& filePath) {
-        auto& entries = GetCurrentGroup1().periodicTriggerEntries;
-        m_logConfig.filePath = filePath;
-        return m_dataLogger->Start(filePath, entries, m_logConfig);
+        auto& group = GetCurrentGroup1();
+        auto& logger = m_dataLoggers[group.id];
+        if (!logger) {
+            logger = std::make_unique<DataLogger>();
+        }
+        group.logConfig.filePath = filePath;
+        return logger->Start(filePath, group.periodicTriggerEntries, group.logConfig);
     }
 
     void I2CTableViewModel::StopDataLogging() {
-        m_dataLogger->Stop();
+        DataLogger* logger = FindLogger(GetCurrentGroup().id);
+        if (logger) {
+            logger->Stop();
+        }
     }
 
     void I2CTableViewModel::Connect()
@@ -97,6 +121,7 @@ namespace I2CDebugger {
         CommandGroup newGroup;
         newGroup.name = "New Group " + std::to_string(m_data.commandGroups.size() + 1);
         m_data.commandGroups.push_back(newGroup);
+        m_handleIndexDirty = true;
         m_data.currentGroupIndex = static_cast<int>(m_data.commandGroups.size()) - 1;
     }
 
@@ -110,7 +135,17 @@ namespace I2CDebugger {
     void I2CTableViewModel::DeleteGroup()
     {
         if (m_data.commandGroups.size() > 1) {
+            // 删除前停止该组的周期执行和日志
+            auto& group = GetCurrentGroup1();
+            StopGroupPeriodic(group);
+            auto logger = m_dataLoggers.find(group.id);
+            if (logger != m_dataLoggers.end()) {
+                logger->second->Stop();
+                m_dataLoggers.erase(logger);
+            }
+
             m_data.commandGroups.erase(m_data.commandGroups.begin() + m_data.currentGroupIndex);
+            m_handleIndexDirty = true;
             if (m_data.currentGroupIndex >= static_cast<int>(m_data.commandGroups.size())) {
                 m_data.currentGroupIndex = static_cast<int>(m_data.commandGroups.size()) - 1;
             }
@@ -124,9 +159,24 @@ namespace I2CDebugger {
 
     // 导入命令表（作为新的命令组添加）
     bool I2CTableViewModel::ImportGroup(const std::string& filePath) {
+        m_handleIndexDirty = true;
         return m_configService->ImportCommandGroup(m_data, filePath, true);
     }
 
+    // 寄存器映射生成的命令组追加到末尾，并切换到第一个新组
+    int I2CTableViewModel::ImportRegisterMap(const RegisterMapImportOptions& options) {
+        if (!m_registerMap.IsOpen()) return 0;
+
+        size_t firstNew = m_data.commandGroups.size();
+        int created = m_registerMap.BuildCommandGroups(options, m_data.commandGroups);
+        if (created > 0) {
+            m_handleIndexDirty = true;
+            m_data.currentGroupIndex = static_cast<int>(firstNew);
+            m_data.selectedRowRegister = -1;
+        }
+        return created;
+    }
+
     //寄存器表操作
     void I2CTableViewModel::AddRegisterEntry()
     {
@@ -134,6 +184,7 @@ namespace I2CDebugger {
         entry.regAddress = 0x00;
         entry.length = 1;
         GetCurrentGroup1().registerEntries.push_back(entry);
+        m_handleIndexDirty = true;
     }
 
     void I2CTableViewModel::DeleteRegisterEntry()
@@ -146,6 +197,7 @@ namespace I2CDebugger {
             index = static_cast<int>(entries.size()) - 1;
         }
         entries.erase(entries.begin() + index);
+        m_handleIndexDirty = true;
 
         if (m_data.selectedRowRegister >= static_cast<int>(entries.size())) {
             m_data.selectedRowRegister = static_cast<int>(entries.size()) - 1;
@@ -163,7 +215,9 @@ namespace I2CDebugger {
         }
 
         RegisterEntry copy = entries[index];
+        copy.handle = NewEntryHandle();
         entries.insert(entries.begin() + index + 1, copy);
+        m_handleIndexDirty = true;
         m_data.selectedRowRegister = index + 1;
     }
 
@@ -173,6 +227,7 @@ namespace I2CDebugger {
         int index = m_data.selectedRowRegister;
         if (index > 0 && index < static_cast<int>(entries.size())) {
             std::swap(entries[index], entries[index - 1]);
+            m_handleIndexDirty = true;
             m_data.selectedRowRegister--;
         }
     }
@@ -183,6 +238,7 @@ namespace I2CDebugger {
         int index = m_data.selectedRowRegister;
         if (index >= 0 && index < static_cast<int>(entries.size()) - 1) {
             std::swap(entries[index], entries[index + 1]);
+            m_handleIndexDirty = true;
             m_data.selectedRowRegister++;
         }
     }
@@ -197,7 +253,7 @@ namespace I2CDebugger {
             return;
         }
         m_data.isReadingAllRegisters = true;
-        m_hardwareService->ReadAllRegisters(group.slaveAddress, group.registerEntries);
+        m_registerBatchId = m_hardwareService->ReadAllRegisters(group.slaveAddress, group.registerEntries);
     }
 
     // 单次触发操作
@@ -207,6 +263,7 @@ namespace I2CDebugger {
         entry.regAddress = 0x00;
         entry.length = 1;
         GetCurrentGroup1().singleTriggerEntries.push_back(entry);
+        m_handleIndexDirty = true;
     }
 
     void I2CTableViewModel::DeleteSingleEntry()
@@ -219,6 +276,7 @@ namespace I2CDebugger {
             index = static_cast<int>(entries.size()) - 1;
         }
         entries.erase(entries.begin() + index);
+        m_handleIndexDirty = true;
 
         if (m_data.selectedRowSingle >= static_cast<int>(entries.size())) {
             m_data.selectedRowSingle = static_cast<int>(entries.size()) - 1;
@@ -236,7 +294,9 @@ namespace I2CDebugger {
         }
 
         SingleTriggerEntry copy = entries[index];
+        copy.handle = NewEntryHandle();
         entries.insert(entries.begin() + index + 1, copy);
+        m_handleIndexDirty = true;
         m_data.selectedRowSingle = index + 1;
     }
 
@@ -246,6 +306,7 @@ namespace I2CDebugger {
         int index = m_data.selectedRowSingle;
         if (index > 0 && index < static_cast<int>(entries.size())) {
             std::swap(entries[index], entries[index - 1]);
+            m_handleIndexDirty = true;
             m_data.selectedRowSingle--;
         }
     }
@@ -256,6 +317,7 @@ namespace I2CDebugger {
         int index = m_data.selectedRowSingle;
         if (index >= 0 && index < static_cast<int>(entries.size()) - 1) {
             std::swap(entries[index], entries[index + 1]);
+            m_handleIndexDirty = true;
             m_data.selectedRowSingle++;
         }
     }
@@ -271,13 +333,19 @@ namespace I2CDebugger {
 
         switch (entry.type) {
         case CommandType::Read:
-            m_hardwareService->InsertSingleRead(slaveAddr, entry.regAddress, entry.length, 2, index);
+            m_hardwareService->InsertSingleRead(slaveAddr, entry.regAddress, entry.length, 2, index, entry.handle);
             break;
         case CommandType::Write:
-            m_hardwareService->InsertSingleWrite(slaveAddr, entry.regAddress, entry.data, 2, index);
+            if (entry.writeMask != 0 || entry.verifyWrite) {
+                m_hardwareService->InsertFusedWrite(slaveAddr, entry.regAddress, entry.data,
+                    entry.writeMask, entry.verifyWrite, 2, index, entry.handle);
+            }
+            else {
+                m_hardwareService->InsertSingleWrite(slaveAddr, entry.regAddress, entry.data, 2, index, entry.handle);
+            }
             break;
         case CommandType::SendCommand:
-            m_hardwareService->InsertSingleCommand(slaveAddr, entry.regAddress, 2, index);
+            m_hardwareService->InsertSingleCommand(slaveAddr, entry.regAddress, 2, index, entry.handle);
             break;
         }
     }
@@ -292,7 +360,7 @@ namespace I2CDebugger {
             return;
         }
         m_data.isExecuteAllSingleCommands = true;
-        m_hardwareService->ExecuteAllSingleTrigger(group.slaveAddress, group.singleTriggerEntries);
+        m_singleBatchId = m_hardwareService->ExecuteAllSingleTrigger(group.slaveAddress, group.singleTriggerEntries);
     }
 
     void I2CTableViewModel::SetAllSingleEntriesEnabled(bool enabled)
@@ -329,6 +397,7 @@ namespace I2CDebugger {
         entry.regAddress = 0x00;
         entry.length = 1;
         GetCurrentGroup1().periodicTriggerEntries.push_back(entry);
+        m_handleIndexDirty = true;
     }
 
     void I2CTableViewModel::DeletePeriodicEntry()
@@ -341,6 +410,7 @@ namespace I2CDebugger {
             index = static_cast<int>(entries.size()) - 1;
         }
         entries.erase(entries.begin() + index);
+        m_handleIndexDirty = true;
 
         if (m_data.selectedRowPeriodic >= static_cast<int>(entries.size())) {
             m_data.selectedRowPeriodic = static_cast<int>(entries.size()) - 1;
@@ -358,8 +428,10 @@ namespace I2CDebugger {
         }
 
         PeriodicTriggerEntry copy = entries[index];
+        copy.handle = NewEntryHandle();
         copy.errorCount = 0;
         entries.insert(entries.begin() + index + 1, copy);
+        m_handleIndexDirty = true;
         m_data.selectedRowPeriodic = index + 1;
     }
 
@@ -369,6 +441,7 @@ namespace I2CDebugger {
         int index = m_data.selectedRowPeriodic;
         if (index > 0 && index < static_cast<int>(entries.size())) {
             std::swap(entries[index], entries[index - 1]);
+            m_handleIndexDirty = true;
             m_data.selectedRowPeriodic--;
         }
     }
@@ -379,6 +452,7 @@ namespace I2CDebugger {
         int index = m_data.selectedRowPeriodic;
         if (index >= 0 && index < static_cast<int>(entries.size()) - 1) {
             std::swap(entries[index], entries[index + 1]);
+            m_handleIndexDirty = true;
             m_data.selectedRowPeriodic++;
         }
     }
@@ -394,13 +468,19 @@ namespace I2CDebugger {
 
         switch (entry.type) {
         case CommandType::Read:
-            m_hardwareService->InsertSingleRead(slaveAddr, entry.regAddress, entry.length, 3, index);
+            m_hardwareService->InsertSingleRead(slaveAddr, entry.regAddress, entry.length, 3, index, entry.handle);
             break;
         case CommandType::Write:
-            m_hardwareService->InsertSingleWrite(slaveAddr, entry.regAddress, entry.data, 3, index);
+            if (entry.writeMask != 0 || entry.verifyWrite) {
+                m_hardwareService->InsertFusedWrite(slaveAddr, entry.regAddress, entry.data,
+                    entry.writeMask, entry.verifyWrite, 3, index, entry.handle);
+            }
+            else {
+                m_hardwareService->InsertSingleWrite(slaveAddr, entry.regAddress, entry.data, 3, index, entry.handle);
+            }
             break;
         case CommandType::SendCommand:
-            m_hardwareService->InsertSingleCommand(slaveAddr, entry.regAddress, 3, index);
+            m_hardwareService->InsertSingleCommand(slaveAddr, entry.regAddress, 3, index, entry.handle);
             break;
         }
     }
@@ -409,14 +489,57 @@ namespace I2CDebugger {
     {
         if (!m_data.isConnected) return;
         auto& group = GetCurrentGroup1();
-        m_data.isPeriodicRunning = true;
-        m_hardwareService->StartPeriodicExecution(group.slaveAddress, group.periodicTriggerEntries, group.interval);
+        group.periodicRunning = true;
+        m_periodicBatchIds[group.id] = m_hardwareService->StartPeriodicExecution(
+            group.id, group.slaveAddress, group.periodicTriggerEntries, group.interval);
+        UpdatePeriodicRunningFlag();
     }
 
     void I2CTableViewModel::StopPeriodicExecution()
     {
+        StopGroupPeriodic(GetCurrentGroup1());
+    }
+
+    void I2CTableViewModel::StopAllPeriodicExecution()
+    {
+        m_hardwareService->StopAllPeriodicExecution();
+        for (auto& group : m_data.commandGroups) {
+            group.periodicRunning = false;
+        }
+        m_periodicBatchIds.clear();
+        UpdatePeriodicRunningFlag();
+    }
+
+    void I2CTableViewModel::StopGroupPeriodic(CommandGroup& group)
+    {
+        if (!group.periodicRunning) return;
+        group.periodicRunning = false;
+        m_periodicBatchIds.erase(group.id);
+        m_hardwareService->StopPeriodicExecution(group.id);
+        UpdatePeriodicRunningFlag();
+    }
+
+    void I2CTableViewModel::UpdatePeriodicRunningFlag()
+    {
+        m_data.isPeriodicRunning = !m_periodicBatchIds.empty();
+    }
+
+    int I2CTableViewModel::GetRunningPeriodicGroupCount() const
+    {
+        return static_cast<int>(m_periodicBatchIds.size());
+    }
+
+    void I2CTableViewModel::ResetRunState()
+    {
+        for (auto& group : m_data.commandGroups) {
+            group.periodicRunning = false;
+        }
+        m_periodicBatchIds.clear();
         m_data.isPeriodicRunning = false;
-        m_hardwareService->StopPeriodicExecution();
+        m_data.isReadingAllRegisters = false;
+        m_data.isExecuteAllSingleCommands = false;
+        m_registerBatchId = 0;
+        m_singleBatchId = 0;
     }
 
     void I2CTableViewModel::SetAllPeriodicEntriesEnabled(bool enabled)
@@ -455,26 +578,19 @@ namespace I2CDebugger {
     }
     // ============== 寄存器表解析方法 ==============
 
-    void I2CTableViewModel::UpdateRegisterParsedValue(size_t entryIndex) {
-        auto& group = GetCurrentGroup1();
-        if (entryIndex >= group.registerEntries.size()) return;
-
-        auto& entry = group.registerEntries[entryIndex];
-        auto& config = entry.parseConfig;
-
+    void I2CTableViewModel::EvaluateParsedValue(ParseConfig& config, const std::vector<uint8_t>& data) {
         if (!config.enabled || config.readFormula.empty()) {
             config.parseSuccess = false;
             return;
         }
 
-        if (entry.data.empty()) {
+        if (data.empty()) {
             config.parseSuccess = false;
             config.lastError = "数据为空";
             return;
         }
 
-        auto result = m_expressionParser->EvaluateReadFormula(
-            config.readFormula, entry.data);
+        auto result = m_expressionParser->EvaluateReadFormula(config.readFormula, data);
 
         config.parsedValue = result.value;
         config.parseSuccess = result.success;
@@ -483,6 +599,14 @@ namespace I2CDebugger {
         }
     }
 
+    void I2CTableViewModel::UpdateRegisterParsedValue(size_t entryIndex) {
+        auto& group = GetCurrentGroup1();
+        if (entryIndex >= group.registerEntries.size()) return;
+
+        auto& entry = group.registerEntries[entryIndex];
+        EvaluateParsedValue(entry.parseConfig, entry.data);
+    }
+
     ParseConfig& I2CTableViewModel::GetRegisterParseConfig(size_t entryIndex) {
         auto& group = GetCurrentGroup1();
         static ParseConfig emptyConfig;
@@ -507,27 +631,7 @@ namespace I2CDebugger {
         if (entryIndex >= group.singleTriggerEntries.size()) return;
 
         auto& entry = group.singleTriggerEntries[entryIndex];
-        auto& config = entry.parseConfig;
-
-        if (!config.enabled || config.readFormula.empty()) {
-            config.parseSuccess = false;
-            return;
-        }
-
-        if (entry.data.empty()) {
-            config.parseSuccess = false;
-            config.lastError = "数据为空";
-            return;
-        }
-
-        auto result = m_expressionParser->EvaluateReadFormula(
-            config.readFormula, entry.data);
-
-        config.parsedValue = result.value;
-        config.parseSuccess = result.success;
-        if (!result.success) {
-            config.lastError = result.errorMsg;
-        }
+        EvaluateParsedValue(entry.parseConfig, entry.data);
     }
 
     void I2CTableViewModel::UpdateSingleRawFromParsedValue(size_t entryIndex, double newValue) {
@@ -582,27 +686,7 @@ namespace I2CDebugger {
         if (entryIndex >= group.periodicTriggerEntries.size()) return;
 
         auto& entry = group.periodicTriggerEntries[entryIndex];
-        auto& config = entry.parseConfig;
-
-        if (!config.enabled || config.readFormula.empty()) {
-            config.parseSuccess = false;
-            return;
-        }
-
-        if (entry.data.empty()) {
-            config.parseSuccess = false;
-            config.lastError = "数据为空";
-            return;
-        }
-
-        auto result = m_expressionParser->EvaluateReadFormula(
-            config.readFormula, entry.data);
-
-        config.parsedValue = result.value;
-        config.parseSuccess = result.success;
-        if (!result.success) {
-            config.lastError = result.errorMsg;
-        }
+        EvaluateParsedValue(entry.parseConfig, entry.data);
     }
 
     void I2CTableViewModel::UpdateRawFromParsedValue(size_t entryIndex, double newValue) {
@@ -681,6 +765,22 @@ namespace I2CDebugger {
         return oss.str();
     }
 
+    size_t I2CTableViewModel::FormatHexData(const std::vector<uint8_t>& data, char* out, size_t outSize) const
+    {
+        static const char HEX_DIGITS[] = "0123456789ABCDEF";
+        if (outSize == 0) return 0;
+        size_t pos = 0;
+        for (size_t i = 0; i < data.size(); i++) {
+            const size_t needed = (i > 0) ? 3 : 2;
+            if (pos + needed >= outSize) break;
+            if (i > 0) out[pos++] = ' ';
+            out[pos++] = HEX_DIGITS[data[i] >> 4];
+            out[pos++] = HEX_DIGITS[data[i] & 0x0F];
+        }
+        out[pos] = '\0';
+        return pos;
+    }
+
     std::vector<uint8_t> I2CTableViewModel::ParseHexDataInput(const char* input) const
     {
         std::vector<uint8_t> result;
@@ -703,89 +803,198 @@ namespace I2CDebugger {
         return result;
     }
 
+    // ============== 句柄查找 ==============
+
+    bool I2CTableViewModel::IsSlotValid(EntryHandle handle, const EntrySlot& slot) const
+    {
+        if (slot.groupIndex < 0 || slot.groupIndex >= static_cast<int>(m_data.commandGroups.size())) {
+            return false;
+        }
+        const auto& group = m_data.commandGroups[slot.groupIndex];
+        switch (slot.table) {
+        case TabType::RegisterTable:
+            return slot.row < group.registerEntries.size() && group.registerEntries[slot.row].handle == handle;
+        case TabType::SingleTrigger:
+            return slot.row < group.singleTriggerEntries.size() && group.singleTriggerEntries[slot.row].handle == handle;
+        case TabType::PeriodicTrigger:
+            return slot.row < group.periodicTriggerEntries.size() && group.periodicTriggerEntries[slot.row].handle == handle;
+        }
+        return false;
+    }
+
+    void I2CTableViewModel::RebuildHandleIndex()
+    {
+        m_handleIndex.clear();
+        m_handleIndexDirty = false;
+        for (size_t g = 0; g < m_data.commandGroups.size(); g++) {
+            const auto& group = m_data.commandGroups[g];
+            EntrySlot slot;
+            slot.groupIndex = static_cast<int>(g);
+
+            slot.table = TabType::RegisterTable;
+            for (size_t i = 0; i < group.registerEntries.size(); i++) {
+                slot.row = i;
+                m_handleIndex[group.registerEntries[i].handle] = slot;
+            }
+            slot.table = TabType::SingleTrigger;
+            for (size_t i = 0; i < group.singleTriggerEntries.size(); i++) {
+                slot.row = i;
+                m_handleIndex[group.singleTriggerEntries[i].handle] = slot;
+            }
+            slot.table = TabType::PeriodicTrigger;
+            for (size_t i = 0; i < group.periodicTriggerEntries.size(); i++) {
+                slot.row = i;
+                m_handleIndex[group.periodicTriggerEntries[i].handle] = slot;
+            }
+        }
+    }
+
+    bool I2CTableViewModel::ResolveHandle(EntryHandle handle, EntrySlot& slot)
+    {
+        if (handle == INVALID_ENTRY_HANDLE) return false;
+
+        auto it = m_handleIndex.find(handle);
+        if (it != m_handleIndex.end() && IsSlotValid(handle, it->second)) {
+            slot = it->second;
+            return true;
+        }
+
+        // 只有结构性编辑（增删/移动条目、增删命令组、重新加载）之后才重建；
+        // 索引未失效时查不到说明条目已被删除，结果直接丢弃
+        if (!m_handleIndexDirty) return false;
+        RebuildHandleIndex();
+        it = m_handleIndex.find(handle);
+        if (it == m_handleIndex.end()) return false;
+        slot = it->second;
+        return true;
+    }
+
+    CommandGroup* I2CTableViewModel::FindGroupById(uint32_t groupId)
+    {
+        for (auto& group : m_data.commandGroups) {
+            if (group.id == groupId) return &group;
+        }
+        return nullptr;
+    }
+
+    // 回读校验失败时保留写入值与回读值供悬停提示；其他结果清空，避免显示上一次的字节
+    template <typename Entry>
+    static void RecordVerifyBytes(const ResponsePacket& packet, Entry& entry)
+    {
+        if (packet.errorType == ErrorType::VerifyMismatch) {
+            entry.verifyWritten = packet.writtenData;
+            entry.verifyReadback = packet.rawData;
+        }
+        else {
+            entry.verifyWritten.clear();
+            entry.verifyReadback.clear();
+        }
+    }
+
     void I2CTableViewModel::OnDataResult(const ResponsePacket& packet)
     {
         if (packet.controlId == 0) return;
+        ProfileZone zone("I2CTableViewModel::OnDataResult");
 
         m_data.activityIndicator.Trigger();
-        auto& group = GetCurrentGroup1();
 
-        switch (packet.controlId) {
-        case 1: {  // 寄存器表
-            if (packet.commandId < group.registerEntries.size()) {
-                auto& entry = group.registerEntries[packet.commandId];
-                entry.lastSuccess = packet.success;
-                entry.lastErrorType = packet.errorType;
-                if (packet.success) {
-                    entry.data = packet.rawData;
-                    entry.lastError.clear();
-
-                    // 新增：读取成功后自动更新解析值
-                    if (entry.parseConfig.enabled && !entry.parseConfig.readFormula.empty()) {
-                        UpdateRegisterParsedValue(packet.commandId);
-                    }
-                }
-                else {
-                    entry.lastError = packet.errorMsg;
+        // 按句柄路由到所属条目，与当前显示的命令组无关；条目已被删除则丢弃
+        EntrySlot slot;
+        if (!ResolveHandle(packet.entryHandle, slot)) return;
+        auto& group = m_data.commandGroups[slot.groupIndex];
+
+        switch (slot.table) {
+        case TabType::RegisterTable: {
+            auto& entry = group.registerEntries[slot.row];
+            entry.lastSuccess = packet.success;
+            entry.lastErrorType = packet.errorType;
+            if (packet.success) {
+                entry.data = packet.rawData;
+                entry.lastErrorDetail.clear();
+
+                // 读取成功后自动更新解析值
+                if (entry.parseConfig.enabled && !entry.parseConfig.readFormula.empty()) {
+                    EvaluateParsedValue(entry.parseConfig, entry.data);
                 }
             }
-            if (packet.commandId >= group.registerEntries.size() - 1 || !packet.success) {
-                m_data.isReadingAllRegisters = false;
+            else {
+                entry.lastErrorDetail = packet.errorDetail;
             }
             break;
         }
-        case 2: {  // 单次触发
-            if (packet.commandId < group.singleTriggerEntries.size()) {
-                auto& entry = group.singleTriggerEntries[packet.commandId];
-                entry.lastSuccess = packet.success;
-                entry.lastErrorType = packet.errorType;
-                if (packet.success && !packet.rawData.empty()) {
-                    entry.data = packet.rawData;
-                    entry.lastError.clear();
-
-                    // 新增：读取成功后自动更新解析值
-                    if (entry.parseConfig.enabled && !entry.parseConfig.readFormula.empty()) {
-                        UpdateSingleParsedValue(packet.commandId);
-                    }
-                }
-                else if (!packet.success) {
-                    entry.lastError = packet.errorMsg;
+        case TabType::SingleTrigger: {
+            auto& entry = group.singleTriggerEntries[slot.row];
+            entry.lastSuccess = packet.success;
+            entry.lastErrorType = packet.errorType;
+            if (packet.success && !packet.rawData.empty()) {
+                entry.data = packet.rawData;
+                entry.lastErrorDetail.clear();
+
+                // 读取成功后自动更新解析值
+                if (entry.parseConfig.enabled && !entry.parseConfig.readFormula.empty()) {
+                    EvaluateParsedValue(entry.parseConfig, entry.data);
                 }
             }
-            if (packet.commandId >= group.singleTriggerEntries.size() - 1 || !packet.success) {
-                m_data.isExecuteAllSingleCommands = false;
+            else if (!packet.success) {
+                entry.lastErrorDetail = packet.errorDetail;
             }
+            RecordVerifyBytes(packet, entry);
             break;
         }
-        case 3: {  // 周期触发
-            if (packet.commandId < group.periodicTriggerEntries.size()) {
-                auto& entry = group.periodicTriggerEntries[packet.commandId];
-                entry.lastSuccess = packet.success;
-                entry.lastErrorType = packet.errorType;
-                if (packet.success && !packet.rawData.empty()) {
-                    entry.data = packet.rawData;
-                    entry.lastError.clear();
-
-                    // 读取成功后自动更新解析值
-                    if (entry.parseConfig.enabled && !entry.parseConfig.readFormula.empty()) {
-                        UpdateParsedValue(packet.commandId);
-                    }
-
+        case TabType::PeriodicTrigger: {
+            auto& entry = group.periodicTriggerEntries[slot.row];
+            entry.lastSuccess = packet.success;
+            entry.lastErrorType = packet.errorType;
+            if (packet.success && !packet.rawData.empty()) {
+                entry.data = packet.rawData;
+                entry.lastErrorDetail.clear();
+
+                // 读取成功后自动更新解析值
+                if (entry.parseConfig.enabled && !entry.parseConfig.readFormula.empty()) {
+                    EvaluateParsedValue(entry.parseConfig, entry.data);
                 }
-                else if (!packet.success) {
-                    entry.lastError = packet.errorMsg;
-                    if (packet.errorType == ErrorType::SlaveNotResponse) {
-                        entry.errorCount++;
-                    }
+            }
+            else if (!packet.success) {
+                entry.lastErrorDetail = packet.errorDetail;
+                if (packet.errorType == ErrorType::SlaveNotResponse || packet.errorType == ErrorType::VerifyMismatch) {
+                    entry.errorCount++;
                 }
-
-                if (packet.commandId >= group.periodicTriggerEntries.size() - 1) {
-                    // 新增：记录日志
-                    if (m_dataLogger->IsActive()) {
-                        m_dataLogger->LogPeriodicRow(group.periodicTriggerEntries);
-                    }
+                else if (packet.errorType == ErrorType::SlaveSuspended) {
+                    // 从机挂起期间数据已过期，日志记为 NaN
+                    entry.parseConfig.parseSuccess = false;
                 }
             }
+            RecordVerifyBytes(packet, entry);
+            break;
+        }
+        }
+    }
+
+    void I2CTableViewModel::OnBatchComplete(const BatchCompletion& batch)
+    {
+        switch (batch.controlId) {
+        case 1:  // 寄存器表读取全部
+            if (batch.batchId == m_registerBatchId) {
+                m_data.isReadingAllRegisters = false;
+                m_registerBatchId = 0;
+            }
+            break;
+        case 2:  // 单次触发执行全部
+            if (batch.batchId == m_singleBatchId) {
+                m_data.isExecuteAllSingleCommands = false;
+                m_singleBatchId = 0;
+            }
+            break;
+        case 3: {  // 周期触发完成一轮
+            if (batch.aborted) break;
+            auto it = m_periodicBatchIds.find(batch.groupId);
+            if (it == m_periodicBatchIds.end() || it->second != batch.batchId) break;
+
+            CommandGroup* group = FindGroupById(batch.groupId);
+            DataLogger* logger = FindLogger(batch.groupId);
+            if (group && logger && logger->IsActive()) {
+                logger->LogPeriodicRow(group->periodicTriggerEntries);
+            }
             break;
         }
         default:
@@ -5,8 +5,10 @@
 #include "../services/configuration_service.h"
 #include "../services/expression_parser.h"  // 添加
 #include "../services/data_logger.h"
+#include "../services/register_map.h"
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace I2CDebugger {
 
@@ -29,6 +31,12 @@ namespace I2CDebugger {
         bool ExportGroup(const std::string& filePath);
         bool ImportGroup(const std::string& filePath);
 
+        // 从厂商寄存器描述（CSV/JSON）生成命令组：先建索引预览，再按范围生成
+        bool OpenRegisterMap(const std::string& filePath) { return m_registerMap.Open(filePath); }
+        void CloseRegisterMap() { m_registerMap.Close(); }
+        RegisterMap& GetRegisterMap() { return m_registerMap; }
+        int ImportRegisterMap(const RegisterMapImportOptions& options);
+
         void AddRegisterEntry();
         void DeleteRegisterEntry();
         void CopyRegisterEntry();
@@ -56,6 +64,13 @@ namespace I2CDebugger {
         void ExecutePeriodicCommand(int index);
         void StartPeriodicExecution();
         void StopPeriodicExecution();
+        void StopAllPeriodicExecution();
+        bool IsCurrentGroupPeriodicRunning() const { return GetCurrentGroup().periodicRunning; }
+        int GetRunningPeriodicGroupCount() const;
+        BusLoadStats GetBusLoadStats() const { return m_hardwareService->GetBusLoadStats(); }
+        PeriodicCapacity EstimateCurrentGroupCapacity() const {
+            return m_hardwareService->EstimatePeriodicCapacity(GetCurrentGroup().periodicTriggerEntries);
+        }
 
         void SetAllPeriodicEntriesEnabled(bool enabled);
         bool AreAllPeriodicEntriesEnabled() const;
@@ -67,12 +82,18 @@ namespace I2CDebugger {
         const CommandGroup& GetCurrentGroup() const;  // 添加 const 版本
 
         I2CTableAppData& GetData() { return m_data; }
+        // 通过 GetData() 整体替换命令组（如加载配置）后调用，下次查找句柄时重建索引
+        void InvalidateHandleIndex() { m_handleIndexDirty = true; }
         const I2CTableAppData& GetData() const { return m_data; }
 
         uint8_t ParseHexInput(const char* input) const;
         std::string FormatHexData(const std::vector<uint8_t>& data) const;
+        // 写入调用方缓冲区（不分配堆内存），放不下的字节截断；返回写入的字符数
+        size_t FormatHexData(const std::vector<uint8_t>& data, char* out, size_t outSize) const;
         std::vector<uint8_t> ParseHexDataInput(const char* input) const;
         void OnDataResult(const ResponsePacket& packet);
+        void OnBatchComplete(const BatchCompletion& batch);
+        void ResetRunState();  // 断开连接时清除所有进行中的状态
         // ============== 解析相关方法（扩展） ==============
 
         // 寄存器表解析
@@ -93,23 +114,56 @@ namespace I2CDebugger {
         void SetParseConfig(size_t entryIndex, const ParseConfig& config);
 
         std::string GetFormulaHelp() const;
+        FormulaCheckResult CheckFormula(const std::string& formula, bool isWrite) {
+            return m_expressionParser->CheckFormulaAsync(formula, isWrite);
+        }
 
         // ============== 数据日志相关方法 ==============
-        DataLogConfig& GetLogConfig() { return m_logConfig; }
-        bool IsDataLoggingActive() const { return m_dataLogger->IsActive(); }
-        uint32_t GetLoggedDataCount() const { return m_dataLogger->GetLoggedCount(); }
+        // 每个命令组独立记录，以下方法均作用于当前组
+        DataLogConfig& GetLogConfig() { return GetCurrentGroup1().logConfig; }
+        bool IsDataLoggingActive() const;
+        uint32_t GetLoggedDataCount() const;
 
         bool StartDataLogging(const std::string& filePath);
         void StopDataLogging();
 
 
     private:
+        // 句柄 → 条目位置（组下标 + 表类型 + 行号）
+        struct EntrySlot {
+            int groupIndex = -1;
+            TabType table = TabType::RegisterTable;
+            size_t row = 0;
+        };
+
+        // O(1) 查找；结构性编辑后标记失效，下次查找时整体重建一次
+        bool ResolveHandle(EntryHandle handle, EntrySlot& slot);
+        bool IsSlotValid(EntryHandle handle, const EntrySlot& slot) const;
+        void RebuildHandleIndex();
+        CommandGroup* FindGroupById(uint32_t groupId);
+
+        // 对任意组中的条目计算解析值（不依赖当前选中组）
+        void EvaluateParsedValue(ParseConfig& config, const std::vector<uint8_t>& data);
+
+        void StopGroupPeriodic(CommandGroup& group);
+        void UpdatePeriodicRunningFlag();
+        DataLogger* FindLogger(uint32_t groupId) const;
+
         I2CTableAppData m_data;
         std::shared_ptr<HardwareService> m_hardwareService;
         std::shared_ptr<ConfigurationService> m_configService;
         std::unique_ptr<ExpressionParser> m_expressionParser;  // 添加
-        std::unique_ptr<DataLogger> m_dataLogger;
-        DataLogConfig m_logConfig;
+        std::unordered_map<uint32_t, std::unique_ptr<DataLogger>> m_dataLoggers;  // 组ID → 日志
+
+        std::unordered_map<EntryHandle, EntrySlot> m_handleIndex;
+        bool m_handleIndexDirty = true;
+
+        RegisterMap m_registerMap;
+
+        // 进行中的批次
+        uint32_t m_registerBatchId = 0;
+        uint32_t m_singleBatchId = 0;
+        std::unordered_map<uint32_t, uint32_t> m_periodicBatchIds;  // 组ID → 周期批次
     };
 
 }
@@ -20,6 +20,7 @@ bool PMBus::Open(char ** deviceName) {
         return false;
     }
     isOpen_ = true;
+    responseTimeout_ = 0;
     return true;
 }
 
@@ -52,6 +53,25 @@ bool PMBus::Configure(uint32_t bitrate) {
         lastError_ = "SMBus_Configure failed: " + std::to_string(ret);
         return false;
     }
+    responseTimeout_ = DEFAULT_RESPONSE_TIMEOUT;
+    return true;
+}
+
+bool PMBus::SetResponseTimeout(uint32_t timeoutMs) {
+    if (!isOpen_) {
+        lastError_ = "Device not open";
+        return false;
+    }
+    if (timeoutMs == responseTimeout_) return true;
+
+    int ret = SMBus_SetResponseTimeout(device_, static_cast<DWORD>(timeoutMs));
+    if (ret != 0) {
+        lastError_ = "SMBus_SetResponseTimeout failed: " + std::to_string(ret);
+        responseTimeout_ = 0;
+        return false;
+    }
+    responseTimeout_ = timeoutMs;
+    timeoutSwitches_++;
     return true;
 }
 
@@ -140,7 +160,9 @@ INT PMBus::ScanDevices(uint8_t startAddr, uint8_t endAddr, std::vector<uint8_t>&
     std::vector<BYTE> addrGroup(128, 0); // 假设最多 128 个地址
     int ret = SMBus_Scan(device_, addrGroup.data(), startAddr, endAddr);
     if (ret < 0) {
+        // 扫描期间设备超时被临时改为 10 ms，出错时未必已恢复：缓存作废，下次 SetResponseTimeout 必定重新下发
         lastError_ = "SMBus_Scan failed: " + std::to_string(ret);
+        responseTimeout_ = 0;
         return ret;
     }
 
@@ -153,6 +175,6 @@ INT PMBus::ScanDevices(uint8_t startAddr, uint8_t endAddr, std::vector<uint8_t>&
     return ret;
 }
 
-std::string PMBus::GetLastError() const {
+const std::string& PMBus::GetLastError() const {
     return lastError_;
 }
@@ -36,6 +36,11 @@ public:
     // 配置通信参数（简化版，只允许修改 bitrate，其他用默认值）
     bool Configure(uint32_t bitrate = DEFAULT_BITRATE);
 
+    // 设置 HID 响应超时（毫秒）；与当前值相同时直接返回，不产生 HID 配置往返
+    bool SetResponseTimeout(uint32_t timeoutMs);
+    uint32_t GetResponseTimeout() const { return responseTimeout_; }
+    uint32_t GetTimeoutSwitchCount() const { return timeoutSwitches_; }
+
     // 写入数据（类似 I2C 写入寄存器值）
     INT Write(uint8_t slaveAddress, uint8_t regAddr, const std::vector<uint8_t>& data);
 
@@ -49,10 +54,12 @@ public:
     INT ScanDevices(uint8_t startAddr, uint8_t endAddr, std::vector<uint8_t>& foundAddresses);
 
     // 获取最后一次错误信息（可扩展）
-    std::string GetLastError() const;
+    const std::string& GetLastError() const;
 
 private:
     HID_SMBUS_DEVICE device_;  // SMBus C API 的设备句柄
     bool isOpen_{ false };
+    uint32_t responseTimeout_{ 0 };     // 已下发到设备的响应超时，0 表示未知
+    uint32_t timeoutSwitches_{ 0 };     // 实际下发的次数
     std::string lastError_;
 };
@@ -114,6 +114,30 @@ INT SMBus_Configure(HID_SMBUS_DEVICE device, DWORD bitRate, BYTE address, BOOL a
     return 0;
 }
 
+INT SMBus_SetResponseTimeout(HID_SMBUS_DEVICE device, DWORD responseTimeout)
+{
+    BOOL                opened;
+    HID_SMBUS_STATUS    status;
+
+    // Make sure that the device is opened
+    if(HidSmbus_IsOpened(device, &opened) == HID_SMBUS_SUCCESS && opened)
+    {
+        // Set response timeout
+        status = HidSmbus_SetTimeouts(device, responseTimeout);
+        // Check status
+        if(status != HID_SMBUS_SUCCESS)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
 INT SMBus_WriteRead(HID_SMBUS_DEVICE device, BYTE *buffer, BYTE slaveAddress, WORD numBytesToRead, BYTE targetAddressSize, BYTE *targetAddress)
 {
     BOOL                opened;
@@ -18,6 +18,7 @@ INT SMBus_Open(HID_SMBUS_DEVICE* device, char** string);
 INT SMBus_Close(HID_SMBUS_DEVICE device);
 INT SMBus_Reset(HID_SMBUS_DEVICE device);
 INT SMBus_Configure(HID_SMBUS_DEVICE device, DWORD bitRate, BYTE address, BOOL autoReadRespond, WORD writeTimeout, WORD readTimeout, BOOL sclLowTimeout, WORD transferRetries, DWORD responseTimeout);
+INT SMBus_SetResponseTimeout(HID_SMBUS_DEVICE device, DWORD responseTimeout);
 INT SMBus_WriteRead(HID_SMBUS_DEVICE device, BYTE *buffer, BYTE slaveAddress, WORD numBytesToRead, BYTE targetAddressSize, BYTE *targetAddress);
 INT SMBus_Read(HID_SMBUS_DEVICE device, BYTE *buffer, BYTE slaveAddress, WORD numBytesToRead);
 INT SMBus_Write(HID_SMBUS_DEVICE device, BYTE *buffer, BYTE slaveAddress, BYTE numBytesToWrite);
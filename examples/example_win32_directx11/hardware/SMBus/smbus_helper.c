@@ -40,7 +40,11 @@ INT SMBus_Scan(HID_SMBUS_DEVICE device, BYTE *slave_addr_group, BYTE slaveAddres
             totalNumBytesRead++;
         }
         else if (status == HID_SMBUS_DEVICE_IO_FAILED)
+        {
+            // Try to restore response timeout, the caller treats it as unknown anyway
+            HidSmbus_SetTimeouts(device, responseTimeout);
             return -2;
+        }
     }
 
     // Restore response timeout
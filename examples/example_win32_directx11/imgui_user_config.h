@@ -0,0 +1,17 @@
+﻿#pragma once
+
+// 本程序的 ImGui 编译配置，经工程的 IMGUI_USER_CONFIG 宏在 imconfig.h 之前包含（见 imgui.h 开头）。
+// 这样 imconfig.h 保持库自带的默认值，别的工程使用同一份 ImGui 源码时不受影响。
+
+// ID 哈希使用 SSE 4.2 CRC32 指令（运行时检测 CPU，不支持时退回查表，ID 不变）
+#define IMGUI_USE_SSE4_2_CRC
+
+// 当前上下文按线程保存（imgui.cpp 中 GImGui 一节的做法），定义在 main.cpp。
+// 只有主线程设置上下文；字形、延迟绘制等工作线程看到的是空指针，IM_ALLOC/IM_FREE 不会从这些线程写上下文里的分配统计
+struct ImGuiContext;
+extern thread_local ImGuiContext* GImGuiThreadContext;
+#define GImGui GImGuiThreadContext
+
+// ImGui 内部的 NewFrame/EndFrame/Render 与表格布局接入性能剖析，实现在 core/services/profiler.cpp
+struct ImProfileZone { const char* Name; long long Begin; ImProfileZone(const char* name); ~ImProfileZone(); };
+#define IM_PROFILE_SCOPE(_NAME)     ImProfileZone im_profile_zone(_NAME)
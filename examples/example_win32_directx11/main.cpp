@@ -15,11 +15,18 @@
 // [App] 引入我们的业务核心
 #include "core/app.h"
 #include "resource.h" // 确保包含了资源头文件
+#include "core/font/font_load.h"
+#include "core/font/font_cache.h"
+#include "core/font/font_bake.h"
+#include "core/font/font_upload.h"
+#include "core/services/profiler.h"
+#include "core/services/heap_stats.h"
+#include <chrono>
 
 #pragma comment(linker, "/subsystem:windows /entry:mainCRTStartup")
 
-// User created LoadFont funtion.
-void LoadFont(void);
+// 当前 ImGui 上下文按线程保存，见 imgui_user_config.h
+thread_local ImGuiContext* GImGuiThreadContext = nullptr;
 
 // Data
 static ID3D11Device*            g_pd3dDevice = nullptr;
@@ -39,6 +46,9 @@ LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 // Main code
 int main(int, char**)
 {
+    auto startup_begin = std::chrono::steady_clock::now();
+    bool first_frame_presented = false;
+
     // Make process DPI aware and obtain main monitor scale
     ImGui_ImplWin32_EnableDpiAwareness();
     float main_scale = ImGui_ImplWin32_GetDpiScaleForMonitor(::MonitorFromPoint(POINT{ 0, 0 }, MONITOR_DEFAULTTOPRIMARY));
@@ -100,10 +110,13 @@ int main(int, char**)
 
 
     LoadFont();
+    FontBakeStart(0);
+    FontUploadInstall();
     // ---------------------------------------------------------
     // [App] 1. 实例化并 Setup
     // ---------------------------------------------------------
     // 初始化应用程序
+    I2CDebugger::Profiler::SetThreadName("界面线程");
     I2CDebugger::App app;
     app.Initialize();
 
@@ -134,6 +147,9 @@ int main(int, char**)
     bool done = false;
     while (!done)
     {
+        I2CDebugger::Profiler::BeginFrame();
+        I2CDebugger::HeapStats::BeginFrame();
+
         // Poll and handle messages (inputs, window resize, etc.)
         // See the WndProc() function below for our to dispatch events to the Win32 backend.
         MSG msg;
@@ -169,6 +185,9 @@ int main(int, char**)
         ImGui_ImplWin32_NewFrame();
         ImGui::NewFrame();
 
+        // 分帧预热界面常用字形，每帧只烘焙少量，避免阻塞启动
+        PrewarmFontGlyphs(32);
+
         MyUi::DockspaceDemoBegin();
         // ---------------------------------------------------------
         // [App] 2. 这是唯一需要调用的业务入口
@@ -182,7 +201,10 @@ int main(int, char**)
         const float clear_color_with_alpha[4] = { clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w };
         g_pd3dDeviceContext->OMSetRenderTargets(1, &g_mainRenderTargetView, nullptr);
         g_pd3dDeviceContext->ClearRenderTargetView(g_mainRenderTargetView, clear_color_with_alpha);
-        ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+        {
+            I2CDebugger::ProfileZone zone("ImGui_ImplDX11_RenderDrawData");
+            ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+        }
 
         // Update and Render additional Platform Windows
         if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
@@ -192,9 +214,19 @@ int main(int, char**)
         }
 
         // Present
-        HRESULT hr = g_pSwapChain->Present(1, 0);   // Present with vsync
-        //HRESULT hr = g_pSwapChain->Present(0, 0); // Present without vsync
+        HRESULT hr;
+        {
+            I2CDebugger::ProfileZone zone("Present");
+            hr = g_pSwapChain->Present(1, 0);   // Present with vsync
+            //hr = g_pSwapChain->Present(0, 0); // Present without vsync
+        }
         g_SwapChainOccluded = (hr == DXGI_STATUS_OCCLUDED);
+
+        if (!first_frame_presented)
+        {
+            first_frame_presented = true;
+            SetFirstFrameTime(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startup_begin).count());
+        }
     }
 
 
@@ -204,7 +236,12 @@ int main(int, char**)
     // 清理
     app.Shutdown();
 
+    // 先停掉字形线程，再写回本次新光栅化的字形
+    FontBakeStop();
+    FontCacheSave();
+
     // Cleanup
+    FontUploadShutdown();
     ImGui_ImplDX11_Shutdown();
     ImGui_ImplWin32_Shutdown();
     ImGui::DestroyContext();
@@ -66,6 +66,19 @@
 //---- Use legacy CRC32-adler tables (used before 1.91.6), in order to preserve old .ini data that you cannot afford to invalidate.
 //#define IMGUI_USE_LEGACY_CRC32_ADLER
 
+//---- Select the hash used for IDs (ImHashData/ImHashStr), which runs for every PushID()/GetID() and widget label.
+// The default is CRC32c, table based unless compiling with SSE 4.2 or AVX enabled (e.g. /arch:AVX, -msse4.2), in which case CRC32 instructions are used.
+// - IMGUI_USE_SSE4_2_CRC: use CRC32 instructions even if the program is not compiled for SSE 4.2 (x86/x64 only, ignored elsewhere). Same IDs as the default.
+//   CPU support is checked once at runtime, CPUs without SSE 4.2 use the lookup table.
+// - IMGUI_USE_FAST_HASH: portable multiply/xorshift hash over 8-byte words. IDs differ from CRC32c: .ini data keyed by ID (e.g. table settings) saved with another hash is not found.
+//#define IMGUI_USE_SSE4_2_CRC
+//#define IMGUI_USE_FAST_HASH
+
+//---- Instrument NewFrame()/EndFrame()/Render() and table layout/borders with profiler zones. Expands to nothing by default.
+// The zone must last until the end of the enclosing scope. _NAME is a string literal.
+//struct MyProfileZone { MyProfileZone(const char* name); ~MyProfileZone(); };
+//#define IM_PROFILE_SCOPE(_NAME)     MyProfileZone my_profile_zone(_NAME)
+
 //---- Use 32-bit for ImWchar (default is 16-bit) to support Unicode planes 1-16. (e.g. point beyond 0xFFFF like emoticons, dingbats, symbols, shapes, ancient languages, etc...)
 //#define IMGUI_USE_WCHAR32
 
@@ -2394,7 +2394,7 @@ void ImFormatStringToTempBufferV(const char** out_buf, const char** out_buf_end,
     }
 }
 
-#ifndef IMGUI_ENABLE_SSE4_2_CRC
+#if (!defined(IMGUI_ENABLE_SSE4_2_CRC) || defined(IMGUI_SSE4_2_CRC_RUNTIME_CHECK)) && !defined(IMGUI_USE_FAST_HASH)
 // CRC32 needs a 1KB lookup table (not cache friendly)
 // Although the code to generate the table is simple and shorter than the table itself, using a const table allows us to easily:
 // - avoid an unnecessary branch/memory tap, - keep the ImHashXXX functions usable by static constructors, - make it thread-safe.
@@ -2440,42 +2440,166 @@ static const ImU32 GCrc32LookupTable[256] =
 };
 #endif
 
-// Known size hash
-// It is ok to call ImHashData on a string with known length but the ### operator won't be supported.
-// FIXME-OPT: Replace with e.g. FNV1a hash? CRC32 pretty much randomly access 1KB. Need to do proper measurements.
+#if defined(IMGUI_USE_FAST_HASH)
+
+// Word-wise multiply/xorshift hash, see IMGUI_USE_FAST_HASH in imconfig.h.
+// Output differs from the CRC32c variants below.
+static inline ImU64 ImHashFastStep(ImU64 h, ImU64 word)
+{
+    h = (h ^ word) * 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 31);
+}
+
 ImGuiID ImHashData(const void* data_p, size_t data_size, ImGuiID seed)
 {
-    ImU32 crc = ~seed;
     const unsigned char* data = (const unsigned char*)data_p;
-    const unsigned char *data_end = (const unsigned char*)data_p + data_size;
-#ifndef IMGUI_ENABLE_SSE4_2_CRC
+    ImU64 h = (ImU64)seed ^ ((ImU64)data_size * 0x9E3779B97F4A7C15ULL);
+    while (data_size >= 8)
+    {
+        ImU64 word;
+        memcpy(&word, data, 8);
+        h = ImHashFastStep(h, word);
+        data += 8;
+        data_size -= 8;
+    }
+    if (data_size >= 4)
+    {
+        ImU32 lo, hi; // Overlapping reads for 4..7 bytes
+        memcpy(&lo, data, 4);
+        memcpy(&hi, data + data_size - 4, 4);
+        h = ImHashFastStep(h, lo | ((ImU64)hi << 32));
+    }
+    else if (data_size > 0)
+    {
+        h = ImHashFastStep(h, data[0] | ((ImU64)data[data_size >> 1] << 8) | ((ImU64)data[data_size - 1] << 16));
+    }
+    h ^= h >> 32;
+    h *= 0xD6E8FEB86659FD93ULL;
+    h ^= h >> 32;
+    return (ImGuiID)h;
+}
+
+#else
+
+#if !defined(IMGUI_ENABLE_SSE4_2_CRC) || defined(IMGUI_SSE4_2_CRC_RUNTIME_CHECK)
+// CRC32c with the lookup table, one byte per step.
+// FIXME-OPT: CRC32 pretty much randomly access 1KB. See IMGUI_USE_SSE4_2_CRC and IMGUI_USE_FAST_HASH in imconfig.h.
+static ImU32 ImCrc32cTable(ImU32 crc, const unsigned char* data, const unsigned char* data_end)
+{
     const ImU32* crc32_lut = GCrc32LookupTable;
     while (data < data_end)
         crc = (crc >> 8) ^ crc32_lut[(crc & 0xFF) ^ *data++];
-    return ~crc;
-#else
+    return crc;
+}
+#endif
+
+#if defined(IMGUI_ENABLE_SSE4_2_CRC)
+
+// CRC32c with SSE 4.2 instructions, 8 bytes per step on 64-bit targets.
+// IMGUI_SSE4_2_CRC_TARGET allows using the instructions when the rest of the program isn't compiled for SSE 4.2 (see IMGUI_USE_SSE4_2_CRC in imconfig.h).
+static IMGUI_SSE4_2_CRC_TARGET ImU32 ImCrc32c(ImU32 crc, const unsigned char* data, const unsigned char* data_end)
+{
+#if defined(_M_X64) || defined(__x86_64__)
+    ImU64 crc64 = crc;
+    while (data + 8 <= data_end)
+    {
+        ImU64 word;
+        memcpy(&word, data, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+    }
+    crc = (ImU32)crc64;
+#endif
     while (data + 4 <= data_end)
     {
-        crc = _mm_crc32_u32(crc, *(ImU32*)data);
+        ImU32 word;
+        memcpy(&word, data, 4);
+        crc = _mm_crc32_u32(crc, word);
         data += 4;
     }
     while (data < data_end)
         crc = _mm_crc32_u8(crc, *data++);
-    return ~crc;
+    return crc;
+}
+
+#ifdef IMGUI_SSE4_2_CRC_RUNTIME_CHECK
+// The program is not compiled for SSE 4.2, so the CPU may lack the instructions (SSE 4.2 = CPUID.1:ECX bit 20).
+static bool ImCpuHasSse42()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2") != 0;
+#endif
+}
+#endif
+
+// Known size hash
+// It is ok to call ImHashData on a string with known length but the ### operator won't be supported.
+ImGuiID ImHashData(const void* data_p, size_t data_size, ImGuiID seed)
+{
+    const unsigned char* data = (const unsigned char*)data_p;
+#ifdef IMGUI_SSE4_2_CRC_RUNTIME_CHECK
+    static const bool has_sse42 = ImCpuHasSse42();
+    if (!has_sse42)
+        return ~ImCrc32cTable(~seed, data, data + data_size); // Same output
 #endif
+    return ~ImCrc32c(~seed, data, data + data_size);
+}
+
+#else
+
+// Known size hash
+// It is ok to call ImHashData on a string with known length but the ### operator won't be supported.
+ImGuiID ImHashData(const void* data_p, size_t data_size, ImGuiID seed)
+{
+    const unsigned char* data = (const unsigned char*)data_p;
+    return ~ImCrc32cTable(~seed, data, data + data_size);
 }
 
+#endif // IMGUI_ENABLE_SSE4_2_CRC
+
+#endif
+
 // Zero-terminated string hash, with support for ### to reset back to seed value.
 // e.g. "label###id" outputs the same hash as "id" (and "label" is generally displayed by the UI functions)
-// FIXME-OPT: Replace with e.g. FNV1a hash? CRC32 pretty much randomly access 1KB. Need to do proper measurements.
+#if defined(IMGUI_USE_FAST_HASH) || defined(IMGUI_ENABLE_SSE4_2_CRC)
+// Markers are matched left to right ("####x" hashes as "#x"), then what follows the last one is hashed in bulk by ImHashData().
+ImGuiID ImHashStr(const char* data_p, size_t data_size, ImGuiID seed)
+{
+    const char* data = data_p;
+    const char* p = data_p;
+    if (data_size != 0)
+    {
+        const char* data_end = data_p + data_size;
+        for (; p < data_end; p++)
+            if (*p == '#' && p + 2 < data_end && p[1] == '#' && p[2] == '#')
+            {
+                data = p + 3;
+                p += 2;
+            }
+    }
+    else
+    {
+        for (; *p; p++)
+            if (*p == '#' && p[1] == '#' && p[2] == '#')
+            {
+                data = p + 3;
+                p += 2;
+            }
+    }
+    return ImHashData(data, (size_t)(p - data), seed);
+}
+#else
+// Table lookups are slow enough that a single pass hashing byte by byte is faster than scanning first.
 ImGuiID ImHashStr(const char* data_p, size_t data_size, ImGuiID seed)
 {
     seed = ~seed;
     ImU32 crc = seed;
     const unsigned char* data = (const unsigned char*)data_p;
-#ifndef IMGUI_ENABLE_SSE4_2_CRC
     const ImU32* crc32_lut = GCrc32LookupTable;
-#endif
     if (data_size != 0)
     {
         while (data_size-- > 0)
@@ -2488,11 +2612,7 @@ ImGuiID ImHashStr(const char* data_p, size_t data_size, ImGuiID seed)
                 data_size -= 2;
                 continue;
             }
-#ifndef IMGUI_ENABLE_SSE4_2_CRC
             crc = (crc >> 8) ^ crc32_lut[(crc & 0xFF) ^ c];
-#else
-            crc = _mm_crc32_u8(crc, c);
-#endif
         }
     }
     else
@@ -2505,15 +2625,12 @@ ImGuiID ImHashStr(const char* data_p, size_t data_size, ImGuiID seed)
                 data += 2;
                 continue;
             }
-#ifndef IMGUI_ENABLE_SSE4_2_CRC
             crc = (crc >> 8) ^ crc32_lut[(crc & 0xFF) ^ c];
-#else
-            crc = _mm_crc32_u8(crc, c);
-#endif
         }
     }
     return ~crc;
 }
+#endif
 
 // Skip to the "###" marker if any. We don't skip past to match the behavior of GetID()
 // FIXME-OPT: This is not designed to be optimal. Use with care.
@@ -4526,6 +4643,7 @@ void ImGui::Shutdown()
         }
     }
     g.DrawListSharedData.TempBuffer.clear();
+    g.FrameArena.ClearFreeMemory();
 
     // Cleanup of other data are conditional on actually having initialized Dear ImGui.
     if (!g.Initialized)
@@ -4711,6 +4829,8 @@ void ImGui::GcCompactTransientMiscBuffers()
     g.InputTextLineIndex.clear();
     g.MultiSelectTempDataStacked = 0;
     g.MultiSelectTempData.clear_destruct();
+    if (g.FrameArena.AllocCount == 0)
+        g.FrameArena.ClearFreeMemory();
     TableGcCompactSettings();
     for (ImFontAtlas* atlas : g.FontAtlases)
         atlas->CompactCache();
@@ -5186,6 +5306,60 @@ void ImGui::MemFree(void* ptr)
     return (*GImAllocatorFreeFunc)(ptr, GImAllocatorUserData);
 }
 
+// For memory which doesn't outlive the frame, e.g. temporary arrays built while submitting items.
+// Blocks of the frame arena are reused by the following frames, so a repeating frame does no heap allocation.
+void* ImGui::MemAllocFrame(size_t size)
+{
+    ImGuiContext& g = *GImGui;
+    return g.FrameArena.Alloc(size);
+}
+
+void* ImGuiFrameArena::Alloc(size_t size)
+{
+    const int MIN_BLOCK_SIZE = 16 * 1024;
+    const int sz = (int)IM_MEMALIGN(size, 16);
+
+    // Skip to the next block when the current one is full. Blocks too small for a large request are left unused for
+    // the rest of the frame: the request gets a dedicated block at the end, which the next frames will reuse as well.
+    while (BlockCurrent == Blocks.Size || BlockUsed + sz > Blocks[BlockCurrent].Size)
+    {
+        if (BlockCurrent == Blocks.Size)
+        {
+            ImGuiFrameArenaBlock block;
+            block.Size = ImMax(sz, MIN_BLOCK_SIZE);
+            block.Data = (char*)IM_ALLOC((size_t)block.Size);
+            Blocks.push_back(block);
+            ReservedBytes += block.Size;
+            BlockUsed = 0;
+            break;
+        }
+        BlockCurrent++;
+        BlockUsed = 0;
+    }
+
+    void* ptr = Blocks[BlockCurrent].Data + BlockUsed;
+    BlockUsed += sz;
+    UsedBytes += sz;
+    AllocCount++;
+    HighWaterMark = ImMax(HighWaterMark, UsedBytes);
+    return ptr;
+}
+
+void ImGuiFrameArena::Reset()
+{
+    LastFrameUsedBytes = UsedBytes;
+    LastFrameAllocCount = AllocCount;
+    BlockCurrent = BlockUsed = UsedBytes = AllocCount = 0;
+}
+
+void ImGuiFrameArena::ClearFreeMemory()
+{
+    for (ImGuiFrameArenaBlock& block : Blocks)
+        IM_FREE(block.Data);
+    Blocks.clear();
+    BlockCurrent = BlockUsed = UsedBytes = AllocCount = ReservedBytes = 0;
+}
+
 // We record the number of allocation in recent frames, as a way to audit/sanitize our guiding principles of "no allocations on idle/repeating frames"
 void ImGui::DebugAllocHook(ImGuiDebugAllocInfo* info, int frame_count, void* ptr, size_t size)
 {
@@ -5203,6 +5377,8 @@ void ImGui::DebugAllocHook(ImGuiDebugAllocInfo* info, int frame_count, void* ptr
         //printf("[%05d] MemAlloc(%d) -> 0x%p\n", frame_count, (int)size, ptr);
         entry->AllocCount++;
         info->TotalAllocCount++;
+        info->FrameAllocCount++;
+        info->FrameAllocBytes += (int)size;
     }
     else
     {
@@ -5649,6 +5825,7 @@ void ImGui::NewFrame()
 {
     IM_ASSERT(GImGui != NULL && "No current context. Did you call ImGui::CreateContext() and ImGui::SetCurrentContext() ?");
     ImGuiContext& g = *GImGui;
+    IM_PROFILE_SCOPE("ImGui::NewFrame");
 
     // Remove pending delete hooks before frame start.
     // This deferred removal avoid issues of removal while iterating the hook vector
@@ -5656,6 +5833,9 @@ void ImGui::NewFrame()
         if (g.Hooks[n].Type == ImGuiContextHookType_PendingRemoval_)
             g.Hooks.erase(&g.Hooks[n]);
 
+    // Release memory obtained with MemAllocFrame() during the previous frame
+    g.FrameArena.Reset();
+
     CallContextHooks(&g, ImGuiContextHookType_NewFramePre);
 
     // Check and assert for various common IO and Configuration mistakes
@@ -5666,6 +5846,14 @@ void ImGui::NewFrame()
     // Load settings on first frame, save settings when modified (after a delay)
     UpdateSettings();
 
+    // Record number of allocations for the frame which just ended (including the ones done between Render() and NewFrame())
+    ImGuiDebugAllocInfo* alloc_info = &g.DebugAllocInfo;
+    alloc_info->LastFrameAllocCount = alloc_info->FrameAllocCount;
+    alloc_info->LastFrameAllocBytes = alloc_info->FrameAllocBytes;
+    alloc_info->FrameAllocHistory[alloc_info->FrameAllocHistoryIdx] = (float)alloc_info->FrameAllocCount;
+    alloc_info->FrameAllocHistoryIdx = (alloc_info->FrameAllocHistoryIdx + 1) % IM_COUNTOF(alloc_info->FrameAllocHistory);
+    alloc_info->FrameAllocCount = alloc_info->FrameAllocBytes = 0;
+
     g.Time += g.IO.DeltaTime;
     g.FrameCount += 1;
     g.TooltipOverrideCount = 0;
@@ -6191,6 +6379,7 @@ void ImGui::EndFrame()
 {
     ImGuiContext& g = *GImGui;
     IM_ASSERT(g.Initialized);
+    IM_PROFILE_SCOPE("ImGui::EndFrame");
 
     // Don't process EndFrame() multiple times.
     if (g.FrameCountEnded == g.FrameCount)
@@ -6305,6 +6494,7 @@ void ImGui::Render()
 {
     ImGuiContext& g = *GImGui;
     IM_ASSERT(g.Initialized);
+    IM_PROFILE_SCOPE("ImGui::Render");
 
     if (g.FrameCountEnded != g.FrameCount)
         EndFrame();
@@ -22614,6 +22804,11 @@ void ImGui::ShowMetricsWindow(bool* p_open)
         ImGuiDebugAllocInfo* info = &g.DebugAllocInfo;
         Text("%d current allocations", info->TotalAllocCount - info->TotalFreeCount);
         if (SmallButton("GC now")) { g.GcCompactAll = true; }
+        Text("Last frame: %d alloc, %d bytes", info->LastFrameAllocCount, info->LastFrameAllocBytes);
+        PlotHistogram("##AllocsPerFrame", info->FrameAllocHistory, IM_COUNTOF(info->FrameAllocHistory), info->FrameAllocHistoryIdx, "MemAlloc() calls per frame", 0.0f, FLT_MAX, ImVec2(-FLT_MIN, GetTextLineHeight() * 3.0f));
+        ImGuiFrameArena* arena = &g.FrameArena;
+        Text("Frame arena: %d bytes in %d alloc last frame, high-water mark %d bytes", arena->LastFrameUsedBytes, arena->LastFrameAllocCount, arena->HighWaterMark);
+        Text("Frame arena: %d bytes reserved in %d blocks", arena->ReservedBytes, arena->Blocks.Size);
         Text("Recent frames with allocations:");
         int buf_size = IM_COUNTOF(info->LastEntriesBuf);
         for (int n = buf_size - 1; n >= 0; n--)
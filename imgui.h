@@ -175,6 +175,7 @@ struct ImDrawCmd;                   // A single draw command within a parent ImD
 struct ImDrawData;                  // All draw command lists required to render the frame + pos/size coordinates to use for the projection matrix.
 struct ImDrawList;                  // A single draw command list (generally one per window, conceptually you may see this as a dynamic "mesh" builder)
 struct ImDrawListSharedData;        // Data shared among multiple draw lists (typically owned by parent ImGui context, but you may create one yourself)
+struct ImDrawListSegment;           // Retained vertices/indices of a region of a draw list, replayed on later frames while its content doesn't change.
 struct ImDrawListSplitter;          // Helper to split a draw list into different layers which can be drawn into out of order, then flattened back.
 struct ImDrawVert;                  // A single vertex (pos + uv + col = 20 bytes by default. Override layout with IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
 struct ImFont;                      // Runtime data for a single font within a parent ImFontAtlas
@@ -1180,6 +1181,7 @@ namespace ImGui
     IMGUI_API void          GetAllocatorFunctions(ImGuiMemAllocFunc* p_alloc_func, ImGuiMemFreeFunc* p_free_func, void** p_user_data);
     IMGUI_API void*         MemAlloc(size_t size);
     IMGUI_API void          MemFree(void* ptr);
+    IMGUI_API void*         MemAllocFrame(size_t size);             // Allocate from the current context's frame arena: valid until the next NewFrame(), never pass to MemFree().
 
     // (Optional) Platform/OS interface for multi-viewport support
     // Read comments around the ImGuiPlatformIO structure for more details.
@@ -3343,6 +3345,27 @@ struct ImDrawListSplitter
     IMGUI_API void              SetCurrentChannel(ImDrawList* draw_list, int channel_idx);
 };
 
+// Retained output of a region of an ImDrawList, see ImDrawList::SegmentBegin().
+// Keep one persistent instance per region (e.g. per table cell). Copyable.
+struct ImDrawListSegment
+{
+    ImVector<ImDrawVert>        VtxBuffer;      // Recorded vertices, positioned at Origin
+    ImVector<ImDrawIdx>         IdxBuffer;      // Recorded indices, relative to the first recorded vertex
+    ImGuiID                     Key;            // Content key passed to SegmentEnd()
+    ImVec2                      Origin;         // Region position when recorded
+    ImVec2                      Size;           // Region size, fully inside ClipRect when recorded
+    ImVec4                      ClipRect;
+    ImTextureRef                TexRef;
+    ImU64                       TexStamp;       // Font atlas texture UniqueID + discarded rectangles/reloaded glyphs count: glyph UVs and fallbacks are not reused while this is unchanged
+    bool                        Valid;
+    int                         _VtxStart, _IdxStart, _CmdCount, _Channel; // SegmentBegin() state
+    unsigned int                _VtxCurrentIdx;
+
+    ImDrawListSegment()         { memset(this, 0, sizeof(*this)); }
+    void                        Invalidate() { Valid = false; }
+    void                        ClearFreeMemory() { VtxBuffer.clear(); IdxBuffer.clear(); Valid = false; }
+};
+
 // Flags for ImDrawList functions
 // (Legacy: bit 0 must always correspond to ImDrawFlags_Closed to be backward compatible with old API using a bool. Bits 1..3 must be unused)
 enum ImDrawFlags_
@@ -3448,6 +3471,7 @@ struct ImDrawList
     // - Only simple polygons are supported by filling functions (no self-intersections, no holes).
     // - Concave polygon fill is more expensive than convex one: it has O(N^2) complexity. Provided as a convenience for the user but not used by the main library.
     IMGUI_API void  AddPolyline(const ImVec2* points, int num_points, ImU32 col, ImDrawFlags flags, float thickness);
+    IMGUI_API void  AddPolylineValues(const float* values, int values_count, const ImVec2& origin, const ImVec2& scale, ImU32 col, float thickness = 1.0f, int stride = sizeof(float)); // Evenly spaced samples: point i = (origin.x + i * scale.x, origin.y + values[i] * scale.y). For long plots.
     IMGUI_API void  AddConvexPolyFilled(const ImVec2* points, int num_points, ImU32 col);
     IMGUI_API void  AddConcavePolyFilled(const ImVec2* points, int num_points, ImU32 col);
 
@@ -3500,6 +3524,16 @@ struct ImDrawList
     inline void     ChannelsMerge()             { _Splitter.Merge(this); }
     inline void     ChannelsSetCurrent(int n)   { _Splitter.SetCurrentChannel(this, n); }
 
+    // Advanced: Retained segments
+    // - Record what is emitted between SegmentBegin() and SegmentEnd(), then on later frames replay it (copy + translation) instead of rebuilding it.
+    // - 'key' must cover everything that affects the output: text, colors, font, sizes. The draw list only checks clip rect, texture and font atlas state.
+    // - Recording is dropped if the output changed draw command/channel or if the region [origin, origin+size] isn't fully inside the clip rect.
+    // - Replay requires the same key, clip rect and texture, an integral offset (text is pixel-snapped) and the region to stay inside the clip rect.
+    IMGUI_API void  SegmentBegin(ImDrawListSegment* segment);
+    IMGUI_API bool  SegmentEnd(ImDrawListSegment* segment, ImGuiID key, const ImVec2& origin, const ImVec2& size);
+    IMGUI_API bool  SegmentCanReplay(const ImDrawListSegment* segment, ImGuiID key, const ImVec2& origin) const;
+    IMGUI_API void  SegmentReplay(const ImDrawListSegment* segment, const ImVec2& origin);
+
     // Advanced: Primitives allocations
     // - We render triangles (three vertices)
     // - All primitives needs to be reserved via PrimReserve() beforehand.
@@ -3932,6 +3966,10 @@ struct ImFontBaked
     ImVector<ImFontGlyph>       Glyphs;             // 12-16 // out // All glyphs.
     int                         FallbackGlyphIndex; // 4     // out // Index of FontFallbackChar
 
+    // [Internal] Members: Dense printable ASCII table (for RenderText/CalcTextSize fast path)
+    ImU16                       AsciiGlyphIndex[96];// 192   // out // Glyphs index for codepoints 0x20..0x7E, missing glyphs point to FallbackGlyphIndex. Valid when AsciiTableState == 1.
+    ImS8                        AsciiTableState;    // 1     // out // 0: not built yet, 1: ready, -1: unavailable (e.g. locked atlas). Reset when an ASCII glyph is discarded.
+
     // [Internal] Members: Cold
     float                       Ascent, Descent;    // 4+4   // out // Ascent: distance from top to bottom of e.g. 'A' [0..FontSize] (unscaled)
     unsigned int                MetricsTotalSurface:26;// 3  // out // Total surface in pixels to get an idea of the font rasterization/texture cost (not exact, we approximate the cost of padding between glyphs)
@@ -3960,6 +3998,7 @@ enum ImFontFlags_
     ImFontFlags_NoLoadError             = 1 << 1,   // Disable throwing an error/assert when calling AddFontXXX() with missing file/data. Calling code is expected to check AddFontXXX() return value.
     ImFontFlags_NoLoadGlyphs            = 1 << 2,   // [Internal] Disable loading new glyphs.
     ImFontFlags_LockBakedSizes          = 1 << 3,   // [Internal] Disable loading new baked sizes, disable garbage collecting current ones. e.g. if you want to lock a font to a single size. Important: if you use this to preload given sizes, consider the possibility of multiple font density used on Retina display.
+    ImFontFlags_NoAsciiFastPath         = 1 << 4,   // [Internal] Disable the printable ASCII fast path in RenderText()/CalcTextSize(). Output is identical, this is only useful to measure or debug it.
 };
 
 // Font runtime data and rendering
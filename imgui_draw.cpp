@@ -10,6 +10,7 @@ Index of this file:
 // [SECTION] ImDrawList
 // [SECTION] ImTriangulator, ImDrawList concave polygon fill
 // [SECTION] ImDrawListSplitter
+// [SECTION] ImDrawListSegment
 // [SECTION] ImDrawData
 // [SECTION] Helpers ShadeVertsXXX functions
 // [SECTION] ImFontConfig
@@ -138,8 +139,22 @@ namespace IMGUI_STB_NAMESPACE
 #ifdef  IMGUI_ENABLE_STB_TRUETYPE
 #ifndef STB_TRUETYPE_IMPLEMENTATION                         // in case the user already have an implementation in the _same_ compilation unit (e.g. unity builds)
 #ifndef IMGUI_DISABLE_STB_TRUETYPE_IMPLEMENTATION           // in case the user already have an implementation in another compilation unit
-#define STBTT_malloc(x,u)   ((void)(u), IM_ALLOC(x))
-#define STBTT_free(x,u)     ((void)(u), IM_FREE(x))
+// Rasterization may run on worker threads (see ImFontLoader::FontSrcRasterizeGlyph): call the allocator functions directly,
+// MemAlloc()/MemFree() would record the allocations into the current context from those threads.
+static void* ImStbTrueTypeMalloc(size_t size)
+{
+    ImGuiMemAllocFunc alloc_func; ImGuiMemFreeFunc free_func; void* user_data;
+    ImGui::GetAllocatorFunctions(&alloc_func, &free_func, &user_data);
+    return alloc_func(size, user_data);
+}
+static void ImStbTrueTypeFree(void* ptr)
+{
+    ImGuiMemAllocFunc alloc_func; ImGuiMemFreeFunc free_func; void* user_data;
+    ImGui::GetAllocatorFunctions(&alloc_func, &free_func, &user_data);
+    free_func(ptr, user_data);
+}
+#define STBTT_malloc(x,u)   ((void)(u), ImStbTrueTypeMalloc(x))
+#define STBTT_free(x,u)     ((void)(u), ImStbTrueTypeFree(x))
 #define STBTT_assert(x)     do { IM_ASSERT(x); } while(0)
 #define STBTT_fmod(x,y)     ImFmod(x,y)
 #define STBTT_sqrt(x)       ImSqrt(x)
@@ -1066,6 +1081,172 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
     }
 }
 
+static inline float ImPolylineValue(const float* values, int stride, int n)
+{
+    return *(const float*)(const void*)((const unsigned char*)values + (size_t)n * stride);
+}
+
+// Polyline through evenly spaced samples: point i is (origin.x + i * scale.x, origin.y + values[i] * scale.y).
+// - Meant for long plots (100k+ points): no ImVec2 array is built, points outside the clip rect horizontally are skipped,
+//   and with baked line textures (integer thickness) each point only costs 2 vertices and 6 indices, same as AddPolyline().
+// - Geometry is emitted in chunks small enough for 16-bit indices (ImDrawListFlags_AllowVtxOffset takes care of
+//   restarting the vertex offset between chunks). Chunks share their boundary point so joins are seamless.
+// - Falls back to PathLineTo() + PathStroke() when the texture path can't be used (e.g. fractional thickness, no AA).
+void ImDrawList::AddPolylineValues(const float* values, int values_count, const ImVec2& origin, const ImVec2& scale, ImU32 col, float thickness, int stride)
+{
+    if (values_count < 2 || (col & IM_COL32_A_MASK) == 0)
+        return;
+
+    // Skip points left/right of the clip rectangle, keeping one point beyond each side so the visible segments are complete.
+    int first = 0;
+    int last = values_count - 1;
+    if (scale.x > 0.0f)
+    {
+        const float pad = thickness * 0.5f + 1.0f;
+        const float i_min = ImFloor((_CmdHeader.ClipRect.x - pad - origin.x) / scale.x);
+        const float i_max = ImCeil((_CmdHeader.ClipRect.z + pad - origin.x) / scale.x);
+        if (i_max < 0.0f || i_min > (float)last)
+            return;
+        first = (i_min > 0.0f) ? (int)i_min : 0;
+        last = (i_max < (float)last) ? (int)i_max : last;
+        if (first >= last)
+            return;
+    }
+
+    thickness = ImMax(thickness, 1.0f);
+    const int integer_thickness = (int)thickness;
+    const bool use_texture = (Flags & ImDrawListFlags_AntiAliasedLines) && (Flags & ImDrawListFlags_AntiAliasedLinesUseTex) && (integer_thickness < IM_DRAWLIST_TEX_LINES_WIDTH_MAX) && (thickness - integer_thickness <= 0.00001f) && (_FringeScale == 1.0f);
+    if (!use_texture)
+    {
+        // Borrow the end of _Path so a path being built by the caller is left untouched
+        const int path_size = _Path.Size;
+        _Path.reserve(path_size + last - first + 1);
+        for (int i = first; i <= last; i++)
+            _Path.push_back(ImVec2(origin.x + i * scale.x, origin.y + ImPolylineValue(values, stride, i) * scale.y));
+        AddPolyline(_Path.Data + path_size, _Path.Size - path_size, col, ImDrawFlags_None, thickness);
+        _Path.Size = path_size;
+        return;
+    }
+
+    const ImVec4 tex_uvs = _Data->TexUvLines[integer_thickness];
+    const ImVec2 tex_uv0(tex_uvs.x, tex_uvs.y);
+    const ImVec2 tex_uv1(tex_uvs.z, tex_uvs.w);
+    const float half_draw_size = (thickness * 0.5f) + 1.0f; // See AddPolyline()
+    const float dx = scale.x;
+    const int last_segment = values_count - 2;
+    const int CHUNK_POINTS = 8192;
+
+    // Temporary buffer: for n points, n+1 segment normals (the ones on either side of each point) as X and Y arrays.
+    // The segment normals are then replaced in place by the vertex offsets at each point.
+    _Data->TempBuffer.reserve_discard(CHUNK_POINTS + 4);
+    float* temp_x = (float*)(void*)_Data->TempBuffer.Data;
+    float* temp_y = temp_x + (CHUNK_POINTS + 4);
+
+    // Grow the buffers once for the whole polyline instead of once per chunk
+    const int chunk_count = (last - first + CHUNK_POINTS - 2) / (CHUNK_POINTS - 1);
+    VtxBuffer.reserve(VtxBuffer.Size + (last - first + chunk_count) * 2);
+    IdxBuffer.reserve(IdxBuffer.Size + (last - first) * 6);
+
+    for (int chunk_first = first; chunk_first < last; chunk_first += CHUNK_POINTS - 1)
+    {
+        const int chunk_last = ImMin(chunk_first + CHUNK_POINTS - 1, last);
+        const int n = chunk_last - chunk_first + 1;
+
+        // Segment j of the chunk goes from point (chunk_first + j - 1) to (chunk_first + j). At both ends of the
+        // polyline the missing segment is replaced by its neighbor, so the end points use the normal of their only segment.
+        for (int j = 0; j <= n; j++)
+        {
+            const int seg = ImClamp(chunk_first + j - 1, 0, last_segment);
+            temp_y[j] = (ImPolylineValue(values, stride, seg + 1) - ImPolylineValue(values, stride, seg)) * scale.y;
+        }
+
+        // Normals (dy, -dx) / length. dx is the same for all segments.
+        int j = 0;
+#ifdef IMGUI_ENABLE_SSE
+        {
+            const __m128 v_dx = _mm_set1_ps(dx);
+            const __m128 v_dx2 = _mm_set1_ps(dx * dx);
+            const __m128 v_zero = _mm_setzero_ps();
+            for (; j + 4 <= n + 1; j += 4)
+            {
+                const __m128 dy = _mm_loadu_ps(temp_y + j);
+                const __m128 d2 = _mm_add_ps(v_dx2, _mm_mul_ps(dy, dy));
+                const __m128 inv_len = _mm_and_ps(_mm_rsqrt_ps(d2), _mm_cmpgt_ps(d2, v_zero));
+                _mm_storeu_ps(temp_x + j, _mm_mul_ps(dy, inv_len));
+                _mm_storeu_ps(temp_y + j, _mm_sub_ps(v_zero, _mm_mul_ps(v_dx, inv_len)));
+            }
+        }
+#endif
+        for (; j <= n; j++)
+        {
+            float nx = temp_y[j];
+            float ny = -dx;
+            IM_NORMALIZE2F_OVER_ZERO(nx, ny);
+            temp_x[j] = nx;
+            temp_y[j] = ny;
+        }
+
+        // Offset to the outer edges at each point: average of the normals of both segments, see IM_FIXNORMAL2F().
+        // Point j reads segments j and j+1 and overwrites slot j, so this can be done in place in increasing order.
+        j = 0;
+#ifdef IMGUI_ENABLE_SSE
+        {
+            const __m128 v_half = _mm_set1_ps(0.5f);
+            const __m128 v_size = _mm_set1_ps(half_draw_size);
+            const __m128 v_min_d2 = _mm_set1_ps(0.000001f);
+            const __m128 v_max_inv = _mm_set1_ps(IM_FIXNORMAL2F_MAX_INVLEN2);
+            const __m128 v_one = _mm_set1_ps(1.0f);
+            for (; j + 4 <= n; j += 4)
+            {
+                const __m128 mx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(temp_x + j), _mm_loadu_ps(temp_x + j + 1)), v_half);
+                const __m128 my = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(temp_y + j), _mm_loadu_ps(temp_y + j + 1)), v_half);
+                const __m128 d2 = _mm_add_ps(_mm_mul_ps(mx, mx), _mm_mul_ps(my, my));
+                const __m128 valid = _mm_cmpgt_ps(d2, v_min_d2);
+                __m128 inv_len2 = _mm_min_ps(_mm_div_ps(v_one, _mm_max_ps(d2, v_min_d2)), v_max_inv);
+                inv_len2 = _mm_or_ps(_mm_and_ps(valid, inv_len2), _mm_andnot_ps(valid, v_one));
+                const __m128 k = _mm_mul_ps(inv_len2, v_size);
+                _mm_storeu_ps(temp_x + j, _mm_mul_ps(mx, k));
+                _mm_storeu_ps(temp_y + j, _mm_mul_ps(my, k));
+            }
+        }
+#endif
+        for (; j < n; j++)
+        {
+            float dm_x = (temp_x[j] + temp_x[j + 1]) * 0.5f;
+            float dm_y = (temp_y[j] + temp_y[j + 1]) * 0.5f;
+            IM_FIXNORMAL2F(dm_x, dm_y);
+            temp_x[j] = dm_x * half_draw_size;
+            temp_y[j] = dm_y * half_draw_size;
+        }
+
+        // Emit 2 vertices per point and 2 triangles per segment
+        const int idx_count = (n - 1) * 6;
+        const int vtx_count = n * 2;
+        PrimReserve(idx_count, vtx_count);
+        ImDrawVert* vtx_write = _VtxWritePtr;
+        for (j = 0; j < n; j++)
+        {
+            const int i = chunk_first + j;
+            const float x = origin.x + i * scale.x;
+            const float y = origin.y + ImPolylineValue(values, stride, i) * scale.y;
+            vtx_write[0].pos.x = x + temp_x[j]; vtx_write[0].pos.y = y + temp_y[j]; vtx_write[0].uv = tex_uv0; vtx_write[0].col = col; // Left-side outer edge
+            vtx_write[1].pos.x = x - temp_x[j]; vtx_write[1].pos.y = y - temp_y[j]; vtx_write[1].uv = tex_uv1; vtx_write[1].col = col; // Right-side outer edge
+            vtx_write += 2;
+        }
+        ImDrawIdx* idx_write = _IdxWritePtr;
+        for (unsigned int idx1 = _VtxCurrentIdx, idx_end = _VtxCurrentIdx + vtx_count - 2; idx1 < idx_end; idx1 += 2)
+        {
+            const unsigned int idx2 = idx1 + 2;
+            idx_write[0] = (ImDrawIdx)(idx2 + 0); idx_write[1] = (ImDrawIdx)(idx1 + 0); idx_write[2] = (ImDrawIdx)(idx1 + 1); // Right tri
+            idx_write[3] = (ImDrawIdx)(idx2 + 1); idx_write[4] = (ImDrawIdx)(idx1 + 1); idx_write[5] = (ImDrawIdx)(idx2 + 0); // Left tri
+            idx_write += 6;
+        }
+        _VtxWritePtr = vtx_write;
+        _IdxWritePtr = idx_write;
+        _VtxCurrentIdx += vtx_count;
+    }
+}
+
 // - We intentionally avoid using ImVec2 and its math operators here to reduce cost to a minimum for debug/non-inlined builds.
 // - Filled shapes must always use clockwise winding order. The anti-aliasing fringe depends on it. Counter-clockwise shapes will have "inward" anti-aliasing.
 void ImDrawList::AddConvexPolyFilled(const ImVec2* points, const int points_count, ImU32 col)
@@ -2257,6 +2438,116 @@ void ImDrawListSplitter::SetCurrentChannel(ImDrawList* draw_list, int idx)
         draw_list->AddDrawCmd();
 }
 
+//-----------------------------------------------------------------------------
+// [SECTION] ImDrawListSegment
+//-----------------------------------------------------------------------------
+
+// Identify font atlas texture contents: a new texture (grow/repack) changes UniqueID, any discarded rectangle may have its pixels reused,
+// and a glyph previously drawn as fallback may now be loadable (see ImFontAtlasBakedForgetMissingGlyph()).
+// Both counters only grow, except RectsDiscardedCount which is reset along with a new texture.
+static ImU64 ImDrawList_GetTexStamp(const ImDrawList* draw_list)
+{
+    ImTextureData* tex = draw_list->_CmdHeader.TexRef._TexData;
+    if (tex == NULL)
+        return 0;
+    ImFontAtlas* atlas = draw_list->_Data->FontAtlas;
+    ImFontAtlasBuilder* builder = (atlas && atlas->TexData == tex) ? atlas->Builder : NULL;
+    const ImU32 changes = builder ? (ImU32)(builder->RectsDiscardedCount + builder->GlyphsReloadedCount) : 0;
+    return ((ImU64)(ImU32)tex->UniqueID << 32) | changes;
+}
+
+void ImDrawList::SegmentBegin(ImDrawListSegment* segment)
+{
+    segment->_VtxStart = VtxBuffer.Size;
+    segment->_IdxStart = IdxBuffer.Size;
+    segment->_CmdCount = CmdBuffer.Size;
+    segment->_Channel = _Splitter._Current;
+    segment->_VtxCurrentIdx = _VtxCurrentIdx;
+}
+
+bool ImDrawList::SegmentEnd(ImDrawListSegment* segment, ImGuiID key, const ImVec2& origin, const ImVec2& size)
+{
+    segment->Valid = false;
+    if (CmdBuffer.Size != segment->_CmdCount || _Splitter._Current != segment->_Channel || _VtxCurrentIdx < segment->_VtxCurrentIdx)
+        return false;
+    const ImVec4& clip = _CmdHeader.ClipRect;
+    if (origin.x < clip.x || origin.y < clip.y || origin.x + size.x > clip.z || origin.y + size.y > clip.w)
+        return false;
+
+    const int vtx_count = VtxBuffer.Size - segment->_VtxStart;
+    const int idx_count = IdxBuffer.Size - segment->_IdxStart;
+    segment->VtxBuffer.resize(vtx_count);
+    segment->IdxBuffer.resize(idx_count);
+    if (vtx_count > 0)
+        memcpy(segment->VtxBuffer.Data, VtxBuffer.Data + segment->_VtxStart, (size_t)vtx_count * sizeof(ImDrawVert));
+    const ImDrawIdx* src_idx = IdxBuffer.Data + segment->_IdxStart;
+    for (int n = 0; n < idx_count; n++)
+    {
+        const unsigned int idx = (unsigned int)src_idx[n] - segment->_VtxCurrentIdx;
+        if (idx >= (unsigned int)vtx_count)
+            return false; // Referencing vertices emitted before SegmentBegin()
+        segment->IdxBuffer.Data[n] = (ImDrawIdx)idx;
+    }
+
+    segment->Key = key;
+    segment->Origin = origin;
+    segment->Size = size;
+    segment->ClipRect = clip;
+    segment->TexRef = _CmdHeader.TexRef;
+    segment->TexStamp = ImDrawList_GetTexStamp(this);
+    segment->Valid = true;
+    return true;
+}
+
+bool ImDrawList::SegmentCanReplay(const ImDrawListSegment* segment, ImGuiID key, const ImVec2& origin) const
+{
+    if (!segment->Valid || segment->Key != key)
+        return false;
+    const ImVec4& clip = _CmdHeader.ClipRect;
+    if (memcmp(&segment->ClipRect, &clip, sizeof(ImVec4)) != 0 || segment->TexRef != _CmdHeader.TexRef || segment->TexStamp != ImDrawList_GetTexStamp(this))
+        return false;
+    const ImVec2 offset = origin - segment->Origin;
+    if (offset.x != (float)(int)offset.x || offset.y != (float)(int)offset.y)
+        return false;
+    if (origin.x < clip.x || origin.y < clip.y || origin.x + segment->Size.x > clip.z || origin.y + segment->Size.y > clip.w)
+        return false;
+    return true;
+}
+
+// Caller is expected to have checked SegmentCanReplay()
+void ImDrawList::SegmentReplay(const ImDrawListSegment* segment, const ImVec2& origin)
+{
+    const int vtx_count = segment->VtxBuffer.Size;
+    const int idx_count = segment->IdxBuffer.Size;
+    if (idx_count == 0)
+        return;
+    PrimReserve(idx_count, vtx_count);
+
+    const ImVec2 offset = origin - segment->Origin;
+    if (offset.x == 0.0f && offset.y == 0.0f)
+    {
+        memcpy(_VtxWritePtr, segment->VtxBuffer.Data, (size_t)vtx_count * sizeof(ImDrawVert));
+    }
+    else
+    {
+        const ImDrawVert* src = segment->VtxBuffer.Data;
+        for (int n = 0; n < vtx_count; n++)
+        {
+            _VtxWritePtr[n] = src[n];
+            _VtxWritePtr[n].pos.x += offset.x;
+            _VtxWritePtr[n].pos.y += offset.y;
+        }
+    }
+    const ImDrawIdx* src_idx = segment->IdxBuffer.Data;
+    const unsigned int vtx_index = _VtxCurrentIdx;
+    for (int n = 0; n < idx_count; n++)
+        _IdxWritePtr[n] = (ImDrawIdx)(vtx_index + src_idx[n]);
+
+    _VtxWritePtr += vtx_count;
+    _IdxWritePtr += idx_count;
+    _VtxCurrentIdx += vtx_count;
+}
+
 //-----------------------------------------------------------------------------
 // [SECTION] ImDrawData
 //-----------------------------------------------------------------------------
@@ -2993,6 +3284,77 @@ void ImFontAtlasTextureBlockQueueUpload(ImFontAtlas* atlas, ImTextureData* tex,
     }
 }
 
+static int IMGUI_CDECL ImTextureRectComparerByYX(const void* lhs, const void* rhs)
+{
+    const ImTextureRect* a = (const ImTextureRect*)lhs;
+    const ImTextureRect* b = (const ImTextureRect*)rhs;
+    if (a->y != b->y)
+        return (a->y < b->y) ? -1 : +1;
+    return (a->x < b->x) ? -1 : (a->x > b->x) ? +1 : 0;
+}
+
+// Merge queued update rectangles to reduce the number of uploads issued by the backend.
+// Two rectangles are merged when their bounding box exceeds the pixels they actually need by no more than
+// 'max_overhead' (0.25f = 25%) plus 'upload_cost_pixels', the amount of extra pixels worth copying to save one upload call.
+// A merged rectangle may cover pixels that were uploaded before: those are unchanged on the CPU side, so uploading them again is harmless.
+// Returns the number of rectangles left in tex->Updates[]. tex->UpdateRect is unaffected.
+int ImTextureDataCoalesceUpdates(ImTextureData* tex, float max_overhead, int upload_cost_pixels)
+{
+    ImVector<ImTextureRect>& updates = tex->Updates;
+    if (updates.Size < 2)
+        return updates.Size;
+
+    // Packed glyphs are laid out in rows: after sorting, merge candidates are among the last few emitted rectangles.
+    const int MERGE_WINDOW = 8;
+    ImQsort(updates.Data, (size_t)updates.Size, sizeof(ImTextureRect), ImTextureRectComparerByYX);
+    ImVector<int> needed_area; // Pixels actually requested inside each emitted rectangle
+    needed_area.resize(updates.Size);
+    for (int n = 0; n < updates.Size; n++)
+        needed_area[n] = updates[n].w * updates[n].h;
+
+    for (int pass = 0; pass < 4; pass++)
+    {
+        bool merged_any = false;
+        int out_n = 0;
+        for (int n = 0; n < updates.Size; n++)
+        {
+            const ImTextureRect r = updates[n];
+            const int r_area = needed_area[n];
+            int merge_idx = -1;
+            for (int m = out_n - 1; m >= 0 && m >= out_n - MERGE_WINDOW; m--)
+            {
+                const ImTextureRect& o = updates[m];
+                const int x0 = ImMin(o.x, r.x), y0 = ImMin(o.y, r.y);
+                const int x1 = ImMax(o.x + o.w, r.x + r.w), y1 = ImMax(o.y + o.h, r.y + r.h);
+                const int needed = needed_area[m] + r_area;
+                if ((float)((x1 - x0) * (y1 - y0)) <= (float)needed * (1.0f + max_overhead) + (float)upload_cost_pixels)
+                {
+                    updates[m].x = (unsigned short)x0;
+                    updates[m].y = (unsigned short)y0;
+                    updates[m].w = (unsigned short)(x1 - x0);
+                    updates[m].h = (unsigned short)(y1 - y0);
+                    needed_area[m] = needed;
+                    merge_idx = m;
+                    break;
+                }
+            }
+            if (merge_idx != -1)
+            {
+                merged_any = true;
+                continue;
+            }
+            updates[out_n] = r;
+            needed_area[out_n] = r_area;
+            out_n++;
+        }
+        updates.resize(out_n);
+        needed_area.resize(out_n);
+        if (!merged_any)
+            break;
+    }
+    return updates.Size;
+}
+
 #ifndef IMGUI_DISABLE_OBSOLETE_FUNCTIONS
 static void GetTexDataAsFormat(ImFontAtlas* atlas, ImTextureFormat format, unsigned char** out_pixels, int* out_width, int* out_height, int* out_bytes_per_pixel)
 {
@@ -3451,6 +3813,16 @@ void ImFontAtlasBuildGetOversampleFactors(ImFontConfig* src, ImFontBaked* baked,
     *out_oversample_v = (src->OversampleV != 0) ? src->OversampleV : 1;
 }
 
+void ImFontAtlasBuildGetGlyphRasterParams(ImFontConfig* src, ImFontBaked* baked, ImFontGlyphRasterParams* out_params)
+{
+    ImFontAtlasBuildGetOversampleFactors(src, baked, &out_params->OversampleH, &out_params->OversampleV);
+    out_params->Size = baked->Size;
+    out_params->RasterizerDensity = src->RasterizerDensity * baked->RasterizerDensity;
+    out_params->Ascent = baked->Ascent;
+    const float ref_size = baked->OwnerFont->Sources[0]->SizePixels;
+    out_params->OffsetsScale = (ref_size != 0.0f) ? (baked->Size / ref_size) : 1.0f;
+}
+
 // Setup main font loader for the atlas
 // Every font source (ImFontConfig) will use this unless ImFontConfig::FontLoader specify a custom loader.
 void ImFontAtlasBuildSetupFontLoader(ImFontAtlas* atlas, const ImFontLoader* font_loader)
@@ -3837,6 +4209,8 @@ void ImFontAtlasBakedDiscardFontGlyph(ImFontAtlas* atlas, ImFont* font, ImFontBa
     IM_UNUSED(font);
     baked->IndexLookup[c] = IM_FONTGLYPH_INDEX_UNUSED;
     baked->IndexAdvanceX[c] = baked->FallbackAdvanceX;
+    if (c >= 0x20 && c < 0x7F)
+        baked->AsciiTableState = 0;
 }
 
 ImFontBaked* ImFontAtlasBakedAdd(ImFontAtlas* atlas, ImFont* font, float font_size, float font_rasterizer_density, ImGuiID baked_id)
@@ -4706,9 +5080,9 @@ static bool ImGui_ImplStbTrueType_FontBakedInit(ImFontAtlas* atlas, ImFontConfig
     return true;
 }
 
-static bool ImGui_ImplStbTrueType_FontBakedLoadGlyph(ImFontAtlas* atlas, ImFontConfig* src, ImFontBaked* baked, void*, ImWchar codepoint, ImFontGlyph* out_glyph, float* out_advance_x)
+// Only reads 'src' and 'params': safe to call from any thread.
+static bool ImGui_ImplStbTrueType_FontSrcRasterizeGlyph(ImFontConfig* src, const ImFontGlyphRasterParams* params, ImWchar codepoint, ImFontGlyph* out_glyph, int* out_w, int* out_h, unsigned char* out_pixels, int out_pixels_size)
 {
-    // Search for first font which has the glyph
     ImGui_ImplStbTrueType_FontSrcData* bd_font_data = (ImGui_ImplStbTrueType_FontSrcData*)src->FontLoaderData;
     IM_ASSERT(bd_font_data);
     int glyph_index = stbtt_FindGlyphIndex(&bd_font_data->FontInfo, (int)codepoint);
@@ -4716,12 +5090,12 @@ static bool ImGui_ImplStbTrueType_FontBakedLoadGlyph(ImFontAtlas* atlas, ImFontC
         return false;
 
     // Fonts unit to pixels
-    int oversample_h, oversample_v;
-    ImFontAtlasBuildGetOversampleFactors(src, baked, &oversample_h, &oversample_v);
-    const float scale_for_layout = bd_font_data->ScaleFactor * baked->Size;
-    const float rasterizer_density = src->RasterizerDensity * baked->RasterizerDensity;
-    const float scale_for_raster_x = bd_font_data->ScaleFactor * baked->Size * rasterizer_density * oversample_h;
-    const float scale_for_raster_y = bd_font_data->ScaleFactor * baked->Size * rasterizer_density * oversample_v;
+    const int oversample_h = params->OversampleH;
+    const int oversample_v = params->OversampleV;
+    const float scale_for_layout = bd_font_data->ScaleFactor * params->Size;
+    const float rasterizer_density = params->RasterizerDensity;
+    const float scale_for_raster_x = bd_font_data->ScaleFactor * params->Size * rasterizer_density * oversample_h;
+    const float scale_for_raster_y = bd_font_data->ScaleFactor * params->Size * rasterizer_density * oversample_v;
 
     // Obtain size and advance
     int x0, y0, x1, y1;
@@ -4729,67 +5103,89 @@ static bool ImGui_ImplStbTrueType_FontBakedLoadGlyph(ImFontAtlas* atlas, ImFontC
     stbtt_GetGlyphBitmapBoxSubpixel(&bd_font_data->FontInfo, glyph_index, scale_for_raster_x, scale_for_raster_y, 0, 0, &x0, &y0, &x1, &y1);
     stbtt_GetGlyphHMetrics(&bd_font_data->FontInfo, glyph_index, &advance, &lsb);
 
-    // Load metrics only mode
-    if (out_advance_x != NULL)
-    {
-        IM_ASSERT(out_glyph == NULL);
-        *out_advance_x = advance * scale_for_layout;
-        return true;
-    }
-
     // Prepare glyph
     out_glyph->Codepoint = codepoint;
     out_glyph->AdvanceX = advance * scale_for_layout;
+    out_glyph->Visible = false;
+    *out_w = *out_h = 0;
 
-    // Pack and retrieve position inside texture atlas
-    // (generally based on stbtt_PackFontRangesRenderIntoRects)
     const bool is_visible = (x0 != x1 && y0 != y1);
-    if (is_visible)
+    if (!is_visible)
+        return true;
+    const int w = (x1 - x0 + oversample_h - 1);
+    const int h = (y1 - y0 + oversample_v - 1);
+    *out_w = w;
+    *out_h = h;
+    if (out_pixels == NULL || w * h > out_pixels_size)
+        return true;
+
+    // Render with oversampling
+    // (those functions conveniently assert if pixels are not cleared, which is another safety layer)
+    stbtt_GetGlyphBitmapBox(&bd_font_data->FontInfo, glyph_index, scale_for_raster_x, scale_for_raster_y, &x0, &y0, &x1, &y1);
+    memset(out_pixels, 0, w * h * 1);
+    float sub_x, sub_y;
+    stbtt_MakeGlyphBitmapSubpixelPrefilter(&bd_font_data->FontInfo, out_pixels, w, h, w,
+        scale_for_raster_x, scale_for_raster_y, 0, 0, oversample_h, oversample_v, &sub_x, &sub_y, glyph_index);
+
+    float font_off_x = ImFloor(src->GlyphOffset.x * params->OffsetsScale + 0.5f); // Snap scaled offset.
+    float font_off_y = ImFloor(src->GlyphOffset.y * params->OffsetsScale + 0.5f);
+    font_off_x += sub_x;
+    font_off_y += sub_y + IM_ROUND(params->Ascent);
+    float recip_h = 1.0f / (oversample_h * rasterizer_density);
+    float recip_v = 1.0f / (oversample_v * rasterizer_density);
+
+    // glyph.X0, glyph.Y0 are drawing coordinates from base text position, and accounting for oversampling.
+    out_glyph->X0 = x0 * recip_h + font_off_x;
+    out_glyph->Y0 = y0 * recip_v + font_off_y;
+    out_glyph->X1 = (x0 + w) * recip_h + font_off_x;
+    out_glyph->Y1 = (y0 + h) * recip_v + font_off_y;
+    out_glyph->Visible = true;
+    return true;
+}
+
+static bool ImGui_ImplStbTrueType_FontBakedLoadGlyph(ImFontAtlas* atlas, ImFontConfig* src, ImFontBaked* baked, void*, ImWchar codepoint, ImFontGlyph* out_glyph, float* out_advance_x)
+{
+    // Load metrics only mode
+    if (out_advance_x != NULL)
     {
-        const int w = (x1 - x0 + oversample_h - 1);
-        const int h = (y1 - y0 + oversample_v - 1);
-        ImFontAtlasRectId pack_id = ImFontAtlasPackAddRect(atlas, w, h);
-        if (pack_id == ImFontAtlasRectId_Invalid)
-        {
-            // Pathological out of memory case (TexMaxWidth/TexMaxHeight set too small?)
-            IM_ASSERT(pack_id != ImFontAtlasRectId_Invalid && "Out of texture memory.");
+        IM_ASSERT(out_glyph == NULL);
+        ImGui_ImplStbTrueType_FontSrcData* bd_font_data = (ImGui_ImplStbTrueType_FontSrcData*)src->FontLoaderData;
+        IM_ASSERT(bd_font_data);
+        int glyph_index = stbtt_FindGlyphIndex(&bd_font_data->FontInfo, (int)codepoint);
+        if (glyph_index == 0)
             return false;
-        }
-        ImTextureRect* r = ImFontAtlasPackGetRect(atlas, pack_id);
+        int advance, lsb;
+        stbtt_GetGlyphHMetrics(&bd_font_data->FontInfo, glyph_index, &advance, &lsb);
+        *out_advance_x = advance * bd_font_data->ScaleFactor * baked->Size;
+        return true;
+    }
 
-        // Render
-        stbtt_GetGlyphBitmapBox(&bd_font_data->FontInfo, glyph_index, scale_for_raster_x, scale_for_raster_y, &x0, &y0, &x1, &y1);
-        ImFontAtlasBuilder* builder = atlas->Builder;
+    // Rasterize into the builder's temporary buffer, growing it if needed
+    ImFontGlyphRasterParams params;
+    ImFontAtlasBuildGetGlyphRasterParams(src, baked, &params);
+    ImFontAtlasBuilder* builder = atlas->Builder;
+    int w, h;
+    if (!ImGui_ImplStbTrueType_FontSrcRasterizeGlyph(src, &params, codepoint, out_glyph, &w, &h, builder->TempBuffer.Data, builder->TempBuffer.Size))
+        return false;
+    if (w != 0 && !out_glyph->Visible)
+    {
         builder->TempBuffer.resize(w * h * 1);
-        unsigned char* bitmap_pixels = builder->TempBuffer.Data;
-        memset(bitmap_pixels, 0, w * h * 1);
-
-        // Render with oversampling
-        // (those functions conveniently assert if pixels are not cleared, which is another safety layer)
-        float sub_x, sub_y;
-        stbtt_MakeGlyphBitmapSubpixelPrefilter(&bd_font_data->FontInfo, bitmap_pixels, w, h, w,
-            scale_for_raster_x, scale_for_raster_y, 0, 0, oversample_h, oversample_v, &sub_x, &sub_y, glyph_index);
+        ImGui_ImplStbTrueType_FontSrcRasterizeGlyph(src, &params, codepoint, out_glyph, &w, &h, builder->TempBuffer.Data, builder->TempBuffer.Size);
+    }
+    if (!out_glyph->Visible)
+        return true;
 
-        const float ref_size = baked->OwnerFont->Sources[0]->SizePixels;
-        const float offsets_scale = (ref_size != 0.0f) ? (baked->Size / ref_size) : 1.0f;
-        float font_off_x = ImFloor(src->GlyphOffset.x * offsets_scale + 0.5f); // Snap scaled offset.
-        float font_off_y = ImFloor(src->GlyphOffset.y * offsets_scale + 0.5f);
-        font_off_x += sub_x;
-        font_off_y += sub_y + IM_ROUND(baked->Ascent);
-        float recip_h = 1.0f / (oversample_h * rasterizer_density);
-        float recip_v = 1.0f / (oversample_v * rasterizer_density);
-
-        // Register glyph
-        // r->x r->y are coordinates inside texture (in pixels)
-        // glyph.X0, glyph.Y0 are drawing coordinates from base text position, and accounting for oversampling.
-        out_glyph->X0 = x0 * recip_h + font_off_x;
-        out_glyph->Y0 = y0 * recip_v + font_off_y;
-        out_glyph->X1 = (x0 + (int)r->w) * recip_h + font_off_x;
-        out_glyph->Y1 = (y0 + (int)r->h) * recip_v + font_off_y;
-        out_glyph->Visible = true;
-        out_glyph->PackId = pack_id;
-        ImFontAtlasBakedSetFontGlyphBitmap(atlas, baked, src, out_glyph, r, bitmap_pixels, ImTextureFormat_Alpha8, w);
+    // Pack and retrieve position inside texture atlas
+    ImFontAtlasRectId pack_id = ImFontAtlasPackAddRect(atlas, w, h);
+    if (pack_id == ImFontAtlasRectId_Invalid)
+    {
+        // Pathological out of memory case (TexMaxWidth/TexMaxHeight set too small?)
+        IM_ASSERT(pack_id != ImFontAtlasRectId_Invalid && "Out of texture memory.");
+        return false;
     }
+    ImTextureRect* r = ImFontAtlasPackGetRect(atlas, pack_id);
+    out_glyph->PackId = pack_id;
+    ImFontAtlasBakedSetFontGlyphBitmap(atlas, baked, src, out_glyph, r, builder->TempBuffer.Data, ImTextureFormat_Alpha8, w);
 
     return true;
 }
@@ -4804,6 +5200,7 @@ const ImFontLoader* ImFontAtlasGetFontLoaderForStbTruetype()
     loader.FontBakedInit = ImGui_ImplStbTrueType_FontBakedInit;
     loader.FontBakedDestroy = NULL;
     loader.FontBakedLoadGlyph = ImGui_ImplStbTrueType_FontBakedLoadGlyph;
+    loader.FontSrcRasterizeGlyph = ImGui_ImplStbTrueType_FontSrcRasterizeGlyph;
     return &loader;
 }
 
@@ -5144,6 +5541,7 @@ void ImFontBaked::ClearOutputData()
     IndexAdvanceX.clear();
     IndexLookup.clear();
     FallbackGlyphIndex = -1;
+    AsciiTableState = 0;
     Ascent = Descent = 0.0f;
     MetricsTotalSurface = 0;
 }
@@ -5262,6 +5660,22 @@ void ImFontAtlasBakedAddFontGlyphAdvancedX(ImFontAtlas* atlas, ImFontBaked* bake
     baked->IndexAdvanceX[codepoint] = advance_x;
 }
 
+// Clear the "not found" mark left when loaders failed to provide a glyph, so it is loaded again on next use.
+// Used when a loader deferred the glyph (e.g. rasterized on a worker thread). Returns false if the glyph is already loaded.
+bool ImFontAtlasBakedForgetMissingGlyph(ImFontBaked* baked, ImWchar codepoint)
+{
+    if ((int)codepoint >= baked->IndexLookup.Size)
+        return true;
+    if (baked->IndexLookup[codepoint] == IM_FONTGLYPH_INDEX_NOT_FOUND)
+    {
+        baked->IndexLookup[codepoint] = IM_FONTGLYPH_INDEX_UNUSED;
+        baked->IndexAdvanceX[codepoint] = -1.0f;
+        if (ImFontAtlasBuilder* builder = baked->OwnerFont->OwnerAtlas->Builder)
+            builder->GlyphsReloadedCount++; // Invalidate recorded ImDrawListSegment that used the fallback glyph
+    }
+    return baked->IndexLookup[codepoint] == IM_FONTGLYPH_INDEX_UNUSED;
+}
+
 // Copy to texture, post-process and queue update for backend
 void ImFontAtlasBakedSetFontGlyphBitmap(ImFontAtlas* atlas, ImFontBaked* baked, ImFontConfig* src, ImFontGlyph* glyph, ImTextureRect* r, const unsigned char* src_pixels, ImTextureFormat src_fmt, int src_pitch)
 {
@@ -5293,6 +5707,30 @@ ImFontGlyph* ImFontBaked::FindGlyph(ImWchar c)
     return glyph ? glyph : &Glyphs.Data[FallbackGlyphIndex];
 }
 
+// Build dense Glyphs index for printable ASCII (0x20..0x7E), used by the RenderText()/CalcTextSize() fast path.
+// Loads missing glyphs once. Table is left unavailable if any of them can't be resolved (e.g. locked atlas).
+static bool ImFontBaked_BuildAsciiTable(ImFontBaked* baked)
+{
+    if (baked->AsciiTableState != 0)
+        return baked->AsciiTableState > 0;
+    for (ImWchar c = 0x20; c < 0x7F; c++)
+        baked->FindGlyph(c);
+    baked->AsciiTableState = -1;
+    if (baked->IndexLookup.Size < 0x7F || baked->IndexAdvanceX.Size < 0x7F)
+        return false;
+    for (int c = 0x20; c < 0x7F; c++)
+    {
+        int i = (int)baked->IndexLookup.Data[c];
+        if (i == IM_FONTGLYPH_INDEX_NOT_FOUND)
+            i = baked->FallbackGlyphIndex;
+        if (i == IM_FONTGLYPH_INDEX_UNUSED || i < 0 || baked->IndexAdvanceX.Data[c] < 0.0f)
+            return false;
+        baked->AsciiGlyphIndex[c - 0x20] = (ImU16)i;
+    }
+    baked->AsciiTableState = 1;
+    return true;
+}
+
 // Attempt to load but when missing, return NULL instead of FallbackGlyph
 ImFontGlyph* ImFontBaked::FindGlyphNoFallback(ImWchar c)
 {
@@ -5603,6 +6041,41 @@ const char* ImFont::CalcWordWrapPosition(float size, const char* text, const cha
     return ImFontCalcWordWrapPositionEx(this, size, text, text_end, wrap_width, ImDrawTextFlags_None);
 }
 
+// Return end of the run of printable ASCII characters (0x20..0x7E) starting at 's', scanning 16/32 bytes at a time when SIMD is available.
+static inline const char* ImTextFindPrintableAsciiEnd(const char* s, const char* s_end)
+{
+    if (s >= s_end || (unsigned char)(*s - 0x20) >= 0x5F)
+        return s;
+#if defined(__AVX2__)
+    const __m256i lo_32 = _mm256_set1_epi8(0x1F);
+    const __m256i hi_32 = _mm256_set1_epi8(0x7F);
+    while (s_end - s >= 32)
+    {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(const void*)s);
+        const unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpgt_epi8(v, lo_32), _mm256_cmpgt_epi8(hi_32, v)));
+        if (mask != 0xFFFFFFFFu)
+            return s + ImCountTrailingZeroes(~mask);
+        s += 32;
+    }
+#endif
+#ifdef IMGUI_ENABLE_SSE
+    const __m128i lo = _mm_set1_epi8(0x1F);
+    const __m128i hi = _mm_set1_epi8(0x7F);
+    while (s_end - s >= 16)
+    {
+        // Bytes >= 0x80 are negative as signed and fail the first comparison.
+        const __m128i v = _mm_loadu_si128((const __m128i*)(const void*)s);
+        const unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmplt_epi8(v, hi)));
+        if (mask != 0xFFFF)
+            return s + ImCountTrailingZeroes(~mask);
+        s += 16;
+    }
+#endif
+    while (s < s_end && (unsigned char)(*s - 0x20) < 0x5F)
+        s++;
+    return s;
+}
+
 ImVec2 ImFontCalcTextSizeEx(ImFont* font, float size, float max_width, float wrap_width, const char* text_begin, const char* text_end_display, const char* text_end, const char** out_remaining, ImVec2* out_offset, ImDrawTextFlags flags)
 {
     if (!text_end)
@@ -5620,6 +6093,10 @@ ImVec2 ImFontCalcTextSizeEx(ImFont* font, float size, float max_width, float wra
     const bool word_wrap_enabled = (wrap_width > 0.0f);
     const char* word_wrap_eol = NULL;
 
+    // Printable ASCII runs can sum IndexAdvanceX directly. Table is built by RenderText(), so CalcTextSize() never loads glyphs for it.
+    const bool ascii_fast_path = (baked->AsciiTableState > 0) && !(font->Flags & ImFontFlags_NoAsciiFastPath);
+    const char* ascii_run_end = text_begin;
+
     const char* s = text_begin;
     while (s < text_end_display)
     {
@@ -5644,6 +6121,25 @@ ImVec2 ImFontCalcTextSizeEx(ImFont* font, float size, float max_width, float wra
             }
         }
 
+        // Printable ASCII run: no decoding, no glyph loading
+        if (ascii_fast_path && s >= ascii_run_end)
+            ascii_run_end = ImTextFindPrintableAsciiEnd(s, (word_wrap_enabled && word_wrap_eol < text_end_display) ? word_wrap_eol : text_end_display);
+        if (s < ascii_run_end)
+        {
+            const float* advance_x = baked->IndexAdvanceX.Data;
+            while (s < ascii_run_end)
+            {
+                const float char_width = advance_x[(unsigned char)*s] * scale;
+                if (line_width + char_width >= max_width)
+                    break;
+                line_width += char_width;
+                s++;
+            }
+            if (s < ascii_run_end)
+                break;
+            continue;
+        }
+
         // Decode and advance source
         const char* prev_s = s;
         unsigned int c = (unsigned int)*s;
@@ -5755,6 +6251,10 @@ begin:
     const float line_height = size;
     ImFontBaked* baked = GetFontBaked(size);
 
+    // Printable ASCII runs use a dense glyph table: no UTF-8 decoding and no FindGlyph() per character.
+    // Built before PrimReserve() so that glyph loading can't invalidate the reserved range.
+    const ImU16* ascii_table = (!(Flags & ImFontFlags_NoAsciiFastPath) && ImFontBaked_BuildAsciiTable(baked)) ? baked->AsciiGlyphIndex : NULL;
+
     const float scale = size / baked->Size;
     const float origin_x = x;
     const bool word_wrap_enabled = (wrap_width > 0.0f);
@@ -5810,6 +6310,7 @@ begin:
 
     const ImU32 col_untinted = col | ~IM_COL32_A_MASK;
     const char* word_wrap_eol = NULL;
+    const char* ascii_run_end = s;
 
     while (s < text_end)
     {
@@ -5831,30 +6332,42 @@ begin:
             }
         }
 
-        // Decode and advance source
-        unsigned int c = (unsigned int)*s;
-        if (c < 0x80)
+        // Printable ASCII run: glyph straight from the dense table (Glyphs may have grown since, so always index through baked->Glyphs.Data)
+        const ImFontGlyph* glyph;
+        if (ascii_table != NULL && s >= ascii_run_end)
+            ascii_run_end = ImTextFindPrintableAsciiEnd(s, word_wrap_enabled ? word_wrap_eol : text_end);
+        if (s < ascii_run_end)
+        {
+            glyph = &baked->Glyphs.Data[ascii_table[(unsigned char)*s - 0x20]];
             s += 1;
+        }
         else
-            s += ImTextCharFromUtf8(&c, s, text_end);
-
-        if (c < 32)
         {
-            if (c == '\n')
+            // Decode and advance source
+            unsigned int c = (unsigned int)*s;
+            if (c < 0x80)
+                s += 1;
+            else
+                s += ImTextCharFromUtf8(&c, s, text_end);
+
+            if (c < 32)
             {
-                x = origin_x;
-                y += line_height;
-                if (y > clip_rect.w)
-                    break; // break out of main loop
-                continue;
+                if (c == '\n')
+                {
+                    x = origin_x;
+                    y += line_height;
+                    if (y > clip_rect.w)
+                        break; // break out of main loop
+                    continue;
+                }
+                if (c == '\r')
+                    continue;
             }
-            if (c == '\r')
-                continue;
-        }
 
-        const ImFontGlyph* glyph = baked->FindGlyph((ImWchar)c);
-        //if (glyph == NULL)
-        //    continue;
+            glyph = baked->FindGlyph((ImWchar)c);
+            //if (glyph == NULL)
+            //    continue;
+        }
 
         float char_width = glyph->AdvanceX * scale;
         if (glyph->Visible)
@@ -72,6 +72,28 @@ Index of this file:
 #if defined(IMGUI_ENABLE_SSE4_2) && !defined(IMGUI_USE_LEGACY_CRC32_ADLER) && !defined(__EMSCRIPTEN__)
 #define IMGUI_ENABLE_SSE4_2_CRC
 #endif
+// Opt-in SSE 4.2 CRC32c for ImHashData()/ImHashStr() when the program isn't compiled for SSE 4.2 (see imconfig.h). MSVC allows the intrinsics regardless of /arch.
+#if defined(IMGUI_USE_SSE4_2_CRC) && defined(IMGUI_ENABLE_SSE) && !defined(IMGUI_ENABLE_SSE4_2_CRC) && !defined(IMGUI_USE_LEGACY_CRC32_ADLER) && !defined(__EMSCRIPTEN__)
+#include <nmmintrin.h>
+#define IMGUI_ENABLE_SSE4_2_CRC
+#define IMGUI_SSE4_2_CRC_RUNTIME_CHECK  // CPU support is checked once at runtime, falling back to the lookup table
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>                     // __cpuid()
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define IMGUI_SSE4_2_CRC_TARGET __attribute__((target("sse4.2")))
+#endif
+#endif
+#ifndef IMGUI_SSE4_2_CRC_TARGET
+#define IMGUI_SSE4_2_CRC_TARGET
+#endif
+// Profiler zones, see IM_PROFILE_SCOPE in imconfig.h
+#ifndef IM_PROFILE_SCOPE
+#define IM_PROFILE_SCOPE(_NAME)
+#endif
+#if defined(IMGUI_USE_FAST_HASH) && defined(IMGUI_USE_LEGACY_CRC32_ADLER)
+#error "IMGUI_USE_FAST_HASH and IMGUI_USE_LEGACY_CRC32_ADLER can't be used together."
+#endif
 
 // Visual Studio warnings
 #ifdef _MSC_VER
@@ -137,6 +159,7 @@ Index of this file:
 struct ImBitVector;                 // Store 1-bit per value
 struct ImRect;                      // An axis-aligned rectangle (2 points)
 struct ImGuiTextIndex;              // Maintain a line index for a text buffer.
+struct ImGuiFrameArena;             // Bump allocator for memory released at the next NewFrame()
 
 // ImDrawList/ImFontAtlas
 struct ImDrawDataBuilder;           // Helper to build a ImDrawData instance
@@ -390,6 +413,11 @@ inline bool             ImIsPowerOfTwo(int v)               { return v != 0 && (
 inline bool             ImIsPowerOfTwo(ImU64 v)             { return v != 0 && (v & (v - 1)) == 0; }
 inline int              ImUpperPowerOfTwo(int v)            { v--; v |= v >> 1; v |= v >> 2; v |= v >> 4; v |= v >> 8; v |= v >> 16; v++; return v; }
 inline unsigned int     ImCountSetBits(unsigned int v)      { unsigned int count = 0; while (v > 0) { v = v & (v - 1); count++; } return count; }
+#if defined(__GNUC__) || defined(__clang__)
+inline unsigned int     ImCountTrailingZeroes(unsigned int v) { return (unsigned int)__builtin_ctz(v); } // 'v' must not be 0
+#else
+inline unsigned int     ImCountTrailingZeroes(unsigned int v) { static const unsigned char debruijn[32] = { 0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8, 31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9 }; return debruijn[((v & (0u - v)) * 0x077CB531u) >> 27]; }
+#endif
 
 // Helpers: String
 #define ImStrlen strlen
@@ -831,6 +859,33 @@ struct ImGuiTextIndex
     void            append(const char* base, int old_size, int new_size);
 };
 
+// Helper: ImGuiFrameArena
+// Bump allocator for memory which only needs to live until the next NewFrame(), see ImGui::MemAllocFrame().
+// Blocks are allocated with IM_ALLOC() and kept across frames: once warmed up, a repeating frame doesn't touch the heap.
+// Not thread-safe: only use from the thread calling NewFrame().
+struct ImGuiFrameArenaBlock
+{
+    char*           Data;
+    int             Size;
+};
+
+struct ImGuiFrameArena
+{
+    ImVector<ImGuiFrameArenaBlock> Blocks;
+    int             BlockCurrent = 0;                       // Index in Blocks[] being filled
+    int             BlockUsed = 0;                          // Bytes used in Blocks[BlockCurrent]
+    int             UsedBytes = 0;                          // Bytes handed out this frame, including alignment padding
+    int             AllocCount = 0;                         // Allocations this frame
+    int             LastFrameUsedBytes = 0;
+    int             LastFrameAllocCount = 0;
+    int             HighWaterMark = 0;                      // Largest UsedBytes reached by a frame
+    int             ReservedBytes = 0;                      // Sum of Blocks[] sizes
+
+    IMGUI_API void* Alloc(size_t size);
+    IMGUI_API void  Reset();                                // Rewind all blocks, called by NewFrame()
+    IMGUI_API void  ClearFreeMemory();
+};
+
 // Helper: ImGuiStorage
 IMGUI_API ImGuiStoragePair* ImLowerBound(ImGuiStoragePair* in_begin, ImGuiStoragePair* in_end, ImGuiID key);
 
@@ -2296,6 +2351,12 @@ struct ImGuiDebugAllocInfo
     int         TotalFreeCount;
     ImS16       LastEntriesIdx;             // Current index in buffer
     ImGuiDebugAllocEntry LastEntriesBuf[6]; // Track last 6 frames that had allocations
+    int         FrameAllocCount;            // Number of calls to MemAlloc() during the current frame
+    int         FrameAllocBytes;
+    int         LastFrameAllocCount;
+    int         LastFrameAllocBytes;
+    float       FrameAllocHistory[120];     // Number of calls to MemAlloc() for each of the last 120 frames (for plotting)
+    int         FrameAllocHistoryIdx;
 
     ImGuiDebugAllocInfo() { memset(this, 0, sizeof(*this)); }
 };
@@ -2769,6 +2830,7 @@ struct ImGuiContext
     int                     WantCaptureKeyboardNextFrame;       // "
     int                     WantTextInputNextFrame;             // Copied in EndFrame() from g.PlatformImeData.WantTextInput. Needs to be set for some backends (SDL3) to emit character inputs.
     ImVector<char>          TempBuffer;                         // Temporary text buffer
+    ImGuiFrameArena         FrameArena;                         // Storage for MemAllocFrame(), rewound by NewFrame()
     char                    TempKeychordName[64];
 
     ImGuiContext(ImFontAtlas* shared_font_atlas);
@@ -3097,6 +3159,7 @@ struct ImGuiTableColumn
     float                   WidthRequest;                   // Master width absolute value when !(Flags & _WidthStretch). When Stretch this is derived every frame from StretchWeight in TableUpdateLayout()
     float                   WidthAuto;                      // Automatic width
     float                   WidthMax;                       // Maximum width (FIXME: overwritten by each instance)
+    float                   WidthGivenLayout;               // WidthGiven as output by the width distribution in TableUpdateLayout(), before clamping to WidthMax. Reused while the layout cache key matches.
     float                   StretchWeight;                  // Master width weight when (Flags & _WidthStretch). Often around ~1.0f initially.
     float                   InitStretchWeightOrWidth;       // Value passed to TableSetupColumn(). For Width it is a content width (_without padding_).
     ImRect                  ClipRect;                       // Clipping rectangle for the column
@@ -3224,6 +3287,7 @@ struct IMGUI_API ImGuiTable
     float                       ColumnsGivenWidth;          // Sum of current column width
     float                       ColumnsAutoFitWidth;        // Sum of ideal column width in order nothing to be clipped, used for auto-fitting and content width submission in outer window
     float                       ColumnsStretchSumWeights;   // Sum of weight of all enabled stretching columns
+    ImGuiID                     LayoutCacheKey;             // Hash of the inputs of the last width distribution in TableUpdateLayout(), 0 when not cached (e.g. auto-fitting)
     float                       ResizedColumnNextWidth;
     float                       ResizeLockMinContentsX2;    // Lock minimum contents width while resizing down in order to not create feedback loops. But we allow growing the table.
     float                       RefScale;                   // Reference scale to be able to rescale columns on font/dpi changes.
@@ -3246,6 +3310,7 @@ struct IMGUI_API ImGuiTable
     ImVector<ImGuiTableInstanceData>    InstanceDataExtra;  // FIXME-OPT: Using a small-vector pattern would be good.
     ImGuiTableColumnSortSpecs   SortSpecsSingle;
     ImVector<ImGuiTableColumnSortSpecs> SortSpecsMulti;     // FIXME-OPT: Using a small-vector pattern would be good.
+    ImVector<char>              LayoutCacheKeyData;         // Bytes hashed into LayoutCacheKey, compared on a hash match so that a collision cannot reuse another layout
     ImGuiTableSortSpecs         SortSpecs;                  // Public facing sorts specs, this is what we return in TableGetSortSpecs()
     ImGuiTableColumnIdx         SortSpecsCount;
     ImGuiTableColumnIdx         ColumnsEnabledCount;        // Number of enabled columns (<= ColumnsCount)
@@ -4055,6 +4120,17 @@ namespace ImGui
 // [SECTION] ImFontLoader
 //-----------------------------------------------------------------------------
 
+// Values read from an ImFontBaked for ImFontLoader::FontSrcRasterizeGlyph(), so the rasterizer doesn't access the baked font.
+struct ImFontGlyphRasterParams
+{
+    float           Size;                   // ImFontBaked::Size
+    float           RasterizerDensity;      // ImFontConfig::RasterizerDensity * ImFontBaked::RasterizerDensity
+    float           Ascent;                 // ImFontBaked::Ascent
+    float           OffsetsScale;           // Scale applied to ImFontConfig::GlyphOffset
+    int             OversampleH;
+    int             OversampleV;
+};
+
 // Hooks and storage for a given font backend.
 // This structure is likely to evolve as we add support for incremental atlas updates.
 // Conceptually this could be public, but API is still going to be evolve.
@@ -4070,6 +4146,13 @@ struct ImFontLoader
     void            (*FontBakedDestroy)(ImFontAtlas* atlas, ImFontConfig* src, ImFontBaked* baked, void* loader_data_for_baked_src);
     bool            (*FontBakedLoadGlyph)(ImFontAtlas* atlas, ImFontConfig* src, ImFontBaked* baked, void* loader_data_for_baked_src, ImWchar codepoint, ImFontGlyph* out_glyph, float* out_advance_x);
 
+    // [Optional] Rasterize a glyph without touching the atlas or the baked font, so it may be called from another thread while 'src' is alive.
+    // - 'params' are obtained on the main thread with ImFontAtlasBuildGetGlyphRasterParams().
+    // - Sets *out_w, *out_h to the Alpha8 bitmap size. The bitmap is written only if w*h <= out_pixels_size, in which case out_glyph->Visible is set.
+    //   Call again with a larger buffer when out_glyph->Visible is false but *out_w is not zero. Returns false if the glyph is not in the font.
+    // - out_glyph->PackId is left invalid: the caller packs the bitmap and adds the glyph as FontBakedLoadGlyph() would.
+    bool            (*FontSrcRasterizeGlyph)(ImFontConfig* src, const ImFontGlyphRasterParams* params, ImWchar codepoint, ImFontGlyph* out_glyph, int* out_w, int* out_h, unsigned char* out_pixels, int out_pixels_size);
+
     // Size of backend data, Per Baked * Per Source. Buffers are managed by core to avoid excessive allocations.
     // FIXME: At this point the two other types of buffers may be managed by core to be consistent?
     size_t          FontBakedSrcLoaderDataSize;
@@ -4156,6 +4239,7 @@ struct ImFontAtlasBuilder
     int                         RectsPackedSurface;     // Number of packed pixels. Used when compacting to heuristically find the ideal texture size.
     int                         RectsDiscardedCount;
     int                         RectsDiscardedSurface;
+    int                         GlyphsReloadedCount;    // Number of missing glyphs reset for reloading by ImFontAtlasBakedForgetMissingGlyph(). Part of ImDrawListSegment::TexStamp.
     int                         FrameCount;             // Current frame count
     ImVec2i                     MaxRectSize;            // Largest rectangle to pack (de-facto used as a "minimum texture size")
     ImVec2i                     MaxRectBounds;          // Bottom-right most used pixels
@@ -4193,6 +4277,7 @@ IMGUI_API ImVec2i           ImFontAtlasTextureGetSizeEstimate(ImFontAtlas* atlas
 IMGUI_API void              ImFontAtlasBuildSetupFontSpecialGlyphs(ImFontAtlas* atlas, ImFont* font, ImFontConfig* src);
 IMGUI_API void              ImFontAtlasBuildLegacyPreloadAllGlyphRanges(ImFontAtlas* atlas); // Legacy
 IMGUI_API void              ImFontAtlasBuildGetOversampleFactors(ImFontConfig* src, ImFontBaked* baked, int* out_oversample_h, int* out_oversample_v);
+IMGUI_API void              ImFontAtlasBuildGetGlyphRasterParams(ImFontConfig* src, ImFontBaked* baked, ImFontGlyphRasterParams* out_params);
 IMGUI_API void              ImFontAtlasBuildDiscardBakes(ImFontAtlas* atlas, int unused_frames);
 
 IMGUI_API bool              ImFontAtlasFontSourceInit(ImFontAtlas* atlas, ImFontConfig* src);
@@ -4210,6 +4295,7 @@ IMGUI_API ImFontBaked*      ImFontAtlasBakedAdd(ImFontAtlas* atlas, ImFont* font
 IMGUI_API void              ImFontAtlasBakedDiscard(ImFontAtlas* atlas, ImFont* font, ImFontBaked* baked);
 IMGUI_API ImFontGlyph*      ImFontAtlasBakedAddFontGlyph(ImFontAtlas* atlas, ImFontBaked* baked, ImFontConfig* src, const ImFontGlyph* in_glyph);
 IMGUI_API void              ImFontAtlasBakedAddFontGlyphAdvancedX(ImFontAtlas* atlas, ImFontBaked* baked, ImFontConfig* src, ImWchar codepoint, float advance_x);
+IMGUI_API bool              ImFontAtlasBakedForgetMissingGlyph(ImFontBaked* baked, ImWchar codepoint);
 IMGUI_API void              ImFontAtlasBakedDiscardFontGlyph(ImFontAtlas* atlas, ImFont* font, ImFontBaked* baked, ImFontGlyph* glyph);
 IMGUI_API void              ImFontAtlasBakedSetFontGlyphBitmap(ImFontAtlas* atlas, ImFontBaked* baked, ImFontConfig* src, ImFontGlyph* glyph, ImTextureRect* r, const unsigned char* src_pixels, ImTextureFormat src_fmt, int src_pitch);
 
@@ -4231,6 +4317,7 @@ IMGUI_API void              ImFontAtlasTextureBlockPostProcessMultiply(ImFontAtl
 IMGUI_API void              ImFontAtlasTextureBlockFill(ImTextureData* dst_tex, int dst_x, int dst_y, int w, int h, ImU32 col);
 IMGUI_API void              ImFontAtlasTextureBlockCopy(ImTextureData* src_tex, int src_x, int src_y, ImTextureData* dst_tex, int dst_x, int dst_y, int w, int h);
 IMGUI_API void              ImFontAtlasTextureBlockQueueUpload(ImFontAtlas* atlas, ImTextureData* tex, int x, int y, int w, int h);
+IMGUI_API int               ImTextureDataCoalesceUpdates(ImTextureData* tex, float max_overhead, int upload_cost_pixels);
 
 IMGUI_API int               ImTextureDataGetFormatBytesPerPixel(ImTextureFormat format);
 IMGUI_API const char*       ImTextureDataGetStatusName(ImTextureStatus status);
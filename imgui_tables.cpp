@@ -797,6 +797,32 @@ static void TableSetupColumnFlags(ImGuiTable* table, ImGuiTableColumn* column, I
     }
 }
 
+// Hash the inputs of the width distribution in TableUpdateLayout() (Part 3 to 5).
+// Column widths and stretch weights that it outputs are fed back as inputs, so a stable table matches from its second frame.
+// Inputs are packed in g.TempBuffer to hash them in a single call (all fields are 4 bytes wide: no padding to clear).
+// They are left there for the caller to verify a hash match, *out_key_size receives their size.
+static ImGuiID TableCalcLayoutCacheKey(ImGuiTable* table, float width_avail, int* out_key_size)
+{
+    struct TableKey { ImGuiTableFlags Flags; int ColumnsEnabledCount; int IsInitializing; float WidthAvail, MinColumnWidth, OuterPaddingX, CellPaddingX, CellSpacingX1, CellSpacingX2; };
+    struct ColumnKey { int Index, DisplayOrder, IsRequestOutput; ImGuiTableColumnFlags Flags; float WidthAuto, WidthRequest, StretchWeight, InitStretchWeightOrWidth; };
+    ImGuiContext& g = *GImGui;
+    g.TempBuffer.reserve((int)(sizeof(TableKey) + sizeof(ColumnKey) * table->ColumnsCount));
+    TableKey* table_key = (TableKey*)(void*)g.TempBuffer.Data;
+    *table_key = { table->Flags, table->ColumnsEnabledCount, table->IsInitializing, width_avail, table->MinColumnWidth, table->OuterPaddingX, table->CellPaddingX, table->CellSpacingX1, table->CellSpacingX2 };
+    ColumnKey* column_key = (ColumnKey*)(void*)(table_key + 1);
+    for (int column_n = 0; column_n < table->ColumnsCount; column_n++)
+    {
+        if (!IM_BITARRAY_TESTBIT(table->EnabledMaskByIndex, column_n))
+            continue;
+        const ImGuiTableColumn* column = &table->Columns[column_n];
+        *column_key++ = { column_n, column->DisplayOrder, column->IsRequestOutput, column->Flags & ~(ImGuiTableColumnFlags_StatusMask_ | ImGuiTableColumnFlags_NoDirectResize_),
+            column->WidthAuto, column->WidthRequest, column->StretchWeight, column->InitStretchWeightOrWidth };
+    }
+    *out_key_size = (int)((char*)column_key - (char*)table_key);
+    const ImGuiID key = ImHashData(table_key, (size_t)*out_key_size);
+    return (key != 0) ? key : 1;
+}
+
 // Layout columns for the frame. This is in essence the followup to BeginTable() and this is our largest function.
 // Runs on the first call to TableNextRow(), to give a chance for TableSetupColumn() and other TableSetupXXXXX() functions to be called first.
 // FIXME-TABLE: Our width (and therefore our WorkRect) will be minimal in the first frame for _WidthAuto columns.
@@ -805,6 +831,7 @@ void ImGui::TableUpdateLayout(ImGuiTable* table)
 {
     ImGuiContext& g = *GImGui;
     IM_ASSERT(table->IsLayoutLocked == false);
+    IM_PROFILE_SCOPE("ImGui::TableUpdateLayout");
 
     const ImGuiTableFlags table_sizing_policy = (table->Flags & ImGuiTableFlags_SizingMask_);
     table->IsDefaultDisplayOrder = true;
@@ -918,113 +945,144 @@ void ImGui::TableUpdateLayout(ImGuiTable* table)
     if (has_auto_fit_request)
         table->IsSettingsDirty = true;
 
-    // [Part 3] Fix column flags and record a few extra information.
-    float sum_width_requests = 0.0f;    // Sum of all width for fixed and auto-resize columns, excluding width contributed by Stretch columns but including spacing/padding.
-    float stretch_sum_weights = 0.0f;   // Sum of all weights for stretch columns.
-    table->LeftMostStretchedColumn = table->RightMostStretchedColumn = -1;
-    for (int column_n = 0; column_n < table->ColumnsCount; column_n++)
+    // Width distribution (Part 3 to 5) only depends on the values hashed by TableCalcLayoutCacheKey(). When they match the
+    // previous frame, the widths stored in columns are still valid: skip it and only reapply the per-frame flags.
+    const ImRect work_rect = table->WorkRect;
+    const float width_spacings = (table->OuterPaddingX * 2.0f) + (table->CellSpacingX1 + table->CellSpacingX2) * (table->ColumnsEnabledCount - 1);
+    const float width_removed = (table->HasScrollbarYPrev && !table->InnerWindow->ScrollbarY) ? g.Style.ScrollbarSize : 0.0f; // To synchronize decoration width of synced tables with mismatching scrollbar state (#5920)
+    const float width_avail = ImMax(1.0f, (((table->Flags & ImGuiTableFlags_ScrollX) && table->InnerWidth == 0.0f) ? table->InnerClipRect.GetWidth() : work_rect.GetWidth()) - width_removed);
+    int layout_cache_key_size = 0;
+    const ImGuiID layout_cache_key = has_auto_fit_request ? 0 : TableCalcLayoutCacheKey(table, width_avail, &layout_cache_key_size);
+    const bool use_layout_cache = (layout_cache_key != 0 && layout_cache_key == table->LayoutCacheKey && layout_cache_key_size == table->LayoutCacheKeyData.Size
+        && memcmp(g.TempBuffer.Data, table->LayoutCacheKeyData.Data, (size_t)layout_cache_key_size) == 0);
+    if (layout_cache_key != 0 && !use_layout_cache)
     {
-        if (!IM_BITARRAY_TESTBIT(table->EnabledMaskByIndex, column_n))
-            continue;
-        ImGuiTableColumn* column = &table->Columns[column_n];
-
-        const bool column_is_resizable = (column->Flags & ImGuiTableColumnFlags_NoResize) == 0;
-        if (column->Flags & ImGuiTableColumnFlags_WidthFixed)
+        table->LayoutCacheKeyData.resize(layout_cache_key_size);
+        memcpy(table->LayoutCacheKeyData.Data, g.TempBuffer.Data, (size_t)layout_cache_key_size);
+    }
+    table->LayoutCacheKey = layout_cache_key;
+    if (use_layout_cache)
+    {
+        for (int column_n = 0; column_n < table->ColumnsCount; column_n++)
         {
-            // Apply same widths policy
-            float width_auto = column->WidthAuto;
-            if (table_sizing_policy == ImGuiTableFlags_SizingFixedSame && (column->AutoFitQueue != 0x00 || !column_is_resizable))
-                width_auto = fixed_max_width_auto;
-
-            // Apply automatic width
-            // Latch initial size for fixed columns and update it constantly for auto-resizing column (unless clipped!)
-            if (column->AutoFitQueue != 0x00)
-                column->WidthRequest = width_auto;
-            else if ((column->Flags & ImGuiTableColumnFlags_WidthFixed) && !column_is_resizable && column->IsRequestOutput)
-                column->WidthRequest = width_auto;
-
-            // FIXME-TABLE: Increase minimum size during init frame to avoid biasing auto-fitting widgets
-            // (e.g. TextWrapped) too much. Otherwise what tends to happen is that TextWrapped would output a very
-            // large height (= first frame scrollbar display very off + clipper would skip lots of items).
-            // This is merely making the side-effect less extreme, but doesn't properly fixes it.
-            // FIXME: Move this to ->WidthGiven to avoid temporary lossyness?
-            // FIXME: This break IsPreserveWidthAuto from not flickering if the stored WidthAuto was smaller.
-            if (column->AutoFitQueue > 0x01 && table->IsInitializing && !column->IsPreserveWidthAuto)
-                column->WidthRequest = ImMax(column->WidthRequest, table->MinColumnWidth * 4.0f); // FIXME-TABLE: Another constant/scale?
-            sum_width_requests += column->WidthRequest;
+            if (!IM_BITARRAY_TESTBIT(table->EnabledMaskByIndex, column_n))
+                continue;
+            ImGuiTableColumn* column = &table->Columns[column_n];
+            column->IsPreserveWidthAuto = false;
+            if (column->NextEnabledColumn == -1 && table->LeftMostStretchedColumn != -1)
+                column->Flags |= ImGuiTableColumnFlags_NoDirectResize_;
+            column->WidthGiven = column->WidthGivenLayout;
         }
-        else
+    }
+    else
+    {
+        // [Part 3] Fix column flags and record a few extra information.
+        float sum_width_requests = 0.0f;    // Sum of all width for fixed and auto-resize columns, excluding width contributed by Stretch columns but including spacing/padding.
+        float stretch_sum_weights = 0.0f;   // Sum of all weights for stretch columns.
+        table->LeftMostStretchedColumn = table->RightMostStretchedColumn = -1;
+        for (int column_n = 0; column_n < table->ColumnsCount; column_n++)
         {
-            // Initialize stretch weight
-            if (column->AutoFitQueue != 0x00 || column->StretchWeight < 0.0f || !column_is_resizable)
+            if (!IM_BITARRAY_TESTBIT(table->EnabledMaskByIndex, column_n))
+                continue;
+            ImGuiTableColumn* column = &table->Columns[column_n];
+
+            const bool column_is_resizable = (column->Flags & ImGuiTableColumnFlags_NoResize) == 0;
+            if (column->Flags & ImGuiTableColumnFlags_WidthFixed)
             {
-                if (column->InitStretchWeightOrWidth > 0.0f)
-                    column->StretchWeight = column->InitStretchWeightOrWidth;
-                else if (table_sizing_policy == ImGuiTableFlags_SizingStretchProp)
-                    column->StretchWeight = (column->WidthAuto / stretch_sum_width_auto) * count_stretch;
-                else
-                    column->StretchWeight = 1.0f;
+                // Apply same widths policy
+                float width_auto = column->WidthAuto;
+                if (table_sizing_policy == ImGuiTableFlags_SizingFixedSame && (column->AutoFitQueue != 0x00 || !column_is_resizable))
+                    width_auto = fixed_max_width_auto;
+
+                // Apply automatic width
+                // Latch initial size for fixed columns and update it constantly for auto-resizing column (unless clipped!)
+                if (column->AutoFitQueue != 0x00)
+                    column->WidthRequest = width_auto;
+                else if ((column->Flags & ImGuiTableColumnFlags_WidthFixed) && !column_is_resizable && column->IsRequestOutput)
+                    column->WidthRequest = width_auto;
+
+                // FIXME-TABLE: Increase minimum size during init frame to avoid biasing auto-fitting widgets
+                // (e.g. TextWrapped) too much. Otherwise what tends to happen is that TextWrapped would output a very
+                // large height (= first frame scrollbar display very off + clipper would skip lots of items).
+                // This is merely making the side-effect less extreme, but doesn't properly fixes it.
+                // FIXME: Move this to ->WidthGiven to avoid temporary lossyness?
+                // FIXME: This break IsPreserveWidthAuto from not flickering if the stored WidthAuto was smaller.
+                if (column->AutoFitQueue > 0x01 && table->IsInitializing && !column->IsPreserveWidthAuto)
+                    column->WidthRequest = ImMax(column->WidthRequest, table->MinColumnWidth * 4.0f); // FIXME-TABLE: Another constant/scale?
+                sum_width_requests += column->WidthRequest;
             }
+            else
+            {
+                // Initialize stretch weight
+                if (column->AutoFitQueue != 0x00 || column->StretchWeight < 0.0f || !column_is_resizable)
+                {
+                    if (column->InitStretchWeightOrWidth > 0.0f)
+                        column->StretchWeight = column->InitStretchWeightOrWidth;
+                    else if (table_sizing_policy == ImGuiTableFlags_SizingStretchProp)
+                        column->StretchWeight = (column->WidthAuto / stretch_sum_width_auto) * count_stretch;
+                    else
+                        column->StretchWeight = 1.0f;
+                }
 
-            stretch_sum_weights += column->StretchWeight;
-            if (table->LeftMostStretchedColumn == -1 || table->Columns[table->LeftMostStretchedColumn].DisplayOrder > column->DisplayOrder)
-                table->LeftMostStretchedColumn = (ImGuiTableColumnIdx)column_n;
-            if (table->RightMostStretchedColumn == -1 || table->Columns[table->RightMostStretchedColumn].DisplayOrder < column->DisplayOrder)
-                table->RightMostStretchedColumn = (ImGuiTableColumnIdx)column_n;
+                stretch_sum_weights += column->StretchWeight;
+                if (table->LeftMostStretchedColumn == -1 || table->Columns[table->LeftMostStretchedColumn].DisplayOrder > column->DisplayOrder)
+                    table->LeftMostStretchedColumn = (ImGuiTableColumnIdx)column_n;
+                if (table->RightMostStretchedColumn == -1 || table->Columns[table->RightMostStretchedColumn].DisplayOrder < column->DisplayOrder)
+                    table->RightMostStretchedColumn = (ImGuiTableColumnIdx)column_n;
+            }
+            column->IsPreserveWidthAuto = false;
+            sum_width_requests += table->CellPaddingX * 2.0f;
         }
-        column->IsPreserveWidthAuto = false;
-        sum_width_requests += table->CellPaddingX * 2.0f;
-    }
-    table->ColumnsEnabledFixedCount = (ImGuiTableColumnIdx)count_fixed;
-    table->ColumnsStretchSumWeights = stretch_sum_weights;
-
-    // [Part 4] Apply final widths based on requested widths
-    const ImRect work_rect = table->WorkRect;
-    const float width_spacings = (table->OuterPaddingX * 2.0f) + (table->CellSpacingX1 + table->CellSpacingX2) * (table->ColumnsEnabledCount - 1);
-    const float width_removed = (table->HasScrollbarYPrev && !table->InnerWindow->ScrollbarY) ? g.Style.ScrollbarSize : 0.0f; // To synchronize decoration width of synced tables with mismatching scrollbar state (#5920)
-    const float width_avail = ImMax(1.0f, (((table->Flags & ImGuiTableFlags_ScrollX) && table->InnerWidth == 0.0f) ? table->InnerClipRect.GetWidth() : work_rect.GetWidth()) - width_removed);
-    const float width_avail_for_stretched_columns = width_avail - width_spacings - sum_width_requests;
-    float width_remaining_for_stretched_columns = width_avail_for_stretched_columns;
-    table->ColumnsGivenWidth = width_spacings + (table->CellPaddingX * 2.0f) * table->ColumnsEnabledCount;
-    for (int column_n = 0; column_n < table->ColumnsCount; column_n++)
-    {
-        if (!IM_BITARRAY_TESTBIT(table->EnabledMaskByIndex, column_n))
-            continue;
-        ImGuiTableColumn* column = &table->Columns[column_n];
+        table->ColumnsEnabledFixedCount = (ImGuiTableColumnIdx)count_fixed;
+        table->ColumnsStretchSumWeights = stretch_sum_weights;
 
-        // Allocate width for stretched/weighted columns (StretchWeight gets converted into WidthRequest)
-        if (column->Flags & ImGuiTableColumnFlags_WidthStretch)
+        // [Part 4] Apply final widths based on requested widths
+        const float width_avail_for_stretched_columns = width_avail - width_spacings - sum_width_requests;
+        float width_remaining_for_stretched_columns = width_avail_for_stretched_columns;
+        table->ColumnsGivenWidth = width_spacings + (table->CellPaddingX * 2.0f) * table->ColumnsEnabledCount;
+        for (int column_n = 0; column_n < table->ColumnsCount; column_n++)
         {
-            float weight_ratio = column->StretchWeight / stretch_sum_weights;
-            column->WidthRequest = IM_TRUNC(ImMax(width_avail_for_stretched_columns * weight_ratio, table->MinColumnWidth) + 0.01f);
-            width_remaining_for_stretched_columns -= column->WidthRequest;
-        }
+            if (!IM_BITARRAY_TESTBIT(table->EnabledMaskByIndex, column_n))
+                continue;
+            ImGuiTableColumn* column = &table->Columns[column_n];
 
-        // [Resize Rule 1] The right-most Visible column is not resizable if there is at least one Stretch column
-        // See additional comments in TableSetColumnWidth().
-        if (column->NextEnabledColumn == -1 && table->LeftMostStretchedColumn != -1)
-            column->Flags |= ImGuiTableColumnFlags_NoDirectResize_;
+            // Allocate width for stretched/weighted columns (StretchWeight gets converted into WidthRequest)
+            if (column->Flags & ImGuiTableColumnFlags_WidthStretch)
+            {
+                float weight_ratio = column->StretchWeight / stretch_sum_weights;
+                column->WidthRequest = IM_TRUNC(ImMax(width_avail_for_stretched_columns * weight_ratio, table->MinColumnWidth) + 0.01f);
+                width_remaining_for_stretched_columns -= column->WidthRequest;
+            }
 
-        // Assign final width, record width in case we will need to shrink
-        column->WidthGiven = ImTrunc(ImMax(column->WidthRequest, table->MinColumnWidth));
-        table->ColumnsGivenWidth += column->WidthGiven;
-    }
+            // [Resize Rule 1] The right-most Visible column is not resizable if there is at least one Stretch column
+            // See additional comments in TableSetColumnWidth().
+            if (column->NextEnabledColumn == -1 && table->LeftMostStretchedColumn != -1)
+                column->Flags |= ImGuiTableColumnFlags_NoDirectResize_;
 
-    // [Part 5] Redistribute stretch remainder width due to rounding (remainder width is < 1.0f * number of Stretch column).
-    // Using right-to-left distribution (more likely to match resizing cursor).
-    if (width_remaining_for_stretched_columns >= 1.0f && !(table->Flags & ImGuiTableFlags_PreciseWidths))
-        for (int order_n = table->ColumnsCount - 1; stretch_sum_weights > 0.0f && width_remaining_for_stretched_columns >= 1.0f && order_n >= 0; order_n--)
-        {
-            if (!IM_BITARRAY_TESTBIT(table->EnabledMaskByDisplayOrder, order_n))
-                continue;
-            ImGuiTableColumn* column = &table->Columns[table->DisplayOrderToIndex[order_n]];
-            if (!(column->Flags & ImGuiTableColumnFlags_WidthStretch))
-                continue;
-            column->WidthRequest += 1.0f;
-            column->WidthGiven += 1.0f;
-            width_remaining_for_stretched_columns -= 1.0f;
+            // Assign final width, record width in case we will need to shrink
+            column->WidthGiven = ImTrunc(ImMax(column->WidthRequest, table->MinColumnWidth));
+            table->ColumnsGivenWidth += column->WidthGiven;
         }
 
+        // [Part 5] Redistribute stretch remainder width due to rounding (remainder width is < 1.0f * number of Stretch column).
+        // Using right-to-left distribution (more likely to match resizing cursor).
+        if (width_remaining_for_stretched_columns >= 1.0f && !(table->Flags & ImGuiTableFlags_PreciseWidths))
+            for (int order_n = table->ColumnsCount - 1; stretch_sum_weights > 0.0f && width_remaining_for_stretched_columns >= 1.0f && order_n >= 0; order_n--)
+            {
+                if (!IM_BITARRAY_TESTBIT(table->EnabledMaskByDisplayOrder, order_n))
+                    continue;
+                ImGuiTableColumn* column = &table->Columns[table->DisplayOrderToIndex[order_n]];
+                if (!(column->Flags & ImGuiTableColumnFlags_WidthStretch))
+                    continue;
+                column->WidthRequest += 1.0f;
+                column->WidthGiven += 1.0f;
+                width_remaining_for_stretched_columns -= 1.0f;
+            }
+        for (int column_n = 0; column_n < table->ColumnsCount; column_n++)
+            if (IM_BITARRAY_TESTBIT(table->EnabledMaskByIndex, column_n))
+                table->Columns[column_n].WidthGivenLayout = table->Columns[column_n].WidthGiven;
+    }
+
     // Determine if table is hovered which will be used to flag columns as hovered.
     // - In principle we'd like to use the equivalent of IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByActiveItem),
     //   but because our item is partially submitted at this point we use ItemHoverable() and a workaround (temporarily
@@ -2604,6 +2662,7 @@ void ImGui::TableSetupDrawChannels(ImGuiTable* table)
 void ImGui::TableMergeDrawChannels(ImGuiTable* table)
 {
     ImGuiContext& g = *GImGui;
+    IM_PROFILE_SCOPE("ImGui::TableMergeDrawChannels");
     ImDrawListSplitter* splitter = table->DrawSplitter;
     const bool has_freeze_v = (table->FreezeRowsCount > 0);
     const bool has_freeze_h = (table->FreezeColumnsCount > 0);
@@ -2789,6 +2848,7 @@ void ImGui::TableDrawBorders(ImGuiTable* table)
     ImGuiWindow* inner_window = table->InnerWindow;
     if (!table->OuterWindow->ClipRect.Overlaps(table->OuterRect))
         return;
+    IM_PROFILE_SCOPE("ImGui::TableDrawBorders");
 
     ImDrawList* inner_drawlist = inner_window->DrawList;
     table->DrawSplitter->SetCurrentChannel(inner_drawlist, TABLE_DRAW_CHANNEL_BG0);
@@ -4002,6 +4062,8 @@ void ImGui::TableGcCompactTransientBuffers(ImGuiTable* table)
     table->SortSpecsMulti.clear();
     table->IsSortSpecsDirty = true; // FIXME: In theory shouldn't have to leak into user performing a sort on resume.
     table->ColumnsNames.clear();
+    table->LayoutCacheKey = 0;
+    table->LayoutCacheKeyData.clear();
     table->MemoryCompacted = true;
     for (int n = 0; n < table->ColumnsCount; n++)
         table->Columns[n].NameOffset = -1;
@@ -4077,6 +4139,7 @@ void ImGui::DebugNodeTable(ImGuiTable* table)
     BulletText("OuterRect: Pos: (%.1f,%.1f) Size: (%.1f,%.1f) Sizing: '%s'", table->OuterRect.Min.x, table->OuterRect.Min.y, table->OuterRect.GetWidth(), table->OuterRect.GetHeight(), DebugNodeTableGetSizingPolicyDesc(table->Flags));
     BulletText("ColumnsGivenWidth: %.1f, ColumnsAutoFitWidth: %.1f, InnerWidth: %.1f%s", table->ColumnsGivenWidth, table->ColumnsAutoFitWidth, table->InnerWidth, table->InnerWidth == 0.0f ? " (auto)" : "");
     BulletText("CellPaddingX: %.1f, CellSpacingX: %.1f/%.1f, OuterPaddingX: %.1f", table->CellPaddingX, table->CellSpacingX1, table->CellSpacingX2, table->OuterPaddingX);
+    BulletText("LayoutCacheKey: 0x%08X", table->LayoutCacheKey);
     BulletText("HoveredColumnBody: %d, HoveredColumnBorder: %d", table->HoveredColumnBody, table->HoveredColumnBorder);
     BulletText("ResizedColumn: %d, ReorderColumn: %d, HeldHeaderColumn: %d", table->ResizedColumn, table->ReorderColumn, table->HeldHeaderColumn);
     for (int n = 0; n < table->InstanceCurrent + 1; n++)